@@ -161,7 +161,22 @@ function vcpkgExtractFile(  [Parameter(Mandatory=$true)][string]$file,
     $zip = $shell.NameSpace($file)
     $itemCount = $zip.Items().Count
 
-    if (vcpkgHasCommand -commandName 'Microsoft.PowerShell.Archive\Expand-Archive')
+    $hasZipFileType = $false
+    try
+    {
+        Add-Type -AssemblyName System.IO.Compression.FileSystem -ErrorAction Stop
+        $hasZipFileType = $true
+    }
+    catch { }
+
+    if ($hasZipFileType)
+    {
+        # Streams the entries in-process; much faster than cmdlet- or shell-based
+        # extraction, which matters for first-run bootstrap on a fresh machine.
+        Write-Verbose("Extracting with System.IO.Compression.ZipFile")
+        [System.IO.Compression.ZipFile]::ExtractToDirectory($file, $destinationPartial)
+    }
+    elseif (vcpkgHasCommand -commandName 'Microsoft.PowerShell.Archive\Expand-Archive')
     {
         Write-Verbose("Extracting with Microsoft.PowerShell.Archive\Expand-Archive")
         Microsoft.PowerShell.Archive\Expand-Archive -path $file -destinationpath $destinationPartial
@@ -110,7 +110,11 @@ function(vcpkg_configure_cmake)
         set(ENV{PATH} "$ENV{PATH};${NINJA_PATH}")
     endif()
 
-    file(REMOVE_RECURSE ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-rel ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-dbg)
+    # Feature-incremental rebuilds (PolicyFeatureIncremental) keep the previous
+    # configure/build outputs so only the newly requested features are built.
+    if(NOT _VCPKG_FEATURE_INCREMENTAL)
+        file(REMOVE_RECURSE ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-rel ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-dbg)
+    endif()
 
     if(DEFINED VCPKG_CMAKE_SYSTEM_NAME)
         list(APPEND _csc_OPTIONS "-DCMAKE_SYSTEM_NAME=${VCPKG_CMAKE_SYSTEM_NAME}")
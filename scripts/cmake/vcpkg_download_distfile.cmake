@@ -103,15 +103,39 @@ function(vcpkg_download_distfile VAR)
         # Tries to download the file.
         foreach(url IN LISTS vcpkg_download_distfile_URLS)
             message(STATUS "Downloading ${url}...")
-            file(DOWNLOAD ${url} "${download_file_path_part}" STATUS download_status)
-            list(GET download_status 0 status_code)
-            if (NOT "${status_code}" STREQUAL "0")
-                message(STATUS "Downloading ${url}... Failed. Status: ${download_status}")
-                set(download_success 0)
+            set(download_success 0)
+
+            # Prefer the tool's native downloader: it fetches large files as parallel
+            # byte-range chunks, resumes interrupted downloads, and verifies the hash
+            # in-process. Falls back to file(DOWNLOAD) when unavailable or on failure.
+            if(DEFINED VCPKG_EXECUTABLE AND EXISTS "${VCPKG_EXECUTABLE}")
+                if(DEFINED vcpkg_download_distfile_SHA512)
+                    set(_vcpkg_download_hash_arg "--sha512=${vcpkg_download_distfile_SHA512}")
+                else()
+                    set(_vcpkg_download_hash_arg "")
+                endif()
+                execute_process(
+                    COMMAND "${VCPKG_EXECUTABLE}" x-download "${url}" "${download_file_path_part}" ${_vcpkg_download_hash_arg}
+                    RESULT_VARIABLE _vcpkg_download_error_code
+                )
+                if("${_vcpkg_download_error_code}" STREQUAL "0")
+                    set(download_success 1)
+                endif()
+            endif()
+
+            if(NOT download_success)
+                file(DOWNLOAD ${url} "${download_file_path_part}" STATUS download_status)
+                list(GET download_status 0 status_code)
+                if("${status_code}" STREQUAL "0")
+                    set(download_success 1)
+                endif()
+            endif()
+
+            if(NOT download_success)
+                message(STATUS "Downloading ${url}... Failed.")
             else()
                 file(RENAME ${download_file_path_part} ${downloaded_file_path})
                 message(STATUS "Downloading ${url}... OK")
-                set(download_success 1)
                 break()
             endif()
         endforeach(url)
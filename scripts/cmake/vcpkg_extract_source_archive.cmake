@@ -43,15 +43,49 @@ function(vcpkg_extract_source_archive_ex)
     endif()
 
     get_filename_component(ARCHIVE_FILENAME ${_vesae_ARCHIVE} NAME)
-    if(NOT EXISTS ${WORKING_DIRECTORY}/${ARCHIVE_FILENAME}.extracted)
-        message(STATUS "Extracting source ${_vesae_ARCHIVE}")
+
+    # The tracking file records the archive's SHA512, so an unchanged distfile skips
+    # extraction entirely while a changed one invalidates the old tree.
+    file(SHA512 ${_vesae_ARCHIVE} ARCHIVE_SHA512)
+    set(EXTRACTED_MARKER ${WORKING_DIRECTORY}/${ARCHIVE_FILENAME}.extracted)
+
+    set(_vesae_needs_extraction ON)
+    if(EXISTS ${EXTRACTED_MARKER})
+        file(READ ${EXTRACTED_MARKER} PREVIOUS_ARCHIVE_SHA512)
+        if(PREVIOUS_ARCHIVE_SHA512 STREQUAL ARCHIVE_SHA512)
+            set(_vesae_needs_extraction OFF)
+        endif()
+    endif()
+
+    if(_vesae_needs_extraction)
+        # Content-addressed shared extraction store: the archive is extracted at most once
+        # per content hash and every buildtree (any port, any triplet) copies from the
+        # pristine store instead of re-extracting. The copy stays writable because
+        # portfiles patch the tree in place.
+        set(EXTRACTION_STORE ${DOWNLOADS}/extracted/${ARCHIVE_SHA512})
+        if(NOT EXISTS ${EXTRACTION_STORE}.complete)
+            message(STATUS "Extracting source ${_vesae_ARCHIVE}")
+            # Extract to a temporary directory and rename so an interrupted extraction
+            # never leaves a half-populated store entry.
+            file(REMOVE_RECURSE ${EXTRACTION_STORE} ${EXTRACTION_STORE}.tmp)
+            file(MAKE_DIRECTORY ${EXTRACTION_STORE}.tmp)
+            vcpkg_execute_required_process(
+                COMMAND ${CMAKE_COMMAND} -E tar xjf ${_vesae_ARCHIVE}
+                WORKING_DIRECTORY ${EXTRACTION_STORE}.tmp
+                LOGNAME extract
+            )
+            file(RENAME ${EXTRACTION_STORE}.tmp ${EXTRACTION_STORE})
+            file(WRITE ${EXTRACTION_STORE}.complete "")
+        else()
+            message(STATUS "Using cached extraction of ${ARCHIVE_FILENAME}")
+        endif()
+
         file(MAKE_DIRECTORY ${WORKING_DIRECTORY})
-        vcpkg_execute_required_process(
-            COMMAND ${CMAKE_COMMAND} -E tar xjf ${_vesae_ARCHIVE}
-            WORKING_DIRECTORY ${WORKING_DIRECTORY}
-            LOGNAME extract
-        )
-        file(WRITE ${WORKING_DIRECTORY}/${ARCHIVE_FILENAME}.extracted)
+        file(GLOB _vesae_store_contents ${EXTRACTION_STORE}/*)
+        foreach(_vesae_item ${_vesae_store_contents})
+            file(COPY ${_vesae_item} DESTINATION ${WORKING_DIRECTORY})
+        endforeach()
+        file(WRITE ${EXTRACTED_MARKER} "${ARCHIVE_SHA512}")
     endif()
     message(STATUS "Extracting done")
 endfunction()
@@ -115,7 +115,11 @@ elseif(CMD MATCHES "^CREATE$")
         )
         set(_VCPKG_INTERNAL_NO_HASH_CHECK "FALSE")
     endif()
-    file(SHA512 ${DOWNLOADS}/${FILENAME} SHA512)
+    if(NOT SHA512)
+        # The tool computes the hash while downloading; this is only the fallback
+        # for direct script invocations.
+        file(SHA512 ${DOWNLOADS}/${FILENAME} SHA512)
+    endif()
 
     file(MAKE_DIRECTORY ports/${PORT})
     configure_file(scripts/templates/portfile.in.cmake ports/${PORT}/portfile.cmake @ONLY)
@@ -0,0 +1,45 @@
+#pragma once
+
+namespace vcpkg::AllocStats
+{
+    // Opt-in allocation tracking (--x-alloc-stats): global operator new/delete are
+    // replaced and every allocation is charged to the subsystem tag of the innermost
+    // TagScope on the current thread ("untagged" otherwise), recording allocation
+    // count, total bytes, and peak live bytes per tag. The hooks and the scope
+    // bookkeeping exist only in builds configured with -DVCPKG_ALLOC_STATS=ON, so a
+    // normal build pays nothing for them -- not even a branch; there enable() warns
+    // that tracking was compiled out.
+#if defined(VCPKG_ALLOC_STATS)
+    void enable();
+    bool enabled();
+
+    struct TagScope
+    {
+        explicit TagScope(const char* tag);
+        ~TagScope();
+
+        TagScope(const TagScope&) = delete;
+        TagScope& operator=(const TagScope&) = delete;
+
+    private:
+        const char* m_previous;
+    };
+
+    // Prints the per-tag table once during exit; does nothing when tracking was
+    // never enabled.
+    void report();
+#else
+    void enable(); // Warns that tracking was compiled out.
+    inline bool enabled() { return false; }
+
+    struct TagScope
+    {
+        explicit TagScope(const char*) {}
+
+        TagScope(const TagScope&) = delete;
+        TagScope& operator=(const TagScope&) = delete;
+    };
+
+    inline void report() {}
+#endif
+}
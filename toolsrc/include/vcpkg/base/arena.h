@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace vcpkg
+{
+    // Bump allocator for short-lived objects that die together, such as parse output or
+    // plan-construction scratch state. Allocation is a pointer increment into
+    // geometrically growing blocks; individual deallocation is a no-op and all memory is
+    // released at once when the arena is destroyed. Destructors of arena-allocated
+    // objects are never run by the arena itself.
+    struct Arena
+    {
+        explicit Arena(size_t first_block_size = 64 * 1024) : m_next_block_size(first_block_size) {}
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        void* allocate(size_t size, size_t align)
+        {
+            uintptr_t p = (reinterpret_cast<uintptr_t>(m_next) + align - 1) & ~(static_cast<uintptr_t>(align) - 1);
+            if (m_next == nullptr || p + size > reinterpret_cast<uintptr_t>(m_end))
+            {
+                grow(size + align);
+                p = (reinterpret_cast<uintptr_t>(m_next) + align - 1) & ~(static_cast<uintptr_t>(align) - 1);
+            }
+            m_next = reinterpret_cast<char*>(p + size);
+            return reinterpret_cast<void*>(p);
+        }
+
+    private:
+        void grow(size_t minimum_size)
+        {
+            size_t block_size = m_next_block_size;
+            if (block_size < minimum_size) block_size = minimum_size;
+            m_next_block_size = block_size * 2;
+
+            m_blocks.emplace_back(new char[block_size]);
+            m_next = m_blocks.back().get();
+            m_end = m_next + block_size;
+        }
+
+        char* m_next = nullptr;
+        char* m_end = nullptr;
+        size_t m_next_block_size;
+        std::vector<std::unique_ptr<char[]>> m_blocks;
+    };
+
+    // STL-compatible adaptor over Arena. Containers using it must not outlive the arena;
+    // deallocate() is a no-op, so repeatedly growing a single container wastes the
+    // abandoned blocks -- reserve up front where the size is known.
+    template<class T>
+    struct ArenaAllocator
+    {
+        using value_type = T;
+
+        ArenaAllocator(Arena& arena) : m_arena(&arena) {}
+
+        template<class U>
+        ArenaAllocator(const ArenaAllocator<U>& other) : m_arena(other.arena())
+        {
+        }
+
+        T* allocate(size_t n) { return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T))); }
+        void deallocate(T*, size_t) {}
+
+        Arena* arena() const { return m_arena; }
+
+    private:
+        Arena* m_arena;
+    };
+
+    template<class T, class U>
+    bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs)
+    {
+        return lhs.arena() == rhs.arena();
+    }
+
+    template<class T, class U>
+    bool operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs)
+    {
+        return lhs.arena() != rhs.arena();
+    }
+}
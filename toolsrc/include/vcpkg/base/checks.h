@@ -52,4 +52,16 @@ namespace vcpkg::Checks
                               Strings::format(error_message_template, error_message_arg1, error_message_args...));
         }
     }
+
+    // Variant for messages whose arguments are themselves expensive to materialize
+    // (path conversions, string joins): the callable is only invoked when the check
+    // fails, so a passing check costs a single branch.
+    template<class MessageFn, class = decltype(std::declval<MessageFn&&>()())>
+    void check_exit(const LineInfo& line_info, bool expression, MessageFn&& get_message)
+    {
+        if (!expression)
+        {
+            exit_with_message(line_info, get_message());
+        }
+    }
 }
@@ -3,6 +3,7 @@
 #include <vcpkg/base/files.h>
 #include <vcpkg/base/machinetype.h>
 
+#include <string>
 #include <vector>
 
 namespace vcpkg::CoffFileReader
@@ -10,11 +11,20 @@ namespace vcpkg::CoffFileReader
     struct DllInfo
     {
         MachineType machine_type;
+        // True when the export directory is present and exports at least one function.
+        bool has_exports;
+        // IMAGE_DLLCHARACTERISTICS_APPCONTAINER, required for Windows Store binaries.
+        bool is_appcontainer;
+        // Names from the import directory, i.e. what dumpbin /dependents prints.
+        std::vector<std::string> imported_dll_names;
     };
 
     struct LibInfo
     {
         std::vector<MachineType> machine_types;
+        // Concatenated .drectve payloads of all archive members; this is where the
+        // linker finds /DEFAULTLIB directives naming the CRT flavor.
+        std::string linker_directives;
     };
 
     DllInfo read_dll(const fs::path& path);
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+
+namespace vcpkg::CoreBudget
+{
+    // Shares the machine's cores between the parallel install scheduler and the build
+    // tools its child builds run (make -j, msbuild /m). Without this, N concurrent
+    // package builds each spawn a full-machine build and oversubscribe N-fold.
+    //
+    // On POSIX this implements the GNU make jobserver protocol: a token pipe is
+    // created, preloaded with the core budget, and advertised to every child build
+    // through MAKEFLAGS, so all the sub-makes of all concurrent package builds draw
+    // from one machine-wide pool. Tools that do not speak the protocol (and all
+    // builds on Windows, which launch under the captured toolchain environment)
+    // fall back to the static even share reported by cores_per_build(), which
+    // build_package forwards to the portfile as VCPKG_MAX_CONCURRENCY.
+    void initialize(size_t total_cores, size_t scheduler_concurrency);
+
+    // The per-build core share: total cores divided by the scheduler concurrency
+    // given to initialize(), never less than 1. Before initialize() is called (or
+    // for serial installs) this is the whole machine.
+    size_t cores_per_build();
+}
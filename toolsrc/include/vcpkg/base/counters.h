@@ -0,0 +1,25 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace vcpkg
+{
+    // A counter for bookkeeping shared across worker threads. Increments are relaxed --
+    // readers only ever aggregate after the writers are done -- and the value is padded
+    // to a cache line so adjacent counters never contend through false sharing.
+    struct alignas(64) RelaxedCounter
+    {
+        constexpr RelaxedCounter() = default;
+
+        RelaxedCounter(const RelaxedCounter&) = delete;
+        RelaxedCounter& operator=(const RelaxedCounter&) = delete;
+
+        void increment() { m_value.fetch_add(1, std::memory_order_relaxed); }
+        void add(uint64_t n) { m_value.fetch_add(n, std::memory_order_relaxed); }
+        uint64_t load() const { return m_value.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<uint64_t> m_value{0};
+    };
+}
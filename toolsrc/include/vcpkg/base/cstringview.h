@@ -18,6 +18,39 @@ namespace vcpkg
         const char* cstr;
     };
 
+    // A length-carrying view over a null-terminated string. Sizes computed once at
+    // the call site (std::string, or one strlen for a literal) propagate instead of
+    // being re-derived by every consumer; the referenced data stays null terminated,
+    // so it still hands a c_str() to C APIs.
+    struct StringView
+    {
+        constexpr StringView() : m_cstr(nullptr), m_size(0) {}
+        StringView(const char* cstr) : m_cstr(cstr), m_size(strlen(cstr)) {}
+        constexpr StringView(const char* cstr, size_t size) : m_cstr(cstr), m_size(size) {}
+        StringView(const std::string& str) : m_cstr(str.c_str()), m_size(str.size()) {}
+        StringView(const CStringView& str) : StringView(str.c_str()) {}
+        constexpr StringView(const StringView&) = default;
+
+        constexpr const char* c_str() const { return m_cstr; }
+        constexpr const char* data() const { return m_cstr; }
+        constexpr size_t size() const { return m_size; }
+        constexpr bool empty() const { return m_size == 0; }
+        std::string to_string() const { return std::string(m_cstr, m_size); }
+
+    private:
+        const char* m_cstr;
+        size_t m_size;
+    };
+
+    inline bool operator==(const StringView& l, const StringView& r)
+    {
+        return l.size() == r.size() && memcmp(l.data(), r.data(), l.size()) == 0;
+    }
+
+    inline bool operator!=(const StringView& l, const StringView& r) { return !(l == r); }
+
+    inline const char* to_printf_arg(const StringView string_view) { return string_view.c_str(); }
+
     struct CWStringView
     {
         constexpr CWStringView() : cstr(nullptr) {}
@@ -31,6 +64,28 @@ namespace vcpkg
         const wchar_t* cstr;
     };
 
+    // A non-owning range of characters referencing a slice of a larger buffer
+    // (such as a memory-mapped file), without copying or requiring null termination.
+    struct StringRange
+    {
+        constexpr StringRange() : begin(nullptr), end(nullptr) {}
+        constexpr StringRange(const char* begin, const char* end) : begin(begin), end(end) {}
+        StringRange(const std::string& str) : begin(str.data()), end(str.data() + str.size()) {}
+
+        size_t size() const { return static_cast<size_t>(end - begin); }
+        std::string to_string() const { return std::string(begin, end); }
+
+        const char* begin;
+        const char* end;
+    };
+
+    inline bool operator==(const StringRange& l, const StringRange& r)
+    {
+        return l.size() == r.size() && memcmp(l.begin, r.begin, l.size()) == 0;
+    }
+
+    inline bool operator!=(const StringRange& l, const StringRange& r) { return !(l == r); }
+
     namespace details
     {
         inline bool vcpkg_strcmp(const char* l, const char* r) { return strcmp(l, r) == 0; }
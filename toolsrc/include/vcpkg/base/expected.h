@@ -72,6 +72,12 @@ namespace vcpkg
             return std::move(this->m_t);
         }
 
+        T& value_or_exit(const LineInfo& line_info) &
+        {
+            exit_if_error(line_info);
+            return this->m_t;
+        }
+
         const T& value_or_exit(const LineInfo& line_info) const&
         {
             exit_if_error(line_info);
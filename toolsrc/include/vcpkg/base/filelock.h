@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vcpkg/base/files.h>
+
+namespace vcpkg::Files
+{
+    // Advisory cross-process lock backed by an OS file lock (LockFileEx on Windows,
+    // flock elsewhere). Multiple processes may hold the shared lock at once; the
+    // exclusive lock waits for all other holders to release. The lock is dropped by
+    // the destructor and is also released by the OS if the process dies, so a crashed
+    // invocation can never wedge later ones.
+    struct FileLock
+    {
+        static FileLock take_shared(const fs::path& path);
+        static FileLock take_exclusive(const fs::path& path);
+
+        FileLock(const FileLock&) = delete;
+        FileLock& operator=(const FileLock&) = delete;
+
+        FileLock(FileLock&& other);
+        FileLock& operator=(FileLock&& other);
+
+        ~FileLock();
+
+    private:
+        explicit FileLock(intptr_t handle) : m_handle(handle) {}
+
+        intptr_t m_handle;
+    };
+}
@@ -1,6 +1,10 @@
 #pragma once
 
 #include <vcpkg/base/expected.h>
+#include <vcpkg/base/span.h>
+
+#include <fstream>
+#include <functional>
 
 #if defined(_WIN32)
 #include <filesystem>
@@ -24,24 +28,116 @@ namespace fs
 
 namespace vcpkg::Files
 {
+    // Append-only line writer over a file, accumulating output in a large user-space
+    // buffer so that producing many small lines issues few underlying writes. The
+    // destructor flushes whatever remains buffered.
+    struct BufferedWriter
+    {
+        explicit BufferedWriter(const fs::path& file_path);
+        BufferedWriter(BufferedWriter&&) = default;
+        BufferedWriter& operator=(BufferedWriter&&) = default;
+        ~BufferedWriter();
+
+        void write_line(const std::string& line);
+        void flush();
+
+    private:
+        std::fstream m_stream;
+        std::string m_buffer;
+    };
+
+    // Builds "base / suffix" paths for many suffixes against one fixed base. The
+    // base's native representation (including its UTF-16 conversion on Windows) is
+    // produced once and kept in a reusable buffer, so each call appends and converts
+    // only the suffix instead of rebuilding the whole path.
+    struct PathBuilder
+    {
+        explicit PathBuilder(const fs::path& base);
+
+        fs::path operator()(const std::string& utf8_suffix);
+
+    private:
+        fs::path::string_type m_buffer;
+        size_t m_base_size;
+    };
+
+    // A read-only view of a file's contents obtained through the platform's memory
+    // mapping facility. The view stays valid for the lifetime of this object and the
+    // contents are never copied into process-private memory.
+    struct MemoryMappedFile
+    {
+        static Expected<MemoryMappedFile> map(const fs::path& file_path);
+
+        MemoryMappedFile() noexcept;
+        MemoryMappedFile(MemoryMappedFile&& other) noexcept;
+        MemoryMappedFile& operator=(MemoryMappedFile&& other) noexcept;
+        MemoryMappedFile(const MemoryMappedFile&) = delete;
+        MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+        ~MemoryMappedFile();
+
+        const char* data() const { return m_data; }
+        size_t size() const { return m_size; }
+
+        Span<const char> view() const { return {m_data, m_size}; }
+
+    private:
+        const char* m_data;
+        size_t m_size;
+#if defined(_WIN32)
+        void* m_mapping_handle;
+#endif
+    };
+
     struct Filesystem
     {
         virtual Expected<std::string> read_contents(const fs::path& file_path) const = 0;
+        // Maps the file instead of copying it into a heap buffer; the contents are
+        // viewable for the lifetime of the returned object. Prefer this over
+        // read_contents() when the caller only scans the data.
+        virtual Expected<MemoryMappedFile> map_contents(const fs::path& file_path) const = 0;
         virtual Expected<std::vector<std::string>> read_lines(const fs::path& file_path) const = 0;
         virtual fs::path find_file_recursively_up(const fs::path& starting_dir, const std::string& filename) const = 0;
         virtual std::vector<fs::path> get_files_recursive(const fs::path& dir) const = 0;
         virtual std::vector<fs::path> get_files_non_recursive(const fs::path& dir) const = 0;
+        // Visits every entry below `dir` in a single traversal, passing each path along
+        // with the file_status observed during enumeration. Unlike get_files_recursive()
+        // this does not materialize the whole tree up front and spares callers a second
+        // status() call per entry, which matters for large packages (qt5 installs ~40k
+        // files). Entries whose status cannot be determined are passed with an unknown
+        // status for the visitor to report.
+        virtual void for_each_file_recursive(
+            const fs::path& dir, const std::function<void(const fs::path&, fs::file_status)>& visitor) const = 0;
 
         virtual void write_lines(const fs::path& file_path, const std::vector<std::string>& lines) = 0;
+        // Gather-write: the parts are written back to back as the new file contents in a
+        // single vectored syscall where the platform supports it, so callers do not need
+        // to concatenate into one buffer first.
+        virtual void write_parts(const fs::path& file_path, const std::vector<std::string>& parts) = 0;
+        // Opens `file_path` for buffered, incremental line output, truncating any
+        // previous contents. Prefer this over write_lines() when the lines are produced
+        // one at a time by a long-running loop.
+        virtual BufferedWriter open_for_write(const fs::path& file_path) = 0;
         virtual void write_contents(const fs::path& file_path, const std::string& data) = 0;
+        virtual void append_contents(const fs::path& file_path, const std::string& data) = 0;
         virtual void rename(const fs::path& oldpath, const fs::path& newpath) = 0;
+        virtual void rename(const fs::path& oldpath, const fs::path& newpath, std::error_code& ec) = 0;
         virtual bool remove(const fs::path& path) = 0;
         virtual bool remove(const fs::path& path, std::error_code& ec) = 0;
         virtual std::uintmax_t remove_all(const fs::path& path, std::error_code& ec) = 0;
+        // Probing queries. The error_code overloads never throw, so loops that test
+        // expected-missing paths pay a branch instead of an unwind; the plain
+        // overloads route through them and report not-found and failure alike as
+        // false, so no probe throws through the underlying filesystem library.
         virtual bool exists(const fs::path& path) const = 0;
+        virtual bool exists(const fs::path& path, std::error_code& ec) const noexcept = 0;
         virtual bool is_directory(const fs::path& path) const = 0;
+        virtual bool is_directory(const fs::path& path, std::error_code& ec) const noexcept = 0;
         virtual bool is_regular_file(const fs::path& path) const = 0;
+        virtual bool is_regular_file(const fs::path& path, std::error_code& ec) const noexcept = 0;
         virtual bool is_empty(const fs::path& path) const = 0;
+        // Not noexcept: emptiness of a directory is answered by starting an iteration,
+        // which may allocate.
+        virtual bool is_empty(const fs::path& path, std::error_code& ec) const = 0;
         virtual bool create_directory(const fs::path& path, std::error_code& ec) = 0;
         virtual bool create_directories(const fs::path& path, std::error_code& ec) = 0;
         virtual void copy(const fs::path& oldpath, const fs::path& newpath, fs::copy_options opts) = 0;
@@ -49,7 +145,12 @@ namespace vcpkg::Files
                                const fs::path& newpath,
                                fs::copy_options opts,
                                std::error_code& ec) = 0;
+        virtual void create_hard_link(const fs::path& oldpath, const fs::path& newpath, std::error_code& ec) = 0;
         virtual fs::file_status status(const fs::path& path, std::error_code& ec) const = 0;
+        virtual std::uintmax_t file_size(const fs::path& path, std::error_code& ec) const = 0;
+        // The last modification time expressed as ticks of the filesystem clock, suitable
+        // for change detection stamps.
+        virtual std::int64_t last_write_time(const fs::path& path, std::error_code& ec) const = 0;
     };
 
     Filesystem& get_real_filesystem();
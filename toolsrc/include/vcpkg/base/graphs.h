@@ -2,9 +2,11 @@
 
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 
 #include <vcpkg/base/checks.h>
 #include <vcpkg/base/span.h>
+#include <vcpkg/base/system.h>
 
 namespace vcpkg::Graphs
 {
@@ -23,6 +25,9 @@ namespace vcpkg::Graphs
     template<class V, class U>
     struct AdjacencyProvider
     {
+        using vertex_type = V;
+        using vertex_data_type = U;
+
         virtual std::vector<V> adjacency_list(const U& vertex) const = 0;
         virtual std::string to_string(const V& vertex) const = 0;
         virtual U load_vertex_data(const V& vertex) const = 0;
@@ -30,58 +35,136 @@ namespace vcpkg::Graphs
 
     namespace details
     {
+        // Recovers <V, U> from any type derived from AdjacencyProvider<V, U> so that
+        // topological_sort() can be templated on the concrete provider. Calling through the
+        // concrete (final) type lets the compiler devirtualize and inline adjacency_list() and
+        // load_vertex_data(); passing an abstract AdjacencyProvider reference still works and
+        // keeps the virtual dispatch.
         template<class V, class U>
-        void topological_sort_internal(const V& vertex,
-                                       const AdjacencyProvider<V, U>& f,
-                                       std::unordered_map<V, ExplorationStatus>& exploration_status,
-                                       std::vector<U>& sorted)
+        AdjacencyProvider<V, U> probe_adjacency_provider(const AdjacencyProvider<V, U>&);
+
+        template<class F>
+        using ProviderBase = decltype(probe_adjacency_provider(std::declval<const F&>()));
+    }
+
+    // Scratch buffers for topological_sort(). Passing the same instance to repeated
+    // sorts reuses the allocations; the buffers are reset at the start of every sort.
+    template<class V>
+    struct SortScratch
+    {
+        std::unordered_map<V, size_t> vertex_indices;
+        std::vector<V> vertices;
+        std::vector<ExplorationStatus> exploration_status;
+
+        void clear()
+        {
+            vertex_indices.clear();
+            vertices.clear();
+            exploration_status.clear();
+        }
+
+        size_t index_of(const V& vertex)
+        {
+            const auto it = vertex_indices.emplace(vertex, vertices.size()).first;
+            if (it->second == vertices.size())
+            {
+                vertices.push_back(vertex);
+                exploration_status.push_back(ExplorationStatus::NOT_EXPLORED);
+            }
+            return it->second;
+        }
+    };
+
+    namespace details
+    {
+        template<class V, class U, class F>
+        void topological_sort_internal(const V& root, const F& f, SortScratch<V>& scratch, std::vector<U>& sorted)
         {
-            ExplorationStatus& status = exploration_status[vertex];
-            switch (status)
+            // One frame per vertex on the current DFS path. An explicit stack keeps deep
+            // dependency chains from overflowing the call stack.
+            struct Frame
+            {
+                size_t vertex_index;
+                U vertex_data;
+                std::vector<V> neighbours;
+                size_t next_neighbour;
+            };
+
+            {
+                const size_t root_index = scratch.index_of(root);
+                if (scratch.exploration_status[root_index] == ExplorationStatus::FULLY_EXPLORED) return;
+            }
+
+            std::vector<Frame> stack;
+            const auto push_frame = [&](size_t vertex_index) {
+                scratch.exploration_status[vertex_index] = ExplorationStatus::PARTIALLY_EXPLORED;
+                U vertex_data = f.load_vertex_data(scratch.vertices[vertex_index]);
+                std::vector<V> neighbours = f.adjacency_list(vertex_data);
+                stack.push_back(Frame{vertex_index, std::move(vertex_data), std::move(neighbours), 0});
+            };
+
+            push_frame(scratch.vertex_indices.at(root));
+            while (!stack.empty())
             {
-                case ExplorationStatus::FULLY_EXPLORED: return;
-                case ExplorationStatus::PARTIALLY_EXPLORED:
+                Frame& frame = stack.back();
+                if (frame.next_neighbour == frame.neighbours.size())
                 {
-                    System::println("Cycle detected within graph:");
-                    for (auto&& node : exploration_status)
+                    sorted.push_back(std::move(frame.vertex_data));
+                    scratch.exploration_status[frame.vertex_index] = ExplorationStatus::FULLY_EXPLORED;
+                    stack.pop_back();
+                    continue;
+                }
+
+                const size_t neighbour_index = scratch.index_of(frame.neighbours[frame.next_neighbour++]);
+                switch (scratch.exploration_status[neighbour_index])
+                {
+                    case ExplorationStatus::FULLY_EXPLORED: break;
+                    case ExplorationStatus::NOT_EXPLORED: push_frame(neighbour_index); break;
+                    case ExplorationStatus::PARTIALLY_EXPLORED:
                     {
-                        if (node.second == ExplorationStatus::PARTIALLY_EXPLORED)
+                        System::println("Cycle detected within graph:");
+                        for (size_t i = 0; i < scratch.vertices.size(); ++i)
                         {
-                            System::println("    %s", f.to_string(node.first));
+                            if (scratch.exploration_status[i] == ExplorationStatus::PARTIALLY_EXPLORED)
+                            {
+                                System::println("    %s", f.to_string(scratch.vertices[i]));
+                            }
                         }
+                        Checks::exit_fail(VCPKG_LINE_INFO);
                     }
-                    Checks::exit_fail(VCPKG_LINE_INFO);
-                }
-                case ExplorationStatus::NOT_EXPLORED:
-                {
-                    status = ExplorationStatus::PARTIALLY_EXPLORED;
-                    U vertex_data = f.load_vertex_data(vertex);
-                    for (const V& neighbour : f.adjacency_list(vertex_data))
-                        topological_sort_internal(neighbour, f, exploration_status, sorted);
-
-                    sorted.push_back(std::move(vertex_data));
-                    status = ExplorationStatus::FULLY_EXPLORED;
-                    return;
+                    default: Checks::unreachable(VCPKG_LINE_INFO);
                 }
-                default: Checks::unreachable(VCPKG_LINE_INFO);
             }
         }
     }
 
-    template<class VertexRange, class V, class U>
-    std::vector<U> topological_sort(const VertexRange& starting_vertices, const AdjacencyProvider<V, U>& f)
+    template<class VertexRange,
+             class F,
+             class V = typename details::ProviderBase<F>::vertex_type,
+             class U = typename details::ProviderBase<F>::vertex_data_type>
+    std::vector<U> topological_sort(const VertexRange& starting_vertices, const F& f, SortScratch<V>& scratch)
     {
         std::vector<U> sorted;
-        std::unordered_map<V, ExplorationStatus> exploration_status;
+        scratch.clear();
 
         for (auto&& vertex : starting_vertices)
         {
-            details::topological_sort_internal(vertex, f, exploration_status, sorted);
+            details::topological_sort_internal<V, U>(vertex, f, scratch, sorted);
         }
 
         return sorted;
     }
 
+    template<class VertexRange,
+             class F,
+             class V = typename details::ProviderBase<F>::vertex_type,
+             class U = typename details::ProviderBase<F>::vertex_data_type>
+    std::vector<U> topological_sort(const VertexRange& starting_vertices, const F& f)
+    {
+        SortScratch<V> scratch;
+        return topological_sort(starting_vertices, f, scratch);
+    }
+
     template<class V>
     struct Graph final : AdjacencyProvider<V, V>
     {
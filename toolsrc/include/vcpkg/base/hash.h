@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vcpkg/base/expected.h>
+#include <vcpkg/base/files.h>
+
+#include <memory>
+#include <string>
+
+namespace vcpkg::Hash
+{
+    // Supported algorithms: "SHA256" and "SHA512" (case-insensitive). Hashing runs
+    // in-process; nothing shells out to an external tool.
+    std::string get_string_hash(const std::string& data, const std::string& hash_type);
+    Expected<std::string> get_file_hash(const Files::Filesystem& fs, const fs::path& path, const std::string& hash_type);
+
+    // Incremental hashing for callers that produce data in chunks, e.g. hashing a
+    // download while it streams to disk. Algorithm selection as above.
+    struct StreamingHasher
+    {
+        explicit StreamingHasher(const std::string& hash_type);
+        ~StreamingHasher();
+
+        StreamingHasher(const StreamingHasher&) = delete;
+        StreamingHasher& operator=(const StreamingHasher&) = delete;
+
+        void update(const void* data, size_t size);
+        std::string finalize();
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> m_impl;
+    };
+}
@@ -1,26 +1,85 @@
 #pragma once
 
+#include <atomic>
+#include <future>
+#include <mutex>
+
 namespace vcpkg
 {
+    // Thread-safe: concurrent workers can share a lazily computed value without
+    // external locking. Initialized values are served with a single atomic load (free
+    // on x86; acquire only orders the first read after the producing store), and the
+    // mutex is only ever taken on the initializing path.
     template<typename T>
     class Lazy
     {
     public:
         Lazy() : value(T()), initialized(false) {}
 
+        // Copies do not carry an in-flight prefetch; the copy falls back to computing
+        // the value on demand.
+        Lazy(const Lazy& other) : value(T()), initialized(false)
+        {
+            std::lock_guard<std::mutex> lock(other.init_mutex);
+            value = other.value;
+            initialized.store(other.initialized.load(std::memory_order_relaxed), std::memory_order_release);
+        }
+        Lazy& operator=(const Lazy& other)
+        {
+            if (this == &other) return *this;
+            std::lock_guard<std::mutex> lock(other.init_mutex);
+            value = other.value;
+            initialized.store(other.initialized.load(std::memory_order_relaxed), std::memory_order_release);
+            return *this;
+        }
+
+        Lazy(Lazy&& other)
+            : value(std::move(other.value)),
+              pending(std::move(other.pending)),
+              initialized(other.initialized.load(std::memory_order_relaxed))
+        {
+        }
+        Lazy& operator=(Lazy&& other)
+        {
+            value = std::move(other.value);
+            pending = std::move(other.pending);
+            initialized.store(other.initialized.load(std::memory_order_relaxed), std::memory_order_release);
+            return *this;
+        }
+
+        // Begins computing the value on a background thread. A later get_lazy() joins
+        // that work instead of running its functor, so several Lazy values can be
+        // produced concurrently and overlapped with other startup work.
+        template<class F>
+        void prefetch(const F& f) const
+        {
+            if (initialized.load(std::memory_order_acquire)) return;
+            std::lock_guard<std::mutex> lock(init_mutex);
+            if (initialized.load(std::memory_order_relaxed) || pending.valid()) return;
+            pending = std::async(std::launch::async, [f]() { return f(); });
+        }
+
         template<class F>
         T const& get_lazy(const F& f) const
         {
-            if (!initialized)
+            // Double-checked: the hot path is the one load above; losers of the
+            // initialization race re-check under the lock and reuse the winner's value.
+            if (!initialized.load(std::memory_order_acquire))
             {
-                value = f();
-                initialized = true;
+                std::lock_guard<std::mutex> lock(init_mutex);
+                if (!initialized.load(std::memory_order_relaxed))
+                {
+                    value = pending.valid() ? pending.get() : f();
+                    initialized.store(true, std::memory_order_release);
+                }
             }
             return value;
         }
 
     private:
         mutable T value;
-        mutable bool initialized;
+        mutable std::future<T> pending;
+        mutable std::mutex init_mutex;
+        mutable std::atomic<bool> initialized;
     };
 }
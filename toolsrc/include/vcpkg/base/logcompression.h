@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/optional.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace vcpkg::LogCompression
+{
+    // Build logs compress extremely well (long repeated compiler command lines and
+    // paths), so capture compresses them on the fly with a simple block-based LZ77
+    // codec instead of landing gigabytes of text on disk. The format is our own --
+    // the tool links no compression library -- and `vcpkg x-cat-log` decompresses
+    // for viewing. Compressed logs carry the ".vlz" extension.
+    constexpr char FILE_EXTENSION[] = ".vlz";
+
+    bool is_compressed_log_path(const fs::path& path);
+
+    // Streaming compressor over an already-open file. Input is buffered into fixed
+    // blocks and each block hits the disk exactly once, so memory stays bounded no
+    // matter how large the log grows.
+    struct Compressor
+    {
+        explicit Compressor(FILE* file);
+        ~Compressor();
+
+        Compressor(const Compressor&) = delete;
+        Compressor& operator=(const Compressor&) = delete;
+
+        void write(const char* data, size_t size);
+
+        // Flushes the final partial block; returns the total compressed bytes
+        // written. No data may be written afterwards.
+        uint64_t finish();
+
+    private:
+        void flush_block(const char* data, size_t size);
+
+        FILE* m_file;
+        std::string m_pending;
+        uint64_t m_compressed_bytes;
+        bool m_finished;
+    };
+
+    // Inflates a complete compressed log; nullopt if `compressed` is not in the
+    // expected format or is corrupt.
+    Optional<std::string> decompress(const std::string& compressed);
+}
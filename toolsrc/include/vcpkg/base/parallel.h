@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vcpkg/base/system.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace vcpkg::Parallel
+{
+    // Number of workers the helpers below use for `task_count` tasks: one thread per
+    // usable hardware context (respecting container CPU caps), never more than there
+    // are tasks, and at least one.
+    inline size_t worker_count_for(const size_t task_count)
+    {
+        return std::max<size_t>(1, std::min<size_t>(System::get_cpu_topology().effective_cores, task_count));
+    }
+
+    // Runs f(i, worker_index) for every i in [0, task_count), fanned across
+    // `worker_count` threads including the calling thread, and joins before returning.
+    // Tasks are claimed from a shared atomic counter, which load-balances uneven task
+    // costs without any per-task queueing; worker_index is in [0, worker_count) so
+    // callers can keep per-worker state and merge it after the join. Exceptions must
+    // not escape f; Checks::exit_* from a worker terminates the process as usual.
+    template<class F>
+    void for_each_index_with_worker(const size_t worker_count, const size_t task_count, const F& f)
+    {
+        if (task_count == 0) return;
+
+        std::atomic<size_t> next_task{0};
+        const auto work = [&](const size_t worker_index) {
+            for (;;)
+            {
+                const size_t i = next_task.fetch_add(1, std::memory_order_relaxed);
+                if (i >= task_count) return;
+                f(i, worker_index);
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (size_t i = 1; i < worker_count; ++i)
+            workers.emplace_back(work, i);
+        work(0);
+        for (std::thread& worker : workers)
+            worker.join();
+    }
+
+    // Runs f(i) for every i in [0, task_count) across worker_count_for(task_count)
+    // threads, for callers that need no per-worker state.
+    template<class F>
+    void for_each_index(const size_t task_count, const F& f)
+    {
+        for_each_index_with_worker(
+            worker_count_for(task_count), task_count, [&f](const size_t i, const size_t) { f(i); });
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+
+namespace vcpkg::Progress
+{
+    // Live per-package status lines for long-running operations. Worker threads only
+    // record their current phase under a mutex; a dedicated render thread multiplexes
+    // the active tasks into a single throttled status line on stderr, so the threads
+    // doing the work never block on console I/O. The engine renders only when stderr
+    // is a terminal and stays inert otherwise.
+    struct TaskScope
+    {
+        explicit TaskScope(std::string name);
+        ~TaskScope();
+
+        TaskScope(const TaskScope&) = delete;
+        TaskScope& operator=(const TaskScope&) = delete;
+
+        // Updates the phase shown next to this task, e.g. "build" or "install".
+        void set_phase(std::string phase);
+
+    private:
+        size_t m_id;
+    };
+
+    // Erases the status line and joins the render thread; called once during exit.
+    // Does nothing when no task was ever shown.
+    void shutdown();
+}
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <vcpkg/base/span.h>
+
 #include <algorithm>
+#include <functional>
+#include <utility>
 #include <vector>
 
 // Add more forwarding functions to the m_data std::vector as needed.
@@ -46,7 +50,126 @@ namespace vcpkg
 
         const T& operator[](int i) const { return this->m_data[i]; }
 
+        // Inserts in place, keeping the data sorted, so callers do not need to rebuild
+        // the whole container to add an element.
+        void insert(T value)
+        {
+            auto it = std::lower_bound(this->m_data.begin(), this->m_data.end(), value);
+            this->m_data.insert(it, std::move(value));
+        }
+
+        template<class Compare>
+        void insert(T value, Compare comp)
+        {
+            auto it = std::lower_bound(this->m_data.begin(), this->m_data.end(), value, comp);
+            this->m_data.insert(it, std::move(value));
+        }
+
+        // Non-owning view over the sorted data.
+        Span<const T> span() const { return Span<const T>(this->m_data.data(), this->m_data.size()); }
+
     private:
         std::vector<T> m_data;
     };
+
+    // Sorted-vector-backed set for small, iteration-heavy key sets (cluster features,
+    // parsed command switches). One contiguous allocation instead of a node per
+    // element, binary-search lookup, and iteration in key order.
+    template<class T, class Compare = std::less<T>>
+    class FlatSet
+    {
+    public:
+        using value_type = T;
+        using iterator = typename std::vector<T>::const_iterator;
+        using const_iterator = typename std::vector<T>::const_iterator;
+
+        iterator begin() const { return m_data.cbegin(); }
+        iterator end() const { return m_data.cend(); }
+        iterator cbegin() const { return m_data.cbegin(); }
+        iterator cend() const { return m_data.cend(); }
+
+        bool empty() const { return m_data.empty(); }
+        typename std::vector<T>::size_type size() const { return m_data.size(); }
+
+        iterator find(const T& value) const
+        {
+            auto it = std::lower_bound(m_data.cbegin(), m_data.cend(), value, Compare());
+            if (it != m_data.cend() && !Compare()(value, *it)) return it;
+            return m_data.cend();
+        }
+
+        std::pair<iterator, bool> insert(T value)
+        {
+            auto it = std::lower_bound(m_data.begin(), m_data.end(), value, Compare());
+            if (it != m_data.end() && !Compare()(value, *it)) return {it, false};
+            return {m_data.insert(it, std::move(value)), true};
+        }
+
+        void clear() { m_data.clear(); }
+
+    private:
+        std::vector<T> m_data;
+    };
+
+    // The map counterpart of FlatSet: sorted key/value pairs in one vector.
+    template<class K, class V, class Compare = std::less<K>>
+    class FlatMap
+    {
+    public:
+        using value_type = std::pair<K, V>;
+        using iterator = typename std::vector<value_type>::iterator;
+        using const_iterator = typename std::vector<value_type>::const_iterator;
+
+        iterator begin() { return m_data.begin(); }
+        iterator end() { return m_data.end(); }
+        const_iterator begin() const { return m_data.cbegin(); }
+        const_iterator end() const { return m_data.cend(); }
+        const_iterator cbegin() const { return m_data.cbegin(); }
+        const_iterator cend() const { return m_data.cend(); }
+
+        bool empty() const { return m_data.empty(); }
+        typename std::vector<value_type>::size_type size() const { return m_data.size(); }
+
+        iterator find(const K& key)
+        {
+            auto it = lower_bound(key);
+            if (it != m_data.end() && !Compare()(key, it->first)) return it;
+            return m_data.end();
+        }
+        const_iterator find(const K& key) const
+        {
+            auto it = std::lower_bound(m_data.cbegin(), m_data.cend(), key, [](const value_type& entry, const K& k) {
+                return Compare()(entry.first, k);
+            });
+            if (it != m_data.cend() && !Compare()(key, it->first)) return it;
+            return m_data.cend();
+        }
+
+        // Matching std::map, an existing key keeps its value.
+        std::pair<iterator, bool> emplace(K key, V value)
+        {
+            auto it = lower_bound(key);
+            if (it != m_data.end() && !Compare()(key, it->first)) return {it, false};
+            return {m_data.emplace(it, std::move(key), std::move(value)), true};
+        }
+
+        V& operator[](const K& key)
+        {
+            auto it = lower_bound(key);
+            if (it != m_data.end() && !Compare()(key, it->first)) return it->second;
+            return m_data.emplace(it, key, V())->second;
+        }
+
+        void clear() { m_data.clear(); }
+
+    private:
+        iterator lower_bound(const K& key)
+        {
+            return std::lower_bound(m_data.begin(), m_data.end(), key, [](const value_type& entry, const K& k) {
+                return Compare()(entry.first, k);
+            });
+        }
+
+        std::vector<value_type> m_data;
+    };
 }
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vcpkg/base/counters.h>
+
+#include <string>
+
+namespace vcpkg::Stats
+{
+    // Per-invocation hot-path counters. They are incremented unconditionally -- a
+    // relaxed add is cheap enough for the paths they instrument -- and only aggregated
+    // when reported, either at exit when --stats was passed or by the x-stats command.
+    void enable();
+    bool enabled();
+
+    struct Counters
+    {
+        RelaxedCounter ports_loaded;
+        RelaxedCounter ports_load_us;
+        RelaxedCounter binary_cache_hits;
+        RelaxedCounter binary_cache_misses;
+        RelaxedCounter control_cache_hits;
+        RelaxedCounter control_cache_misses;
+        RelaxedCounter files_read;
+        RelaxedCounter bytes_read;
+        RelaxedCounter files_written;
+        RelaxedCounter bytes_written;
+        RelaxedCounter processes_spawned;
+    };
+
+    Counters& get();
+
+    // Renders every counter as one flat JSON object, suitable for log scraping.
+    std::string to_json();
+
+    // Prints the JSON object; called once during exit. Does nothing when --stats was
+    // not passed.
+    void report();
+}
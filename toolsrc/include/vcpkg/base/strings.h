@@ -2,8 +2,16 @@
 
 #include <vcpkg/base/cstringview.h>
 
+#include <array>
 #include <vector>
 
+namespace vcpkg
+{
+    // Forward-declared because optional.h includes checks.h, which includes this header.
+    template<class T>
+    struct Optional;
+}
+
 namespace vcpkg::Strings::details
 {
     template<class T>
@@ -23,6 +31,8 @@ namespace vcpkg::Strings::details
     }
 
     std::string format_internal(const char* fmtstr, ...);
+
+    void format_internal_to(std::string& output, const char* fmtstr, ...);
 }
 
 namespace vcpkg::Strings
@@ -34,20 +44,64 @@ namespace vcpkg::Strings
         return details::format_internal(fmtstr, to_printf_arg(to_printf_arg(args))...);
     }
 
+    // Appends the formatted text to `buffer` in a single pass, so hot loops can reuse
+    // one buffer across iterations instead of constructing a string per call.
+    template<class... Args>
+    void format_to(std::string& buffer, const char* fmtstr, const Args&... args)
+    {
+        using vcpkg::Strings::details::to_printf_arg;
+        details::format_internal_to(buffer, fmtstr, to_printf_arg(to_printf_arg(args))...);
+    }
+
     std::wstring to_utf16(const CStringView& s);
 
     std::string to_utf8(const CWStringView& w);
 
+    // Appending transcoders for hot loops: the converted text lands in a
+    // caller-owned buffer, so reusing one buffer across calls amortizes the
+    // allocation the returning forms above pay every time. ASCII runs -- the
+    // overwhelming majority of paths, environment blocks and build output -- are
+    // widened/narrowed sixteen bytes at a time with SSE2; only text from the first
+    // non-ASCII unit onward goes through the platform converter.
+    void to_utf16_append(const CStringView& s, std::wstring& output);
+    void to_utf8_append(const CWStringView& w, std::string& output);
+
     std::string::const_iterator case_insensitive_ascii_find(const std::string& s, const std::string& pattern);
 
     bool case_insensitive_ascii_contains(const std::string& s, const std::string& pattern);
 
-    bool case_insensitive_ascii_equals(const CStringView left, const CStringView right);
+    // Length mismatches are rejected from the carried sizes before any bytes are
+    // compared, and the scan itself never re-derives a length.
+    bool case_insensitive_ascii_equals(const StringView left, const StringView right);
+
+    // Three-way ASCII-case-insensitive comparison, consistent with
+    // case_insensitive_ascii_equals; used for binary searching sorted name tables.
+    int case_insensitive_ascii_compare(const StringView left, const StringView right);
 
     std::string ascii_to_lowercase(const std::string& input);
 
     bool case_insensitive_ascii_starts_with(const std::string& s, const std::string& pattern);
 
+    // Hash of the lowercased bytes, consistent with case_insensitive_ascii_equals.
+    size_t case_insensitive_ascii_hash(const std::string& s);
+
+    // Single-pass search for multiple literal patterns (Aho-Corasick), matching
+    // case-insensitively over ASCII. Construction cost is proportional to the total
+    // pattern length; first_match() then scans the haystack once regardless of how many
+    // patterns there are.
+    struct MultiPatternMatcher
+    {
+        explicit MultiPatternMatcher(const std::vector<std::string>& patterns);
+
+        // Returns the index of the first pattern (in construction order) occurring
+        // anywhere in `input`, or nullopt if none do.
+        Optional<size_t> first_match(const std::string& input) const;
+
+    private:
+        std::vector<std::array<int, 256>> m_transitions;
+        std::vector<size_t> m_first_pattern;
+    };
+
     template<class Container, class Transformer>
     std::string join(const char* delimiter, const Container& v, Transformer transformer)
     {
@@ -84,6 +138,18 @@ namespace vcpkg::Strings
 
     std::vector<std::string> split(const std::string& s, const std::string& delimiter);
 
+    // Small fixed-pattern scanners for sites that previously compiled a std::regex at
+    // runtime: construction alone costs milliseconds and matching is far slower than a
+    // direct scan.
+
+    // Collapses every whitespace run to a single space, like regex_replace("\s+", " ").
+    std::string collapse_whitespace(const std::string& input);
+
+    // Appends the target of every `add_library(` call in a CMake source to `out`: the
+    // token after the open paren, which must be followed by whitespace. Equivalent to
+    // the matches of \badd_library\(([^\s\)]+)\s.
+    void find_cmake_library_names(const std::string& contents, std::vector<std::string>& out);
+
     template<class T>
     std::string serialize(const T& t)
     {
@@ -4,6 +4,9 @@
 #include <vcpkg/base/optional.h>
 #include <vcpkg/base/strings.h>
 
+#include <functional>
+#include <future>
+
 namespace vcpkg::System
 {
     tm get_current_date_time();
@@ -36,13 +39,55 @@ namespace vcpkg::System
     {
         int exit_code;
         std::string output;
+        // Peak memory of the child process tree in bytes, on platforms that can
+        // observe it (Windows job-object accounting); 0 when unknown.
+        long long peak_memory_bytes = 0;
     };
 
-    int cmd_execute_clean(const CStringView cmd_line);
-
-    int cmd_execute(const CStringView cmd_line);
-
-    ExitCodeAndOutput cmd_execute_and_capture_output(const CStringView cmd_line);
+    int cmd_execute_clean(const StringView cmd_line);
+
+#if defined(_WIN32)
+    // Runs `environment_setup_cmd` under the clean environment and captures the
+    // variable block it leaves behind, suitable for cmd_execute_with_environment.
+    // Returns nullopt if the setup command fails.
+    Optional<std::wstring> capture_clean_environment(const CStringView environment_setup_cmd);
+
+    // Same as cmd_execute_clean, but launches with the given captured environment
+    // block instead of the default clean block.
+    int cmd_execute_with_environment(const StringView cmd_line, const std::wstring& environment_block);
+#endif
+
+    int cmd_execute(const StringView cmd_line);
+
+    ExitCodeAndOutput cmd_execute_and_capture_output(const StringView cmd_line);
+
+    // Streams the child's combined stdout/stderr into `log_file` while keeping only the
+    // last `tail_capacity` bytes in memory; `output` holds that tail on return. Use
+    // this instead of cmd_execute_and_capture_output for commands whose logs can grow
+    // to gigabytes: the full log lands on disk, and the tail is enough to show the
+    // failure immediately.
+    ExitCodeAndOutput cmd_execute_and_capture_output_to_file(const StringView cmd_line,
+                                                             const fs::path& log_file,
+                                                             size_t tail_capacity);
+
+#if defined(_WIN32)
+    // The capture-to-file mode above, launched with the given captured environment
+    // block instead of this process's environment.
+    ExitCodeAndOutput cmd_execute_with_environment_and_capture_output_to_file(const StringView cmd_line,
+                                                                              const std::wstring& environment_block,
+                                                                              const fs::path& log_file,
+                                                                              size_t tail_capacity);
+#endif
+
+    // Runs a command, delivering its combined stdout/stderr to `sink` in large chunks as
+    // it is produced instead of accumulating everything in memory. Returns the exit
+    // code, or 1 if the process could not be launched or the pipe broke mid-read.
+    int cmd_execute_and_stream_output(const StringView cmd_line,
+                                      const std::function<void(const char*, size_t)>& sink);
+
+    // Launches a command on a background thread, so callers can overlap process startup
+    // and execution with other work and collect the result through the future.
+    std::future<ExitCodeAndOutput> cmd_execute_and_capture_output_async(std::string cmd_line);
 
     void powershell_execute(const std::string& title,
                             const fs::path& script_path,
@@ -59,6 +104,10 @@ namespace vcpkg::System
         warning = 14,
     };
 
+    // Writes any batched console output to stdout. Runs automatically before external
+    // processes are spawned and during exit; only interactive prompts need to call it.
+    void flush_output();
+
     void println();
     void print(const CStringView message);
     void println(const CStringView message);
@@ -89,8 +138,16 @@ namespace vcpkg::System
         return System::println(c, Strings::format(message_template, message_arg1, message_args...));
     }
 
+    // Reads are memoized per process: repeatedly queried variables (PATH, VCPKG_ROOT,
+    // VCPKG_DEFAULT_TRIPLET) pay the syscall and, on Windows, the UTF-16 conversions
+    // only once. The cache stays coherent because in-process writes go through
+    // set_environment_variable().
     Optional<std::string> get_environment_variable(const CStringView varname) noexcept;
 
+    // Sets (or, with nullopt, unsets) a variable in this process's environment and
+    // updates the read cache in place.
+    void set_environment_variable(const CStringView varname, const Optional<std::string>& value) noexcept;
+
     Optional<std::string> get_registry_string(void* base_hkey, const CStringView subkey, const CStringView valuename);
 
     enum class CPUArchitecture
@@ -105,6 +162,30 @@ namespace vcpkg::System
 
     CPUArchitecture get_host_processor();
 
+    // Total physical memory of this machine in bytes, or 0 if it cannot be
+    // determined. Used as the budget for memory-aware build scheduling.
+    long long get_physical_memory_bytes();
+
+    // Memory currently available for new allocations in bytes (MemAvailable on
+    // Linux, available physical memory on Windows), or 0 if it cannot be determined.
+    long long get_available_memory_bytes();
+
+    struct CPUTopology
+    {
+        // Hardware execution contexts (SMT threads).
+        size_t logical_cores;
+        // Physical cores; equals logical_cores when SMT is off or undetectable.
+        size_t physical_cores;
+        // Cores this process may actually use after container limits: CPU affinity
+        // masks and cgroup CPU quotas on Linux, job-object CPU rate caps on Windows.
+        // This is the right default for scheduler and thread-pool sizing -- CI often
+        // runs in containers capped far below the host's core count.
+        size_t effective_cores;
+    };
+
+    // Detected once per process.
+    const CPUTopology& get_cpu_topology();
+
     std::vector<CPUArchitecture> get_supported_host_architectures();
 
     const fs::path& get_program_files_32_bit();
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+
+namespace vcpkg::Timing
+{
+    // Hierarchical phase timing, enabled by --debug-timing. Scopes nest per thread, so
+    // each completed scope records its full path ("install plan/load ports") along with
+    // the thread it ran on and its duration. When enabled, exit prints an aggregated
+    // per-phase summary to the console and writes the raw events as a Chrome
+    // trace-event JSON file (loadable in chrome://tracing) for offline profiling.
+    void enable();
+    bool enabled();
+
+    struct PhaseScope
+    {
+        explicit PhaseScope(std::string name);
+        ~PhaseScope();
+
+        PhaseScope(const PhaseScope&) = delete;
+        PhaseScope& operator=(const PhaseScope&) = delete;
+
+    private:
+        bool m_active;
+    };
+
+    // Prints the summary and writes the trace file; called once during exit. Does
+    // nothing when timing was never enabled.
+    void report();
+}
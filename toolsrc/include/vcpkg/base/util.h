@@ -31,6 +31,167 @@ namespace vcpkg::Util
         }
     }
 
+    // Lazy, allocation-free counterparts to fmap() / fmap_flatten() for ranges that are
+    // iterated exactly once. The views hold a pointer to the underlying range, so the range
+    // must outlive the view.
+    namespace Views
+    {
+        template<class It, class Func>
+        struct TransformIterator
+        {
+            It it;
+            const Func* f;
+
+            decltype(auto) operator*() const { return (*f)(*it); }
+            TransformIterator& operator++()
+            {
+                ++it;
+                return *this;
+            }
+            bool operator==(const TransformIterator& other) const { return it == other.it; }
+            bool operator!=(const TransformIterator& other) const { return it != other.it; }
+        };
+
+        template<class Range, class Func>
+        struct TransformView
+        {
+            const Range* range;
+            Func f;
+
+            using iterator = TransformIterator<decltype(std::begin(std::declval<const Range&>())), Func>;
+
+            iterator begin() const { return {std::begin(*range), &f}; }
+            iterator end() const { return {std::end(*range), &f}; }
+        };
+
+        template<class It, class Pred>
+        struct FilterIterator
+        {
+            It it;
+            It last;
+            const Pred* pred;
+
+            decltype(auto) operator*() const { return *it; }
+            FilterIterator& operator++()
+            {
+                ++it;
+                skip_rejected();
+                return *this;
+            }
+            void skip_rejected()
+            {
+                while (it != last && !(*pred)(*it))
+                    ++it;
+            }
+            bool operator==(const FilterIterator& other) const { return it == other.it; }
+            bool operator!=(const FilterIterator& other) const { return it != other.it; }
+        };
+
+        template<class Range, class Pred>
+        struct FilterView
+        {
+            const Range* range;
+            Pred pred;
+
+            using iterator = FilterIterator<decltype(std::begin(std::declval<const Range&>())), Pred>;
+
+            iterator begin() const
+            {
+                iterator it{std::begin(*range), std::end(*range), &pred};
+                it.skip_rejected();
+                return it;
+            }
+            iterator end() const { return {std::end(*range), std::end(*range), &pred}; }
+        };
+
+        // Flattening requires the outer range to yield lvalue inner ranges (e.g. a transform
+        // returning a reference to a member container); iterators into temporaries would dangle.
+        template<class OuterIt>
+        struct FlattenIterator
+        {
+            using InnerIt = decltype(std::begin(*std::declval<OuterIt&>()));
+
+            OuterIt outer;
+            OuterIt outer_last;
+            InnerIt inner;
+            InnerIt inner_last;
+
+            decltype(auto) operator*() const { return *inner; }
+            FlattenIterator& operator++()
+            {
+                ++inner;
+                skip_empty();
+                return *this;
+            }
+            void enter_outer()
+            {
+                if (outer != outer_last)
+                {
+                    auto&& inner_range = *outer;
+                    inner = std::begin(inner_range);
+                    inner_last = std::end(inner_range);
+                }
+            }
+            void skip_empty()
+            {
+                while (outer != outer_last && inner == inner_last)
+                {
+                    ++outer;
+                    enter_outer();
+                }
+            }
+            bool operator==(const FlattenIterator& other) const
+            {
+                return outer == other.outer && (outer == outer_last || inner == other.inner);
+            }
+            bool operator!=(const FlattenIterator& other) const { return !(*this == other); }
+        };
+
+        template<class Range>
+        struct FlattenView
+        {
+            const Range* range;
+
+            using iterator = FlattenIterator<decltype(std::begin(std::declval<const Range&>()))>;
+
+            iterator begin() const
+            {
+                iterator it{std::begin(*range), std::end(*range), {}, {}};
+                it.enter_outer();
+                it.skip_empty();
+                return it;
+            }
+            iterator end() const { return {std::end(*range), std::end(*range), {}, {}}; }
+        };
+    }
+
+    template<class Range, class Func>
+    Views::TransformView<Range, Func> transform(const Range& range, Func f)
+    {
+        return {&range, std::move(f)};
+    }
+
+    template<class Range, class Pred>
+    Views::FilterView<Range, Pred> filter(const Range& range, Pred pred)
+    {
+        return {&range, std::move(pred)};
+    }
+
+    template<class Range>
+    Views::FlattenView<Range> flatten(const Range& range)
+    {
+        return {&range};
+    }
+
+    template<class View, class T = std::decay_t<decltype(*begin(std::declval<const View&>()))>>
+    std::vector<T> to_vector(const View& view)
+    {
+        std::vector<T> ret;
+        for (auto&& x : view)
+            ret.push_back(x);
+        return ret;
+    }
+
     template<class Cont, class Func>
     using FmapOut = decltype(std::declval<Func&>()(*begin(std::declval<Cont&>())));
 
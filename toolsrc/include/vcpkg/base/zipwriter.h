@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vcpkg/base/files.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vcpkg::Files
+{
+    // Minimal streaming zip writer. Entries go to disk as they are added and the
+    // central directory is emitted by finish(), so each input byte is written exactly
+    // once and nothing needs to be staged on disk first. Entries are stored
+    // uncompressed; zip64 records are used where offsets or counts outgrow the classic
+    // format, so archives beyond 4GB and 65535 entries work.
+    struct ZipWriter
+    {
+        explicit ZipWriter(const fs::path& file_path);
+
+        ZipWriter(const ZipWriter&) = delete;
+        ZipWriter& operator=(const ZipWriter&) = delete;
+
+        // `archive_name` must be relative and use forward slashes.
+        void add_file(const std::string& archive_name, const std::string& contents);
+
+        // Writes the central directory and closes the archive; no entries can be added
+        // afterwards.
+        void finish();
+
+    private:
+        struct CentralDirectoryEntry
+        {
+            std::string name;
+            uint32_t crc32;
+            uint64_t size;
+            uint64_t local_header_offset;
+        };
+
+        void write_bytes(const void* data, size_t size);
+        void write_u16(uint16_t value);
+        void write_u32(uint32_t value);
+        void write_u64(uint64_t value);
+
+        std::fstream m_stream;
+        uint64_t m_offset;
+        std::vector<CentralDirectoryEntry> m_entries;
+    };
+}
@@ -13,7 +13,7 @@ namespace vcpkg
     struct BinaryParagraph
     {
         BinaryParagraph();
-        explicit BinaryParagraph(std::unordered_map<std::string, std::string> fields);
+        explicit BinaryParagraph(Parse::RawParagraph fields);
         BinaryParagraph(const SourceParagraph& spgh, const Triplet& triplet);
         BinaryParagraph(const SourceParagraph& spgh, const FeatureParagraph& fpgh, const Triplet& triplet);
 
@@ -40,4 +40,11 @@ namespace vcpkg
     };
 
     void serialize(const BinaryParagraph& pgh, std::string& out_str);
+
+    // Compact binary serialization of built-package metadata, written as a sidecar next
+    // to the text CONTROL when a package is created and preferred on read, so
+    // enumerating a large packages tree does not re-parse text paragraphs. Purely a
+    // cache: an unreadable or malformed sidecar falls back to the text file.
+    std::string serialize_binary(const BinaryControlFile& bcf);
+    Optional<BinaryControlFile> deserialize_binary(const std::string& contents);
 }
\ No newline at end of file
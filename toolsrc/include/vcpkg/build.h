@@ -12,8 +12,14 @@
 
 #include <array>
 #include <map>
+#include <unordered_set>
 #include <vector>
 
+namespace vcpkg::Dependencies
+{
+    struct AnyAction;
+}
+
 namespace vcpkg::Build
 {
     namespace Command
@@ -101,6 +107,17 @@ namespace vcpkg::Build
 
     std::string make_build_env_cmd(const PreBuildInfo& pre_build_info, const Toolset& toolset);
 
+#if defined(_WIN32)
+    // Returns the environment block the triplet's vcvars setup command leaves behind,
+    // served from a persistent per-toolset cache under the vcpkg root so repeated
+    // invocations skip the multi-second vcvarsall run. The cache is keyed by the
+    // composed setup command and invalidated when vcvarsall itself changes; returns
+    // nullopt when the environment cannot be captured.
+    Optional<std::wstring> get_build_environment_block(const VcpkgPaths& paths,
+                                                       const PreBuildInfo& pre_build_info,
+                                                       const Toolset& toolset);
+#endif
+
     struct ExtendedBuildResult
     {
         ExtendedBuildResult(BuildResult code);
@@ -110,6 +127,9 @@ namespace vcpkg::Build
         BuildResult code;
         std::vector<PackageSpec> unmet_dependencies;
         std::unique_ptr<BinaryControlFile> binary_control_file;
+        // Peak memory of the build's process tree in bytes; 0 when the platform could
+        // not observe it. Feeds the parallel scheduler's per-port memory profile.
+        long long peak_memory_bytes = 0;
     };
 
     struct BuildPackageConfig
@@ -138,6 +158,32 @@ namespace vcpkg::Build
                                       const BuildPackageConfig& config,
                                       const StatusParagraphs& status_db);
 
+    // Variant for callers that have already verified the package's dependencies are
+    // installed (such as the parallel install scheduler, which performs the check before
+    // dispatching). Performs no status database reads and is therefore safe to run on a
+    // worker thread while the coordinating thread owns the database.
+    ExtendedBuildResult build_package(const VcpkgPaths& paths, const BuildPackageConfig& config);
+
+    // Base URL of the remote binary cache (the VCPKG_REMOTE_BINARY_CACHE environment
+    // variable), if configured. Archives are fetched from and stored to
+    // <base>/<first two abi chars>/<abi>.zip, mirroring the local layout, so any
+    // HTTP server with GET/PUT can back a fleet-wide cache.
+    Optional<std::string> remote_binary_cache_url();
+
+    // Downloads the remote cache archives for every cacheable action in the plan
+    // that is not yet present locally, several transfers at a time. Called at plan
+    // start so the fleet's cached packages arrive in parallel instead of serially
+    // per build.
+    void prefetch_binary_archives(const VcpkgPaths& paths, const std::vector<Dependencies::AnyAction>& action_plan);
+
+    // Compressed package staging (--x-compress-packages): built packages are kept in
+    // packages/ as one zip per package and expanded on demand when installed.
+    fs::path package_archive_path(const VcpkgPaths& paths, const PackageSpec& spec);
+
+    // Expands the compressed staging archive into packages/<spec> when the expanded tree
+    // is absent; returns whether the expanded tree exists afterwards.
+    bool expand_package_archive(const VcpkgPaths& paths, const PackageSpec& spec);
+
     enum class BuildPolicy
     {
         EMPTY_PACKAGE,
@@ -145,6 +191,9 @@ namespace vcpkg::Build
         ONLY_RELEASE_CRT,
         EMPTY_INCLUDE_FOLDER,
         ALLOW_OBSOLETE_MSVCRT,
+        // The portfile can rebuild just the delta when features are added to an
+        // already-built port, reusing the existing buildtree's configure/build outputs.
+        FEATURE_INCREMENTAL,
         // Must be last
         COUNT,
     };
@@ -155,6 +204,7 @@ namespace vcpkg::Build
         BuildPolicy::ONLY_RELEASE_CRT,
         BuildPolicy::EMPTY_INCLUDE_FOLDER,
         BuildPolicy::ALLOW_OBSOLETE_MSVCRT,
+        BuildPolicy::FEATURE_INCREMENTAL,
     };
 
     const std::string& to_string(BuildPolicy policy);
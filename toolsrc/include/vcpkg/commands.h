@@ -33,12 +33,28 @@ namespace vcpkg::Commands
         void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths, const Triplet& default_triplet);
     }
 
+    // Hidden fixture generator: emits a synthetic ports tree and matching status-file
+    // entries so parser and planner scaling can be measured reproducibly.
+    namespace GeneratePorts
+    {
+        extern const CommandStructure COMMAND_STRUCTURE;
+        void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths, const Triplet& default_triplet);
+    }
+
     namespace Create
     {
         extern const CommandStructure COMMAND_STRUCTURE;
         void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths);
     }
 
+    // Declarative transaction mode: takes the complete desired package set and computes one
+    // combined install+remove plan, executed in a single process with one status-db load.
+    namespace SetInstalled
+    {
+        extern const CommandStructure COMMAND_STRUCTURE;
+        void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths, const Triplet& default_triplet);
+    }
+
     namespace Upgrade
     {
         extern const CommandStructure COMMAND_STRUCTURE;
@@ -56,6 +72,44 @@ namespace vcpkg::Commands
         void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths);
     }
 
+    // Native replacement for applocal.ps1: deploys a linked binary's dependent DLLs from
+    // the installed tree, with a stamp cache so unchanged binaries skip the import scan.
+    namespace AppLocal
+    {
+        extern const CommandStructure COMMAND_STRUCTURE;
+        void perform_and_exit(const VcpkgCmdArguments& args);
+    }
+
+    // Opt-in warm daemon: keeps a process with the parsed ports tree and status database
+    // resident and serves commands sent over a local socket, avoiding per-invocation startup
+    // costs. Clients forward automatically when VCPKG_DAEMON_SOCKET is set.
+    namespace Daemon
+    {
+        extern const CommandStructure COMMAND_STRUCTURE;
+        void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths);
+
+        // Called at startup: if a daemon socket is configured and reachable, sends the
+        // command line to the daemon, relays its output, and exits with the daemon's exit
+        // code. Returns (without output) when no daemon is available.
+        void try_dispatch_to_daemon(const int argc, const CommandLineCharType* const* const argv);
+    }
+
+    // Native distfile downloader (parallel byte-range chunks, resume, in-process hash
+    // verification); invoked by vcpkg_download_distfile.cmake during port builds.
+    namespace Download
+    {
+        extern const CommandStructure COMMAND_STRUCTURE;
+        void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths);
+    }
+
+    // Prints the per-invocation hot-path counters (cache hits, I/O volume, process
+    // spawns) as JSON after a cache-warming ports load; see also the --stats flag.
+    namespace Stats
+    {
+        extern const CommandStructure COMMAND_STRUCTURE;
+        void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths);
+    }
+
     namespace Search
     {
         extern const CommandStructure COMMAND_STRUCTURE;
@@ -74,6 +128,32 @@ namespace vcpkg::Commands
         void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths);
     }
 
+    // Packs the installed tree and status database into one archive, and restores
+    // it, so a fresh agent is provisioned by a copy instead of replaying installs.
+    namespace Snapshot
+    {
+        extern const CommandStructure COMMAND_STRUCTURE;
+        void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths);
+    }
+
+    // Audits every installed package's listfile against the filesystem in parallel,
+    // so a crashed agent can reinstall only what is actually broken instead of the
+    // whole triplet.
+    namespace Verify
+    {
+        extern const CommandStructure COMMAND_STRUCTURE;
+        void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths);
+    }
+
+    // Emits the whole ports dependency graph (nodes, edges, versions, features) in
+    // one write, so external tooling parses the ports tree once instead of shelling
+    // `depend-info` per port.
+    namespace Graph
+    {
+        extern const CommandStructure COMMAND_STRUCTURE;
+        void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths);
+    }
+
     namespace Cache
     {
         void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths);
@@ -119,13 +199,25 @@ namespace vcpkg::Commands
 
     namespace Hash
     {
-        void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths);
+        void perform_and_exit(const VcpkgCmdArguments& args);
+    }
+
+    namespace CatLog
+    {
+        extern const CommandStructure COMMAND_STRUCTURE;
+        void perform_and_exit(const VcpkgCmdArguments& args);
+    }
+
+    namespace CIMerge
+    {
+        extern const CommandStructure COMMAND_STRUCTURE;
+        void perform_and_exit(const VcpkgCmdArguments& args);
     }
 
     template<class T>
     struct PackageNameAndFunction
     {
-        std::string name;
+        CStringView name;
         T function;
     };
 
@@ -133,18 +225,23 @@ namespace vcpkg::Commands
     Span<const PackageNameAndFunction<CommandTypeB>> get_available_commands_type_b();
     Span<const PackageNameAndFunction<CommandTypeC>> get_available_commands_type_c();
 
+    // The command tables are constexpr, sorted case-insensitively by name, and live
+    // in the binary's read-only data; lookup binary searches them, so dispatch and
+    // completion allocate nothing at startup.
     template<typename T>
-    T find(const std::string& command_name, const std::vector<PackageNameAndFunction<T>> available_commands)
-    {
-        for (const PackageNameAndFunction<T>& cmd : available_commands)
+    const PackageNameAndFunction<T>* find(const std::string& command_name,
+                                          Span<const PackageNameAndFunction<T>> available_commands)
+    {
+        auto it = std::lower_bound(available_commands.begin(),
+                                   available_commands.end(),
+                                   command_name,
+                                   [](const PackageNameAndFunction<T>& cmd, const std::string& name) {
+                                       return Strings::case_insensitive_ascii_compare(cmd.name, name) < 0;
+                                   });
+        if (it != available_commands.end() && Strings::case_insensitive_ascii_compare(it->name, command_name) == 0)
         {
-            if (cmd.name == command_name)
-            {
-                return cmd.function;
-            }
+            return &*it;
         }
-
-        // not found
         return nullptr;
     }
 }
@@ -1,12 +1,15 @@
 #pragma once
 
 #include <vcpkg/base/optional.h>
+#include <vcpkg/base/sortedvector.h>
 #include <vcpkg/base/util.h>
 #include <vcpkg/build.h>
 #include <vcpkg/packagespec.h>
 #include <vcpkg/statusparagraphs.h>
 #include <vcpkg/vcpkgpaths.h>
 
+#include <memory>
+#include <unordered_set>
 #include <vector>
 
 namespace vcpkg::Dependencies
@@ -23,13 +26,23 @@ namespace vcpkg::Dependencies
                                  const Build::BuildPackageOptions& options);
     std::string to_output_string(RequestType request_type, const CStringView s);
 
-    struct AnyParagraph
+    // The paragraph a plan vertex was resolved from; at most one member is set and
+    // the resulting plan type is the tag. The status and source paragraphs are owned
+    // by the status database and the port file provider respectively, and the binary
+    // control file is held by pointer, so moving a plan action between the graph and
+    // the executing phases never deep-copies paragraph text.
+    struct AnyParagraph : Util::MoveOnlyBase
     {
         std::vector<PackageSpec> dependencies(const Triplet& triplet) const;
 
-        Optional<StatusParagraph> status_paragraph;
-        Optional<BinaryControlFile> binary_control_file;
-        Optional<const SourceControlFile*> source_control_file;
+        // Exit-on-missing accessors for phases whose plan type guarantees the
+        // paragraph is present.
+        const BinaryControlFile& binary_control_file_or_exit(const LineInfo& line_info) const;
+        const SourceControlFile& source_control_file_or_exit(const LineInfo& line_info) const;
+
+        const StatusParagraph* status_paragraph = nullptr;
+        std::unique_ptr<BinaryControlFile> binary_control_file;
+        const SourceControlFile* source_control_file = nullptr;
     };
 }
 
@@ -51,12 +64,12 @@ namespace vcpkg::Dependencies
         InstallPlanAction();
 
         InstallPlanAction(const PackageSpec& spec,
-                          const std::unordered_set<std::string>& features,
+                          const FlatSet<std::string>& features,
                           const RequestType& request_type);
-        InstallPlanAction(const PackageSpec& spec, const AnyParagraph& any_paragraph, const RequestType& request_type);
+        InstallPlanAction(const PackageSpec& spec, AnyParagraph&& any_paragraph, const RequestType& request_type);
         InstallPlanAction(const PackageSpec& spec,
                           const SourceControlFile& any_paragraph,
-                          const std::unordered_set<std::string>& features,
+                          const FlatSet<std::string>& features,
                           const RequestType& request_type);
 
         std::string displayname() const;
@@ -111,7 +124,7 @@ namespace vcpkg::Dependencies
         static bool compare_by_name(const ExportPlanAction* left, const ExportPlanAction* right);
 
         ExportPlanAction();
-        ExportPlanAction(const PackageSpec& spec, const AnyParagraph& any_paragraph, const RequestType& request_type);
+        ExportPlanAction(const PackageSpec& spec, AnyParagraph&& any_paragraph, const RequestType& request_type);
 
         PackageSpec spec;
         AnyParagraph any_paragraph;
@@ -135,11 +148,25 @@ namespace vcpkg::Dependencies
 
     struct PathsPortFileProvider : Util::ResourceBase, PortFileProvider
     {
-        explicit PathsPortFileProvider(const VcpkgPaths& paths);
+        // Overlay roots (from --overlay-ports and the VCPKG_OVERLAY_PORTS environment
+        // variable) are probed in priority order before the main ports tree; resolution
+        // is per port and lazy, so an edit in one root costs only that port's re-parse.
+        explicit PathsPortFileProvider(const VcpkgPaths& paths,
+                                       const std::vector<std::string>& overlay_ports = {});
         Optional<const SourceControlFile&> get_control_file(const std::string& src_name) const override;
 
+        // Parses every named port not already in the cache, fanning the loads across
+        // worker threads, so commands that know their spec list up front pay for each
+        // port at most once instead of parsing on demand in every phase.
+        void load_ports(Span<const std::string> port_names) const;
+
     private:
+        // Resolves a port name to its directory: the first overlay root containing the
+        // port wins, then the main ports tree.
+        fs::path port_directory(const std::string& src_name) const;
+
         const VcpkgPaths& ports;
+        std::vector<fs::path> overlay_roots;
         mutable std::unordered_map<std::string, SourceControlFile> cache;
     };
 
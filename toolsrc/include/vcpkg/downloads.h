@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/optional.h>
+
+#include <string>
+#include <vector>
+
+namespace vcpkg::Downloads
+{
+    // Native download engine for distfiles. Large files are split into parallel
+    // byte-range chunks when the server supports them; chunk files left behind by an
+    // interrupted run are reused, so a restart only refetches the missing ranges. When
+    // `expected_sha512` is non-empty the result is verified in-process before being
+    // moved into place. Returns true on success; failures are reported to the console.
+    bool download_file(Files::Filesystem& fs,
+                       const std::string& url,
+                       const fs::path& destination,
+                       const std::string& expected_sha512,
+                       size_t max_connections,
+                       bool print_transport_errors = true);
+
+    // Downloads `url` to `destination` over a single connection, computing the
+    // SHA512 of the bytes as they stream to disk, so multi-GB archives are read
+    // once instead of downloaded and then rehashed. Returns the hash on success.
+    Optional<std::string> download_file_and_hash(Files::Filesystem& fs,
+                                                 const std::string& url,
+                                                 const fs::path& destination);
+
+    // Downloads from whichever of several mirror URLs responds first: the fastest
+    // known host starts immediately and each further mirror joins the race after a
+    // short delay, so a stalled upstream costs one stagger instead of a timeout.
+    // Observed per-host throughput persists next to the downloads and orders future
+    // attempts. Returns true when any mirror delivered a verified file.
+    bool download_file_from_mirrors(Files::Filesystem& fs,
+                                    const std::vector<std::string>& urls,
+                                    const fs::path& destination,
+                                    const std::string& expected_sha512,
+                                    size_t max_connections);
+
+    // Uploads `file` to `url` with an HTTP PUT. Returns true when the server
+    // accepted it.
+    bool upload_file(const std::string& url, const fs::path& file);
+
+    struct Distfile
+    {
+        std::vector<std::string> urls; // mirrors, in preference order
+        std::string filename;
+        std::string sha512;
+    };
+
+    // Extracts the download steps of a portfile that can be resolved without running
+    // it: vcpkg_download_distfile calls with literal URLS/FILENAME/SHA512, and
+    // vcpkg_from_github calls with literal REPO/REF/SHA512 (mirroring the URL and
+    // filename the script computes). Calls whose arguments reference variables are
+    // skipped.
+    std::vector<Distfile> parse_portfile_distfiles(const std::string& portfile_contents);
+
+    // Fetches the given distfiles into `downloads_dir` on detached background
+    // threads, skipping files already present, so the network transfer overlaps with
+    // whatever the calling thread does next (typically the build of an earlier
+    // package). An interrupted prefetch leaves part files that the next download of
+    // the same file resumes.
+    void prefetch_distfiles(Files::Filesystem& fs, const fs::path& downloads_dir, std::vector<Distfile>&& distfiles);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vcpkg/vcpkgcmdarguments.h>
+#include <vcpkg/vcpkgpaths.h>
+
+namespace vcpkg::GC
+{
+    // Last-access tracking behind `vcpkg x-gc`: builds and installs stamp the
+    // buildtrees/<port> and packages/<spec> entries they touch into a small journal
+    // under buildtrees, and x-gc evicts the least recently used entries until both
+    // trees fit a size target. Entries that predate tracking have no stamp and are
+    // treated as the stalest candidates.
+    void record_buildtree_access(const VcpkgPaths& paths, const std::string& port_name);
+    void record_package_access(const VcpkgPaths& paths, const PackageSpec& spec);
+
+    // Per-port installed-size profile fed by successful installs, consulted by the
+    // disk-space preflight to estimate plans whose packages are not built yet. The
+    // lookup falls back to the same port on another triplet before giving up.
+    void record_package_size(const VcpkgPaths& paths, const PackageSpec& spec, uint64_t bytes);
+    Optional<uint64_t> profiled_package_size(const VcpkgPaths& paths, const PackageSpec& spec);
+
+    // Evicts least recently used entries until `bytes_needed` have been freed or
+    // nothing evictable remains; returns the bytes freed (as measured before
+    // removal, so failures to remove can overcount slightly).
+    uint64_t try_free_bytes(const VcpkgPaths& paths, uint64_t bytes_needed);
+
+    std::string format_size(uint64_t bytes);
+
+    extern const CommandStructure COMMAND_STRUCTURE;
+
+    void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths);
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vcpkg/base/chrono.h>
+#include <vcpkg/base/counters.h>
 #include <vcpkg/base/util.h>
 
 #include <atomic>
@@ -12,8 +13,23 @@ namespace vcpkg
         static Util::LockGuarded<Chrono::ElapsedTimer> timer;
         static Util::LockGuarded<std::string> g_surveydate;
 
+        // Bookkeeping incremented from worker threads; read once at exit.
+        static RelaxedCounter g_installed_file_count;
+        static RelaxedCounter g_removed_file_count;
+
         static std::atomic<bool> debugging;
         static std::atomic<bool> feature_packages;
+        static std::atomic<bool> g_use_hard_links;
+        // Deduplicate installed files across triplets through a content-addressed store
+        // of hardlinks under <root>/store.
+        static std::atomic<bool> g_use_content_store;
+        // Keep built packages as compressed archives in packages/ instead of expanded
+        // trees; they are expanded on demand when installed.
+        static std::atomic<bool> g_compress_packages;
+        // Capture per-port build logs compressed (build-<triplet>.log.vlz); view with
+        // `vcpkg x-cat-log`.
+        static std::atomic<bool> g_compress_logs;
+        static std::atomic<bool> g_cache_failed_builds;
 
         static std::atomic<int> g_init_console_cp;
         static std::atomic<int> g_init_console_output_cp;
@@ -69,15 +69,33 @@ namespace vcpkg::Install
 
     std::vector<std::string> get_all_port_names(const VcpkgPaths& paths);
 
+    // Whether staging should try hard links before copying regardless of the global
+    // --x-use-hard-links opt-in. Raw exports stage from the packages tree into a
+    // directory on the same volume, where linking is near-instant and doubles no
+    // disk; cross-volume targets fall back to copying per file as before.
+    enum class PreferHardLinks
+    {
+        NO,
+        YES
+    };
+
     void install_files_and_write_listfile(Files::Filesystem& fs, const fs::path& source_dir, const InstallDir& dirs);
+    void install_files_and_write_listfile(Files::Filesystem& fs,
+                                          const fs::path& source_dir,
+                                          const InstallDir& dirs,
+                                          PreferHardLinks prefer_hard_links);
     InstallResult install_package(const VcpkgPaths& paths,
                                   const BinaryControlFile& binary_paragraph,
                                   StatusParagraphs* status_db);
 
+    // When concurrency is greater than one, build phases of independent packages are
+    // dispatched to worker threads; all status database and installed-tree mutation
+    // stays on the calling thread.
     InstallSummary perform(const std::vector<Dependencies::AnyAction>& action_plan,
                            const KeepGoing keep_going,
                            const VcpkgPaths& paths,
-                           StatusParagraphs& status_db);
+                           StatusParagraphs& status_db,
+                           const size_t concurrency = 1);
 
     extern const CommandStructure COMMAND_STRUCTURE;
 
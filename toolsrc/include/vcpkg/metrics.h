@@ -2,6 +2,7 @@
 
 #include <vcpkg/base/util.h>
 
+#include <atomic>
 #include <string>
 
 namespace vcpkg::Metrics
@@ -17,11 +18,44 @@ namespace vcpkg::Metrics
         void track_property(const std::string& name, const std::string& value);
 
         void upload(const std::string& payload);
+        // Drains the entire spool directory, coalescing payloads into batched POSTs.
+        // A machine-wide named mutex makes this a no-op when another uploader
+        // instance is already draining.
+        void drain_spool();
+        // Launches a detached thread that drains the spooled payloads from previous
+        // runs while the current command does its real work; skipped entirely when an
+        // uploader is already active. flush() only spools; the pair keeps all network
+        // latency off the exit path.
+        void start_background_uploader();
         void flush();
     };
 
     extern Util::LockGuarded<Metrics> g_metrics;
 
+    // Single inlined gate for instrumented hot paths: false once both sending and
+    // printing are off (--no-metrics, or a DISABLE_METRICS build). Testing it costs
+    // one relaxed load and a predicted branch, so call sites that would otherwise
+    // format strings or take the g_metrics lock only to be dropped can bail before
+    // evaluating any arguments. Kept in sync by set_send_metrics()/set_print_metrics().
+    extern std::atomic<bool> g_metrics_enabled;
+
+    inline bool metrics_enabled() { return g_metrics_enabled.load(std::memory_order_relaxed); }
+
+    // Lazy-callable recording: the value factory only runs when metrics are enabled,
+    // so a disabled fleet pays nothing for the value's construction either.
+    template<class F>
+    void track_property_lazy(const std::string& name, F&& get_value)
+    {
+        if (metrics_enabled()) g_metrics.lock()->track_property(name, get_value());
+    }
+
+    // Buffered recording for hot paths that run on worker threads: appends to a
+    // per-thread buffer with no locking or JSON encoding at call time. Buffers are
+    // handed to a collector when their thread finishes and folded into the payload by
+    // flush(), so instrumented workers never serialize on g_metrics.
+    void track_metric_buffered(const std::string& name, double value);
+    void track_property_buffered(const std::string& name, const std::string& value);
+
     std::string get_MAC_user();
     bool get_compiled_metrics_enabled();
 }
@@ -4,6 +4,8 @@
 #include <vcpkg/packagespecparseresult.h>
 #include <vcpkg/triplet.h>
 
+#include <cstdint>
+
 namespace vcpkg
 {
     struct ParsedSpecifier
@@ -13,6 +15,12 @@ namespace vcpkg
         std::string triplet;
 
         static ExpectedT<ParsedSpecifier, PackageSpecParseResult> from_string(const std::string& input);
+
+        // Tokenizes each distinct spec string once and shares the structured form by
+        // reference afterwards. Spec strings repeat heavily: every installed paragraph
+        // lists the same dependency names, and the same user arguments are re-parsed
+        // during argument handling, planning, and printing.
+        static const ExpectedT<ParsedSpecifier, PackageSpecParseResult>& from_string_cached(const std::string& input);
     };
 
     struct PackageSpec
@@ -30,6 +38,13 @@ namespace vcpkg
 
         const Triplet& triplet() const;
 
+        // The dense process-wide id of this name:triplet pair. Distinct specs get
+        // distinct small integers, so equality and hashing operate on the id instead of
+        // re-comparing strings. Mirrors the interning Triplet does for its instances.
+        size_t id() const { return m_id; }
+
+        static size_t intern_id(const std::string& name, const Triplet& triplet);
+
         std::string dir() const;
 
         std::string to_string() const;
@@ -44,6 +59,7 @@ namespace vcpkg
     private:
         std::string m_name;
         Triplet m_triplet;
+        size_t m_id = SIZE_MAX;
     };
 
     struct FeatureSpec
@@ -110,13 +126,7 @@ namespace std
     template<>
     struct hash<vcpkg::PackageSpec>
     {
-        size_t operator()(const vcpkg::PackageSpec& value) const
-        {
-            size_t hash = 17;
-            hash = hash * 31 + std::hash<std::string>()(value.name());
-            hash = hash * 31 + std::hash<vcpkg::Triplet>()(value.triplet());
-            return hash;
-        }
+        size_t operator()(const vcpkg::PackageSpec& value) const { return std::hash<size_t>()(value.id()); }
     };
 
     template<>
@@ -5,6 +5,7 @@
 #include <vcpkg/vcpkgpaths.h>
 #include <vcpkg/versiont.h>
 
+#include <vcpkg/base/arena.h>
 #include <vcpkg/base/expected.h>
 
 #include <map>
@@ -13,6 +14,26 @@ namespace vcpkg::Paragraphs
 {
     using RawParagraph = Parse::RawParagraph;
 
+    // A field value parsed without copying: one range per source line, all referencing
+    // the backing buffer (for example a Files::MemoryMappedFile). to_string() joins the
+    // lines with '\n', matching the normalization done by the string-based parse.
+    struct FieldValueView
+    {
+        explicit FieldValueView(Arena& arena) : lines(ArenaAllocator<StringRange>(arena)) {}
+
+        std::vector<StringRange, ArenaAllocator<StringRange>> lines;
+
+        std::string to_string() const;
+    };
+
+    using RawParagraphView =
+        std::vector<std::pair<StringRange, FieldValueView>, ArenaAllocator<std::pair<StringRange, FieldValueView>>>;
+
+    // Parses paragraphs as views into `buffer`, drawing all per-field bookkeeping from
+    // `arena` instead of individual heap allocations. The returned views are only valid
+    // while the backing buffer and the arena are alive.
+    std::vector<RawParagraphView> parse_paragraph_views(StringRange buffer, Arena& arena);
+
     Expected<RawParagraph> get_single_paragraph(const Files::Filesystem& fs, const fs::path& control_path);
     Expected<std::vector<RawParagraph>> get_paragraphs(const Files::Filesystem& fs, const fs::path& control_path);
     Expected<RawParagraph> parse_single_paragraph(const std::string& str);
@@ -20,8 +41,17 @@ namespace vcpkg::Paragraphs
 
     Parse::ParseExpected<SourceControlFile> try_load_port(const Files::Filesystem& fs, const fs::path& control_path);
 
+    // The first query enumerates the packages tree once and parses every package's
+    // control data in parallel; later queries are map hits, so a plan touching many
+    // built packages pays one warm scan instead of a file open per package. Packages
+    // written after the scan join the map through store_cached_control_package (or a
+    // reload after invalidate_cached_control_package).
     Expected<BinaryControlFile> try_load_cached_control_package(const VcpkgPaths& paths, const PackageSpec& spec);
 
+    void store_cached_control_package(const BinaryControlFile& bcf);
+
+    void invalidate_cached_control_package(const PackageSpec& spec);
+
     struct LoadResults
     {
         std::vector<std::unique_ptr<SourceControlFile>> paragraphs;
@@ -32,4 +62,18 @@ namespace vcpkg::Paragraphs
 
     std::vector<std::unique_ptr<SourceControlFile>> load_all_ports(const Files::Filesystem& fs,
                                                                    const fs::path& ports_dir);
+
+    // Same as the above, but consults a binary index of the parsed ports tree kept in a
+    // single flat file under paths.root. Entries are invalidated per-port by the CONTROL
+    // file's size and last write time, so warm invocations skip text parsing entirely.
+    // Ports that fail to parse are never cached.
+    LoadResults try_load_all_ports_cached(const VcpkgPaths& paths);
+
+    std::vector<std::unique_ptr<SourceControlFile>> load_all_ports_cached(const VcpkgPaths& paths);
+
+    // Returns the sorted names of every port, served from the compact name+version
+    // index that is refreshed whenever the ports index is rewritten, without parsing
+    // any CONTROL file. Intended for latency-sensitive callers like shell completion;
+    // falls back to a full cached load when the index has not been generated yet.
+    std::vector<std::string> load_port_names_cached(const VcpkgPaths& paths);
 }
@@ -1,13 +1,47 @@
 #pragma once
 
+#include <vcpkg/base/checks.h>
 #include <vcpkg/base/expected.h>
 #include <vcpkg/base/optional.h>
+#include <vcpkg/base/span.h>
 
+#include <algorithm>
+#include <array>
 #include <memory>
-#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace vcpkg::Parse
 {
+    // The known CONTROL / status paragraph field names. ParagraphParser identifies
+    // every field once, at construction, so extraction by ControlField does no string
+    // hashing or allocation.
+    enum class ControlField
+    {
+        UNKNOWN = 0,
+        ABI,
+        ARCHITECTURE,
+        BUILD_DEPENDS,
+        DEFAULT_FEATURES,
+        DEPENDS,
+        DESCRIPTION,
+        FEATURE,
+        MAINTAINER,
+        MULTI_ARCH,
+        PACKAGE,
+        SOURCE,
+        STATUS,
+        SUPPORTS,
+        TYPE,
+        VERSION,
+        COUNT
+    };
+
+    // Dispatches on the name's length before comparing, so unknown names are usually
+    // rejected without touching their characters.
+    ControlField identify_control_field(const std::string& name);
+    const std::string& control_field_name(ControlField field);
+
     struct ParseControlErrorInfo
     {
         std::string name;
@@ -19,20 +53,92 @@ namespace vcpkg::Parse
     template<class P>
     using ParseExpected = ExpectedT<std::unique_ptr<P>, std::unique_ptr<ParseControlErrorInfo>>;
 
-    using RawParagraph = std::unordered_map<std::string, std::string>;
+    // A parsed paragraph's fields, stored flat in parse order. A paragraph has at
+    // most about a dozen fields, so linear lookup beats hashing and the vector is a
+    // fraction of an unordered_map's resident footprint across a full ports load.
+    struct RawParagraph
+    {
+        using value_type = std::pair<std::string, std::string>;
+        using iterator = std::vector<value_type>::iterator;
+        using const_iterator = std::vector<value_type>::const_iterator;
+
+        iterator begin() { return m_entries.begin(); }
+        iterator end() { return m_entries.end(); }
+        const_iterator begin() const { return m_entries.begin(); }
+        const_iterator end() const { return m_entries.end(); }
+
+        bool empty() const { return m_entries.empty(); }
+        size_t size() const { return m_entries.size(); }
+
+        iterator find(const std::string& key)
+        {
+            return std::find_if(
+                m_entries.begin(), m_entries.end(), [&](const value_type& entry) { return entry.first == key; });
+        }
+        const_iterator find(const std::string& key) const
+        {
+            return std::find_if(
+                m_entries.begin(), m_entries.end(), [&](const value_type& entry) { return entry.first == key; });
+        }
+
+        // Matching the previous unordered_map storage, an existing key is not replaced.
+        void emplace(std::string key, std::string value)
+        {
+            if (find(key) == end()) m_entries.emplace_back(std::move(key), std::move(value));
+        }
+
+        // Read access with at()-like semantics: the key must be present. Kept for
+        // callers written against the previous unordered_map storage.
+        const std::string& operator[](const std::string& key) const
+        {
+            auto it = find(key);
+            Checks::check_exit(VCPKG_LINE_INFO, it != end(), "Field not present: %s", key);
+            return it->second;
+        }
+
+        iterator erase(iterator pos) { return m_entries.erase(pos); }
+
+    private:
+        std::vector<value_type> m_entries;
+    };
+
+    // For the generic Util range helpers, which find begin/end by ADL.
+    inline RawParagraph::iterator begin(RawParagraph& pgh) { return pgh.begin(); }
+    inline RawParagraph::iterator end(RawParagraph& pgh) { return pgh.end(); }
+    inline RawParagraph::const_iterator begin(const RawParagraph& pgh) { return pgh.begin(); }
+    inline RawParagraph::const_iterator end(const RawParagraph& pgh) { return pgh.end(); }
 
     struct ParagraphParser
     {
-        ParagraphParser(RawParagraph&& fields) : fields(std::move(fields)) {}
+        ParagraphParser(RawParagraph&& fields);
 
         void required_field(const std::string& fieldname, std::string& out);
-        std::string optional_field(const std::string& fieldname) const;
+        std::string optional_field(const std::string& fieldname);
+
+        void required_field(ControlField field, std::string& out);
+        std::string optional_field(ControlField field);
+
+        // Moves the named field's value out of the paragraph and erases the entry, so
+        // each field is materialized exactly once and never copied.
+        Optional<std::string> extract_field(const std::string& fieldname);
+        Optional<std::string> extract_field(ControlField field);
+
         std::unique_ptr<ParseControlErrorInfo> error_info(const std::string& name) const;
 
     private:
         RawParagraph&& fields;
+        // Index into `fields` for each known field present in this paragraph, or NPOS
+        // when absent; extraction erases the entry and shifts later indices down.
+        static constexpr size_t NPOS = static_cast<size_t>(-1);
+        std::array<size_t, static_cast<size_t>(ControlField::COUNT)> known_fields;
         std::vector<std::string> missing_fields;
+
+        void erase_entry(size_t index);
     };
 
     std::vector<std::string> parse_comma_list(const std::string& str);
+
+    // Non-allocating variant of parse_comma_list. The returned views point into `str`
+    // and are only valid while it is alive and unmodified.
+    std::vector<Span<const char>> parse_comma_list_views(const std::string& str);
 }
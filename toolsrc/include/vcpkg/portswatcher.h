@@ -0,0 +1,26 @@
+#pragma once
+
+#include <vcpkg/base/optional.h>
+#include <vcpkg/vcpkgpaths.h>
+
+#include <string>
+#include <unordered_set>
+
+namespace vcpkg::PortsWatcher
+{
+    // Watcher-based invalidation for the ports index: validating the index normally
+    // costs a stat of every port's CONTROL file, which dominates warm runs on NFS.
+    // A resident watcher (started by the daemon) subscribes to change notifications
+    // for the ports tree and maintains a heartbeated session file of the port names
+    // edited since it started; a warm load that finds a live session trusts the
+    // index for every port not listed and stats only the listed ones.
+
+    // Starts the background watcher thread; no-op where the platform has no
+    // filesystem notification support compiled in (currently only inotify).
+    void start(const VcpkgPaths& paths);
+
+    // The set of port names edited since the watcher started, or nullopt when no
+    // watcher session is live (missing, stale, or overflowed) and the caller must
+    // fall back to the full stat sweep.
+    Optional<std::unordered_set<std::string>> fresh_invalidations(const VcpkgPaths& paths);
+}
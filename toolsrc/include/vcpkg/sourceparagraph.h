@@ -26,6 +26,7 @@ namespace vcpkg
 
     // zlib[uwp] becomes Dependency{"zlib", "uwp"}
     std::vector<Dependency> expand_qualified_dependencies(const std::vector<std::string>& depends);
+    std::vector<Dependency> expand_qualified_dependencies(Span<const Span<const char>> depends);
 
     std::string to_string(const Dependency& dep);
 
@@ -54,8 +55,10 @@ namespace vcpkg
         static Parse::ParseExpected<SourceControlFile> parse_control_file(
             std::vector<Parse::RawParagraph>&& control_paragraphs);
 
-        std::unique_ptr<SourceParagraph> core_paragraph;
-        std::vector<std::unique_ptr<FeatureParagraph>> feature_paragraphs;
+        // Stored by value: the planner walks every feature paragraph of every reached
+        // port, so contiguous storage beats a heap object per paragraph.
+        SourceParagraph core_paragraph;
+        std::vector<FeatureParagraph> feature_paragraphs;
     };
 
     void print_error_message(Span<const std::unique_ptr<Parse::ParseControlErrorInfo>> error_info_list);
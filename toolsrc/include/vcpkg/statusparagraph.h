@@ -30,7 +30,7 @@ namespace vcpkg
     struct StatusParagraph
     {
         StatusParagraph();
-        explicit StatusParagraph(std::unordered_map<std::string, std::string>&& fields);
+        explicit StatusParagraph(Parse::RawParagraph&& fields);
 
         BinaryParagraph package;
         Want want;
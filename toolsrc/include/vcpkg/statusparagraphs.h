@@ -1,8 +1,13 @@
 #pragma once
 #include <vcpkg/statusparagraph.h>
 
+#include <vcpkg/base/span.h>
+
 #include <iterator>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace vcpkg
 {
@@ -11,6 +16,13 @@ namespace vcpkg
         StatusParagraphs();
         explicit StatusParagraphs(std::vector<std::unique_ptr<StatusParagraph>>&& ps);
 
+        // Lazy construction from unparsed status records: only the Package and
+        // Architecture fields are scanned to build the index, and a record is fully
+        // deserialized the first time a lookup reaches it. Single-package commands
+        // therefore parse one or two records no matter how large the database is;
+        // iterating (begin()) materializes everything.
+        explicit StatusParagraphs(std::vector<std::string>&& raw_records);
+
         using container = std::vector<std::unique_ptr<StatusParagraph>>;
         using iterator = container::reverse_iterator;
         using const_iterator = container::const_reverse_iterator;
@@ -27,6 +39,12 @@ namespace vcpkg
         }
         const_iterator find_installed(const std::string& name, const Triplet& triplet) const;
 
+        // Resolves a whole batch of specs against the database in one call. The result
+        // is in input order, with nullptr for specs that are not installed, so plan
+        // creation can query all of its roots up front instead of issuing a lookup per
+        // spec as the graph is walked.
+        std::vector<const StatusParagraph*> find_all_installed(Span<const PackageSpec> specs) const;
+
         iterator insert(std::unique_ptr<StatusParagraph>);
 
         friend void serialize(const StatusParagraphs& pgh, std::string& out_str);
@@ -35,12 +53,38 @@ namespace vcpkg
 
         const_iterator end() const { return paragraphs.rend(); }
 
-        iterator begin() { return paragraphs.rbegin(); }
+        // Iteration is the bulk-load opt-in: every record is materialized up front,
+        // so the unique_ptrs the iterators expose are never null.
+        iterator begin()
+        {
+            materialize_all();
+            return paragraphs.rbegin();
+        }
 
-        const_iterator begin() const { return paragraphs.rbegin(); }
+        const_iterator begin() const
+        {
+            materialize_all();
+            return paragraphs.rbegin();
+        }
 
     private:
-        std::vector<std::unique_ptr<StatusParagraph>> paragraphs;
+        void materialize(size_t i) const;
+        void materialize_all() const;
+
+        // Slot i holds either the paragraph or, before first access, its unparsed
+        // record text in raw_records[i]. Materialization fills the slot in place, so
+        // positions (and therefore iterators and the index) never move.
+        mutable std::vector<std::unique_ptr<StatusParagraph>> paragraphs;
+        mutable std::vector<std::string> raw_records;
+
+        // Maps the interned spec id of package name:triplet to positions within
+        // `paragraphs`, so the find() lookups that run once per package during plan
+        // creation do not degenerate into repeated linear scans of the whole status
+        // database.
+        std::unordered_multimap<size_t, size_t> index;
+
+        static size_t index_key(const std::string& name, const Triplet& triplet);
+        void rebuild_index();
     };
 
     void serialize(const StatusParagraphs& pgh, std::string& out_str);
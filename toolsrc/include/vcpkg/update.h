@@ -17,7 +17,8 @@ namespace vcpkg::Update
         VersionDiff version_diff;
     };
 
-    std::vector<OutdatedPackage> find_outdated_packages(const Dependencies::PortFileProvider& provider,
+    std::vector<OutdatedPackage> find_outdated_packages(const VcpkgPaths& paths,
+                                                        const Dependencies::PortFileProvider& provider,
                                                         const StatusParagraphs& status_db);
 
     void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths);
@@ -15,6 +15,12 @@ namespace vcpkg
 
         static UserConfig try_read_data(const Files::Filesystem& fs);
 
+        // Reads the config file at most once per process and hands every caller the
+        // same parsed instance, so metrics init and the survey commands share one read.
+        static UserConfig& get_cached(const Files::Filesystem& fs);
+
+        // Writes the config back, skipping the disk write when the values match what
+        // was last read from or written to the file.
         void try_write_data(Files::Filesystem& fs) const;
     };
 }
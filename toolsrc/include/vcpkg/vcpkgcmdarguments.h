@@ -2,19 +2,21 @@
 
 #include <vcpkg/base/cstringview.h>
 #include <vcpkg/base/optional.h>
+#include <vcpkg/base/sortedvector.h>
 #include <vcpkg/base/span.h>
 
 #include <memory>
 #include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
 namespace vcpkg
 {
     struct ParsedArguments
     {
-        std::unordered_set<std::string> switches;
-        std::unordered_map<std::string, std::string> settings;
+        // Flat containers: at most a handful of options per command, checked far more
+        // often than they are inserted.
+        FlatSet<std::string> switches;
+        FlatMap<std::string, std::string> settings;
     };
 
     struct VcpkgPaths;
@@ -64,6 +66,9 @@ namespace vcpkg
 
         std::unique_ptr<std::string> vcpkg_root_dir;
         std::unique_ptr<std::string> triplet;
+        // Additional ports roots from --overlay-ports, in command-line order; earlier
+        // entries take priority over later ones and all take priority over ports/.
+        std::vector<std::string> overlay_ports;
         Optional<bool> debug = nullopt;
         Optional<bool> sendmetrics = nullopt;
         Optional<bool> printmetrics = nullopt;
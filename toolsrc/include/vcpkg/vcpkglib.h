@@ -8,8 +8,17 @@ namespace vcpkg
 {
     StatusParagraphs database_load_check(const VcpkgPaths& paths);
 
+    // As database_load_check(), but never commits pending updates back to the status
+    // file; for planning-only paths that must not write to the installed tree.
+    StatusParagraphs database_load_readonly(const VcpkgPaths& paths);
+
     void write_update(const VcpkgPaths& paths, const StatusParagraph& p);
 
+    // Appends several update records under one lock acquisition and one journal
+    // append, so a package's core and feature transitions flush together instead of
+    // paying a lock round trip and a write per paragraph.
+    void write_updates(const VcpkgPaths& paths, const std::vector<const StatusParagraph*>& pghs);
+
     struct StatusParagraphAndAssociatedFiles
     {
         StatusParagraph pgh;
@@ -20,5 +29,25 @@ namespace vcpkg
     std::vector<StatusParagraphAndAssociatedFiles> get_installed_files(const VcpkgPaths& paths,
                                                                        const StatusParagraphs& status_db);
 
+    // Listfiles record one path per line. New listfiles are written delta-encoded: a
+    // marker first line, then "<N> <suffix>" per entry, where N is the length of the
+    // prefix shared with the previous entry. Consecutive entries share long directory
+    // prefixes, so header-heavy ports shrink by an order of magnitude. read_listfile
+    // decodes that format and passes pre-existing full-path listfiles through as-is.
+    struct ListfileWriter
+    {
+        ListfileWriter(Files::Filesystem& fs, const fs::path& listfile);
+
+        void write_path(const std::string& path);
+        void flush();
+
+    private:
+        Files::BufferedWriter m_writer;
+        std::string m_previous;
+        std::string m_line;
+    };
+
+    Expected<std::vector<std::string>> read_listfile(const Files::Filesystem& fs, const fs::path& listfile);
+
     std::string shorten_text(const std::string& desc, const size_t length);
 } // namespace vcpkg
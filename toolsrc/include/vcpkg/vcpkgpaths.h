@@ -63,6 +63,13 @@ namespace vcpkg
 
         fs::path ports_cmake;
 
+        /// <summary>Begins locating (and, if missing, downloading) the tools on background threads</summary>
+        /// <remarks>
+        ///   The get_*_exe() calls below join the prefetch instead of fetching serially, so calling
+        ///   this before ports parsing overlaps the downloads with it on a first run.
+        /// </remarks>
+        void prefetch_tools() const;
+
         const fs::path& get_cmake_exe() const;
         const fs::path& get_git_exe() const;
         const fs::path& get_nuget_exe() const;
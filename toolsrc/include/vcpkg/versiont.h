@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <vector>
 
 namespace vcpkg
 {
@@ -10,12 +11,25 @@ namespace vcpkg
 
         const std::string& to_string() const;
 
+        // Comparison key precomputed at construction: the numeric runs of the version text
+        // ("1.10.2" -> {1, 10, 2}) and the remaining non-numeric characters ("1.2-rc3" -> ".2-rc"
+        // after the leading 1). Comparing the keys orders versions naturally ("1.10" > "1.9")
+        // without re-examining the text.
+        const std::vector<unsigned long long>& numeric_segments() const;
+
     private:
         std::string value;
+        std::vector<unsigned long long> segments;
+        std::string suffix;
+
+        friend bool operator==(const VersionT& left, const VersionT& right);
+        friend bool operator<(const VersionT& left, const VersionT& right);
     };
 
     bool operator==(const VersionT& left, const VersionT& right);
     bool operator!=(const VersionT& left, const VersionT& right);
+    bool operator<(const VersionT& left, const VersionT& right);
+    bool operator>(const VersionT& left, const VersionT& right);
 
     struct VersionDiff
     {
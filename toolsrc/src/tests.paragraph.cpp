@@ -1,4 +1,4 @@
-#include "tests.pch.h"
+#include "tests.pch.h"
 
 #pragma comment(lib, "version")
 #pragma comment(lib, "winhttp")
@@ -31,11 +31,11 @@ namespace UnitTest1
             Assert::IsTrue(m_pgh.has_value());
             auto& pgh = *m_pgh.get();
 
-            Assert::AreEqual("zlib", pgh->core_paragraph->name.c_str());
-            Assert::AreEqual("1.2.8", pgh->core_paragraph->version.c_str());
-            Assert::AreEqual("", pgh->core_paragraph->maintainer.c_str());
-            Assert::AreEqual("", pgh->core_paragraph->description.c_str());
-            Assert::AreEqual(size_t(0), pgh->core_paragraph->depends.size());
+            Assert::AreEqual("zlib", pgh->core_paragraph.name.c_str());
+            Assert::AreEqual("1.2.8", pgh->core_paragraph.version.c_str());
+            Assert::AreEqual("", pgh->core_paragraph.maintainer.c_str());
+            Assert::AreEqual("", pgh->core_paragraph.description.c_str());
+            Assert::AreEqual(size_t(0), pgh->core_paragraph.depends.size());
         }
 
         TEST_METHOD(SourceParagraph_Construct_Maximum)
@@ -52,14 +52,14 @@ namespace UnitTest1
             Assert::IsTrue(m_pgh.has_value());
             auto& pgh = *m_pgh.get();
 
-            Assert::AreEqual("s", pgh->core_paragraph->name.c_str());
-            Assert::AreEqual("v", pgh->core_paragraph->version.c_str());
-            Assert::AreEqual("m", pgh->core_paragraph->maintainer.c_str());
-            Assert::AreEqual("d", pgh->core_paragraph->description.c_str());
-            Assert::AreEqual(size_t(1), pgh->core_paragraph->depends.size());
-            Assert::AreEqual("bd", pgh->core_paragraph->depends[0].name().c_str());
-            Assert::AreEqual(size_t(1), pgh->core_paragraph->supports.size());
-            Assert::AreEqual("x64", pgh->core_paragraph->supports[0].c_str());
+            Assert::AreEqual("s", pgh->core_paragraph.name.c_str());
+            Assert::AreEqual("v", pgh->core_paragraph.version.c_str());
+            Assert::AreEqual("m", pgh->core_paragraph.maintainer.c_str());
+            Assert::AreEqual("d", pgh->core_paragraph.description.c_str());
+            Assert::AreEqual(size_t(1), pgh->core_paragraph.depends.size());
+            Assert::AreEqual("bd", pgh->core_paragraph.depends[0].name().c_str());
+            Assert::AreEqual(size_t(1), pgh->core_paragraph.supports.size());
+            Assert::AreEqual("x64", pgh->core_paragraph.supports[0].c_str());
         }
 
         TEST_METHOD(SourceParagraph_Two_Depends)
@@ -73,9 +73,9 @@ namespace UnitTest1
             Assert::IsTrue(m_pgh.has_value());
             auto& pgh = *m_pgh.get();
 
-            Assert::AreEqual(size_t(2), pgh->core_paragraph->depends.size());
-            Assert::AreEqual("z", pgh->core_paragraph->depends[0].name().c_str());
-            Assert::AreEqual("openssl", pgh->core_paragraph->depends[1].name().c_str());
+            Assert::AreEqual(size_t(2), pgh->core_paragraph.depends.size());
+            Assert::AreEqual("z", pgh->core_paragraph.depends[0].name().c_str());
+            Assert::AreEqual("openssl", pgh->core_paragraph.depends[1].name().c_str());
         }
 
         TEST_METHOD(SourceParagraph_Three_Depends)
@@ -89,10 +89,10 @@ namespace UnitTest1
             Assert::IsTrue(m_pgh.has_value());
             auto& pgh = *m_pgh.get();
 
-            Assert::AreEqual(size_t(3), pgh->core_paragraph->depends.size());
-            Assert::AreEqual("z", pgh->core_paragraph->depends[0].name().c_str());
-            Assert::AreEqual("openssl", pgh->core_paragraph->depends[1].name().c_str());
-            Assert::AreEqual("xyz", pgh->core_paragraph->depends[2].name().c_str());
+            Assert::AreEqual(size_t(3), pgh->core_paragraph.depends.size());
+            Assert::AreEqual("z", pgh->core_paragraph.depends[0].name().c_str());
+            Assert::AreEqual("openssl", pgh->core_paragraph.depends[1].name().c_str());
+            Assert::AreEqual("xyz", pgh->core_paragraph.depends[2].name().c_str());
         }
 
         TEST_METHOD(SourceParagraph_Three_Supports)
@@ -106,10 +106,10 @@ namespace UnitTest1
             Assert::IsTrue(m_pgh.has_value());
             auto& pgh = *m_pgh.get();
 
-            Assert::AreEqual(size_t(3), pgh->core_paragraph->supports.size());
-            Assert::AreEqual("x64", pgh->core_paragraph->supports[0].c_str());
-            Assert::AreEqual("windows", pgh->core_paragraph->supports[1].c_str());
-            Assert::AreEqual("uwp", pgh->core_paragraph->supports[2].c_str());
+            Assert::AreEqual(size_t(3), pgh->core_paragraph.supports.size());
+            Assert::AreEqual("x64", pgh->core_paragraph.supports[0].c_str());
+            Assert::AreEqual("windows", pgh->core_paragraph.supports[1].c_str());
+            Assert::AreEqual("uwp", pgh->core_paragraph.supports[2].c_str());
         }
 
         TEST_METHOD(SourceParagraph_Construct_Qualified_Depends)
@@ -123,15 +123,15 @@ namespace UnitTest1
             Assert::IsTrue(m_pgh.has_value());
             auto& pgh = *m_pgh.get();
 
-            Assert::AreEqual("zlib", pgh->core_paragraph->name.c_str());
-            Assert::AreEqual("1.2.8", pgh->core_paragraph->version.c_str());
-            Assert::AreEqual("", pgh->core_paragraph->maintainer.c_str());
-            Assert::AreEqual("", pgh->core_paragraph->description.c_str());
-            Assert::AreEqual(size_t(2), pgh->core_paragraph->depends.size());
-            Assert::AreEqual("libA", pgh->core_paragraph->depends[0].name().c_str());
-            Assert::AreEqual("windows", pgh->core_paragraph->depends[0].qualifier.c_str());
-            Assert::AreEqual("libB", pgh->core_paragraph->depends[1].name().c_str());
-            Assert::AreEqual("uwp", pgh->core_paragraph->depends[1].qualifier.c_str());
+            Assert::AreEqual("zlib", pgh->core_paragraph.name.c_str());
+            Assert::AreEqual("1.2.8", pgh->core_paragraph.version.c_str());
+            Assert::AreEqual("", pgh->core_paragraph.maintainer.c_str());
+            Assert::AreEqual("", pgh->core_paragraph.description.c_str());
+            Assert::AreEqual(size_t(2), pgh->core_paragraph.depends.size());
+            Assert::AreEqual("libA", pgh->core_paragraph.depends[0].name().c_str());
+            Assert::AreEqual("windows", pgh->core_paragraph.depends[0].qualifier.c_str());
+            Assert::AreEqual("libB", pgh->core_paragraph.depends[1].name().c_str());
+            Assert::AreEqual("uwp", pgh->core_paragraph.depends[1].qualifier.c_str());
         }
 
         TEST_METHOD(BinaryParagraph_Construct_Minimum)
@@ -340,6 +340,44 @@ namespace UnitTest1
             Assert::AreEqual("v1", pghs[0]["f1"].c_str());
         }
 
+        TEST_METHOD(parse_paragraphs_mixed_line_endings)
+        {
+            // CRLF and LF continuations of the same field normalize to '\n' when the
+            // field value views are materialized into strings.
+            const char* str = "f1: a\r\n"
+                              " b\n"
+                              " c\r\n";
+            auto pghs = vcpkg::Paragraphs::parse_paragraphs(str).value_or_exit(VCPKG_LINE_INFO);
+            Assert::AreEqual(size_t(1), pghs.size());
+            Assert::AreEqual("a\n b\n c", pghs[0]["f1"].c_str());
+        }
+
+        TEST_METHOD(parse_paragraphs_comment_ends_multiline_value)
+        {
+            // A comment line terminates a multi-line value; the following field still
+            // belongs to the same paragraph.
+            const char* str = "f1:\n"
+                              " line1\n"
+                              "#comment\n"
+                              "f2: v2\n";
+            auto pghs = vcpkg::Paragraphs::parse_paragraphs(str).value_or_exit(VCPKG_LINE_INFO);
+            Assert::AreEqual(size_t(1), pghs.size());
+            Assert::AreEqual(size_t(2), pghs[0].size());
+            Assert::AreEqual("\n line1", pghs[0]["f1"].c_str());
+            Assert::AreEqual("v2", pghs[0]["f2"].c_str());
+        }
+
+        TEST_METHOD(raw_paragraph_emplace_keeps_first_value)
+        {
+            // Matching the previous unordered_map storage, emplace() does not replace
+            // an existing key.
+            Parse::RawParagraph pgh;
+            pgh.emplace("f1", "first");
+            pgh.emplace("f1", "second");
+            Assert::AreEqual(size_t(1), pgh.size());
+            Assert::AreEqual("first", pgh["f1"].c_str());
+        }
+
         TEST_METHOD(BinaryParagraph_serialize_min)
         {
             vcpkg::BinaryParagraph pgh({
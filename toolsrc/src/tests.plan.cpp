@@ -42,7 +42,7 @@ namespace UnitTest1
         Assert::AreEqual(plan.spec.triplet().to_string().c_str(), triplet.to_string().c_str());
 
         Assert::AreEqual(pkg_name.c_str(),
-                         (*plan.any_paragraph.source_control_file.get())->core_paragraph->name.c_str());
+                         (*plan.any_paragraph.source_control_file.get())->core_paragraph.name.c_str());
         Assert::AreEqual(size_t(vec.size()), feature_list.size());
 
         for (auto&& feature_name : vec)
@@ -80,9 +80,9 @@ namespace UnitTest1
         }
         PackageSpec emplace(vcpkg::SourceControlFile&& scf)
         {
-            auto spec = PackageSpec::from_name_and_triplet(scf.core_paragraph->name, triplet);
+            auto spec = PackageSpec::from_name_and_triplet(scf.core_paragraph.name, triplet);
             Assert::IsTrue(spec.has_value());
-            map.emplace(scf.core_paragraph->name, std::move(scf));
+            map.emplace(scf.core_paragraph.name, std::move(scf));
             return PackageSpec{*spec.get()};
         }
     };
@@ -1,5 +1,7 @@
 #include "tests.pch.h"
 
+#include <vcpkg/vcpkglib.h>
+
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
 using namespace vcpkg;
@@ -77,4 +79,58 @@ Status: purge ok not-installed
             Assert::IsTrue(it != status_db.end());
         }
     };
+
+    class ListfileCodec : public TestClass<ListfileCodec>
+    {
+        TEST_METHOD(listfile_roundtrip)
+        {
+            auto& fs = Files::get_real_filesystem();
+            const fs::path listfile = fs::stdfs::temp_directory_path() / "vcpkg-test-roundtrip.list";
+
+            const std::vector<std::string> paths = {
+                "x64-windows",
+                "x64-windows/include",
+                "x64-windows/include/zlib/zconf.h",
+                "x64-windows/include/zlib/zlib.h",
+                "x64-windows/lib/zlib.lib",
+            };
+
+            {
+                ListfileWriter writer(fs, listfile);
+                for (auto&& path : paths)
+                    writer.write_path(path);
+                writer.flush();
+            }
+
+            auto maybe_lines = read_listfile(fs, listfile);
+            Assert::IsTrue(!!maybe_lines);
+            const auto& lines = *maybe_lines.get();
+            Assert::AreEqual(paths.size(), lines.size());
+            for (size_t i = 0; i < paths.size(); ++i)
+                Assert::AreEqual(paths[i].c_str(), lines[i].c_str());
+
+            fs.remove(listfile);
+        }
+
+        TEST_METHOD(listfile_old_format_passthrough)
+        {
+            // Listfiles written before the delta encoding are plain full paths, one per
+            // line; read_listfile() must return them unchanged.
+            auto& fs = Files::get_real_filesystem();
+            const fs::path listfile = fs::stdfs::temp_directory_path() / "vcpkg-test-oldformat.list";
+
+            fs.write_contents(listfile,
+                              "x64-windows/include/zlib/zconf.h\n"
+                              "x64-windows/include/zlib/zlib.h\n");
+
+            auto maybe_lines = read_listfile(fs, listfile);
+            Assert::IsTrue(!!maybe_lines);
+            const auto& lines = *maybe_lines.get();
+            Assert::AreEqual(size_t(2), lines.size());
+            Assert::AreEqual("x64-windows/include/zlib/zconf.h", lines[0].c_str());
+            Assert::AreEqual("x64-windows/include/zlib/zlib.h", lines[1].c_str());
+
+            fs.remove(listfile);
+        }
+    };
 }
\ No newline at end of file
@@ -0,0 +1,168 @@
+#include "pch.h"
+
+#include <vcpkg/base/chrono.h>
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/system.h>
+#include <vcpkg/dependencies.h>
+#include <vcpkg/install.h>
+#include <vcpkg/paragraphs.h>
+#include <vcpkg/sourceparagraph.h>
+#include <vcpkg/statusparagraphs.h>
+
+using namespace vcpkg;
+
+// Microbenchmarks for the tool's hot paths. Build with the vcpkg-bench target and run
+// the binary directly; each benchmark reports microseconds per iteration so regressions
+// show up as a diff against a previous run on the same machine. The numbers are only
+// comparable within one machine and build configuration.
+namespace
+{
+    template<class F>
+    void run_bench(const char* name, const size_t iterations, F&& f)
+    {
+        f(); // warmup
+
+        const auto timer = Chrono::ElapsedTimer::create_started();
+        for (size_t i = 0; i < iterations; ++i)
+            f();
+        const auto total_us = timer.microseconds();
+
+        System::println("%s: %s us/iter (%s iters)",
+                        name,
+                        std::to_string(static_cast<int64_t>(total_us / iterations)),
+                        std::to_string(iterations));
+    }
+
+    std::string make_control_text(const size_t paragraph_count)
+    {
+        std::string text;
+        for (size_t i = 0; i < paragraph_count; ++i)
+        {
+            text.append("Source: bench-port-").append(std::to_string(i)).push_back('\n');
+            text.append("Version: 1.0.").append(std::to_string(i)).push_back('\n');
+            text.append("Build-Depends: zlib, bzip2, libpng (windows), boost[core]\n");
+            text.append("Description: A synthetic paragraph used to benchmark the parser\n");
+            text.push_back('\n');
+        }
+        return text;
+    }
+
+    void bench_paragraph_parser()
+    {
+        const std::string text = make_control_text(100);
+        run_bench("Paragraphs::parse_paragraphs, 100 paragraphs", 500, [&]() {
+            auto parsed = Paragraphs::parse_paragraphs(text);
+            Checks::check_exit(VCPKG_LINE_INFO, parsed.get() != nullptr);
+        });
+    }
+
+    StatusParagraphs make_status_db(const size_t package_count, const Triplet& triplet)
+    {
+        std::vector<std::unique_ptr<StatusParagraph>> pghs;
+        for (size_t i = 0; i < package_count; ++i)
+        {
+            SourceParagraph sp;
+            sp.name = "bench-port-" + std::to_string(i);
+            sp.version = "1.0";
+
+            auto pgh = std::make_unique<StatusParagraph>();
+            pgh->package = BinaryParagraph(sp, triplet);
+            pgh->want = Want::INSTALL;
+            pgh->state = InstallState::INSTALLED;
+            pghs.push_back(std::move(pgh));
+        }
+        return StatusParagraphs(std::move(pghs));
+    }
+
+    void bench_status_find()
+    {
+        const Triplet triplet = Triplet::from_canonical_name("x64-windows");
+        const StatusParagraphs status_db = make_status_db(1000, triplet);
+
+        run_bench("StatusParagraphs::find, 1000 packages, 1000 lookups", 1000, [&]() {
+            for (size_t i = 0; i < 1000; ++i)
+            {
+                const auto it = status_db.find("bench-port-" + std::to_string(i), triplet);
+                Checks::check_exit(VCPKG_LINE_INFO, it != status_db.end());
+            }
+        });
+    }
+
+    void bench_create_install_plan()
+    {
+        // A synthetic 1000-node graph: a dependency chain with a small fan-out per node,
+        // none of it installed, so planning walks every vertex.
+        const size_t node_count = 1000;
+        const Triplet triplet = Triplet::from_canonical_name("x64-windows");
+
+        std::unordered_map<std::string, SourceControlFile> map;
+        for (size_t i = 0; i < node_count; ++i)
+        {
+            SourceControlFile scf;
+            scf.core_paragraph = std::make_unique<SourceParagraph>();
+            scf.core_paragraph->name = "bench-port-" + std::to_string(i);
+            scf.core_paragraph->version = "1.0";
+            if (i + 1 < node_count)
+            {
+                scf.core_paragraph->depends.push_back(
+                    Dependency::parse_dependency("bench-port-" + std::to_string(i + 1), ""));
+            }
+            if (i + 7 < node_count)
+            {
+                scf.core_paragraph->depends.push_back(
+                    Dependency::parse_dependency("bench-port-" + std::to_string(i + 7), ""));
+            }
+            map.emplace(scf.core_paragraph->name, std::move(scf));
+        }
+
+        const Dependencies::MapPortFileProvider provider(map);
+        const StatusParagraphs status_db;
+        const std::vector<PackageSpec> specs = {
+            PackageSpec::from_name_and_triplet("bench-port-0", triplet).value_or_exit(VCPKG_LINE_INFO)};
+
+        run_bench("Dependencies::create_install_plan, 1000-node graph", 20, [&]() {
+            const auto plan = Dependencies::create_install_plan(provider, specs, status_db);
+            Checks::check_exit(VCPKG_LINE_INFO, plan.size() == node_count);
+        });
+    }
+
+    void bench_install_files()
+    {
+        // Run the fixture from the system temporary directory; point TMPDIR at a ramdisk
+        // (e.g. /dev/shm) to take the disk out of the measurement.
+        auto& fs = Files::get_real_filesystem();
+        const fs::path root = fs::stdfs::temp_directory_path() / "vcpkg-bench-install";
+        std::error_code ec;
+        fs.remove_all(root, ec);
+
+        const fs::path source_dir = root / "package";
+        const size_t file_count = 200;
+        fs.create_directories(source_dir / "include" / "bench", ec);
+        for (size_t i = 0; i < file_count; ++i)
+        {
+            fs.write_contents(source_dir / "include" / "bench" / ("header-" + std::to_string(i) + ".h"),
+                              "#pragma once\n");
+        }
+
+        const Install::InstallDir dirs = Install::InstallDir::from_destination_root(
+            root / "installed", "x64-bench", root / "installed" / "vcpkg" / "info" / "bench.list");
+
+        run_bench("install_files_and_write_listfile, 200 files", 20, [&]() {
+            std::error_code cleanup_ec;
+            fs.remove_all(root / "installed", cleanup_ec);
+            Install::install_files_and_write_listfile(fs, source_dir, dirs);
+        });
+
+        fs.remove_all(root, ec);
+    }
+}
+
+int main()
+{
+    bench_paragraph_parser();
+    bench_status_find();
+    bench_create_install_plan();
+    bench_install_files();
+    System::flush_output();
+    return 0;
+}
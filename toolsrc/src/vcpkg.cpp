@@ -33,6 +33,77 @@
 
 using namespace vcpkg;
 
+// Root discovery cache: deep monorepo paths over NFS make the upward .vcpkg-root
+// walk measurable, so the root found for a working directory is remembered in a
+// small per-user file ("<cwd>\t<root>" lines) and revalidated with a single stat
+// of <root>/.vcpkg-root on reuse. VCPKG_ROOT is also exported to children, which
+// short-circuits discovery entirely for nested invocations.
+static fs::path root_cache_path()
+{
+#if defined(_WIN32)
+    const auto base = System::get_environment_variable("LOCALAPPDATA");
+#else
+    const auto base = System::get_environment_variable("HOME");
+#endif
+    if (const auto b = base.get())
+    {
+#if defined(_WIN32)
+        return fs::u8path(*b) / "vcpkg" / "root-cache.txt";
+#else
+        return fs::u8path(*b) / ".vcpkg" / "root-cache.txt";
+#endif
+    }
+    return fs::path();
+}
+
+static fs::path lookup_cached_root(const Files::Filesystem& fs, const std::string& cwd)
+{
+    const fs::path cache = root_cache_path();
+    if (cache.empty()) return fs::path();
+
+    const auto maybe_lines = fs.read_lines(cache);
+    if (const auto lines = maybe_lines.get())
+    {
+        for (const std::string& line : *lines)
+        {
+            const size_t split = line.find('\t');
+            if (split == std::string::npos || line.compare(0, split, cwd) != 0) continue;
+
+            const fs::path root = fs::u8path(line.substr(split + 1));
+            if (fs.exists(root / ".vcpkg-root")) return root;
+            return fs::path(); // the tree moved; rediscover and rewrite
+        }
+    }
+    return fs::path();
+}
+
+static void store_cached_root(Files::Filesystem& fs, const std::string& cwd, const fs::path& root)
+{
+    const fs::path cache = root_cache_path();
+    if (cache.empty()) return;
+
+    // Most recently discovered first, existing entry for this cwd dropped, capped
+    // so the file stays a handful of lines even across many trees.
+    static const size_t MAX_CACHED_ROOTS = 64;
+    std::vector<std::string> lines;
+    lines.push_back(cwd + '\t' + root.u8string());
+    const auto maybe_lines = fs.read_lines(cache);
+    if (const auto previous = maybe_lines.get())
+    {
+        for (const std::string& line : *previous)
+        {
+            const size_t split = line.find('\t');
+            if (split == std::string::npos || line.compare(0, split, cwd) == 0) continue;
+            lines.push_back(line);
+            if (lines.size() >= MAX_CACHED_ROOTS) break;
+        }
+    }
+
+    std::error_code ec;
+    fs.create_directories(cache.parent_path(), ec);
+    if (!ec) fs.write_contents(cache, Strings::join("\n", lines) + '\n');
+}
+
 void invalid_command(const std::string& cmd)
 {
     System::println(System::Color::error, "invalid command: %s", cmd);
@@ -49,18 +120,7 @@ static void inner(const VcpkgCmdArguments& args)
         Checks::exit_fail(VCPKG_LINE_INFO);
     }
 
-    static const auto find_command = [&](auto&& commands) {
-        auto it = Util::find_if(commands, [&](auto&& commandc) {
-            return Strings::case_insensitive_ascii_equals(commandc.name, args.command);
-        });
-        using std::end;
-        if (it != end(commands))
-        {
-            return &*it;
-        }
-        else
-            return static_cast<decltype(&*it)>(nullptr);
-    };
+    static const auto find_command = [&](auto&& commands) { return Commands::find(args.command, commands); };
 
     if (const auto command_function = find_command(Commands::get_available_commands_type_c()))
     {
@@ -81,19 +141,31 @@ static void inner(const VcpkgCmdArguments& args)
         }
         else
         {
+            auto& fs = Files::get_real_filesystem();
             const fs::path current_path = fs::stdfs::current_path();
-            vcpkg_root_dir = Files::get_real_filesystem().find_file_recursively_up(current_path, ".vcpkg-root");
+            vcpkg_root_dir = lookup_cached_root(fs, current_path.u8string());
 
             if (vcpkg_root_dir.empty())
             {
-                vcpkg_root_dir = Files::get_real_filesystem().find_file_recursively_up(
-                    fs::stdfs::absolute(System::get_exe_path_of_current_process()), ".vcpkg-root");
+                vcpkg_root_dir = fs.find_file_recursively_up(current_path, ".vcpkg-root");
+
+                if (vcpkg_root_dir.empty())
+                {
+                    vcpkg_root_dir = fs.find_file_recursively_up(
+                        fs::stdfs::absolute(System::get_exe_path_of_current_process()), ".vcpkg-root");
+                }
+
+                if (!vcpkg_root_dir.empty()) store_cached_root(fs, current_path.u8string(), vcpkg_root_dir);
             }
         }
     }
 
     Checks::check_exit(VCPKG_LINE_INFO, !vcpkg_root_dir.empty(), "Error: Could not detect vcpkg-root.");
 
+    // Children (and their nested vcpkg invocations) inherit the answer instead of
+    // repeating the walk.
+    System::set_environment_variable("VCPKG_ROOT", vcpkg_root_dir.u8string());
+
     const Expected<VcpkgPaths> expected_paths = VcpkgPaths::create(vcpkg_root_dir);
     Checks::check_exit(VCPKG_LINE_INFO,
                        !expected_paths.error(),
@@ -174,21 +246,17 @@ static void load_config()
 #if defined(_WIN32)
     auto& fs = Files::get_real_filesystem();
 
-    auto config = UserConfig::try_read_data(fs);
-
-    bool write_config = false;
+    auto& config = UserConfig::get_cached(fs);
 
     // config file not found, could not be read, or invalid
     if (config.user_id.empty() || config.user_time.empty())
     {
         ::vcpkg::Metrics::Metrics::init_user_information(config.user_id, config.user_time);
-        write_config = true;
     }
 
     if (config.user_mac.empty())
     {
         config.user_mac = Metrics::get_MAC_user();
-        write_config = true;
     }
 
     {
@@ -204,10 +272,8 @@ static void load_config()
 
     GlobalState::g_surveydate.lock()->assign(config.last_completed_survey);
 
-    if (write_config)
-    {
-        config.try_write_data(fs);
-    }
+    // A no-op on disk unless one of the fields above was filled in.
+    config.try_write_data(fs);
 #endif
 }
 
@@ -242,6 +308,12 @@ int main(const int argc, const char* const* const argv)
 
     *GlobalState::timer.lock() = Chrono::ElapsedTimer::create_started();
 
+#if !defined(_WIN32)
+    // When a warm daemon is configured, hand the command line to it and exit with its
+    // result; returns when no daemon is reachable.
+    Commands::Daemon::try_dispatch_to_daemon(argc, argv);
+#endif
+
 #if defined(_WIN32)
     GlobalState::g_init_console_cp = GetConsoleCP();
     GlobalState::g_init_console_output_cp = GetConsoleOutputCP();
@@ -267,8 +339,37 @@ int main(const int argc, const char* const* const argv)
     if (const auto p = args.sendmetrics.get()) Metrics::g_metrics.lock()->set_send_metrics(*p);
     if (const auto p = args.debug.get()) GlobalState::debugging = *p;
 
+    Metrics::g_metrics.lock()->start_background_uploader();
+
     Checks::register_console_ctrl_handler();
 
+    // Printed under --debug so wrapper fleets can watch cold-start cost: the time
+    // the loader and static initializers spent before main(), and the time from
+    // main() to command dispatch.
+    if (GlobalState::debugging)
+    {
+        const long long to_dispatch_us = static_cast<long long>(GlobalState::timer.lock()->microseconds());
+#if defined(_WIN32)
+        FILETIME creation_time, unused_exit, unused_kernel, unused_user;
+        if (GetProcessTimes(GetCurrentProcess(), &creation_time, &unused_exit, &unused_kernel, &unused_user))
+        {
+            FILETIME now_time;
+            GetSystemTimeAsFileTime(&now_time);
+            ULARGE_INTEGER creation, now;
+            creation.LowPart = creation_time.dwLowDateTime;
+            creation.HighPart = creation_time.dwHighDateTime;
+            now.LowPart = now_time.dwLowDateTime;
+            now.HighPart = now_time.dwHighDateTime;
+            const long long since_creation_us = static_cast<long long>((now.QuadPart - creation.QuadPart) / 10);
+            Debug::println("Startup: %lld us before main() (loader + static initializers), %lld us to dispatch",
+                           since_creation_us - to_dispatch_us,
+                           to_dispatch_us);
+        }
+#else
+        Debug::println("Startup: %lld us from main() to dispatch", to_dispatch_us);
+#endif
+    }
+
     if (GlobalState::debugging)
     {
         inner(args);
@@ -291,6 +392,7 @@ int main(const int argc, const char* const* const argv)
     }
     Metrics::g_metrics.lock()->track_property("error", exc_msg);
 
+    System::flush_output();
     fflush(stdout);
     System::print("vcpkg.exe has crashed.\n"
                   "Please send an email to:\n"
@@ -303,6 +405,7 @@ int main(const int argc, const char* const* const argv)
                   Commands::Contact::email(),
                   Commands::Version::version(),
                   exc_msg);
+    System::flush_output();
     fflush(stdout);
     for (int x = 0; x < argc; ++x)
     {
@@ -312,5 +415,6 @@ int main(const int argc, const char* const* const argv)
         System::println("%s|", argv[x]);
 #endif
     }
+    System::flush_output();
     fflush(stdout);
 }
@@ -0,0 +1,136 @@
+#include "pch.h"
+
+#include <vcpkg/base/allocstats.h>
+#include <vcpkg/base/system.h>
+
+#if !defined(VCPKG_ALLOC_STATS)
+
+namespace vcpkg::AllocStats
+{
+    void enable()
+    {
+        System::println(System::Color::warning,
+                        "Allocation tracking was compiled out; rebuild with -DVCPKG_ALLOC_STATS=ON.");
+    }
+}
+
+#else
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace vcpkg::AllocStats
+{
+    static std::atomic<bool> g_enabled{false};
+
+    // The tag of the innermost TagScope on this thread; allocations made outside any
+    // scope are charged to "untagged".
+    static thread_local const char* t_current_tag = nullptr;
+
+    // Tags are string literals, so slots match by pointer identity and the lookup is
+    // a short linear scan with no allocation -- the hook must never allocate itself.
+    static const size_t MAX_TAGS = 16;
+
+    struct TagSlot
+    {
+        std::atomic<const char*> name{nullptr};
+        std::atomic<unsigned long long> count{0};
+        std::atomic<unsigned long long> bytes{0};
+        std::atomic<long long> live{0};
+        std::atomic<long long> peak{0};
+    };
+
+    static TagSlot g_slots[MAX_TAGS];
+
+    static size_t slot_for(const char* tag)
+    {
+        for (size_t i = 0; i < MAX_TAGS; ++i)
+        {
+            const char* name = g_slots[i].name.load(std::memory_order_acquire);
+            if (name == tag) return i;
+            if (name == nullptr)
+            {
+                const char* expected = nullptr;
+                if (g_slots[i].name.compare_exchange_strong(expected, tag, std::memory_order_acq_rel)) return i;
+                if (expected == tag) return i;
+            }
+        }
+        // Out of slots; fold into the first one rather than dropping the bytes.
+        return 0;
+    }
+
+    // Every tracked allocation carries a two-word prefix (size and slot index, kept
+    // at 16 bytes to preserve malloc's alignment), so the delete hook can subtract
+    // the right amount from the right tag without any lookup. Allocations made
+    // before enable() store the sentinel slot and are simply not recorded.
+    static const unsigned long long UNRECORDED_SLOT = MAX_TAGS;
+
+    void* tracked_allocate(const size_t size)
+    {
+        void* raw = std::malloc(size + 2 * sizeof(unsigned long long));
+        if (!raw) throw std::bad_alloc();
+
+        unsigned long long* header = static_cast<unsigned long long*>(raw);
+        unsigned long long slot = UNRECORDED_SLOT;
+        if (g_enabled.load(std::memory_order_relaxed))
+        {
+            slot = slot_for(t_current_tag ? t_current_tag : "untagged");
+            TagSlot& counters = g_slots[slot];
+            counters.count.fetch_add(1, std::memory_order_relaxed);
+            counters.bytes.fetch_add(size, std::memory_order_relaxed);
+            const long long live = counters.live.fetch_add(size, std::memory_order_relaxed) + static_cast<long long>(size);
+            long long peak = counters.peak.load(std::memory_order_relaxed);
+            while (live > peak && !counters.peak.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+            {
+            }
+        }
+        header[0] = size;
+        header[1] = slot;
+        return header + 2;
+    }
+
+    void tracked_deallocate(void* p) noexcept
+    {
+        if (!p) return;
+        unsigned long long* header = static_cast<unsigned long long*>(p) - 2;
+        if (header[1] < MAX_TAGS)
+        {
+            g_slots[header[1]].live.fetch_sub(static_cast<long long>(header[0]), std::memory_order_relaxed);
+        }
+        std::free(header);
+    }
+
+    void enable() { g_enabled.store(true, std::memory_order_relaxed); }
+    bool enabled() { return g_enabled.load(std::memory_order_relaxed); }
+
+    TagScope::TagScope(const char* tag) : m_previous(t_current_tag) { t_current_tag = tag; }
+    TagScope::~TagScope() { t_current_tag = m_previous; }
+
+    void report()
+    {
+        if (!enabled()) return;
+
+        System::println("Allocation statistics per subsystem tag:");
+        System::println("%-12s %15s %15s %15s", "tag", "allocations", "bytes", "peak live");
+        for (const TagSlot& slot : g_slots)
+        {
+            const char* name = slot.name.load(std::memory_order_acquire);
+            if (!name) continue;
+            System::println("%-12s %15s %15s %15s",
+                            name,
+                            std::to_string(slot.count.load(std::memory_order_relaxed)),
+                            std::to_string(slot.bytes.load(std::memory_order_relaxed)),
+                            std::to_string(slot.peak.load(std::memory_order_relaxed)));
+        }
+    }
+}
+
+void* operator new(std::size_t size) { return vcpkg::AllocStats::tracked_allocate(size); }
+void* operator new[](std::size_t size) { return vcpkg::AllocStats::tracked_allocate(size); }
+void operator delete(void* p) noexcept { vcpkg::AllocStats::tracked_deallocate(p); }
+void operator delete[](void* p) noexcept { vcpkg::AllocStats::tracked_deallocate(p); }
+void operator delete(void* p, std::size_t) noexcept { vcpkg::AllocStats::tracked_deallocate(p); }
+void operator delete[](void* p, std::size_t) noexcept { vcpkg::AllocStats::tracked_deallocate(p); }
+
+#endif
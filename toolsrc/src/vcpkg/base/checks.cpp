@@ -3,8 +3,12 @@
 #include <vcpkg/globalstate.h>
 #include <vcpkg/metrics.h>
 
+#include <vcpkg/base/allocstats.h>
 #include <vcpkg/base/checks.h>
+#include <vcpkg/base/progress.h>
+#include <vcpkg/base/stats.h>
 #include <vcpkg/base/system.h>
+#include <vcpkg/base/timing.h>
 
 namespace vcpkg::Checks
 {
@@ -14,14 +18,30 @@ namespace vcpkg::Checks
 
         auto metrics = Metrics::g_metrics.lock();
         metrics->track_metric("elapsed_us", elapsed_us);
+
+        // Aggregate the relaxed worker-thread counters exactly once, now that every
+        // writer has finished.
+        const uint64_t installed_files = GlobalState::g_installed_file_count.load();
+        const uint64_t removed_files = GlobalState::g_removed_file_count.load();
+        if (installed_files != 0) metrics->track_metric("installed_files", static_cast<double>(installed_files));
+        if (removed_files != 0) metrics->track_metric("removed_files", static_cast<double>(removed_files));
+
         GlobalState::debugging = false;
         metrics->flush();
 
+        // The status line must be erased before the final reports print over it.
+        Progress::shutdown();
+
+        Timing::report();
+        Stats::report();
+        AllocStats::report();
+
 #if defined(_WIN32)
         SetConsoleCP(GlobalState::g_init_console_cp);
         SetConsoleOutputCP(GlobalState::g_init_console_output_cp);
 #endif
 
+        System::flush_output();
         fflush(nullptr);
 
 #if defined(_WIN32)
@@ -2,35 +2,50 @@
 
 #include <vcpkg/base/checks.h>
 #include <vcpkg/base/cofffilereader.h>
+#include <vcpkg/base/parallel.h>
 
 using namespace std;
 
 namespace vcpkg::CoffFileReader
 {
 #if defined(_WIN32)
-    template<class T>
-    static T reinterpret_bytes(const char* data)
+    // Headers and member offsets are parsed directly out of a file mapping; nothing is
+    // copied into intermediate buffers and there are no per-field seeks or reads.
+    struct MappedView
     {
-        return (*reinterpret_cast<const T*>(&data[0]));
-    }
+        static MappedView map(const fs::path& path)
+        {
+            auto maybe_mapping = Files::MemoryMappedFile::map(path);
+            Checks::check_exit(VCPKG_LINE_INFO,
+                               maybe_mapping.has_value(),
+                               "Could not open file %s for reading",
+                               path.generic_string());
+            return MappedView{std::move(*maybe_mapping.get())};
+        }
 
-    template<class T>
-    static T read_value_from_stream(fstream& fs)
-    {
-        T data;
-        fs.read(reinterpret_cast<char*>(&data), sizeof data);
-        return data;
-    }
+        const char* at(const uint64_t offset, const uint64_t length) const
+        {
+            Checks::check_exit(VCPKG_LINE_INFO,
+                               offset <= m_mapping.size() && length <= m_mapping.size() - offset,
+                               "Unexpected end of file while parsing binary");
+            return m_mapping.data() + offset;
+        }
 
-    template<class T>
-    static T peek_value_from_stream(fstream& fs)
-    {
-        const std::streampos original_pos = fs.tellg();
-        T data;
-        fs.read(reinterpret_cast<char*>(&data), sizeof data);
-        fs.seekg(original_pos);
-        return data;
-    }
+        template<class T>
+        T read_value(const uint64_t offset) const
+        {
+            T value;
+            memcpy(&value, at(offset, sizeof(T)), sizeof(T));
+            return value;
+        }
+
+        uint64_t size() const { return m_mapping.size(); }
+
+    private:
+        explicit MappedView(Files::MemoryMappedFile&& mapping) : m_mapping(std::move(mapping)) {}
+
+        Files::MemoryMappedFile m_mapping;
+    };
 
     static void verify_equal_strings(
         const LineInfo& line_info, const char* expected, const char* actual, int size, const char* label)
@@ -43,26 +58,9 @@ namespace vcpkg::CoffFileReader
                            actual);
     }
 
-    static void read_and_verify_PE_signature(fstream& fs)
+    static uint64_t align_to_size(const uint64_t unaligned, const uint64_t alignment_size)
     {
-        static const size_t OFFSET_TO_PE_SIGNATURE_OFFSET = 0x3c;
-
-        static const char* PE_SIGNATURE = "PE\0\0";
-        static const size_t PE_SIGNATURE_SIZE = 4;
-
-        fs.seekg(OFFSET_TO_PE_SIGNATURE_OFFSET, ios_base::beg);
-        const int32_t offset_to_PE_signature = read_value_from_stream<int32_t>(fs);
-
-        fs.seekg(offset_to_PE_signature);
-        char signature[PE_SIGNATURE_SIZE];
-        fs.read(signature, PE_SIGNATURE_SIZE);
-        verify_equal_strings(VCPKG_LINE_INFO, PE_SIGNATURE, signature, PE_SIGNATURE_SIZE, "PE_SIGNATURE");
-        fs.seekg(offset_to_PE_signature + PE_SIGNATURE_SIZE, ios_base::beg);
-    }
-
-    static fpos_t align_to_size(const uint64_t unaligned, const uint64_t alignment_size)
-    {
-        fpos_t aligned = unaligned - 1;
+        uint64_t aligned = unaligned - 1;
         aligned /= alignment_size;
         aligned += 1;
         aligned *= alignment_size;
@@ -73,57 +71,65 @@ namespace vcpkg::CoffFileReader
     {
         static const size_t HEADER_SIZE = 20;
 
-        static CoffFileHeader read(fstream& fs)
+        static CoffFileHeader read(const MappedView& view, const uint64_t offset)
         {
-            CoffFileHeader ret;
-            ret.data.resize(HEADER_SIZE);
-            fs.read(&ret.data[0], HEADER_SIZE);
-            return ret;
+            view.at(offset, HEADER_SIZE);
+            return CoffFileHeader{&view, offset};
         }
 
         MachineType machine_type() const
         {
             static const size_t MACHINE_TYPE_OFFSET = 0;
-            static const size_t MACHINE_TYPE_SIZE = 2;
 
-            std::string machine_field_as_string = data.substr(MACHINE_TYPE_OFFSET, MACHINE_TYPE_SIZE);
-            const uint16_t machine = reinterpret_bytes<uint16_t>(machine_field_as_string.c_str());
+            const uint16_t machine = view->read_value<uint16_t>(offset + MACHINE_TYPE_OFFSET);
             return to_machine_type(machine);
         }
 
+        uint16_t number_of_sections() const
+        {
+            static const size_t NUMBER_OF_SECTIONS_OFFSET = 2;
+            return view->read_value<uint16_t>(offset + NUMBER_OF_SECTIONS_OFFSET);
+        }
+
+        uint16_t size_of_optional_header() const
+        {
+            static const size_t SIZE_OF_OPTIONAL_HEADER_OFFSET = 16;
+            return view->read_value<uint16_t>(offset + SIZE_OF_OPTIONAL_HEADER_OFFSET);
+        }
+
     private:
-        std::string data;
+        CoffFileHeader(const MappedView* view, const uint64_t offset) : view(view), offset(offset) {}
+
+        const MappedView* view;
+        uint64_t offset;
     };
 
     struct ArchiveMemberHeader
     {
         static const size_t HEADER_SIZE = 60;
 
-        static ArchiveMemberHeader read(fstream& fs)
+        static ArchiveMemberHeader read(const MappedView& view, const uint64_t offset)
         {
             static const size_t HEADER_END_OFFSET = 58;
             static const char* HEADER_END = "`\n";
             static const size_t HEADER_END_SIZE = 2;
 
-            ArchiveMemberHeader ret;
-            ret.data.resize(HEADER_SIZE);
-            fs.read(&ret.data[0], HEADER_SIZE);
+            const char* data = view.at(offset, HEADER_SIZE);
 
-            if (ret.data[0] != '\0') // Due to freeglut. github issue #223
+            if (data[0] != '\0') // Due to freeglut. github issue #223
             {
-                const std::string header_end = ret.data.substr(HEADER_END_OFFSET, HEADER_END_SIZE);
                 verify_equal_strings(
-                    VCPKG_LINE_INFO, HEADER_END, header_end.c_str(), HEADER_END_SIZE, "LIB HEADER_END");
+                    VCPKG_LINE_INFO, HEADER_END, data + HEADER_END_OFFSET, HEADER_END_SIZE, "LIB HEADER_END");
             }
 
-            return ret;
+            return ArchiveMemberHeader{data};
         }
 
         std::string name() const
         {
             static const size_t HEADER_NAME_OFFSET = 0;
             static const size_t HEADER_NAME_SIZE = 16;
-            return data.substr(HEADER_NAME_OFFSET, HEADER_NAME_SIZE);
+            return std::string(data + HEADER_NAME_OFFSET, HEADER_NAME_SIZE);
         }
 
         uint64_t member_size() const
@@ -132,7 +138,7 @@ namespace vcpkg::CoffFileReader
 
             static const size_t HEADER_SIZE_OFFSET = 48;
             static const size_t HEADER_SIZE_FIELD_SIZE = 10;
-            const std::string as_string = data.substr(HEADER_SIZE_OFFSET, HEADER_SIZE_FIELD_SIZE);
+            const std::string as_string(data + HEADER_SIZE_OFFSET, HEADER_SIZE_FIELD_SIZE);
             // This is in ASCII decimal representation
             const uint64_t value = std::strtoull(as_string.c_str(), nullptr, 10);
 
@@ -140,25 +146,84 @@ namespace vcpkg::CoffFileReader
             return aligned;
         }
 
-        std::string data;
+    private:
+        explicit ArchiveMemberHeader(const char* data) : data(data) {}
+
+        const char* data;
+    };
+
+    struct SectionHeader
+    {
+        static const size_t HEADER_SIZE = 40;
+
+        static SectionHeader read(const MappedView& view, const uint64_t offset)
+        {
+            view.at(offset, HEADER_SIZE);
+            return SectionHeader{&view, offset};
+        }
+
+        bool has_name(const char* expected) const
+        {
+            static const size_t NAME_OFFSET = 0;
+            static const size_t NAME_SIZE = 8;
+            return memcmp(view->at(offset + NAME_OFFSET, NAME_SIZE), expected, NAME_SIZE) == 0;
+        }
+
+        uint32_t virtual_size() const { return view->read_value<uint32_t>(offset + 8); }
+        uint32_t virtual_address() const { return view->read_value<uint32_t>(offset + 12); }
+        uint32_t size_of_raw_data() const { return view->read_value<uint32_t>(offset + 16); }
+        uint32_t pointer_to_raw_data() const { return view->read_value<uint32_t>(offset + 20); }
+
+    private:
+        SectionHeader(const MappedView* view, const uint64_t offset) : view(view), offset(offset) {}
+
+        const MappedView* view;
+        uint64_t offset;
+    };
+
+    // Maps the RVAs used inside the optional header's data directories back to file
+    // offsets through the section table. Returns 0 for an RVA no section covers.
+    struct SectionTable
+    {
+        static SectionTable read(const MappedView& view, const uint64_t offset, const uint16_t section_count)
+        {
+            SectionTable ret;
+            for (uint16_t i = 0; i < section_count; ++i)
+            {
+                ret.sections.push_back(SectionHeader::read(view, offset + uint64_t{i} * SectionHeader::HEADER_SIZE));
+            }
+            return ret;
+        }
+
+        uint64_t rva_to_file_offset(const uint32_t rva) const
+        {
+            for (const SectionHeader& section : sections)
+            {
+                const uint32_t va = section.virtual_address();
+                const uint32_t size = std::max(section.virtual_size(), section.size_of_raw_data());
+                if (rva >= va && rva - va < size)
+                {
+                    return uint64_t{rva} - va + section.pointer_to_raw_data();
+                }
+            }
+            return 0;
+        }
+
+        std::vector<SectionHeader> sections;
     };
 
     struct OffsetsArray
     {
-        static OffsetsArray read(fstream& fs, const uint32_t offset_count)
+        static OffsetsArray read(const MappedView& view, const uint64_t offset, const uint32_t offset_count)
         {
             static const size_t OFFSET_WIDTH = 4;
 
-            std::string raw_offsets;
-            const size_t raw_offset_size = offset_count * OFFSET_WIDTH;
-            raw_offsets.resize(raw_offset_size);
-            fs.read(&raw_offsets[0], raw_offset_size);
+            view.at(offset, uint64_t{offset_count} * OFFSET_WIDTH);
 
             OffsetsArray ret;
             for (uint32_t i = 0; i < offset_count; ++i)
             {
-                const std::string value_as_string = raw_offsets.substr(OFFSET_WIDTH * i, OFFSET_WIDTH * (i + 1));
-                const uint32_t value = reinterpret_bytes<uint32_t>(value_as_string.c_str());
+                const uint32_t value = view.read_value<uint32_t>(offset + OFFSET_WIDTH * i);
 
                 // Ignore offsets that point to offset 0. See vcpkg github #223 #288 #292
                 if (value != 0)
@@ -179,132 +244,261 @@ namespace vcpkg::CoffFileReader
     {
         static const size_t HEADER_SIZE = 20;
 
-        static ImportHeader read(fstream& fs)
+        static ImportHeader read(const MappedView& view, const uint64_t offset)
         {
             static const size_t SIG1_OFFSET = 0;
             static const uint16_t SIG1 = static_cast<uint16_t>(MachineType::UNKNOWN);
-            static const size_t SIG1_SIZE = 2;
 
             static const size_t SIG2_OFFSET = 2;
             static const uint16_t SIG2 = 0xFFFF;
-            static const size_t SIG2_SIZE = 2;
 
-            ImportHeader ret;
-            ret.data.resize(HEADER_SIZE);
-            fs.read(&ret.data[0], HEADER_SIZE);
+            view.at(offset, HEADER_SIZE);
 
-            const std::string sig1_as_string = ret.data.substr(SIG1_OFFSET, SIG1_SIZE);
-            const uint16_t sig1 = reinterpret_bytes<uint16_t>(sig1_as_string.c_str());
+            const uint16_t sig1 = view.read_value<uint16_t>(offset + SIG1_OFFSET);
             Checks::check_exit(VCPKG_LINE_INFO, sig1 == SIG1, "Sig1 was incorrect. Expected %s but got %s", SIG1, sig1);
 
-            const std::string sig2_as_string = ret.data.substr(SIG2_OFFSET, SIG2_SIZE);
-            const uint16_t sig2 = reinterpret_bytes<uint16_t>(sig2_as_string.c_str());
+            const uint16_t sig2 = view.read_value<uint16_t>(offset + SIG2_OFFSET);
             Checks::check_exit(VCPKG_LINE_INFO, sig2 == SIG2, "Sig2 was incorrect. Expected %s but got %s", SIG2, sig2);
 
-            return ret;
+            return ImportHeader{&view, offset};
         }
 
         MachineType machine_type() const
         {
             static const size_t MACHINE_TYPE_OFFSET = 6;
-            static const size_t MACHINE_TYPE_SIZE = 2;
 
-            std::string machine_field_as_string = data.substr(MACHINE_TYPE_OFFSET, MACHINE_TYPE_SIZE);
-            const uint16_t machine = reinterpret_bytes<uint16_t>(machine_field_as_string.c_str());
+            const uint16_t machine = view->read_value<uint16_t>(offset + MACHINE_TYPE_OFFSET);
             return to_machine_type(machine);
         }
 
     private:
-        std::string data;
+        ImportHeader(const MappedView* view, const uint64_t offset) : view(view), offset(offset) {}
+
+        const MappedView* view;
+        uint64_t offset;
     };
 
-    static void read_and_verify_archive_file_signature(fstream& fs)
+    static void verify_archive_file_signature(const MappedView& view)
     {
         static const char* FILE_START = "!<arch>\n";
         static const size_t FILE_START_SIZE = 8;
 
-        fs.seekg(fs.beg);
-
-        char file_start[FILE_START_SIZE];
-        fs.read(file_start, FILE_START_SIZE);
-        verify_equal_strings(VCPKG_LINE_INFO, FILE_START, file_start, FILE_START_SIZE, "LIB FILE_START");
+        verify_equal_strings(
+            VCPKG_LINE_INFO, FILE_START, view.at(0, FILE_START_SIZE), FILE_START_SIZE, "LIB FILE_START");
     }
 
     DllInfo read_dll(const fs::path& path)
     {
-        std::fstream fs(path, std::ios::in | std::ios::binary | std::ios::ate);
-        Checks::check_exit(VCPKG_LINE_INFO, fs.is_open(), "Could not open file %s for reading", path.generic_string());
+        static const size_t OFFSET_TO_PE_SIGNATURE_OFFSET = 0x3c;
 
-        read_and_verify_PE_signature(fs);
-        CoffFileHeader header = CoffFileHeader::read(fs);
-        const MachineType machine = header.machine_type();
-        return {machine};
-    }
+        static const char* PE_SIGNATURE = "PE\0\0";
+        static const size_t PE_SIGNATURE_SIZE = 4;
 
-    struct Marker
-    {
-        void set_to_offset(const fpos_t position) { this->m_absolute_position = position; }
+        const MappedView view = MappedView::map(path);
 
-        void set_to_current_pos(fstream& fs) { this->m_absolute_position = fs.tellg().seekpos(); }
+        const int32_t offset_to_PE_signature = view.read_value<int32_t>(OFFSET_TO_PE_SIGNATURE_OFFSET);
+        verify_equal_strings(VCPKG_LINE_INFO,
+                             PE_SIGNATURE,
+                             view.at(offset_to_PE_signature, PE_SIGNATURE_SIZE),
+                             PE_SIGNATURE_SIZE,
+                             "PE_SIGNATURE");
 
-        void seek_to_marker(fstream& fs) const { fs.seekg(this->m_absolute_position, ios_base::beg); }
+        const CoffFileHeader header = CoffFileHeader::read(view, offset_to_PE_signature + PE_SIGNATURE_SIZE);
 
-        void advance_by(const uint64_t offset) { this->m_absolute_position += offset; }
+        DllInfo info;
+        info.machine_type = header.machine_type();
+        info.has_exports = false;
+        info.is_appcontainer = false;
 
-    private:
-        fpos_t m_absolute_position = 0;
-    };
+        const uint16_t size_of_optional_header = header.size_of_optional_header();
+        if (size_of_optional_header == 0)
+        {
+            return info;
+        }
+
+        static const uint16_t PE32_PLUS_MAGIC = 0x20b;
+        static const uint16_t DLL_CHARACTERISTICS_OFFSET = 70; // Same for PE32 and PE32+
+        static const uint16_t APPCONTAINER_CHARACTERISTIC = 0x1000;
+
+        const uint64_t optional_header_offset =
+            offset_to_PE_signature + PE_SIGNATURE_SIZE + CoffFileHeader::HEADER_SIZE;
+        const bool is_pe32_plus = view.read_value<uint16_t>(optional_header_offset) == PE32_PLUS_MAGIC;
+
+        const uint16_t dll_characteristics =
+            view.read_value<uint16_t>(optional_header_offset + DLL_CHARACTERISTICS_OFFSET);
+        info.is_appcontainer = (dll_characteristics & APPCONTAINER_CHARACTERISTIC) != 0;
+
+        // The data directory table follows the fixed and windows-specific optional
+        // header fields, which are wider in PE32+ images.
+        const uint64_t directory_count_offset = optional_header_offset + (is_pe32_plus ? 108 : 92);
+        const uint64_t data_directories_offset = optional_header_offset + (is_pe32_plus ? 112 : 96);
+        const uint32_t directory_count = view.read_value<uint32_t>(directory_count_offset);
+
+        const SectionTable section_table = SectionTable::read(
+            view, optional_header_offset + size_of_optional_header, header.number_of_sections());
+
+        static const size_t EXPORT_DIRECTORY_INDEX = 0;
+        static const size_t IMPORT_DIRECTORY_INDEX = 1;
+        static const size_t DIRECTORY_ENTRY_SIZE = 8;
+
+        if (directory_count > EXPORT_DIRECTORY_INDEX)
+        {
+            const uint32_t export_rva = view.read_value<uint32_t>(data_directories_offset);
+            const uint32_t export_size = view.read_value<uint32_t>(data_directories_offset + 4);
+            const uint64_t export_offset = export_rva != 0 ? section_table.rva_to_file_offset(export_rva) : 0;
+            if (export_size != 0 && export_offset != 0)
+            {
+                static const size_t NUMBER_OF_FUNCTIONS_OFFSET = 20;
+                info.has_exports = view.read_value<uint32_t>(export_offset + NUMBER_OF_FUNCTIONS_OFFSET) != 0;
+            }
+        }
+
+        if (directory_count > IMPORT_DIRECTORY_INDEX)
+        {
+            static const size_t IMPORT_DESCRIPTOR_SIZE = 20;
+            static const size_t IMPORT_NAME_RVA_OFFSET = 12;
+            static const size_t MAX_DLL_NAME_LENGTH = 256;
+
+            const uint32_t import_rva =
+                view.read_value<uint32_t>(data_directories_offset + IMPORT_DIRECTORY_INDEX * DIRECTORY_ENTRY_SIZE);
+            uint64_t descriptor_offset = import_rva != 0 ? section_table.rva_to_file_offset(import_rva) : 0;
+            while (descriptor_offset != 0)
+            {
+                const uint32_t name_rva =
+                    view.read_value<uint32_t>(descriptor_offset + IMPORT_NAME_RVA_OFFSET);
+                if (name_rva == 0)
+                {
+                    break; // The descriptor array is terminated by an all-zero entry
+                }
+
+                const uint64_t name_offset = section_table.rva_to_file_offset(name_rva);
+                if (name_offset != 0 && name_offset < view.size())
+                {
+                    const uint64_t max_length = std::min(uint64_t{MAX_DLL_NAME_LENGTH}, view.size() - name_offset);
+                    const char* name = view.at(name_offset, max_length);
+                    info.imported_dll_names.emplace_back(name, strnlen(name, max_length));
+                }
+
+                descriptor_offset += IMPORT_DESCRIPTOR_SIZE;
+            }
+        }
+
+        return info;
+    }
 
     LibInfo read_lib(const fs::path& path)
     {
-        std::fstream fs(path, std::ios::in | std::ios::binary | std::ios::ate);
-        Checks::check_exit(VCPKG_LINE_INFO, fs.is_open(), "Could not open file %s for reading", path.generic_string());
+        static const size_t FILE_START_SIZE = 8;
+
+        const MappedView view = MappedView::map(path);
 
-        read_and_verify_archive_file_signature(fs);
+        verify_archive_file_signature(view);
 
-        Marker marker;
-        marker.set_to_current_pos(fs);
+        uint64_t position = FILE_START_SIZE;
 
         // First Linker Member
-        const ArchiveMemberHeader first_linker_member_header = ArchiveMemberHeader::read(fs);
+        const ArchiveMemberHeader first_linker_member_header = ArchiveMemberHeader::read(view, position);
         Checks::check_exit(VCPKG_LINE_INFO,
                            first_linker_member_header.name().substr(0, 2) == "/ ",
                            "Could not find proper first linker member");
-        marker.advance_by(ArchiveMemberHeader::HEADER_SIZE + first_linker_member_header.member_size());
-        marker.seek_to_marker(fs);
+        position += ArchiveMemberHeader::HEADER_SIZE + first_linker_member_header.member_size();
 
-        const ArchiveMemberHeader second_linker_member_header = ArchiveMemberHeader::read(fs);
+        const ArchiveMemberHeader second_linker_member_header = ArchiveMemberHeader::read(view, position);
         Checks::check_exit(VCPKG_LINE_INFO,
                            second_linker_member_header.name().substr(0, 2) == "/ ",
                            "Could not find proper second linker member");
         // The first 4 bytes contains the number of archive members
-        const uint32_t archive_member_count = read_value_from_stream<uint32_t>(fs);
-        const OffsetsArray offsets = OffsetsArray::read(fs, archive_member_count);
-        marker.advance_by(ArchiveMemberHeader::HEADER_SIZE + second_linker_member_header.member_size());
-        marker.seek_to_marker(fs);
-
-        const bool hasLongnameMemberHeader = peek_value_from_stream<uint16_t>(fs) == 0x2F2F;
+        const uint32_t archive_member_count =
+            view.read_value<uint32_t>(position + ArchiveMemberHeader::HEADER_SIZE);
+        const OffsetsArray offsets =
+            OffsetsArray::read(view, position + ArchiveMemberHeader::HEADER_SIZE + sizeof(uint32_t),
+                               archive_member_count);
+        position += ArchiveMemberHeader::HEADER_SIZE + second_linker_member_header.member_size();
+
+        const bool hasLongnameMemberHeader = view.read_value<uint16_t>(position) == 0x2F2F;
         if (hasLongnameMemberHeader)
         {
-            const ArchiveMemberHeader longnames_member_header = ArchiveMemberHeader::read(fs);
-            marker.advance_by(ArchiveMemberHeader::HEADER_SIZE + longnames_member_header.member_size());
-            marker.seek_to_marker(fs);
+            const ArchiveMemberHeader longnames_member_header = ArchiveMemberHeader::read(view, position);
+            position += ArchiveMemberHeader::HEADER_SIZE + longnames_member_header.member_size();
         }
 
-        std::set<MachineType> machine_types;
         // Next we have the obj and pseudo-object files
-        for (const uint32_t offset : offsets.data)
-        {
-            marker.set_to_offset(offset + ArchiveMemberHeader::HEADER_SIZE); // Skip the header, no need to read it.
-            marker.seek_to_marker(fs);
-            const uint16_t first_two_bytes = peek_value_from_stream<uint16_t>(fs);
+        const auto read_member_at = [&view](const uint32_t offset,
+                                            std::set<MachineType>& machine_types,
+                                            std::string& linker_directives) {
+            // Skip the archive member header, no need to read it.
+            const uint64_t member_position = offset + ArchiveMemberHeader::HEADER_SIZE;
+            const uint16_t first_two_bytes = view.read_value<uint16_t>(member_position);
             const bool isImportHeader = to_machine_type(first_two_bytes) == MachineType::UNKNOWN;
-            const MachineType machine =
-                isImportHeader ? ImportHeader::read(fs).machine_type() : CoffFileHeader::read(fs).machine_type();
-            machine_types.insert(machine);
+            if (isImportHeader)
+            {
+                machine_types.insert(ImportHeader::read(view, member_position).machine_type());
+                return;
+            }
+
+            const CoffFileHeader header = CoffFileHeader::read(view, member_position);
+            machine_types.insert(header.machine_type());
+
+            // Object members carry linker directives (/DEFAULTLIB and friends) in
+            // .drectve sections; raw data pointers are relative to the member start.
+            const uint64_t section_table_offset =
+                member_position + CoffFileHeader::HEADER_SIZE + header.size_of_optional_header();
+            const uint16_t section_count = header.number_of_sections();
+            for (uint16_t i = 0; i < section_count; ++i)
+            {
+                const SectionHeader section =
+                    SectionHeader::read(view, section_table_offset + uint64_t{i} * SectionHeader::HEADER_SIZE);
+                if (!section.has_name(".drectve"))
+                {
+                    continue;
+                }
+
+                const uint32_t raw_size = section.size_of_raw_data();
+                if (raw_size != 0)
+                {
+                    linker_directives.append(view.at(member_position + section.pointer_to_raw_data(), raw_size),
+                                             raw_size);
+                    linker_directives.push_back('\n');
+                }
+            }
+        };
+
+        std::set<MachineType> machine_types;
+        std::string linker_directives;
+
+        // Static libs from LTO builds can have tens of thousands of members. The member
+        // headers all live in the shared mapping, so workers can walk the offset table
+        // concurrently; each deduplicates locally and the sets are merged after the join.
+        static const size_t PARALLEL_MEMBER_THRESHOLD = 1024;
+        if (offsets.data.size() < PARALLEL_MEMBER_THRESHOLD)
+        {
+            for (const uint32_t offset : offsets.data)
+            {
+                read_member_at(offset, machine_types, linker_directives);
+            }
+        }
+        else
+        {
+            const size_t worker_count = Parallel::worker_count_for(offsets.data.size());
+            std::vector<std::set<MachineType>> types_per_worker(worker_count);
+            std::vector<std::string> directives_per_worker(worker_count);
+
+            Parallel::for_each_index_with_worker(
+                worker_count, offsets.data.size(), [&](const size_t i, const size_t worker) {
+                    read_member_at(offsets.data[i], types_per_worker[worker], directives_per_worker[worker]);
+                });
+
+            for (size_t worker = 0; worker < worker_count; ++worker)
+            {
+                machine_types.insert(types_per_worker[worker].cbegin(), types_per_worker[worker].cend());
+                linker_directives.append(directives_per_worker[worker]);
+            }
         }
 
-        return {std::vector<MachineType>(machine_types.cbegin(), machine_types.cend())};
+        LibInfo info;
+        info.machine_types.assign(machine_types.cbegin(), machine_types.cend());
+        info.linker_directives = std::move(linker_directives);
+        return info;
     }
 #else
     DllInfo read_dll(const fs::path& path) { exit(-1); }
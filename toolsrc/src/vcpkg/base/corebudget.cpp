@@ -0,0 +1,47 @@
+#include "pch.h"
+
+#include <vcpkg/base/corebudget.h>
+#include <vcpkg/base/strings.h>
+#include <vcpkg/base/system.h>
+
+namespace vcpkg::CoreBudget
+{
+    static size_t s_cores_per_build = 0;
+
+    void initialize(const size_t total_cores, const size_t scheduler_concurrency)
+    {
+        if (total_cores == 0 || scheduler_concurrency == 0) return;
+
+        s_cores_per_build = std::max<size_t>(1, total_cores / scheduler_concurrency);
+
+#if !defined(_WIN32)
+        // GNU make jobserver: each sub-make owns one implicit job and reads a token
+        // from the pipe for every additional one, so the pool is preloaded with the
+        // cores left over after each concurrent build's implicit job. The pipe fds are
+        // plain (non-CLOEXEC) and therefore inherited by the popen()ed builds.
+        int fds[2];
+        if (pipe(fds) != 0) return;
+
+        const size_t tokens =
+            total_cores > scheduler_concurrency ? total_cores - scheduler_concurrency : 0;
+        for (size_t i = 0; i < tokens; ++i)
+        {
+            const char token = '+';
+            if (write(fds[1], &token, 1) != 1) break;
+        }
+
+        // --jobserver-auth is the make 4.2+ spelling, --jobserver-fds the older one;
+        // make ignores the flag it does not know.
+        System::set_environment_variable(
+            "MAKEFLAGS",
+            Strings::format(
+                " -j --jobserver-auth=%d,%d --jobserver-fds=%d,%d", fds[0], fds[1], fds[0], fds[1]));
+#endif
+    }
+
+    size_t cores_per_build()
+    {
+        if (s_cores_per_build != 0) return s_cores_per_build;
+        return System::get_cpu_topology().effective_cores;
+    }
+}
@@ -0,0 +1,99 @@
+#include "pch.h"
+
+#include <vcpkg/base/checks.h>
+#include <vcpkg/base/filelock.h>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+namespace vcpkg::Files
+{
+#if defined(_WIN32)
+    static const intptr_t INVALID_LOCK_HANDLE = reinterpret_cast<intptr_t>(INVALID_HANDLE_VALUE);
+
+    static intptr_t take_lock(const fs::path& path, const DWORD flags)
+    {
+        const HANDLE handle = CreateFileW(path.c_str(),
+                                          GENERIC_READ | GENERIC_WRITE,
+                                          FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                          nullptr,
+                                          OPEN_ALWAYS,
+                                          FILE_ATTRIBUTE_NORMAL,
+                                          nullptr);
+        Checks::check_exit(
+            VCPKG_LINE_INFO, handle != INVALID_HANDLE_VALUE, "Failed to open lock file: %s", path.u8string());
+
+        OVERLAPPED overlapped = {0};
+        const BOOL locked = LockFileEx(handle, flags, 0, MAXDWORD, MAXDWORD, &overlapped);
+        Checks::check_exit(VCPKG_LINE_INFO, locked, "Failed to lock file: %s", path.u8string());
+
+        return reinterpret_cast<intptr_t>(handle);
+    }
+#else
+    static const intptr_t INVALID_LOCK_HANDLE = -1;
+
+    static intptr_t take_lock(const fs::path& path, const int operation)
+    {
+        const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+        Checks::check_exit(VCPKG_LINE_INFO, fd != -1, "Failed to open lock file: %s", path.u8string());
+
+        int rc;
+        do
+        {
+            rc = ::flock(fd, operation);
+        } while (rc == -1 && errno == EINTR);
+        Checks::check_exit(VCPKG_LINE_INFO, rc == 0, "Failed to lock file: %s", path.u8string());
+
+        return static_cast<intptr_t>(fd);
+    }
+#endif
+
+    FileLock FileLock::take_shared(const fs::path& path)
+    {
+#if defined(_WIN32)
+        return FileLock(take_lock(path, 0));
+#else
+        return FileLock(take_lock(path, LOCK_SH));
+#endif
+    }
+
+    FileLock FileLock::take_exclusive(const fs::path& path)
+    {
+#if defined(_WIN32)
+        return FileLock(take_lock(path, LOCKFILE_EXCLUSIVE_FLAG));
+#else
+        return FileLock(take_lock(path, LOCK_EX));
+#endif
+    }
+
+    FileLock::FileLock(FileLock&& other) : m_handle(other.m_handle) { other.m_handle = INVALID_LOCK_HANDLE; }
+
+    FileLock& FileLock::operator=(FileLock&& other)
+    {
+        if (this != &other)
+        {
+            this->~FileLock();
+            m_handle = other.m_handle;
+            other.m_handle = INVALID_LOCK_HANDLE;
+        }
+        return *this;
+    }
+
+    FileLock::~FileLock()
+    {
+        if (m_handle == INVALID_LOCK_HANDLE) return;
+#if defined(_WIN32)
+        const HANDLE handle = reinterpret_cast<HANDLE>(m_handle);
+        OVERLAPPED overlapped = {0};
+        UnlockFileEx(handle, 0, MAXDWORD, MAXDWORD, &overlapped);
+        CloseHandle(handle);
+#else
+        // Closing the descriptor releases the flock.
+        ::close(static_cast<int>(m_handle));
+#endif
+        m_handle = INVALID_LOCK_HANDLE;
+    }
+}
@@ -0,0 +1,318 @@
+#include "pch.h"
+
+#include <vcpkg/base/checks.h>
+#include <vcpkg/base/hash.h>
+#include <vcpkg/base/strings.h>
+
+namespace vcpkg::Hash
+{
+    template<class T>
+    static T rotr(T value, int bits)
+    {
+        return (value >> bits) | (value << (sizeof(T) * 8 - bits));
+    }
+
+    struct Sha256
+    {
+        using Word = uint32_t;
+        static constexpr size_t BLOCK_SIZE = 64;
+        static constexpr size_t DIGEST_WORDS = 8;
+        static constexpr size_t LENGTH_FIELD_SIZE = 8;
+
+        static constexpr Word INITIAL[8] = {0x6a09e667,
+                                            0xbb67ae85,
+                                            0x3c6ef372,
+                                            0xa54ff53a,
+                                            0x510e527f,
+                                            0x9b05688c,
+                                            0x1f83d9ab,
+                                            0x5be0cd19};
+
+        static void compress(Word (&state)[8], const unsigned char* block)
+        {
+            static constexpr Word K[64] = {
+                0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+                0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+                0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+                0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+                0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+                0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+                0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+                0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+            Word w[64];
+            for (int i = 0; i < 16; i++)
+            {
+                w[i] = (Word(block[i * 4]) << 24) | (Word(block[i * 4 + 1]) << 16) | (Word(block[i * 4 + 2]) << 8) |
+                       Word(block[i * 4 + 3]);
+            }
+            for (int i = 16; i < 64; i++)
+            {
+                const Word s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+                const Word s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+                w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+            }
+
+            Word a = state[0], b = state[1], c = state[2], d = state[3];
+            Word e = state[4], f = state[5], g = state[6], h = state[7];
+            for (int i = 0; i < 64; i++)
+            {
+                const Word s1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+                const Word ch = (e & f) ^ (~e & g);
+                const Word temp1 = h + s1 + ch + K[i] + w[i];
+                const Word s0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+                const Word maj = (a & b) ^ (a & c) ^ (b & c);
+                const Word temp2 = s0 + maj;
+
+                h = g;
+                g = f;
+                f = e;
+                e = d + temp1;
+                d = c;
+                c = b;
+                b = a;
+                a = temp1 + temp2;
+            }
+
+            state[0] += a;
+            state[1] += b;
+            state[2] += c;
+            state[3] += d;
+            state[4] += e;
+            state[5] += f;
+            state[6] += g;
+            state[7] += h;
+        }
+    };
+
+    struct Sha512
+    {
+        using Word = uint64_t;
+        static constexpr size_t BLOCK_SIZE = 128;
+        static constexpr size_t DIGEST_WORDS = 8;
+        static constexpr size_t LENGTH_FIELD_SIZE = 16;
+
+        static constexpr Word INITIAL[8] = {0x6a09e667f3bcc908ULL,
+                                            0xbb67ae8584caa73bULL,
+                                            0x3c6ef372fe94f82bULL,
+                                            0xa54ff53a5f1d36f1ULL,
+                                            0x510e527fade682d1ULL,
+                                            0x9b05688c2b3e6c1fULL,
+                                            0x1f83d9abfb41bd6bULL,
+                                            0x5be0cd19137e2179ULL};
+
+        static void compress(Word (&state)[8], const unsigned char* block)
+        {
+            static constexpr Word K[80] = {
+                0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
+                0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL, 0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
+                0xd807aa98a3030242ULL, 0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+                0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
+                0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL, 0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+                0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+                0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
+                0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL, 0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
+                0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+                0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+                0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL, 0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
+                0xd192e819d6ef5218ULL, 0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+                0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
+                0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL, 0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
+                0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+                0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
+                0xca273eceea26619cULL, 0xd186b8c721c0c207ULL, 0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
+                0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+                0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
+                0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL};
+
+            Word w[80];
+            for (int i = 0; i < 16; i++)
+            {
+                w[i] = 0;
+                for (int b = 0; b < 8; b++)
+                    w[i] = (w[i] << 8) | Word(block[i * 8 + b]);
+            }
+            for (int i = 16; i < 80; i++)
+            {
+                const Word s0 = rotr(w[i - 15], 1) ^ rotr(w[i - 15], 8) ^ (w[i - 15] >> 7);
+                const Word s1 = rotr(w[i - 2], 19) ^ rotr(w[i - 2], 61) ^ (w[i - 2] >> 6);
+                w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+            }
+
+            Word a = state[0], b = state[1], c = state[2], d = state[3];
+            Word e = state[4], f = state[5], g = state[6], h = state[7];
+            for (int i = 0; i < 80; i++)
+            {
+                const Word s1 = rotr(e, 14) ^ rotr(e, 18) ^ rotr(e, 41);
+                const Word ch = (e & f) ^ (~e & g);
+                const Word temp1 = h + s1 + ch + K[i] + w[i];
+                const Word s0 = rotr(a, 28) ^ rotr(a, 34) ^ rotr(a, 39);
+                const Word maj = (a & b) ^ (a & c) ^ (b & c);
+                const Word temp2 = s0 + maj;
+
+                h = g;
+                g = f;
+                f = e;
+                e = d + temp1;
+                d = c;
+                c = b;
+                b = a;
+                a = temp1 + temp2;
+            }
+
+            state[0] += a;
+            state[1] += b;
+            state[2] += c;
+            state[3] += d;
+            state[4] += e;
+            state[5] += f;
+            state[6] += g;
+            state[7] += h;
+        }
+    };
+
+    template<class Impl>
+    struct Hasher
+    {
+        typename Impl::Word state[8];
+        unsigned char buffer[Impl::BLOCK_SIZE];
+        size_t buffered = 0;
+        uint64_t total_length = 0;
+
+        Hasher() { memcpy(state, Impl::INITIAL, sizeof(state)); }
+
+        void update(const unsigned char* data, size_t size)
+        {
+            total_length += size;
+            while (size != 0)
+            {
+                const size_t to_copy = std::min(size, Impl::BLOCK_SIZE - buffered);
+                memcpy(buffer + buffered, data, to_copy);
+                buffered += to_copy;
+                data += to_copy;
+                size -= to_copy;
+                if (buffered == Impl::BLOCK_SIZE)
+                {
+                    Impl::compress(state, buffer);
+                    buffered = 0;
+                }
+            }
+        }
+
+        std::string finalize()
+        {
+            const uint64_t bit_length = total_length * 8;
+
+            buffer[buffered++] = 0x80;
+            if (buffered > Impl::BLOCK_SIZE - Impl::LENGTH_FIELD_SIZE)
+            {
+                memset(buffer + buffered, 0, Impl::BLOCK_SIZE - buffered);
+                Impl::compress(state, buffer);
+                buffered = 0;
+            }
+            memset(buffer + buffered, 0, Impl::BLOCK_SIZE - buffered);
+
+            // The SHA-2 length field is big-endian; the upper half of the SHA-512
+            // 128-bit length is always zero for our input sizes.
+            for (int i = 0; i < 8; i++)
+                buffer[Impl::BLOCK_SIZE - 1 - i] = static_cast<unsigned char>(bit_length >> (i * 8));
+            Impl::compress(state, buffer);
+
+            static constexpr char HEX[] = "0123456789abcdef";
+            std::string out;
+            out.reserve(Impl::DIGEST_WORDS * sizeof(typename Impl::Word) * 2);
+            for (size_t i = 0; i < Impl::DIGEST_WORDS; i++)
+            {
+                for (int b = sizeof(typename Impl::Word) - 1; b >= 0; b--)
+                {
+                    const unsigned char byte = static_cast<unsigned char>(state[i] >> (b * 8));
+                    out.push_back(HEX[byte >> 4]);
+                    out.push_back(HEX[byte & 0xF]);
+                }
+            }
+            return out;
+        }
+    };
+
+    template<class Impl>
+    static std::string hash_string(const std::string& data)
+    {
+        Hasher<Impl> hasher;
+        hasher.update(reinterpret_cast<const unsigned char*>(data.data()), data.size());
+        return hasher.finalize();
+    }
+
+    std::string get_string_hash(const std::string& data, const std::string& hash_type)
+    {
+        const std::string type = Strings::ascii_to_lowercase(hash_type);
+        if (type == "sha256") return hash_string<Sha256>(data);
+        if (type == "sha512") return hash_string<Sha512>(data);
+        Checks::exit_with_message(VCPKG_LINE_INFO, "Unsupported hash algorithm: %s", hash_type);
+    }
+
+    template<class Impl>
+    static Expected<std::string> hash_file(const fs::path& path)
+    {
+        std::fstream file_stream(path, std::ios_base::in | std::ios_base::binary);
+        if (file_stream.fail())
+        {
+            return std::make_error_code(std::errc::no_such_file_or_directory);
+        }
+
+        Hasher<Impl> hasher;
+        unsigned char buffer[64 * 1024];
+        for (;;)
+        {
+            file_stream.read(reinterpret_cast<char*>(buffer), sizeof(buffer));
+            const auto read = file_stream.gcount();
+            if (read > 0) hasher.update(buffer, static_cast<size_t>(read));
+            if (read < static_cast<std::streamsize>(sizeof(buffer))) break;
+        }
+
+        return hasher.finalize();
+    }
+
+    Expected<std::string> get_file_hash(const Files::Filesystem&, const fs::path& path, const std::string& hash_type)
+    {
+        const std::string type = Strings::ascii_to_lowercase(hash_type);
+        if (type == "sha256") return hash_file<Sha256>(path);
+        if (type == "sha512") return hash_file<Sha512>(path);
+        Checks::exit_with_message(VCPKG_LINE_INFO, "Unsupported hash algorithm: %s", hash_type);
+    }
+
+    // Holds both algorithm states so the type selection stays a run-time string like
+    // the rest of this interface; only the selected one is ever fed.
+    struct StreamingHasher::Impl
+    {
+        bool use_sha512;
+        Hasher<Sha256> sha256;
+        Hasher<Sha512> sha512;
+    };
+
+    StreamingHasher::StreamingHasher(const std::string& hash_type) : m_impl(std::make_unique<Impl>())
+    {
+        const std::string type = Strings::ascii_to_lowercase(hash_type);
+        if (type == "sha512")
+            m_impl->use_sha512 = true;
+        else if (type == "sha256")
+            m_impl->use_sha512 = false;
+        else
+            Checks::exit_with_message(VCPKG_LINE_INFO, "Unsupported hash algorithm: %s", hash_type);
+    }
+
+    StreamingHasher::~StreamingHasher() {}
+
+    void StreamingHasher::update(const void* data, const size_t size)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        if (m_impl->use_sha512)
+            m_impl->sha512.update(bytes, size);
+        else
+            m_impl->sha256.update(bytes, size);
+    }
+
+    std::string StreamingHasher::finalize()
+    {
+        return m_impl->use_sha512 ? m_impl->sha512.finalize() : m_impl->sha256.finalize();
+    }
+}
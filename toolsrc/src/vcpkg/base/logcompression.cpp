@@ -0,0 +1,227 @@
+#include "pch.h"
+
+#include <vcpkg/base/logcompression.h>
+
+namespace vcpkg::LogCompression
+{
+    // Layout: the 4-byte magic, then blocks of [raw size u32][payload size u32]
+    // [payload], both sizes little-endian. A payload as large as its raw size is
+    // stored verbatim (incompressible input never expands); anything smaller is an
+    // LZ77 token stream. Tokens are grouped under a control byte of 8 flags, low bit
+    // first: a clear bit is one literal byte, a set bit is a back-reference of
+    // [offset u16][length u8], offset 1..65535 bytes back and length 4..259
+    // (encoded minus 4). References never reach across block boundaries, so every
+    // block decodes independently.
+    static const char MAGIC[4] = {'V', 'L', 'Z', '1'};
+    static const size_t BLOCK_SIZE = 256 * 1024;
+    static const size_t MIN_MATCH = 4;
+    static const size_t MAX_MATCH = MIN_MATCH + 255;
+    static const size_t MAX_OFFSET = 65535;
+
+    bool is_compressed_log_path(const fs::path& path) { return path.extension() == FILE_EXTENSION; }
+
+    static void append_u32(std::string& out, const uint32_t value)
+    {
+        out.push_back(static_cast<char>(value & 0xFF));
+        out.push_back(static_cast<char>((value >> 8) & 0xFF));
+        out.push_back(static_cast<char>((value >> 16) & 0xFF));
+        out.push_back(static_cast<char>((value >> 24) & 0xFF));
+    }
+
+    static uint32_t read_u32(const unsigned char* p)
+    {
+        return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 | static_cast<uint32_t>(p[2]) << 16 |
+               static_cast<uint32_t>(p[3]) << 24;
+    }
+
+    static void compress_block(const unsigned char* data, const size_t size, std::string& out)
+    {
+        // Match candidates come from a positional hash of the next four bytes; one
+        // slot per hash keeps the lookup a single probe, which is plenty for log
+        // text where repeats are long and close together.
+        static const size_t HASH_BITS = 15;
+        std::vector<int32_t> table(size_t(1) << HASH_BITS, -1);
+        const auto hash4 = [&data](const size_t i) {
+            const uint32_t v = read_u32(data + i);
+            return (v * 2654435761u) >> (32 - HASH_BITS);
+        };
+
+        size_t control_index = SIZE_MAX;
+        unsigned char control = 0;
+        int control_bit = 8;
+
+        size_t i = 0;
+        while (i < size)
+        {
+            size_t match_len = 0;
+            size_t match_offset = 0;
+            if (i + MIN_MATCH <= size)
+            {
+                const uint32_t h = hash4(i);
+                const int32_t candidate = table[h];
+                table[h] = static_cast<int32_t>(i);
+                if (candidate >= 0 && i - candidate <= MAX_OFFSET)
+                {
+                    const unsigned char* a = data + i;
+                    const unsigned char* b = data + candidate;
+                    const size_t limit = std::min(size - i, MAX_MATCH);
+                    size_t len = 0;
+                    while (len < limit && a[len] == b[len])
+                        ++len;
+                    if (len >= MIN_MATCH)
+                    {
+                        match_len = len;
+                        match_offset = i - candidate;
+                    }
+                }
+            }
+
+            if (control_bit == 8)
+            {
+                if (control_index != SIZE_MAX) out[control_index] = static_cast<char>(control);
+                control_index = out.size();
+                out.push_back('\0');
+                control = 0;
+                control_bit = 0;
+            }
+
+            if (match_len != 0)
+            {
+                control |= static_cast<unsigned char>(1 << control_bit);
+                out.push_back(static_cast<char>(match_offset & 0xFF));
+                out.push_back(static_cast<char>(match_offset >> 8));
+                out.push_back(static_cast<char>(match_len - MIN_MATCH));
+                i += match_len;
+            }
+            else
+            {
+                out.push_back(static_cast<char>(data[i]));
+                ++i;
+            }
+            ++control_bit;
+        }
+        if (control_index != SIZE_MAX) out[control_index] = static_cast<char>(control);
+    }
+
+    static bool decompress_block(const unsigned char* in, const size_t in_size, const size_t raw_size, std::string& out)
+    {
+        const size_t base = out.size();
+        size_t i = 0;
+        while (out.size() - base < raw_size)
+        {
+            if (i >= in_size) return false;
+            const unsigned char control = in[i++];
+            for (int bit = 0; bit < 8 && out.size() - base < raw_size; ++bit)
+            {
+                if (control & (1 << bit))
+                {
+                    if (i + 3 > in_size) return false;
+                    const size_t offset = static_cast<size_t>(in[i]) | static_cast<size_t>(in[i + 1]) << 8;
+                    const size_t length = static_cast<size_t>(in[i + 2]) + MIN_MATCH;
+                    i += 3;
+                    if (offset == 0 || offset > out.size() - base) return false;
+                    // Overlapping copies are valid (a run is a self-referencing
+                    // match), so this must be byte-at-a-time.
+                    for (size_t k = 0; k < length; ++k)
+                        out.push_back(out[out.size() - offset]);
+                }
+                else
+                {
+                    if (i >= in_size) return false;
+                    out.push_back(static_cast<char>(in[i++]));
+                }
+            }
+        }
+        return i == in_size && out.size() - base == raw_size;
+    }
+
+    Compressor::Compressor(FILE* file) : m_file(file), m_compressed_bytes(sizeof(MAGIC)), m_finished(false)
+    {
+        m_pending.reserve(BLOCK_SIZE);
+        fwrite(MAGIC, 1, sizeof(MAGIC), m_file);
+    }
+
+    Compressor::~Compressor()
+    {
+        if (!m_finished) finish();
+    }
+
+    void Compressor::write(const char* data, size_t size)
+    {
+        while (size != 0)
+        {
+            const size_t take = std::min(size, BLOCK_SIZE - m_pending.size());
+            m_pending.append(data, take);
+            data += take;
+            size -= take;
+            if (m_pending.size() == BLOCK_SIZE)
+            {
+                flush_block(m_pending.data(), m_pending.size());
+                m_pending.clear();
+            }
+        }
+    }
+
+    void Compressor::flush_block(const char* data, const size_t size)
+    {
+        std::string block;
+        block.reserve(8 + size);
+        append_u32(block, static_cast<uint32_t>(size));
+        compress_block(reinterpret_cast<const unsigned char*>(data), size, block);
+        std::string header;
+        if (block.size() - 4 >= size)
+        {
+            // Incompressible; store verbatim. Signalled by payload size == raw size.
+            block.resize(4);
+            block.append(data, size);
+            append_u32(header, static_cast<uint32_t>(size));
+        }
+        else
+        {
+            append_u32(header, static_cast<uint32_t>(block.size() - 4));
+        }
+        fwrite(block.data(), 1, 4, m_file);
+        fwrite(header.data(), 1, 4, m_file);
+        fwrite(block.data() + 4, 1, block.size() - 4, m_file);
+        m_compressed_bytes += 4 + block.size();
+    }
+
+    uint64_t Compressor::finish()
+    {
+        if (!m_finished)
+        {
+            if (!m_pending.empty()) flush_block(m_pending.data(), m_pending.size());
+            m_pending.clear();
+            m_finished = true;
+        }
+        return m_compressed_bytes;
+    }
+
+    Optional<std::string> decompress(const std::string& compressed)
+    {
+        if (compressed.size() < sizeof(MAGIC) || memcmp(compressed.data(), MAGIC, sizeof(MAGIC)) != 0) return nullopt;
+
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(compressed.data());
+        const size_t total = compressed.size();
+        size_t pos = sizeof(MAGIC);
+        std::string out;
+        while (pos < total)
+        {
+            if (pos + 8 > total) return nullopt;
+            const size_t raw_size = read_u32(p + pos);
+            const size_t payload_size = read_u32(p + pos + 4);
+            pos += 8;
+            if (payload_size > total - pos) return nullopt;
+            if (payload_size == raw_size)
+            {
+                out.append(compressed, pos, payload_size);
+            }
+            else if (!decompress_block(p + pos, payload_size, raw_size, out))
+            {
+                return nullopt;
+            }
+            pos += payload_size;
+        }
+        return out;
+    }
+}
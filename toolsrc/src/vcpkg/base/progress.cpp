@@ -0,0 +1,183 @@
+#include "pch.h"
+
+#include <vcpkg/base/chrono.h>
+#include <vcpkg/base/progress.h>
+#include <vcpkg/base/strings.h>
+#include <vcpkg/base/util.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace vcpkg::Progress
+{
+    namespace
+    {
+        struct Task
+        {
+            size_t id;
+            std::string name;
+            std::string phase;
+            Chrono::ElapsedTimer timer;
+        };
+
+        struct Engine
+        {
+            std::mutex mtx;
+            std::condition_variable cv;
+            std::vector<Task> tasks;
+            size_t next_id = 0;
+            bool stop = false;
+            bool thread_started = false;
+            size_t last_render_size = 0;
+            std::thread render_thread;
+        };
+
+        Engine& engine()
+        {
+            static Engine e;
+            return e;
+        }
+
+        bool stderr_is_terminal()
+        {
+#if defined(_WIN32)
+            static const bool is_tty = _isatty(_fileno(stderr)) != 0;
+#else
+            static const bool is_tty = isatty(fileno(stderr)) != 0;
+#endif
+            return is_tty;
+        }
+
+        // Refresh rate of the status line. Redrawing at most four times a second keeps
+        // the elapsed readouts live without measurable terminal traffic, regardless of
+        // how often the workers change state.
+        const std::chrono::milliseconds RENDER_INTERVAL{250};
+
+        const size_t MAX_LINE_SIZE = 118;
+
+        std::string compose_line(const std::vector<Task>& tasks)
+        {
+            std::string line = Strings::format("[%d active]", static_cast<int>(tasks.size()));
+            for (const Task& task : tasks)
+            {
+                line += Strings::format(
+                    " %s (%s, %.1f s)", task.name, task.phase, task.timer.microseconds() / 1000000.0);
+            }
+            if (line.size() > MAX_LINE_SIZE)
+            {
+                line.resize(MAX_LINE_SIZE - 3);
+                line += "...";
+            }
+            return line;
+        }
+
+        // Both render helpers assume the engine lock is held.
+        void erase_line(Engine& e)
+        {
+            if (e.last_render_size == 0) return;
+            std::string wipe = "\r";
+            wipe.append(e.last_render_size, ' ');
+            wipe.push_back('\r');
+            fwrite(wipe.data(), 1, wipe.size(), stderr);
+            fflush(stderr);
+            e.last_render_size = 0;
+        }
+
+        void render(Engine& e)
+        {
+            const std::string line = compose_line(e.tasks);
+            std::string out = "\r";
+            out += line;
+            if (line.size() < e.last_render_size)
+            {
+                out.append(e.last_render_size - line.size(), ' ');
+            }
+            fwrite(out.data(), 1, out.size(), stderr);
+            fflush(stderr);
+            e.last_render_size = line.size();
+        }
+
+        void render_loop()
+        {
+            Engine& e = engine();
+            std::unique_lock<std::mutex> lock(e.mtx);
+            for (;;)
+            {
+                e.cv.wait_for(lock, RENDER_INTERVAL, [&] { return e.stop; });
+                if (e.stop)
+                {
+                    erase_line(e);
+                    return;
+                }
+
+                if (e.tasks.empty())
+                    erase_line(e);
+                else
+                    render(e);
+            }
+        }
+    }
+
+    TaskScope::TaskScope(std::string name)
+    {
+        Engine& e = engine();
+        std::lock_guard<std::mutex> lock(e.mtx);
+        this->m_id = ++e.next_id;
+
+        Task task;
+        task.id = this->m_id;
+        task.name = std::move(name);
+        task.phase = "start";
+        task.timer = Chrono::ElapsedTimer::create_started();
+        e.tasks.push_back(std::move(task));
+
+        if (stderr_is_terminal() && !e.thread_started)
+        {
+            e.thread_started = true;
+            e.render_thread = std::thread(render_loop);
+        }
+    }
+
+    TaskScope::~TaskScope()
+    {
+        Engine& e = engine();
+        std::lock_guard<std::mutex> lock(e.mtx);
+        Util::erase_remove_if(e.tasks, [this](const Task& task) { return task.id == this->m_id; });
+    }
+
+    void TaskScope::set_phase(std::string phase)
+    {
+        Engine& e = engine();
+        std::lock_guard<std::mutex> lock(e.mtx);
+        for (Task& task : e.tasks)
+        {
+            if (task.id == this->m_id)
+            {
+                task.phase = std::move(phase);
+                return;
+            }
+        }
+    }
+
+    void shutdown()
+    {
+        Engine& e = engine();
+        std::thread to_join;
+        {
+            std::lock_guard<std::mutex> lock(e.mtx);
+            if (!e.thread_started) return;
+            e.stop = true;
+            e.cv.notify_all();
+            to_join = std::move(e.render_thread);
+            e.thread_started = false;
+        }
+        if (to_join.joinable()) to_join.join();
+    }
+}
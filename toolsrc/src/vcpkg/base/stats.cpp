@@ -0,0 +1,51 @@
+#include "pch.h"
+
+#include <vcpkg/base/stats.h>
+#include <vcpkg/base/strings.h>
+#include <vcpkg/base/system.h>
+
+namespace vcpkg::Stats
+{
+    static std::atomic<bool> g_enabled(false);
+
+    void enable() { g_enabled = true; }
+    bool enabled() { return g_enabled; }
+
+    Counters& get()
+    {
+        static Counters counters;
+        return counters;
+    }
+
+    std::string to_json()
+    {
+        const Counters& c = get();
+        std::string json = "{";
+        const auto append = [&json](const char* name, const RelaxedCounter& counter) {
+            if (json.size() > 1) json.push_back(',');
+            json.append(
+                Strings::format(R"("%s":%llu)", name, static_cast<unsigned long long>(counter.load())));
+        };
+
+        append("ports_loaded", c.ports_loaded);
+        append("ports_load_us", c.ports_load_us);
+        append("binary_cache_hits", c.binary_cache_hits);
+        append("binary_cache_misses", c.binary_cache_misses);
+        append("control_cache_hits", c.control_cache_hits);
+        append("control_cache_misses", c.control_cache_misses);
+        append("files_read", c.files_read);
+        append("bytes_read", c.bytes_read);
+        append("files_written", c.files_written);
+        append("bytes_written", c.bytes_written);
+        append("processes_spawned", c.processes_spawned);
+
+        json.push_back('}');
+        return json;
+    }
+
+    void report()
+    {
+        if (!g_enabled) return;
+        System::println("%s", to_json());
+    }
+}
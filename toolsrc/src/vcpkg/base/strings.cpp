@@ -4,13 +4,25 @@
 #include <vcpkg/base/strings.h>
 #include <vcpkg/base/util.h>
 
+#if defined(_WIN32) && (defined(_M_X64) || defined(_M_IX86))
+#include <emmintrin.h>
+#define VCPKG_TRANSCODE_SSE2 1
+#else
+#define VCPKG_TRANSCODE_SSE2 0
+#endif
+
 namespace vcpkg::Strings::details
 {
     // To disambiguate between two overloads
     static const auto isspace = [](const char c) { return std::isspace(c); };
 
-    // Avoids C4244 warnings because of char<->int conversion that occur when using std::tolower()
-    static char tolower_char(const char c) { return static_cast<char>(std::tolower(c)); }
+    // Branch-free, locale-free ASCII lowering: adds 0x20 exactly when c is in
+    // ['A','Z']. Written without branches so compilers vectorize the byte loops that
+    // use it.
+    static char tolower_char(const char c)
+    {
+        return static_cast<char>(c + ((static_cast<unsigned char>(c - 'A') < 26) << 5));
+    }
 
 #if defined(_WIN32)
     static _locale_t& c_locale()
@@ -20,41 +32,171 @@ namespace vcpkg::Strings::details
     }
 #endif
 
-    std::string format_internal(const char* fmtstr, ...)
+    // Formats in a single pass for the common case: most output lines fit the stack
+    // buffer, so the separate sizing pass only runs when the result is long.
+    static void append_format(std::string& output, const char* fmtstr, va_list args)
     {
-        va_list args;
-        va_start(args, fmtstr);
+        char stack_buffer[512];
 
+        va_list args_copy;
+        va_copy(args_copy, args);
 #if defined(_WIN32)
-        const int sz = _vscprintf_l(fmtstr, c_locale(), args);
+        const int sz = _vsnprintf_s_l(stack_buffer, sizeof(stack_buffer), _TRUNCATE, fmtstr, c_locale(), args_copy);
 #else
-        const int sz = vsnprintf(nullptr, 0, fmtstr, args);
+        const int sz = vsnprintf(stack_buffer, sizeof(stack_buffer), fmtstr, args_copy);
 #endif
-        Checks::check_exit(VCPKG_LINE_INFO, sz > 0);
+        va_end(args_copy);
 
-        std::string output(sz, '\0');
+        if (sz >= 0 && sz < static_cast<int>(sizeof(stack_buffer)))
+        {
+            output.append(stack_buffer, sz);
+            return;
+        }
 
 #if defined(_WIN32)
-        _vsnprintf_s_l(&output.at(0), output.size() + 1, output.size(), fmtstr, c_locale(), args);
+        const int required = _vscprintf_l(fmtstr, c_locale(), args);
 #else
-        va_start(args, fmtstr);
-        auto res = vsnprintf(&output.at(0), output.size() + 1, fmtstr, args);
+        // vsnprintf already reported the required size above.
+        const int required = sz;
+#endif
+        Checks::check_exit(VCPKG_LINE_INFO, required > 0);
+
+        const size_t offset = output.size();
+        output.resize(offset + required);
+#if defined(_WIN32)
+        _vsnprintf_s_l(&output.at(offset), required + 1, required, fmtstr, c_locale(), args);
+#else
+        vsnprintf(&output.at(offset), required + 1, fmtstr, args);
 #endif
+    }
+
+    std::string format_internal(const char* fmtstr, ...)
+    {
+        std::string output;
+
+        va_list args;
+        va_start(args, fmtstr);
+        append_format(output, fmtstr, args);
         va_end(args);
 
         return output;
     }
+
+    void format_internal_to(std::string& output, const char* fmtstr, ...)
+    {
+        va_list args;
+        va_start(args, fmtstr);
+        append_format(output, fmtstr, args);
+        va_end(args);
+    }
 }
 
 namespace vcpkg::Strings
 {
+#if defined(_WIN32)
+    // Appends the longest all-ASCII prefix of [data, data + size) zero-extended to
+    // UTF-16 and returns its length. SSE2 checks sixteen bytes per iteration with a
+    // sign-bit movemask and unpacks clean blocks directly; the scalar tail also
+    // stops at the first non-ASCII byte.
+    static size_t append_ascii_prefix_widened(const char* data, const size_t size, std::wstring& output)
+    {
+        size_t i = 0;
+#if VCPKG_TRANSCODE_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        while (i + 16 <= size)
+        {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            if (_mm_movemask_epi8(chunk) != 0) break;
+            alignas(16) wchar_t widened[16];
+            _mm_store_si128(reinterpret_cast<__m128i*>(widened), _mm_unpacklo_epi8(chunk, zero));
+            _mm_store_si128(reinterpret_cast<__m128i*>(widened + 8), _mm_unpackhi_epi8(chunk, zero));
+            output.append(widened, 16);
+            i += 16;
+        }
+#endif
+        while (i < size && static_cast<unsigned char>(data[i]) < 0x80)
+        {
+            output.push_back(static_cast<wchar_t>(static_cast<unsigned char>(data[i])));
+            ++i;
+        }
+        return i;
+    }
+
+    // The narrowing counterpart: packs UTF-16 blocks whose units are all below 0x80
+    // down to bytes and returns the length of the ASCII prefix consumed.
+    static size_t append_ascii_prefix_narrowed(const wchar_t* data, const size_t size, std::string& output)
+    {
+        size_t i = 0;
+#if VCPKG_TRANSCODE_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i non_ascii_bits = _mm_set1_epi16(static_cast<short>(0xFF80));
+        while (i + 16 <= size)
+        {
+            const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 8));
+            const __m128i set_bits = _mm_and_si128(_mm_or_si128(lo, hi), non_ascii_bits);
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(set_bits, zero)) != 0xFFFF) break;
+            alignas(16) char narrowed[16];
+            _mm_store_si128(reinterpret_cast<__m128i*>(narrowed), _mm_packus_epi16(lo, hi));
+            output.append(narrowed, 16);
+            i += 16;
+        }
+#endif
+        while (i < size && data[i] < 0x80)
+        {
+            output.push_back(static_cast<char>(data[i]));
+            ++i;
+        }
+        return i;
+    }
+#endif
+
+    void to_utf16_append(const CStringView& s, std::wstring& output)
+    {
+#if defined(_WIN32)
+        const char* const data = s.c_str();
+        const size_t size = strlen(data);
+        const size_t ascii_prefix = append_ascii_prefix_widened(data, size, output);
+        if (ascii_prefix == size) return;
+
+        const int remaining = static_cast<int>(size - ascii_prefix);
+        const int count = MultiByteToWideChar(CP_UTF8, 0, data + ascii_prefix, remaining, nullptr, 0);
+        const size_t old_size = output.size();
+        output.resize(old_size + count);
+        MultiByteToWideChar(CP_UTF8, 0, data + ascii_prefix, remaining, &output[old_size], count);
+#else
+        (void)s;
+        (void)output;
+        Checks::unreachable(VCPKG_LINE_INFO);
+#endif
+    }
+
+    void to_utf8_append(const CWStringView& w, std::string& output)
+    {
+#if defined(_WIN32)
+        const wchar_t* const data = w.c_str();
+        const size_t size = wcslen(data);
+        const size_t ascii_prefix = append_ascii_prefix_narrowed(data, size, output);
+        if (ascii_prefix == size) return;
+
+        const int remaining = static_cast<int>(size - ascii_prefix);
+        const int count =
+            WideCharToMultiByte(CP_UTF8, 0, data + ascii_prefix, remaining, nullptr, 0, nullptr, nullptr);
+        const size_t old_size = output.size();
+        output.resize(old_size + count);
+        WideCharToMultiByte(CP_UTF8, 0, data + ascii_prefix, remaining, &output[old_size], count, nullptr, nullptr);
+#else
+        (void)w;
+        (void)output;
+        Checks::unreachable(VCPKG_LINE_INFO);
+#endif
+    }
+
     std::wstring to_utf16(const CStringView& s)
     {
 #if defined(_WIN32)
-        const int size = MultiByteToWideChar(CP_UTF8, 0, s.c_str(), -1, nullptr, 0);
         std::wstring output;
-        output.resize(size - 1);
-        MultiByteToWideChar(CP_UTF8, 0, s.c_str(), -1, output.data(), size - 1);
+        to_utf16_append(s, output);
         return output;
 #else
         Checks::unreachable(VCPKG_LINE_INFO);
@@ -64,10 +206,8 @@ namespace vcpkg::Strings
     std::string to_utf8(const CWStringView& w)
     {
 #if defined(_WIN32)
-        const int size = WideCharToMultiByte(CP_UTF8, 0, w.c_str(), -1, nullptr, 0, nullptr, nullptr);
         std::string output;
-        output.resize(size - 1);
-        WideCharToMultiByte(CP_UTF8, 0, w.c_str(), -1, output.data(), size - 1, nullptr, nullptr);
+        to_utf8_append(w, output);
         return output;
 #else
         Checks::unreachable(VCPKG_LINE_INFO);
@@ -89,13 +229,30 @@ namespace vcpkg::Strings
         return case_insensitive_ascii_find(s, pattern) != s.end();
     }
 
-    bool case_insensitive_ascii_equals(const CStringView left, const CStringView right)
+    bool case_insensitive_ascii_equals(const StringView left, const StringView right)
     {
-#if defined(_WIN32)
-        return _stricmp(left.c_str(), right.c_str()) == 0;
-#else
-        return strcasecmp(left.c_str(), right.c_str()) == 0;
-#endif
+        if (left.size() != right.size()) return false;
+        const char* l = left.data();
+        const char* r = right.data();
+        for (const char* const l_end = l + left.size(); l != l_end; ++l, ++r)
+        {
+            if (details::tolower_char(*l) != details::tolower_char(*r)) return false;
+        }
+        return true;
+    }
+
+    int case_insensitive_ascii_compare(const StringView left, const StringView right)
+    {
+        const size_t common = left.size() < right.size() ? left.size() : right.size();
+        for (size_t i = 0; i < common; ++i)
+        {
+            const int diff = static_cast<unsigned char>(details::tolower_char(left.data()[i])) -
+                             static_cast<unsigned char>(details::tolower_char(right.data()[i]));
+            if (diff != 0) return diff;
+        }
+        if (left.size() < right.size()) return -1;
+        if (left.size() > right.size()) return 1;
+        return 0;
     }
 
     std::string ascii_to_lowercase(const std::string& input)
@@ -107,11 +264,97 @@ namespace vcpkg::Strings
 
     bool case_insensitive_ascii_starts_with(const std::string& s, const std::string& pattern)
     {
-#if defined(_WIN32)
-        return _strnicmp(s.c_str(), pattern.c_str(), pattern.size()) == 0;
-#else
-        return strncasecmp(s.c_str(), pattern.c_str(), pattern.size()) == 0;
-#endif
+        if (s.size() < pattern.size()) return false;
+        for (size_t i = 0; i < pattern.size(); ++i)
+        {
+            if (details::tolower_char(s[i]) != details::tolower_char(pattern[i])) return false;
+        }
+        return true;
+    }
+
+    size_t case_insensitive_ascii_hash(const std::string& s)
+    {
+        // FNV-1a over the lowercased bytes; pairs with case_insensitive_ascii_equals
+        // for case-insensitive hashed containers.
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (const char c : s)
+        {
+            hash ^= static_cast<unsigned char>(details::tolower_char(c));
+            hash *= 0x100000001b3ULL;
+        }
+        return static_cast<size_t>(hash);
+    }
+
+    MultiPatternMatcher::MultiPatternMatcher(const std::vector<std::string>& patterns)
+    {
+        m_transitions.push_back({});
+        m_first_pattern.push_back(SIZE_MAX);
+
+        // Build a trie over the lowercased pattern bytes; 0 marks a missing transition
+        // (the root cannot be a child, so there is no ambiguity during construction).
+        for (size_t pattern_index = 0; pattern_index < patterns.size(); ++pattern_index)
+        {
+            int node = 0;
+            for (const char c : patterns[pattern_index])
+            {
+                const unsigned char b = static_cast<unsigned char>(details::tolower_char(c));
+                if (m_transitions[node][b] == 0)
+                {
+                    m_transitions[node][b] = static_cast<int>(m_transitions.size());
+                    m_transitions.push_back({});
+                    m_first_pattern.push_back(SIZE_MAX);
+                }
+                node = m_transitions[node][b];
+            }
+            m_first_pattern[node] = std::min(m_first_pattern[node], pattern_index);
+        }
+
+        // Breadth-first conversion into a full automaton: missing transitions are filled
+        // in from the suffix link, and each node inherits the best pattern ending in any
+        // suffix of its path.
+        std::vector<int> suffix(m_transitions.size(), 0);
+        std::vector<int> bfs_order;
+        for (size_t b = 0; b < 256; ++b)
+        {
+            const int child = m_transitions[0][b];
+            if (child != 0) bfs_order.push_back(child);
+        }
+        for (size_t i = 0; i < bfs_order.size(); ++i)
+        {
+            const int node = bfs_order[i];
+            m_first_pattern[node] = std::min(m_first_pattern[node], m_first_pattern[suffix[node]]);
+            for (size_t b = 0; b < 256; ++b)
+            {
+                const int child = m_transitions[node][b];
+                if (child != 0)
+                {
+                    suffix[child] = m_transitions[suffix[node]][b];
+                    bfs_order.push_back(child);
+                }
+                else
+                {
+                    m_transitions[node][b] = m_transitions[suffix[node]][b];
+                }
+            }
+        }
+    }
+
+    Optional<size_t> MultiPatternMatcher::first_match(const std::string& input) const
+    {
+        int node = 0;
+        size_t best = SIZE_MAX;
+        for (const char c : input)
+        {
+            node = m_transitions[node][static_cast<unsigned char>(details::tolower_char(c))];
+            if (m_first_pattern[node] < best)
+            {
+                best = m_first_pattern[node];
+                if (best == 0) break;
+            }
+        }
+
+        if (best == SIZE_MAX) return nullopt;
+        return best;
     }
 
     std::string replace_all(std::string&& s, const std::string& search, const std::string& rep)
@@ -142,6 +385,57 @@ namespace vcpkg::Strings
         Util::erase_remove_if(*strings, [](const std::string& s) { return s.empty(); });
     }
 
+    std::string collapse_whitespace(const std::string& input)
+    {
+        std::string output;
+        output.reserve(input.size());
+        size_t i = 0;
+        while (i < input.size())
+        {
+            if (std::isspace(static_cast<unsigned char>(input[i])))
+            {
+                output.push_back(' ');
+                while (i < input.size() && std::isspace(static_cast<unsigned char>(input[i])))
+                    ++i;
+            }
+            else
+            {
+                output.push_back(input[i++]);
+            }
+        }
+        return output;
+    }
+
+    void find_cmake_library_names(const std::string& contents, std::vector<std::string>& out)
+    {
+        static const char NEEDLE[] = "add_library(";
+        const size_t needle_size = sizeof(NEEDLE) - 1;
+
+        const auto is_word_char = [](const char c) {
+            return std::isalnum(static_cast<unsigned char>(c)) != 0 || c == '_';
+        };
+
+        size_t pos = contents.find(NEEDLE);
+        while (pos != std::string::npos)
+        {
+            const size_t name_begin = pos + needle_size;
+            // Not a match in the middle of a longer identifier (e.g. my_add_library().
+            if (pos == 0 || !is_word_char(contents[pos - 1]))
+            {
+                size_t name_end = name_begin;
+                while (name_end < contents.size() &&
+                       !std::isspace(static_cast<unsigned char>(contents[name_end])) && contents[name_end] != ')')
+                    ++name_end;
+                if (name_end > name_begin && name_end < contents.size() &&
+                    std::isspace(static_cast<unsigned char>(contents[name_end])))
+                {
+                    out.push_back(contents.substr(name_begin, name_end - name_begin));
+                }
+            }
+            pos = contents.find(NEEDLE, name_begin);
+        }
+    }
+
     std::vector<std::string> split(const std::string& s, const std::string& delimiter)
     {
         std::vector<std::string> output;
@@ -1,6 +1,9 @@
 #include "pch.h"
 
 #include <vcpkg/base/checks.h>
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/logcompression.h>
+#include <vcpkg/base/stats.h>
 #include <vcpkg/base/system.h>
 #include <vcpkg/globalstate.h>
 #include <vcpkg/metrics.h>
@@ -68,6 +71,144 @@ namespace vcpkg::System
 #endif
     }
 
+    long long get_physical_memory_bytes()
+    {
+#if defined(_WIN32)
+        MEMORYSTATUSEX status;
+        memset(&status, 0, sizeof(status));
+        status.dwLength = sizeof(status);
+        if (!GlobalMemoryStatusEx(&status)) return 0;
+        return static_cast<long long>(status.ullTotalPhys);
+#else
+        const long pages = sysconf(_SC_PHYS_PAGES);
+        const long page_size = sysconf(_SC_PAGE_SIZE);
+        if (pages <= 0 || page_size <= 0) return 0;
+        return static_cast<long long>(pages) * static_cast<long long>(page_size);
+#endif
+    }
+
+    long long get_available_memory_bytes()
+    {
+#if defined(_WIN32)
+        MEMORYSTATUSEX status;
+        memset(&status, 0, sizeof(status));
+        status.dwLength = sizeof(status);
+        if (!GlobalMemoryStatusEx(&status)) return 0;
+        return static_cast<long long>(status.ullAvailPhys);
+#else
+        std::ifstream meminfo("/proc/meminfo");
+        std::string label;
+        long long kb = 0;
+        while (meminfo >> label >> kb)
+        {
+            if (label == "MemAvailable:") return kb * 1024;
+            meminfo.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        }
+        return 0;
+#endif
+    }
+
+    static CPUTopology detect_cpu_topology()
+    {
+        CPUTopology topology;
+        topology.logical_cores = std::max<size_t>(1, std::thread::hardware_concurrency());
+        topology.physical_cores = topology.logical_cores;
+        topology.effective_cores = topology.logical_cores;
+
+#if defined(_WIN32)
+        // Count physical cores from the processor relation records.
+        DWORD length = 0;
+        GetLogicalProcessorInformation(nullptr, &length);
+        if (GetLastError() == ERROR_INSUFFICIENT_BUFFER && length != 0)
+        {
+            std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> records(length /
+                                                                      sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+            if (GetLogicalProcessorInformation(records.data(), &length))
+            {
+                size_t cores = 0;
+                for (const auto& record : records)
+                    if (record.Relationship == RelationProcessorCore) ++cores;
+                if (cores != 0) topology.physical_cores = cores;
+            }
+        }
+
+        // A job-object CPU rate cap (10000 = one full core's worth) limits what this
+        // process tree may use regardless of the host's core count.
+        JOBOBJECT_CPU_RATE_CONTROL_INFORMATION rate_info;
+        memset(&rate_info, 0, sizeof(rate_info));
+        if (QueryInformationJobObject(
+                nullptr, JobObjectCpuRateControlInformation, &rate_info, sizeof(rate_info), nullptr) &&
+            (rate_info.ControlFlags & JOB_OBJECT_CPU_RATE_CONTROL_ENABLE) &&
+            (rate_info.ControlFlags & JOB_OBJECT_CPU_RATE_CONTROL_HARD_CAP) && rate_info.CpuRate != 0)
+        {
+            const size_t quota_cores =
+                std::max<size_t>(1, topology.logical_cores * rate_info.CpuRate / 10000);
+            topology.effective_cores = std::min(topology.effective_cores, quota_cores);
+        }
+#else
+        // Physical cores: distinct (physical id, core id) pairs from /proc/cpuinfo.
+        {
+            std::ifstream cpuinfo("/proc/cpuinfo");
+            std::string line;
+            std::set<std::pair<long, long>> cores;
+            long physical_id = 0;
+            for (; std::getline(cpuinfo, line);)
+            {
+                if (line.compare(0, 11, "physical id") == 0)
+                    physical_id = std::strtol(line.c_str() + line.find(':') + 1, nullptr, 10);
+                else if (line.compare(0, 7, "core id") == 0)
+                    cores.emplace(physical_id, std::strtol(line.c_str() + line.find(':') + 1, nullptr, 10));
+            }
+            if (!cores.empty()) topology.physical_cores = cores.size();
+        }
+
+        // Affinity mask: containers pinned to a cpuset see fewer usable CPUs than the
+        // host reports.
+        {
+            cpu_set_t affinity;
+            CPU_ZERO(&affinity);
+            if (sched_getaffinity(0, sizeof(affinity), &affinity) == 0)
+            {
+                const size_t usable = static_cast<size_t>(CPU_COUNT(&affinity));
+                if (usable != 0) topology.effective_cores = std::min(topology.effective_cores, usable);
+            }
+        }
+
+        // cgroup CPU quota (v2 then v1): quota/period rounded up is the core budget a
+        // capped container can actually burn.
+        {
+            long long quota = -1;
+            long long period = -1;
+            std::ifstream v2("/sys/fs/cgroup/cpu.max");
+            std::string quota_text;
+            if (v2 >> quota_text >> period)
+            {
+                if (quota_text != "max") quota = std::strtoll(quota_text.c_str(), nullptr, 10);
+            }
+            else
+            {
+                std::ifstream v1_quota("/sys/fs/cgroup/cpu/cpu.cfs_quota_us");
+                std::ifstream v1_period("/sys/fs/cgroup/cpu/cpu.cfs_period_us");
+                v1_quota >> quota;
+                v1_period >> period;
+            }
+
+            if (quota > 0 && period > 0)
+            {
+                const size_t quota_cores = static_cast<size_t>(std::max<long long>(1, (quota + period - 1) / period));
+                topology.effective_cores = std::min(topology.effective_cores, quota_cores);
+            }
+        }
+#endif
+        return topology;
+    }
+
+    const CPUTopology& get_cpu_topology()
+    {
+        static const CPUTopology topology = detect_cpu_topology();
+        return topology;
+    }
+
     std::vector<CPUArchitecture> get_supported_host_architectures()
     {
         std::vector<CPUArchitecture> supported_architectures;
@@ -129,81 +270,95 @@ namespace vcpkg::System
             R"(powershell -NoProfile -ExecutionPolicy Bypass -Command "& {& '%s' %s}")", script_path.u8string(), args);
     }
 
-    int cmd_execute_clean(const CStringView cmd_line)
-    {
 #if defined(_WIN32)
-        static const std::string SYSTEM_ROOT = get_environment_variable("SystemRoot").value_or_exit(VCPKG_LINE_INFO);
-        static const std::string SYSTEM_32 = SYSTEM_ROOT + R"(\system32)";
-        static const std::string NEW_PATH = Strings::format(
-            R"(Path=%s;%s;%s\Wbem;%s\WindowsPowerShell\v1.0\)", SYSTEM_32, SYSTEM_ROOT, SYSTEM_32, SYSTEM_32);
-
-        std::vector<std::wstring> env_wstrings = {
-            L"ALLUSERSPROFILE",
-            L"APPDATA",
-            L"CommonProgramFiles",
-            L"CommonProgramFiles(x86)",
-            L"CommonProgramW6432",
-            L"COMPUTERNAME",
-            L"ComSpec",
-            L"HOMEDRIVE",
-            L"HOMEPATH",
-            L"LOCALAPPDATA",
-            L"LOGONSERVER",
-            L"NUMBER_OF_PROCESSORS",
-            L"OS",
-            L"PATHEXT",
-            L"PROCESSOR_ARCHITECTURE",
-            L"PROCESSOR_ARCHITEW6432",
-            L"PROCESSOR_IDENTIFIER",
-            L"PROCESSOR_LEVEL",
-            L"PROCESSOR_REVISION",
-            L"ProgramData",
-            L"ProgramFiles",
-            L"ProgramFiles(x86)",
-            L"ProgramW6432",
-            L"PROMPT",
-            L"PSModulePath",
-            L"PUBLIC",
-            L"SystemDrive",
-            L"SystemRoot",
-            L"TEMP",
-            L"TMP",
-            L"USERDNSDOMAIN",
-            L"USERDOMAIN",
-            L"USERDOMAIN_ROAMINGPROFILE",
-            L"USERNAME",
-            L"USERPROFILE",
-            L"windir",
-            // Enables proxy information to be passed to Curl, the underlying download library in cmake.exe
-            L"HTTP_PROXY",
-            L"HTTPS_PROXY",
-            // Enables find_package(CUDA) in CMake
-            L"CUDA_PATH",
-            // Environmental variable generated automatically by CUDA after installation
-            L"NVCUDASAMPLES_ROOT",
-        };
-
-        // Flush stdout before launching external process
-        fflush(nullptr);
-
-        std::wstring env_cstr;
-
-        for (auto&& env_wstring : env_wstrings)
-        {
-            const Optional<std::string> value = System::get_environment_variable(Strings::to_utf8(env_wstring));
-            const auto v = value.get();
-            if (!v || v->empty()) continue;
+    // Composes the clean environment block passed to CreateProcessW. This is built once
+    // per process and reused across launches; the ~40 environment lookups and UTF-16
+    // conversions are not worth repeating for every spawned process.
+    static const std::wstring& get_clean_environment_block()
+    {
+        static const std::wstring env_block = []() {
+            static const std::string SYSTEM_ROOT =
+                get_environment_variable("SystemRoot").value_or_exit(VCPKG_LINE_INFO);
+            static const std::string SYSTEM_32 = SYSTEM_ROOT + R"(\system32)";
+            static const std::string NEW_PATH = Strings::format(
+                R"(Path=%s;%s;%s\Wbem;%s\WindowsPowerShell\v1.0\)", SYSTEM_32, SYSTEM_ROOT, SYSTEM_32, SYSTEM_32);
+
+            const std::vector<std::wstring> env_wstrings = {
+                L"ALLUSERSPROFILE",
+                L"APPDATA",
+                L"CommonProgramFiles",
+                L"CommonProgramFiles(x86)",
+                L"CommonProgramW6432",
+                L"COMPUTERNAME",
+                L"ComSpec",
+                L"HOMEDRIVE",
+                L"HOMEPATH",
+                L"LOCALAPPDATA",
+                L"LOGONSERVER",
+                L"NUMBER_OF_PROCESSORS",
+                L"OS",
+                L"PATHEXT",
+                L"PROCESSOR_ARCHITECTURE",
+                L"PROCESSOR_ARCHITEW6432",
+                L"PROCESSOR_IDENTIFIER",
+                L"PROCESSOR_LEVEL",
+                L"PROCESSOR_REVISION",
+                L"ProgramData",
+                L"ProgramFiles",
+                L"ProgramFiles(x86)",
+                L"ProgramW6432",
+                L"PROMPT",
+                L"PSModulePath",
+                L"PUBLIC",
+                L"SystemDrive",
+                L"SystemRoot",
+                L"TEMP",
+                L"TMP",
+                L"USERDNSDOMAIN",
+                L"USERDOMAIN",
+                L"USERDOMAIN_ROAMINGPROFILE",
+                L"USERNAME",
+                L"USERPROFILE",
+                L"windir",
+                // Enables proxy information to be passed to Curl, the underlying download library in cmake.exe
+                L"HTTP_PROXY",
+                L"HTTPS_PROXY",
+                // Enables find_package(CUDA) in CMake
+                L"CUDA_PATH",
+                // Environmental variable generated automatically by CUDA after installation
+                L"NVCUDASAMPLES_ROOT",
+            };
+
+            std::wstring env_cstr;
+
+            for (auto&& env_wstring : env_wstrings)
+            {
+                const Optional<std::string> value = System::get_environment_variable(Strings::to_utf8(env_wstring));
+                const auto v = value.get();
+                if (!v || v->empty()) continue;
+
+                env_cstr.append(env_wstring);
+                env_cstr.push_back(L'=');
+                Strings::to_utf16_append(*v, env_cstr);
+                env_cstr.push_back(L'\0');
+            }
 
-            env_cstr.append(env_wstring);
-            env_cstr.push_back(L'=');
-            env_cstr.append(Strings::to_utf16(*v));
+            Strings::to_utf16_append(NEW_PATH, env_cstr);
             env_cstr.push_back(L'\0');
-        }
+            env_cstr.append(L"VSLANG=1033");
+            env_cstr.push_back(L'\0');
+            return env_cstr;
+        }();
+        return env_block;
+    }
+#endif
 
-        env_cstr.append(Strings::to_utf16(NEW_PATH));
-        env_cstr.push_back(L'\0');
-        env_cstr.append(L"VSLANG=1033");
-        env_cstr.push_back(L'\0');
+#if defined(_WIN32)
+    static int cmd_execute_with_environment_block(const StringView cmd_line, const std::wstring& env_cstr)
+    {
+        // Flush stdout before launching external process
+        flush_output();
+        fflush(nullptr);
 
         STARTUPINFOW startup_info;
         memset(&startup_info, 0, sizeof(STARTUPINFOW));
@@ -221,7 +376,7 @@ namespace vcpkg::System
                                                 nullptr,
                                                 FALSE,
                                                 IDLE_PRIORITY_CLASS | CREATE_UNICODE_ENVIRONMENT,
-                                                env_cstr.data(),
+                                                const_cast<wchar_t*>(env_cstr.data()),
                                                 nullptr,
                                                 &startup_info,
                                                 &process_info);
@@ -238,15 +393,70 @@ namespace vcpkg::System
 
         Debug::println("CreateProcessW() returned %lu", exit_code);
         return static_cast<int>(exit_code);
+    }
+#endif
+
+    int cmd_execute_clean(const StringView cmd_line)
+    {
+        Stats::get().processes_spawned.increment();
+#if defined(_WIN32)
+        return cmd_execute_with_environment_block(cmd_line, get_clean_environment_block());
 #else
+        flush_output();
         fflush(nullptr);
         return system(cmd_line.c_str());
 #endif
     }
 
-    int cmd_execute(const CStringView cmd_line)
+#if defined(_WIN32)
+    Optional<std::wstring> capture_clean_environment(const CStringView environment_setup_cmd)
     {
+        // Run the setup command through the normal clean launch path, then dump the
+        // resulting environment to a file with `set`, so the snapshot is exactly what a
+        // clean launch would have observed after the setup ran.
+        const fs::path temp_file = fs::stdfs::temp_directory_path() /
+                                   Strings::format("vcpkg-env-%lu.txt", GetCurrentProcessId());
+        const int rc =
+            cmd_execute_clean(Strings::format(R"(%s && set > "%s")", environment_setup_cmd, temp_file.u8string()));
+        if (rc != 0) return nullopt;
+
+        const Expected<std::string> maybe_contents = Files::get_real_filesystem().read_contents(temp_file);
+        std::error_code ec;
+        Files::get_real_filesystem().remove(temp_file, ec);
+        const auto contents = maybe_contents.get();
+        if (!contents) return nullopt;
+
+        std::wstring env_cstr;
+        for (const std::string& line : Strings::split(*contents, "\n"))
+        {
+            std::string entry = line;
+            if (!entry.empty() && entry.back() == '\r') entry.pop_back();
+            // cmd's hidden per-drive variables start with '='; they cannot be set in a
+            // child's block and are not meaningful to the build anyway.
+            if (entry.empty() || entry.front() == '=') continue;
+            if (entry.find('=') == std::string::npos) continue;
+
+            Strings::to_utf16_append(entry, env_cstr);
+            env_cstr.push_back(L'\0');
+        }
+
+        if (env_cstr.empty()) return nullopt;
+        return env_cstr;
+    }
+
+    int cmd_execute_with_environment(const StringView cmd_line, const std::wstring& environment_block)
+    {
+        Stats::get().processes_spawned.increment();
+        return cmd_execute_with_environment_block(cmd_line, environment_block);
+    }
+#endif
+
+    int cmd_execute(const StringView cmd_line)
+    {
+        Stats::get().processes_spawned.increment();
+
         // Flush stdout before launching external process
+        flush_output();
         fflush(nullptr);
 
         // Basically we are wrapping it in quotes
@@ -274,61 +484,251 @@ namespace vcpkg::System
         }
     }
 
-    ExitCodeAndOutput cmd_execute_and_capture_output(const CStringView cmd_line)
+    int cmd_execute_and_stream_output(const StringView cmd_line,
+                                      const std::function<void(const char*, size_t)>& sink)
     {
+        Stats::get().processes_spawned.increment();
+
         // Flush stdout before launching external process
+        flush_output();
         fflush(stdout);
 
 #if defined(_WIN32)
         const auto actual_cmd_line = Strings::format(R"###("%s 2>&1")###", cmd_line);
 
         Debug::println("_wpopen(%s)", actual_cmd_line);
-        std::wstring output;
-        wchar_t buf[1024];
         const auto pipe = _wpopen(Strings::to_utf16(actual_cmd_line).c_str(), L"r");
         if (pipe == nullptr)
         {
-            return {1, Strings::to_utf8(output)};
+            return 1;
         }
-        while (fgetws(buf, 1024, pipe))
+        // Drain the pipe in large chunks instead of line-sized pieces so the child is
+        // not stalled on a full pipe buffer while we spin on tiny reads.
+        std::wstring buf;
+        buf.resize(16 * 1024);
+        std::string as_utf8;
+        bool first_chunk = true;
+        while (fgetws(&buf[0], static_cast<int>(buf.size()), pipe))
         {
-            output.append(buf);
+            std::wstring chunk(buf.c_str());
+            if (first_chunk)
+            {
+                remove_byte_order_marks(&chunk);
+                first_chunk = false;
+            }
+            // One UTF-8 buffer is reused across the whole drain; a build emits
+            // thousands of chunks.
+            as_utf8.clear();
+            Strings::to_utf8_append(chunk, as_utf8);
+            sink(as_utf8.data(), as_utf8.size());
         }
         if (!feof(pipe))
         {
-            return {1, Strings::to_utf8(output)};
+            return 1;
         }
 
         const auto ec = _pclose(pipe);
         Debug::println("_pclose() returned %d", ec);
-        remove_byte_order_marks(&output);
-        return {ec, Strings::to_utf8(output)};
+        return ec;
 #else
         const auto actual_cmd_line = Strings::format(R"###(%s 2>&1)###", cmd_line);
 
         Debug::println("popen(%s)", actual_cmd_line);
-        std::string output;
-        char buf[1024];
         const auto pipe = popen(actual_cmd_line.c_str(), "r");
         if (pipe == nullptr)
         {
-            return {1, output};
+            return 1;
         }
-        while (fgets(buf, 1024, pipe))
+        char buf[64 * 1024];
+        size_t bytes_read;
+        while ((bytes_read = fread(buf, 1, sizeof(buf), pipe)) > 0)
         {
-            output.append(buf);
+            sink(buf, bytes_read);
         }
         if (!feof(pipe))
         {
-            return {1, output};
+            return 1;
         }
 
         const auto ec = pclose(pipe);
         Debug::println("pclose() returned %d", ec);
-        return {ec, output};
+        return ec;
 #endif
     }
 
+    std::future<ExitCodeAndOutput> cmd_execute_and_capture_output_async(std::string cmd_line)
+    {
+        return std::async(std::launch::async,
+                          [](const std::string cmd) { return cmd_execute_and_capture_output(cmd); },
+                          std::move(cmd_line));
+    }
+
+    ExitCodeAndOutput cmd_execute_and_capture_output(const StringView cmd_line)
+    {
+        std::string output;
+        // Build logs are commonly tens of MB; start with a sizable reservation and let
+        // append's exponential growth take over from there.
+        output.reserve(16 * 1024);
+        const int ec = cmd_execute_and_stream_output(
+            cmd_line, [&output](const char* data, const size_t size) { output.append(data, size); });
+        return {ec, std::move(output)};
+    }
+
+    // Shared sink state for the capture-to-file modes: every chunk is written through
+    // to the log file, and only a bounded tail is retained in memory.
+    struct LogTailSink
+    {
+        LogTailSink(const fs::path& log_file, const size_t capacity) : tail_capacity(std::max<size_t>(capacity, 1))
+        {
+#if defined(_WIN32)
+            file = _wfopen(log_file.native().c_str(), L"wb");
+#else
+            file = fopen(log_file.c_str(), "wb");
+#endif
+            // Logs named with the compressed extension are compressed as they are
+            // captured; the caller picks the name, so compression stays an opt-in of
+            // the call site (build logs under --x-compress-logs).
+            if (file && LogCompression::is_compressed_log_path(log_file))
+                compressor = std::make_unique<LogCompression::Compressor>(file);
+        }
+
+        ~LogTailSink()
+        {
+            if (compressor) bytes_logged = compressor->finish();
+            compressor.reset();
+            if (file)
+            {
+                fclose(file);
+                Stats::get().files_written.increment();
+                Stats::get().bytes_written.add(bytes_logged);
+            }
+        }
+
+        void operator()(const char* data, const size_t size)
+        {
+            if (compressor)
+            {
+                compressor->write(data, size);
+            }
+            else if (file)
+            {
+                fwrite(data, 1, size, file);
+                bytes_logged += size;
+            }
+            tail.append(data, size);
+            if (tail.size() > tail_capacity) tail.erase(0, tail.size() - tail_capacity);
+        }
+
+        FILE* file;
+        std::unique_ptr<LogCompression::Compressor> compressor;
+        size_t tail_capacity;
+        uint64_t bytes_logged = 0;
+        std::string tail;
+    };
+
+    ExitCodeAndOutput cmd_execute_and_capture_output_to_file(const StringView cmd_line,
+                                                             const fs::path& log_file,
+                                                             const size_t tail_capacity)
+    {
+        LogTailSink sink(log_file, tail_capacity);
+        const int ec =
+            cmd_execute_and_stream_output(cmd_line, [&sink](const char* data, const size_t size) { sink(data, size); });
+        return {ec, std::move(sink.tail)};
+    }
+
+#if defined(_WIN32)
+    ExitCodeAndOutput cmd_execute_with_environment_and_capture_output_to_file(const StringView cmd_line,
+                                                                              const std::wstring& environment_block,
+                                                                              const fs::path& log_file,
+                                                                              const size_t tail_capacity)
+    {
+        Stats::get().processes_spawned.increment();
+
+        // Flush stdout before launching external process
+        flush_output();
+        fflush(nullptr);
+
+        LogTailSink sink(log_file, tail_capacity);
+
+        SECURITY_ATTRIBUTES sa;
+        memset(&sa, 0, sizeof(SECURITY_ATTRIBUTES));
+        sa.nLength = sizeof(SECURITY_ATTRIBUTES);
+        sa.bInheritHandle = TRUE;
+
+        HANDLE read_pipe = nullptr;
+        HANDLE write_pipe = nullptr;
+        if (!CreatePipe(&read_pipe, &write_pipe, &sa, 0)) return {1, std::move(sink.tail)};
+        SetHandleInformation(read_pipe, HANDLE_FLAG_INHERIT, 0);
+
+        STARTUPINFOW startup_info;
+        memset(&startup_info, 0, sizeof(STARTUPINFOW));
+        startup_info.cb = sizeof(STARTUPINFOW);
+        startup_info.dwFlags = STARTF_USESTDHANDLES;
+        startup_info.hStdOutput = write_pipe;
+        startup_info.hStdError = write_pipe;
+
+        PROCESS_INFORMATION process_info;
+        memset(&process_info, 0, sizeof(PROCESS_INFORMATION));
+
+        // Basically we are wrapping it in quotes
+        const std::string actual_cmd_line = Strings::format(R"###(cmd.exe /c "%s")###", cmd_line);
+        Debug::println("CreateProcessW(%s)", actual_cmd_line);
+        const bool succeeded = TRUE == CreateProcessW(nullptr,
+                                                      Strings::to_utf16(actual_cmd_line).data(),
+                                                      nullptr,
+                                                      nullptr,
+                                                      TRUE,
+                                                      IDLE_PRIORITY_CLASS | CREATE_UNICODE_ENVIRONMENT,
+                                                      const_cast<wchar_t*>(environment_block.data()),
+                                                      nullptr,
+                                                      &startup_info,
+                                                      &process_info);
+        CloseHandle(write_pipe);
+        if (!succeeded)
+        {
+            CloseHandle(read_pipe);
+            return {1, std::move(sink.tail)};
+        }
+        CloseHandle(process_info.hThread);
+
+        // A job object tracks the peak committed memory of the child and everything it
+        // spawns, which is how build peaks are profiled for memory-aware scheduling.
+        HANDLE job = CreateJobObjectW(nullptr, nullptr);
+        if (job) AssignProcessToJobObject(job, process_info.hProcess);
+
+        char buf[64 * 1024];
+        DWORD bytes_read = 0;
+        while (ReadFile(read_pipe, buf, sizeof(buf), &bytes_read, nullptr) && bytes_read != 0)
+        {
+            sink(buf, bytes_read);
+        }
+        CloseHandle(read_pipe);
+
+        const DWORD result = WaitForSingleObject(process_info.hProcess, INFINITE);
+        Checks::check_exit(VCPKG_LINE_INFO, result != WAIT_FAILED, "WaitForSingleObject failed");
+
+        DWORD exit_code = 0;
+        GetExitCodeProcess(process_info.hProcess, &exit_code);
+        CloseHandle(process_info.hProcess);
+
+        long long peak_memory_bytes = 0;
+        if (job)
+        {
+            JOBOBJECT_EXTENDED_LIMIT_INFORMATION job_info;
+            memset(&job_info, 0, sizeof(job_info));
+            DWORD info_size = 0;
+            if (QueryInformationJobObject(job, JobObjectExtendedLimitInformation, &job_info, sizeof(job_info), &info_size))
+            {
+                peak_memory_bytes = static_cast<long long>(job_info.PeakJobMemoryUsed);
+            }
+            CloseHandle(job);
+        }
+
+        Debug::println("CreateProcessW() returned %lu", exit_code);
+        return {static_cast<int>(exit_code), std::move(sink.tail), peak_memory_bytes};
+    }
+#endif
+
     void powershell_execute(const std::string& title,
                             const fs::path& script_path,
                             const std::vector<PowershellParameter>& parameters)
@@ -394,9 +794,58 @@ namespace vcpkg::System
         return rc.output;
     }
 
-    void println() { putchar('\n'); }
+    // Coalesces prints into large writes. A console stdout is unbuffered or
+    // line-buffered, so commands that emit one line per package or file used to pay a
+    // console write per line. The buffer drains when it grows large, around console
+    // color changes, before external processes run, and at exit.
+    static const size_t OUTPUT_BUFFER_FLUSH_THRESHOLD = 16 * 1024;
+
+    static std::mutex& output_buffer_mutex()
+    {
+        static std::mutex mtx;
+        return mtx;
+    }
+
+    static std::string& output_buffer()
+    {
+        static std::string buffer;
+        return buffer;
+    }
 
-    void print(const CStringView message) { fputs(message.c_str(), stdout); }
+    void flush_output()
+    {
+        std::lock_guard<std::mutex> lock(output_buffer_mutex());
+        std::string& buffer = output_buffer();
+        if (!buffer.empty())
+        {
+            fwrite(buffer.data(), 1, buffer.size(), stdout);
+            buffer.clear();
+        }
+    }
+
+    void println()
+    {
+        std::lock_guard<std::mutex> lock(output_buffer_mutex());
+        std::string& buffer = output_buffer();
+        buffer.push_back('\n');
+        if (buffer.size() >= OUTPUT_BUFFER_FLUSH_THRESHOLD)
+        {
+            fwrite(buffer.data(), 1, buffer.size(), stdout);
+            buffer.clear();
+        }
+    }
+
+    void print(const CStringView message)
+    {
+        std::lock_guard<std::mutex> lock(output_buffer_mutex());
+        std::string& buffer = output_buffer();
+        buffer.append(message.c_str());
+        if (buffer.size() >= OUTPUT_BUFFER_FLUSH_THRESHOLD)
+        {
+            fwrite(buffer.data(), 1, buffer.size(), stdout);
+            buffer.clear();
+        }
+    }
 
     void println(const CStringView message)
     {
@@ -407,6 +856,10 @@ namespace vcpkg::System
     void print(const Color c, const CStringView message)
     {
 #if defined(_WIN32)
+        // The colored text must not still be sitting in the buffer when the console
+        // attributes are restored.
+        flush_output();
+
         const HANDLE console_handle = GetStdHandle(STD_OUTPUT_HANDLE);
 
         CONSOLE_SCREEN_BUFFER_INFO console_screen_buffer_info{};
@@ -415,6 +868,7 @@ namespace vcpkg::System
 
         SetConsoleTextAttribute(console_handle, static_cast<WORD>(c) | (original_color & 0xF0));
         print(message);
+        flush_output();
         SetConsoleTextAttribute(console_handle, original_color);
 #else
         print(message);
@@ -427,7 +881,7 @@ namespace vcpkg::System
         println();
     }
 
-    Optional<std::string> get_environment_variable(const CStringView varname) noexcept
+    static Optional<std::string> get_environment_variable_uncached(const CStringView varname) noexcept
     {
 #if defined(_WIN32)
         const auto w_varname = Strings::to_utf16(varname);
@@ -448,6 +902,52 @@ namespace vcpkg::System
 #endif
     }
 
+    // Memoizes environment reads by name. The environment of this process only changes
+    // through set_environment_variable() below, which updates the cache in place, so a
+    // cached value never goes stale.
+    static std::mutex s_env_cache_mutex;
+    static std::unordered_map<std::string, Optional<std::string>> s_env_cache;
+
+    Optional<std::string> get_environment_variable(const CStringView varname) noexcept
+    {
+        std::lock_guard<std::mutex> lock(s_env_cache_mutex);
+        const auto it = s_env_cache.find(varname.c_str());
+        if (it != s_env_cache.end())
+        {
+            if (const auto v = it->second.get()) return *v;
+            return nullopt;
+        }
+
+        Optional<std::string> value = get_environment_variable_uncached(varname);
+        if (const auto v = value.get())
+            s_env_cache.emplace(varname.c_str(), *v);
+        else
+            s_env_cache.emplace(varname.c_str(), nullopt);
+        return value;
+    }
+
+    void set_environment_variable(const CStringView varname, const Optional<std::string>& value) noexcept
+    {
+#if defined(_WIN32)
+        const auto w_varname = Strings::to_utf16(varname);
+        if (const auto v = value.get())
+            SetEnvironmentVariableW(w_varname.c_str(), Strings::to_utf16(*v).c_str());
+        else
+            SetEnvironmentVariableW(w_varname.c_str(), nullptr);
+#else
+        if (const auto v = value.get())
+            setenv(varname.c_str(), v->c_str(), 1);
+        else
+            unsetenv(varname.c_str());
+#endif
+
+        std::lock_guard<std::mutex> lock(s_env_cache_mutex);
+        if (const auto v = value.get())
+            s_env_cache[varname.c_str()] = *v;
+        else
+            s_env_cache[varname.c_str()] = nullopt;
+    }
+
 #if defined(_WIN32)
     static bool is_string_keytype(const DWORD hkey_type)
     {
@@ -0,0 +1,160 @@
+#include "pch.h"
+
+#include <vcpkg/base/system.h>
+#include <vcpkg/base/timing.h>
+
+#include <fstream>
+
+namespace vcpkg::Timing
+{
+    namespace
+    {
+        struct PhaseEvent
+        {
+            std::string path;
+            uint64_t thread_id;
+            int64_t start_us;
+            int64_t duration_us;
+        };
+
+        std::atomic<bool> g_enabled(false);
+
+        std::mutex& events_mutex()
+        {
+            static std::mutex mtx;
+            return mtx;
+        }
+
+        std::vector<PhaseEvent>& events()
+        {
+            static std::vector<PhaseEvent> evts;
+            return evts;
+        }
+
+        // Microseconds since the first call, which enable() makes during argument
+        // parsing so every timestamp is relative to process startup.
+        int64_t now_us()
+        {
+            static const auto start = std::chrono::steady_clock::now();
+            return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start)
+                .count();
+        }
+
+        struct OpenPhase
+        {
+            std::string path;
+            int64_t start_us;
+        };
+
+        thread_local std::vector<OpenPhase> t_open_phases;
+
+        uint64_t this_thread_id()
+        {
+            return static_cast<uint64_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+        }
+
+        std::string json_escape(const std::string& s)
+        {
+            std::string escaped;
+            for (const char c : s)
+            {
+                if (c == '"' || c == '\\') escaped.push_back('\\');
+                escaped.push_back(c);
+            }
+            return escaped;
+        }
+    }
+
+    void enable()
+    {
+        now_us();
+        g_enabled = true;
+    }
+
+    bool enabled() { return g_enabled; }
+
+    PhaseScope::PhaseScope(std::string name) : m_active(g_enabled)
+    {
+        if (!m_active) return;
+
+        std::string path =
+            t_open_phases.empty() ? std::move(name) : t_open_phases.back().path + "/" + std::move(name);
+        t_open_phases.push_back({std::move(path), now_us()});
+    }
+
+    PhaseScope::~PhaseScope()
+    {
+        if (!m_active || t_open_phases.empty()) return;
+
+        OpenPhase phase = std::move(t_open_phases.back());
+        t_open_phases.pop_back();
+        const int64_t end_us = now_us();
+
+        std::lock_guard<std::mutex> lock(events_mutex());
+        events().push_back({std::move(phase.path), this_thread_id(), phase.start_us, end_us - phase.start_us});
+    }
+
+    void report()
+    {
+        if (!g_enabled) return;
+
+        std::vector<PhaseEvent> all;
+        {
+            std::lock_guard<std::mutex> lock(events_mutex());
+            all = events();
+        }
+        if (all.empty()) return;
+
+        struct PhaseTotal
+        {
+            int64_t total_us = 0;
+            size_t count = 0;
+        };
+
+        // std::map keeps "a" ahead of "a/b", so parents print before their children.
+        std::map<std::string, PhaseTotal> totals;
+        for (const PhaseEvent& event : all)
+        {
+            PhaseTotal& total = totals[event.path];
+            total.total_us += event.duration_us;
+            total.count++;
+        }
+
+        System::println("\nPhase timing:");
+        for (const auto& entry : totals)
+        {
+            const size_t depth = std::count(entry.first.begin(), entry.first.end(), '/');
+            const size_t last_slash = entry.first.find_last_of('/');
+            const std::string display =
+                last_slash == std::string::npos ? entry.first : entry.first.substr(last_slash + 1);
+            System::println("    %s%s: %s us (%s calls)",
+                            std::string(depth * 2, ' '),
+                            display,
+                            std::to_string(entry.second.total_us),
+                            std::to_string(entry.second.count));
+        }
+
+        const std::string trace_path = "vcpkg-timing.json";
+        std::ofstream trace(trace_path, std::ios::out | std::ios::trunc);
+        if (!trace)
+        {
+            System::println(System::Color::warning, "Warning: could not write %s", trace_path);
+            return;
+        }
+
+        trace << "[";
+        bool first = true;
+        for (const PhaseEvent& event : all)
+        {
+            if (!first) trace << ",";
+            first = false;
+            trace << "\n"
+                  << R"({"name":")" << json_escape(event.path) << R"(","ph":"X","pid":1,"tid":)" << event.thread_id
+                  << R"(,"ts":)" << event.start_us << R"(,"dur":)" << event.duration_us << "}";
+        }
+        trace << "\n]\n";
+        trace.close();
+
+        System::println("Wrote trace events to %s", trace_path);
+    }
+}
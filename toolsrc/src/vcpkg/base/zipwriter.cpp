@@ -0,0 +1,165 @@
+#include "pch.h"
+
+#include <vcpkg/base/checks.h>
+#include <vcpkg/base/zipwriter.h>
+
+namespace vcpkg::Files
+{
+    static uint32_t crc32_of(const std::string& data)
+    {
+        static const std::array<uint32_t, 256> table = []() {
+            std::array<uint32_t, 256> t{};
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                uint32_t c = i;
+                for (int k = 0; k < 8; ++k)
+                {
+                    c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+                }
+                t[i] = c;
+            }
+            return t;
+        }();
+
+        uint32_t crc = 0xFFFFFFFF;
+        for (const char ch : data)
+        {
+            crc = table[(crc ^ static_cast<unsigned char>(ch)) & 0xFF] ^ (crc >> 8);
+        }
+        return crc ^ 0xFFFFFFFF;
+    }
+
+    ZipWriter::ZipWriter(const fs::path& file_path)
+        : m_stream(file_path, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc), m_offset(0)
+    {
+        Checks::check_exit(VCPKG_LINE_INFO, !m_stream.fail(), "Could not open %s for writing", file_path.u8string());
+    }
+
+    void ZipWriter::write_bytes(const void* data, size_t size)
+    {
+        m_stream.write(static_cast<const char*>(data), size);
+        m_offset += size;
+    }
+
+    void ZipWriter::write_u16(uint16_t value)
+    {
+        const unsigned char bytes[] = {
+            static_cast<unsigned char>(value & 0xFF),
+            static_cast<unsigned char>(value >> 8),
+        };
+        write_bytes(bytes, sizeof(bytes));
+    }
+
+    void ZipWriter::write_u32(uint32_t value)
+    {
+        write_u16(static_cast<uint16_t>(value & 0xFFFF));
+        write_u16(static_cast<uint16_t>(value >> 16));
+    }
+
+    void ZipWriter::write_u64(uint64_t value)
+    {
+        write_u32(static_cast<uint32_t>(value & 0xFFFFFFFF));
+        write_u32(static_cast<uint32_t>(value >> 32));
+    }
+
+    void ZipWriter::add_file(const std::string& archive_name, const std::string& contents)
+    {
+        // Offsets beyond 4GB are handled through zip64 central records, but a single
+        // entry of that size would also need zip64 local headers, which nothing we
+        // package comes close to requiring.
+        Checks::check_exit(VCPKG_LINE_INFO,
+                           contents.size() < 0xFFFFFFFF,
+                           "Cannot add %s: single entries over 4GB are not supported",
+                           archive_name);
+
+        const uint32_t crc = crc32_of(contents);
+        const uint32_t size = static_cast<uint32_t>(contents.size());
+        const uint64_t local_header_offset = m_offset;
+
+        write_u32(0x04034B50); // local file header signature
+        write_u16(20);         // version needed to extract
+        write_u16(0);          // general purpose bit flag
+        write_u16(0);          // compression method: stored
+        write_u16(0);          // last mod file time
+        write_u16(0x21);       // last mod file date (1980-01-01)
+        write_u32(crc);
+        write_u32(size); // compressed size
+        write_u32(size); // uncompressed size
+        write_u16(static_cast<uint16_t>(archive_name.size()));
+        write_u16(0); // extra field length
+        write_bytes(archive_name.data(), archive_name.size());
+        write_bytes(contents.data(), contents.size());
+
+        m_entries.push_back({archive_name, crc, size, local_header_offset});
+    }
+
+    void ZipWriter::finish()
+    {
+        const uint64_t central_directory_offset = m_offset;
+
+        for (const CentralDirectoryEntry& entry : m_entries)
+        {
+            const bool needs_zip64 = entry.local_header_offset >= 0xFFFFFFFF;
+
+            write_u32(0x02014B50); // central directory header signature
+            write_u16(45);         // version made by
+            write_u16(needs_zip64 ? 45 : 20);
+            write_u16(0);    // general purpose bit flag
+            write_u16(0);    // compression method: stored
+            write_u16(0);    // last mod file time
+            write_u16(0x21); // last mod file date
+            write_u32(entry.crc32);
+            write_u32(static_cast<uint32_t>(entry.size)); // compressed size
+            write_u32(static_cast<uint32_t>(entry.size)); // uncompressed size
+            write_u16(static_cast<uint16_t>(entry.name.size()));
+            write_u16(needs_zip64 ? 12 : 0); // extra field length
+            write_u16(0);                    // file comment length
+            write_u16(0);                    // disk number start
+            write_u16(0);                    // internal file attributes
+            write_u32(0);                    // external file attributes
+            write_u32(needs_zip64 ? 0xFFFFFFFF : static_cast<uint32_t>(entry.local_header_offset));
+            write_bytes(entry.name.data(), entry.name.size());
+            if (needs_zip64)
+            {
+                write_u16(0x0001); // zip64 extended information
+                write_u16(8);
+                write_u64(entry.local_header_offset);
+            }
+        }
+
+        const uint64_t central_directory_size = m_offset - central_directory_offset;
+        const uint64_t entry_count = m_entries.size();
+
+        // Always emit the zip64 end-of-central-directory pair; readers that do not
+        // need it skip straight to the classic record.
+        const uint64_t zip64_eocd_offset = m_offset;
+        write_u32(0x06064B50); // zip64 end of central directory signature
+        write_u64(44);         // size of the remainder of this record
+        write_u16(45);         // version made by
+        write_u16(45);         // version needed to extract
+        write_u32(0);          // this disk
+        write_u32(0);          // disk with the central directory
+        write_u64(entry_count);
+        write_u64(entry_count);
+        write_u64(central_directory_size);
+        write_u64(central_directory_offset);
+
+        write_u32(0x07064B50); // zip64 end of central directory locator
+        write_u32(0);          // disk with the zip64 end of central directory
+        write_u64(zip64_eocd_offset);
+        write_u32(1); // total number of disks
+
+        write_u32(0x06054B50); // end of central directory signature
+        write_u16(0);          // this disk
+        write_u16(0);          // disk with the central directory
+        write_u16(entry_count >= 0xFFFF ? 0xFFFF : static_cast<uint16_t>(entry_count));
+        write_u16(entry_count >= 0xFFFF ? 0xFFFF : static_cast<uint16_t>(entry_count));
+        write_u32(central_directory_size >= 0xFFFFFFFF ? 0xFFFFFFFF
+                                                       : static_cast<uint32_t>(central_directory_size));
+        write_u32(central_directory_offset >= 0xFFFFFFFF ? 0xFFFFFFFF
+                                                         : static_cast<uint32_t>(central_directory_offset));
+        write_u16(0); // comment length
+
+        m_stream.close();
+    }
+}
@@ -26,7 +26,7 @@ namespace vcpkg
 
     BinaryParagraph::BinaryParagraph() = default;
 
-    BinaryParagraph::BinaryParagraph(std::unordered_map<std::string, std::string> fields)
+    BinaryParagraph::BinaryParagraph(Parse::RawParagraph fields)
     {
         using namespace vcpkg::Parse;
 
@@ -34,29 +34,29 @@ namespace vcpkg
 
         {
             std::string name;
-            parser.required_field(Fields::PACKAGE, name);
+            parser.required_field(ControlField::PACKAGE, name);
             std::string architecture;
-            parser.required_field(Fields::ARCHITECTURE, architecture);
+            parser.required_field(ControlField::ARCHITECTURE, architecture);
             this->spec = PackageSpec::from_name_and_triplet(name, Triplet::from_canonical_name(architecture))
                              .value_or_exit(VCPKG_LINE_INFO);
         }
 
         // one or the other
-        this->version = parser.optional_field(Fields::VERSION);
-        this->feature = parser.optional_field(Fields::FEATURE);
+        this->version = parser.optional_field(ControlField::VERSION);
+        this->feature = parser.optional_field(ControlField::FEATURE);
 
-        this->description = parser.optional_field(Fields::DESCRIPTION);
-        this->maintainer = parser.optional_field(Fields::MAINTAINER);
+        this->description = parser.optional_field(ControlField::DESCRIPTION);
+        this->maintainer = parser.optional_field(ControlField::MAINTAINER);
 
-        this->abi = parser.optional_field(Fields::ABI);
+        this->abi = parser.optional_field(ControlField::ABI);
 
         std::string multi_arch;
-        parser.required_field(Fields::MULTI_ARCH, multi_arch);
+        parser.required_field(ControlField::MULTI_ARCH, multi_arch);
 
-        this->depends = parse_comma_list(parser.optional_field(Fields::DEPENDS));
+        this->depends = parse_comma_list(parser.optional_field(ControlField::DEPENDS));
         if (this->feature.empty())
         {
-            this->default_features = parse_comma_list(parser.optional_field(Fields::DEFAULTFEATURES));
+            this->default_features = parse_comma_list(parser.optional_field(ControlField::DEFAULT_FEATURES));
         }
 
         if (const auto err = parser.error_info(this->spec.to_string()))
@@ -125,4 +125,146 @@ namespace vcpkg
         if (!pgh.abi.empty()) out_str.append("Abi: ").append(pgh.abi).push_back('\n');
         if (!pgh.description.empty()) out_str.append("Description: ").append(pgh.description).push_back('\n');
     }
+
+    namespace
+    {
+        // On-disk format of the CONTROL.bin sidecar: a versioned header followed by
+        // length-prefixed fields, core paragraph first, then one record per feature.
+        // Any malformed or short read rejects the sidecar entirely.
+        static const char SIDECAR_MAGIC[8] = {'V', 'C', 'P', 'K', 'G', 'B', 'I', 'N'};
+        static const uint32_t SIDECAR_VERSION = 1;
+
+        struct SidecarWriter
+        {
+            std::string buffer;
+
+            void write_bytes(const void* data, size_t size) { buffer.append(static_cast<const char*>(data), size); }
+            void write_u32(uint32_t v) { write_bytes(&v, sizeof(v)); }
+            void write_string(const std::string& s)
+            {
+                write_u32(static_cast<uint32_t>(s.size()));
+                buffer.append(s);
+            }
+            void write_string_list(const std::vector<std::string>& list)
+            {
+                write_u32(static_cast<uint32_t>(list.size()));
+                for (auto&& s : list)
+                    write_string(s);
+            }
+            void write_paragraph(const BinaryParagraph& pgh)
+            {
+                write_string(pgh.spec.name());
+                write_string(pgh.spec.triplet().canonical_name());
+                write_string(pgh.version);
+                write_string(pgh.description);
+                write_string(pgh.maintainer);
+                write_string(pgh.feature);
+                write_string_list(pgh.default_features);
+                write_string_list(pgh.depends);
+                write_string(pgh.abi);
+            }
+        };
+
+        struct SidecarReader
+        {
+            const char* cur;
+            const char* end;
+            bool ok = true;
+
+            bool read_bytes(void* out, size_t size)
+            {
+                if (!ok || static_cast<size_t>(end - cur) < size)
+                {
+                    ok = false;
+                    return false;
+                }
+                memcpy(out, cur, size);
+                cur += size;
+                return true;
+            }
+            uint32_t read_u32()
+            {
+                uint32_t v = 0;
+                read_bytes(&v, sizeof(v));
+                return v;
+            }
+            std::string read_string()
+            {
+                const uint32_t size = read_u32();
+                if (!ok || static_cast<size_t>(end - cur) < size)
+                {
+                    ok = false;
+                    return {};
+                }
+                std::string s(cur, cur + size);
+                cur += size;
+                return s;
+            }
+            std::vector<std::string> read_string_list()
+            {
+                std::vector<std::string> list;
+                const uint32_t size = read_u32();
+                for (uint32_t i = 0; ok && i < size; ++i)
+                    list.push_back(read_string());
+                return list;
+            }
+            bool read_paragraph(BinaryParagraph& pgh)
+            {
+                const std::string name = read_string();
+                const std::string triplet = read_string();
+                pgh.version = read_string();
+                pgh.description = read_string();
+                pgh.maintainer = read_string();
+                pgh.feature = read_string();
+                pgh.default_features = read_string_list();
+                pgh.depends = read_string_list();
+                pgh.abi = read_string();
+                if (!ok) return false;
+
+                auto maybe_spec = PackageSpec::from_name_and_triplet(name, Triplet::from_canonical_name(triplet));
+                if (const auto spec = maybe_spec.get())
+                {
+                    pgh.spec = std::move(*spec);
+                    return true;
+                }
+                return false;
+            }
+        };
+    }
+
+    std::string serialize_binary(const BinaryControlFile& bcf)
+    {
+        SidecarWriter writer;
+        writer.write_bytes(SIDECAR_MAGIC, sizeof(SIDECAR_MAGIC));
+        writer.write_u32(SIDECAR_VERSION);
+        writer.write_paragraph(bcf.core_paragraph);
+        writer.write_u32(static_cast<uint32_t>(bcf.features.size()));
+        for (const BinaryParagraph& feature : bcf.features)
+            writer.write_paragraph(feature);
+        return std::move(writer.buffer);
+    }
+
+    Optional<BinaryControlFile> deserialize_binary(const std::string& contents)
+    {
+        SidecarReader reader{contents.data(), contents.data() + contents.size()};
+
+        char magic[sizeof(SIDECAR_MAGIC)];
+        if (!reader.read_bytes(magic, sizeof(magic)) || memcmp(magic, SIDECAR_MAGIC, sizeof(magic)) != 0)
+            return nullopt;
+        if (reader.read_u32() != SIDECAR_VERSION) return nullopt;
+
+        BinaryControlFile bcf;
+        if (!reader.read_paragraph(bcf.core_paragraph)) return nullopt;
+
+        const uint32_t num_features = reader.read_u32();
+        for (uint32_t i = 0; reader.ok && i < num_features; ++i)
+        {
+            BinaryParagraph feature;
+            if (!reader.read_paragraph(feature)) return nullopt;
+            bcf.features.push_back(std::move(feature));
+        }
+
+        if (!reader.ok) return nullopt;
+        return bcf;
+    }
 }
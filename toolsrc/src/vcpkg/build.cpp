@@ -1,13 +1,21 @@
 #include "pch.h"
 
 #include <vcpkg/base/checks.h>
+#include <vcpkg/base/corebudget.h>
 #include <vcpkg/base/chrono.h>
+#include <vcpkg/base/logcompression.h>
+#include <vcpkg/gc.h>
 #include <vcpkg/base/enums.h>
+#include <vcpkg/base/hash.h>
 #include <vcpkg/base/optional.h>
+#include <vcpkg/base/parallel.h>
+#include <vcpkg/base/stats.h>
 #include <vcpkg/base/system.h>
+#include <vcpkg/base/timing.h>
 #include <vcpkg/build.h>
 #include <vcpkg/commands.h>
 #include <vcpkg/dependencies.h>
+#include <vcpkg/downloads.h>
 #include <vcpkg/globalstate.h>
 #include <vcpkg/help.h>
 #include <vcpkg/input.h>
@@ -54,9 +62,9 @@ namespace vcpkg::Build::Command
 
         const auto& scf = source_control_file.value_or_exit(VCPKG_LINE_INFO);
         Checks::check_exit(VCPKG_LINE_INFO,
-                           spec.name() == scf->core_paragraph->name,
+                           spec.name() == scf->core_paragraph.name,
                            "The Source field inside the CONTROL file does not match the port directory: '%s' != '%s'",
-                           scf->core_paragraph->name,
+                           scf->core_paragraph.name,
                            spec.name());
 
         const StatusParagraphs status_db = database_load_check(paths);
@@ -122,17 +130,108 @@ namespace vcpkg::Build::Command
             Checks::exit_with_message(
                 VCPKG_LINE_INFO, "Feature packages are experimentally available under the --featurepackages flag.");
         }
+
+        // Overlap any missing tool downloads with the control file parse below.
+        paths.prefetch_tools();
+
         perform_and_exit_ex(spec, paths.port_dir(spec.package_spec), options, paths);
     }
 }
 
 namespace vcpkg::Build
 {
+    namespace
+    {
+        // Background buildtree janitor for `clean_buildtrees`: deleting a multi-GB
+        // buildtree synchronously between packages serializes disk-heavy removal
+        // against CPU-idle time. A doomed directory is instead renamed to a
+        // vcpkg_trash-prefixed sibling (instant, and it frees the name for the next
+        // build) and the actual deletion runs on one background thread, overlapped
+        // with the following package's compilation. Trash a killed run left behind
+        // is re-queued by the next cleanup pass over the same port.
+        struct BuildtreeJanitor
+        {
+            static BuildtreeJanitor& instance()
+            {
+                // Leaked deliberately: the worker may still be draining at process
+                // exit, and leftover trash is swept by the next run anyway.
+                static BuildtreeJanitor* janitor = new BuildtreeJanitor;
+                return *janitor;
+            }
+
+            void enqueue(Files::Filesystem& fs, const fs::path& dir)
+            {
+                fs::path doomed = dir;
+                const std::string filename = dir.filename().u8string();
+                if (!Strings::case_insensitive_ascii_starts_with(filename, TRASH_PREFIX))
+                {
+                    const fs::path trash =
+                        dir.parent_path() /
+                        fs::u8path(Strings::format("%s%lld-%zu-%s",
+                                                   TRASH_PREFIX,
+                                                   static_cast<long long>(time(nullptr)),
+                                                   m_renamed.fetch_add(1),
+                                                   filename));
+                    std::error_code ec;
+                    fs.rename(dir, trash, ec);
+                    if (ec)
+                    {
+                        // Could not move it aside (locked file, exotic filesystem);
+                        // fall back to deleting in place, synchronously as before.
+                        fs.remove_all(dir, ec);
+                        return;
+                    }
+                    doomed = trash;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_pending.push_back(std::move(doomed));
+                    if (!m_worker_started)
+                    {
+                        m_worker_started = true;
+                        std::thread([this]() { work(); }).detach();
+                    }
+                }
+                m_cv.notify_one();
+            }
+
+            static constexpr const char* TRASH_PREFIX = "vcpkg_trash-";
+
+        private:
+            void work()
+            {
+                Files::Filesystem& fs = Files::get_real_filesystem();
+                std::vector<fs::path> batch;
+                for (;;)
+                {
+                    {
+                        std::unique_lock<std::mutex> lock(m_mutex);
+                        m_cv.wait(lock, [this]() { return !m_pending.empty(); });
+                        batch.swap(m_pending);
+                    }
+                    Parallel::for_each_index(batch.size(), [&](const size_t i) {
+                        std::error_code ec;
+                        fs.remove_all(batch[i], ec);
+                    });
+                    batch.clear();
+                }
+            }
+
+            std::mutex m_mutex;
+            std::condition_variable m_cv;
+            std::vector<fs::path> m_pending;
+            bool m_worker_started = false;
+            std::atomic<size_t> m_renamed{0};
+        };
+    }
+
     static const std::string NAME_EMPTY_PACKAGE = "PolicyEmptyPackage";
     static const std::string NAME_DLLS_WITHOUT_LIBS = "PolicyDLLsWithoutLIBs";
     static const std::string NAME_ONLY_RELEASE_CRT = "PolicyOnlyReleaseCRT";
     static const std::string NAME_EMPTY_INCLUDE_FOLDER = "PolicyEmptyIncludeFolder";
     static const std::string NAME_ALLOW_OBSOLETE_MSVCRT = "PolicyAllowObsoleteMsvcrt";
+    static const std::string NAME_FEATURE_INCREMENTAL = "PolicyFeatureIncremental";
 
     const std::string& to_string(BuildPolicy policy)
     {
@@ -143,6 +242,7 @@ namespace vcpkg::Build
             case BuildPolicy::ONLY_RELEASE_CRT: return NAME_ONLY_RELEASE_CRT;
             case BuildPolicy::EMPTY_INCLUDE_FOLDER: return NAME_EMPTY_INCLUDE_FOLDER;
             case BuildPolicy::ALLOW_OBSOLETE_MSVCRT: return NAME_ALLOW_OBSOLETE_MSVCRT;
+            case BuildPolicy::FEATURE_INCREMENTAL: return NAME_FEATURE_INCREMENTAL;
             default: Checks::unreachable(VCPKG_LINE_INFO);
         }
     }
@@ -156,6 +256,7 @@ namespace vcpkg::Build
             case BuildPolicy::ONLY_RELEASE_CRT: return "VCPKG_POLICY_ONLY_RELEASE_CRT";
             case BuildPolicy::EMPTY_INCLUDE_FOLDER: return "VCPKG_POLICY_EMPTY_INCLUDE_FOLDER";
             case BuildPolicy::ALLOW_OBSOLETE_MSVCRT: return "VCPKG_POLICY_ALLOW_OBSOLETE_MSVCRT";
+            case BuildPolicy::FEATURE_INCREMENTAL: return "VCPKG_POLICY_FEATURE_INCREMENTAL";
             default: Checks::unreachable(VCPKG_LINE_INFO);
         }
     }
@@ -224,6 +325,133 @@ namespace vcpkg::Build
                                tonull);
     }
 
+    // Build output is streamed to a per-port log file; only this much of the end of
+    // the log stays in memory, which is enough to show the failing step immediately.
+    static const size_t BUILD_LOG_TAIL_CAPACITY = 32 * 1024;
+
+#if defined(_WIN32)
+    namespace
+    {
+        fs::path vcvars_env_cache_path(const VcpkgPaths& paths) { return paths.root / ".vcpkg-vcvars-env.cache"; }
+
+        // Stamp identifying the toolset a cached block was captured from; a vcvars
+        // update invalidates the entry.
+        std::string vcvarsall_stamp(const Files::Filesystem& fs, const Toolset& toolset)
+        {
+            std::error_code ec;
+            const auto write_time = fs.last_write_time(toolset.vcvarsall, ec);
+            if (ec) return "0-0";
+            const auto size = fs.file_size(toolset.vcvarsall, ec);
+            if (ec) return "0-0";
+            return Strings::format(
+                "%lld-%llu", static_cast<long long>(write_time), static_cast<unsigned long long>(size));
+        }
+    }
+
+    Optional<std::wstring> get_build_environment_block(const VcpkgPaths& paths,
+                                                       const PreBuildInfo& pre_build_info,
+                                                       const Toolset& toolset)
+    {
+        auto& fs = paths.get_filesystem();
+        const std::string cmd_set_environment = make_build_env_cmd(pre_build_info, toolset);
+        const std::string key = vcpkg::Hash::get_string_hash(cmd_set_environment, "SHA256");
+        const std::string stamp = vcvarsall_stamp(fs, toolset);
+        const fs::path cache_path = vcvars_env_cache_path(paths);
+
+        // The cache file holds a version line followed by one section per setup
+        // command: a "<key> <stamp>" header, the VARIABLE=VALUE lines of the block, and
+        // a blank separator.
+        const auto maybe_lines = fs.read_lines(cache_path);
+        if (const auto lines = maybe_lines.get())
+        {
+            if (!lines->empty() && (*lines)[0] == "1")
+            {
+                for (size_t i = 1; i < lines->size();)
+                {
+                    if ((*lines)[i].empty())
+                    {
+                        ++i;
+                        continue;
+                    }
+                    const bool matches = (*lines)[i] == key + " " + stamp;
+                    std::wstring block;
+                    for (++i; i < lines->size() && !(*lines)[i].empty(); ++i)
+                    {
+                        if (!matches) continue;
+                        block.append(Strings::to_utf16((*lines)[i]));
+                        block.push_back(L'\0');
+                    }
+                    if (matches && !block.empty()) return block;
+                }
+            }
+        }
+
+        const auto captured = System::capture_clean_environment(cmd_set_environment);
+        const auto block = captured.get();
+        if (!block) return nullopt;
+
+        // Rewrite the cache with just this entry; stale sections for other toolsets are
+        // recaptured on their next use.
+        std::string contents = "1\n" + key + " " + stamp + "\n";
+        std::wstring::size_type begin = 0;
+        while (begin < block->size())
+        {
+            const auto end = block->find(L'\0', begin);
+            const auto entry_end = end == std::wstring::npos ? block->size() : end;
+            if (entry_end > begin)
+            {
+                contents.append(Strings::to_utf8(block->substr(begin, entry_end - begin)));
+                contents.push_back('\n');
+            }
+            begin = entry_end + 1;
+        }
+        contents.push_back('\n');
+        fs.write_contents(cache_path, contents);
+
+        return *captured.get();
+    }
+
+    // vcvarsall takes seconds per run and its result depends only on the composed setup
+    // command (toolset, options, architecture, target), so during a long install the
+    // identical environment would otherwise be recomputed for every package. The block
+    // comes from the persistent cache above and is memoized per process on top.
+    static System::ExitCodeAndOutput cmd_execute_clean_with_build_env(const VcpkgPaths& paths,
+                                                                      const PreBuildInfo& pre_build_info,
+                                                                      const Toolset& toolset,
+                                                                      const std::string& cmd,
+                                                                      const fs::path& log_file)
+    {
+        static std::mutex cache_mutex;
+        static std::unordered_map<std::string, Optional<std::wstring>> env_cache;
+
+        const std::string cmd_set_environment = make_build_env_cmd(pre_build_info, toolset);
+
+        const Optional<std::wstring>* entry;
+        {
+            // The lock is held across the capture so concurrent builds of the same
+            // triplet do not race to run vcvarsall; later hits never block on it.
+            std::lock_guard<std::mutex> lock(cache_mutex);
+            auto it = env_cache.find(cmd_set_environment);
+            if (it == env_cache.end())
+            {
+                it = env_cache.emplace(cmd_set_environment, get_build_environment_block(paths, pre_build_info, toolset))
+                         .first;
+            }
+            entry = &it->second;
+        }
+
+        if (const auto block = entry->get())
+        {
+            return System::cmd_execute_with_environment_and_capture_output_to_file(
+                cmd, *block, log_file, BUILD_LOG_TAIL_CAPACITY);
+        }
+
+        // The snapshot failed; fall back to running the setup inline as before.
+        return System::cmd_execute_and_capture_output_to_file(
+            Strings::format(R"(%s && %s)", cmd_set_environment, cmd), log_file, BUILD_LOG_TAIL_CAPACITY);
+    }
+#endif
+
     static BinaryParagraph create_binary_feature_control_file(const SourceParagraph& source_paragraph,
                                                               const FeatureParagraph& feature_paragraph,
                                                               const Triplet& triplet)
@@ -254,19 +482,25 @@ namespace vcpkg::Build
         }
         const fs::path binary_control_file = paths.packages / bcf.core_paragraph.dir() / "CONTROL";
         paths.get_filesystem().write_contents(binary_control_file, start);
+
+        // Sidecar preferred by readers that enumerate the packages tree; the text
+        // CONTROL above stays authoritative.
+        const fs::path sidecar = paths.packages / bcf.core_paragraph.dir() / "CONTROL.bin";
+        paths.get_filesystem().write_contents(sidecar, serialize_binary(bcf));
+
+        // Later loads of this package must see the freshly written data, not whatever
+        // the bulk scan of the packages tree found before the build.
+        Paragraphs::store_cached_control_package(bcf);
     }
 
     ExtendedBuildResult build_package(const VcpkgPaths& paths,
                                       const BuildPackageConfig& config,
                                       const StatusParagraphs& status_db)
     {
-        const PackageSpec spec = PackageSpec::from_name_and_triplet(config.scf.core_paragraph->name, config.triplet)
-                                     .value_or_exit(VCPKG_LINE_INFO);
-
         const Triplet& triplet = config.triplet;
         {
             std::vector<PackageSpec> missing_specs;
-            for (auto&& dep : filter_dependencies(config.scf.core_paragraph->depends, triplet))
+            for (auto&& dep : filter_dependencies(config.scf.core_paragraph.depends, triplet))
             {
                 if (status_db.find_installed(dep, triplet) == status_db.end())
                 {
@@ -281,6 +515,280 @@ namespace vcpkg::Build
             }
         }
 
+        return build_package(paths, config);
+    }
+
+    // Per-file leaf hashes for port directory hashing, cached across runs keyed by
+    // (path, size, mtime) in a sidecar under buildtrees. Recomputing the ABI of an
+    // unchanged ports tree is then pure cache reads, and a changed port rehashes only
+    // its own files; cache misses are hashed in parallel. Returns nullopt when any
+    // file cannot be hashed.
+    static Optional<std::vector<std::string>> hash_port_files(const VcpkgPaths& paths,
+                                                              const std::vector<fs::path>& files)
+    {
+        auto& fs = paths.get_filesystem();
+
+        static std::mutex cache_mutex;
+        static std::unordered_map<std::string, std::string> cache;
+        static bool cache_loaded = false;
+
+        const fs::path cache_path = paths.buildtrees / "vcpkg_port_hash_cache.txt";
+
+        std::unique_lock<std::mutex> lock(cache_mutex);
+        if (!cache_loaded)
+        {
+            cache_loaded = true;
+            const auto maybe_lines = fs.read_lines(cache_path);
+            if (const auto lines = maybe_lines.get())
+            {
+                // Each line is "<hash> <size>|<mtime>|<path>"; the hash contains no
+                // spaces, so splitting at the first space recovers both halves.
+                for (const std::string& line : *lines)
+                {
+                    const size_t split = line.find(' ');
+                    if (split == std::string::npos) continue;
+                    cache.emplace(line.substr(split + 1), line.substr(0, split));
+                }
+            }
+        }
+
+        std::vector<std::string> keys(files.size());
+        std::vector<std::string> hashes(files.size());
+        std::vector<size_t> misses;
+        for (size_t i = 0; i < files.size(); ++i)
+        {
+            std::error_code ec;
+            const auto size = fs.file_size(files[i], ec);
+            const auto mtime = ec ? 0 : fs.last_write_time(files[i], ec);
+            if (!ec)
+            {
+                keys[i] = Strings::format("%llu|%lld|%s",
+                                          static_cast<unsigned long long>(size),
+                                          static_cast<long long>(mtime),
+                                          files[i].u8string());
+                const auto it = cache.find(keys[i]);
+                if (it != cache.end())
+                {
+                    hashes[i] = it->second;
+                    continue;
+                }
+            }
+            misses.push_back(i);
+        }
+        lock.unlock();
+
+        if (!misses.empty())
+        {
+            std::atomic<bool> failed(false);
+            Parallel::for_each_index(misses.size(), [&](size_t mi) {
+                const auto file_hash = vcpkg::Hash::get_file_hash(fs, files[misses[mi]], "SHA512");
+                if (const auto h = file_hash.get())
+                    hashes[misses[mi]] = *h;
+                else
+                    failed = true;
+            });
+            if (failed) return nullopt;
+
+            lock.lock();
+            for (const size_t i : misses)
+            {
+                if (!keys[i].empty()) cache.emplace(keys[i], hashes[i]);
+            }
+
+            std::string contents;
+            for (const auto& entry : cache)
+            {
+                contents.append(entry.second).push_back(' ');
+                contents.append(entry.first).push_back('\n');
+            }
+            std::error_code ec;
+            fs.create_directories(paths.buildtrees, ec);
+            if (!ec) fs.write_contents(cache_path, contents);
+        }
+
+        return hashes;
+    }
+
+    // Computes a tag identifying the inputs that determine the binary output of this
+    // build: the port's files, the target triplet, the toolset and the selected
+    // features. Two builds with equal tags are interchangeable. Returns an empty string
+    // when the build is not cacheable (HEAD builds, or when hashing fails).
+    static std::string compute_abi_tag(const VcpkgPaths& paths,
+                                       const BuildPackageConfig& config,
+                                       const Toolset& toolset)
+    {
+        if (Util::Enum::to_bool(config.build_package_options.use_head_version)) return "";
+
+        auto& fs = paths.get_filesystem();
+
+        std::string abi_info;
+        abi_info.append("triplet ").append(config.triplet.canonical_name()).push_back('\n');
+        abi_info.append("toolset ").append(toolset.version.c_str()).push_back('\n');
+
+        std::vector<std::string> features(config.feature_list.begin(), config.feature_list.end());
+        Util::sort(features);
+        for (auto&& feature : features)
+            abi_info.append("feature ").append(feature).push_back('\n');
+
+        // The final tag is the root of a two-level Merkle tree over the port directory:
+        // the sorted per-file leaf lines below are hashed together with the rest of the
+        // build inputs by the get_string_hash at the end of this function.
+        auto port_files = fs.get_files_recursive(config.port_dir);
+        Util::erase_remove_if(port_files, [&](const fs::path& file) { return !fs.is_regular_file(file); });
+        Util::sort(port_files);
+        const auto maybe_hashes = hash_port_files(paths, port_files);
+        if (!maybe_hashes.has_value()) return "";
+        const std::vector<std::string>& hashes = *maybe_hashes.get();
+        for (size_t i = 0; i < port_files.size(); ++i)
+        {
+            abi_info.append(hashes[i]).push_back(' ');
+            abi_info.append(port_files[i].filename().u8string()).push_back('\n');
+        }
+
+        // Keep a copy of the hashed inputs next to the buildtree for debugging.
+        const fs::path abi_file = paths.buildtrees / config.scf.core_paragraph.name / "vcpkg_abi_info.txt";
+        std::error_code ec;
+        fs.create_directories(abi_file.parent_path(), ec);
+        if (!ec) fs.write_contents(abi_file, abi_info);
+
+        return vcpkg::Hash::get_string_hash(abi_info, "SHA512");
+    }
+
+    static fs::path archive_path_for_abi_tag(const VcpkgPaths& paths, const std::string& abi_tag)
+    {
+        return paths.root / "archives" / abi_tag.substr(0, 2) / (abi_tag + ".zip");
+    }
+
+    Optional<std::string> remote_binary_cache_url()
+    {
+        const auto maybe_url = System::get_environment_variable("VCPKG_REMOTE_BINARY_CACHE");
+        if (const auto url = maybe_url.get())
+        {
+            std::string base = *url;
+            while (!base.empty() && base.back() == '/')
+                base.pop_back();
+            if (!base.empty()) return base;
+        }
+        return nullopt;
+    }
+
+    static std::string remote_archive_url(const std::string& base_url, const std::string& abi_tag)
+    {
+        return Strings::format("%s/%s/%s.zip", base_url, abi_tag.substr(0, 2), abi_tag);
+    }
+
+    static fs::path archive_tombstone_path(const VcpkgPaths& paths, const std::string& abi_tag)
+    {
+        return paths.root / "archives" / "fail" / (abi_tag + ".txt");
+    }
+
+    // A marker recording that post-build lint passed for the package identified by this
+    // abi tag. On a rebuild producing identical inputs the lint is skipped; failing lint
+    // results are never recorded, so their findings are reprinted every run.
+    static fs::path lint_pass_path_for_abi_tag(const VcpkgPaths& paths, const std::string& abi_tag)
+    {
+        return paths.root / "archives" / "lint" / (abi_tag + ".txt");
+    }
+
+    // Records a failed outcome next to the binary cache, keyed by the same abi tag, so
+    // runs with failure caching enabled (CI) skip the port until its build inputs change.
+    static void record_build_failure(const VcpkgPaths& paths, const std::string& abi_tag, const BuildResult result)
+    {
+        if (!GlobalState::g_cache_failed_builds || abi_tag.empty()) return;
+
+        auto& fs = paths.get_filesystem();
+        const fs::path tombstone_path = archive_tombstone_path(paths, abi_tag);
+        std::error_code ec;
+        fs.create_directories(tombstone_path.parent_path(), ec);
+        if (!ec) fs.write_contents(tombstone_path, to_string(result));
+    }
+
+    void prefetch_binary_archives(const VcpkgPaths& paths, const std::vector<Dependencies::AnyAction>& action_plan)
+    {
+        const auto maybe_remote = remote_binary_cache_url();
+        const auto base_url = maybe_remote.get();
+        if (!base_url) return;
+
+        auto& fs = paths.get_filesystem();
+
+        struct ArchiveFetch
+        {
+            std::string url;
+            fs::path destination;
+        };
+
+        std::vector<ArchiveFetch> fetches;
+        for (const auto& action : action_plan)
+        {
+            const auto install_action = action.install_action.get();
+            if (!install_action) continue;
+            if (install_action->plan_type != Dependencies::InstallPlanType::BUILD_AND_INSTALL) continue;
+
+            const auto scf = install_action->any_paragraph.source_control_file;
+            if (!scf) continue;
+
+            const BuildPackageConfig config{*scf,
+                                            install_action->spec.triplet(),
+                                            paths.port_dir(install_action->spec),
+                                            install_action->build_options,
+                                            install_action->feature_list};
+            const auto pre_build_info = PreBuildInfo::from_triplet_file(paths, config.triplet);
+            const std::string abi_tag = compute_abi_tag(paths, config, paths.get_toolset(pre_build_info));
+            if (abi_tag.empty()) continue;
+
+            const fs::path archive_path = archive_path_for_abi_tag(paths, abi_tag);
+            if (fs.exists(archive_path)) continue;
+            fetches.push_back({remote_archive_url(*base_url, abi_tag), archive_path});
+        }
+
+        if (fetches.empty()) return;
+
+        System::println("Fetching %zd packages from the remote binary cache...", fetches.size());
+
+        // Misses leave nothing behind and the package simply builds from source, so
+        // transport errors are not printed.
+        static const size_t MAX_CONCURRENT_TRANSFERS = 4;
+        const size_t worker_count = std::min(MAX_CONCURRENT_TRANSFERS, fetches.size());
+        Parallel::for_each_index_with_worker(worker_count, fetches.size(), [&](const size_t i, size_t) {
+            Downloads::download_file(fs, fetches[i].url, fetches[i].destination, "", 2, false);
+        });
+    }
+
+    fs::path package_archive_path(const VcpkgPaths& paths, const PackageSpec& spec)
+    {
+        return paths.package_dir(spec).generic_string() + ".zip";
+    }
+
+    bool expand_package_archive(const VcpkgPaths& paths, const PackageSpec& spec)
+    {
+        auto& fs = paths.get_filesystem();
+        const fs::path package_dir = paths.package_dir(spec);
+        if (fs.exists(package_dir / "CONTROL")) return true;
+
+        const fs::path package_archive = package_archive_path(paths, spec);
+        if (!fs.exists(package_archive)) return false;
+
+        std::error_code ec;
+        fs.remove_all(package_dir, ec);
+        fs.create_directories(package_dir, ec);
+        const fs::path& cmake_exe = paths.get_cmake_exe();
+        const int expand_code = System::cmd_execute_clean(Strings::format(R"("%s" -E chdir "%s" "%s" -E tar xzf "%s")",
+                                                                          cmake_exe.u8string(),
+                                                                          package_dir.u8string(),
+                                                                          cmake_exe.u8string(),
+                                                                          package_archive.u8string()));
+        return expand_code == 0 && fs.exists(package_dir / "CONTROL");
+    }
+
+    ExtendedBuildResult build_package(const VcpkgPaths& paths, const BuildPackageConfig& config)
+    {
+        const PackageSpec spec = PackageSpec::from_name_and_triplet(config.scf.core_paragraph.name, config.triplet)
+                                     .value_or_exit(VCPKG_LINE_INFO);
+
+        Timing::PhaseScope timing_scope("build " + spec.to_string());
+
+        const Triplet& triplet = config.triplet;
+
         const fs::path& cmake_exe_path = paths.get_cmake_exe();
         const fs::path& git_exe_path = paths.get_git_exe();
 
@@ -301,12 +809,93 @@ namespace vcpkg::Build
         }
 
         const Toolset& toolset = paths.get_toolset(pre_build_info);
+
+        auto& fs = paths.get_filesystem();
+        const std::string abi_tag = compute_abi_tag(paths, config, toolset);
+        if (!abi_tag.empty())
+        {
+            const fs::path archive_path = archive_path_for_abi_tag(paths, abi_tag);
+
+            if (!fs.exists(archive_path))
+            {
+                const auto maybe_remote = remote_binary_cache_url();
+                if (const auto base_url = maybe_remote.get())
+                {
+                    // A miss is the expected outcome for a never-built package, so
+                    // transport errors are not printed.
+                    Downloads::download_file(
+                        fs, remote_archive_url(*base_url, abi_tag), archive_path, "", 2, false);
+                }
+            }
+
+            if (fs.exists(archive_path))
+            {
+                System::println("Using cached binary package: %s", archive_path.u8string());
+
+                const fs::path package_dir = paths.package_dir(spec);
+                std::error_code ec;
+                fs.remove_all(package_dir, ec);
+                fs.create_directories(package_dir, ec);
+                const int restore_code = System::cmd_execute_clean(Strings::format(R"("%s" -E chdir "%s" "%s" -E tar xzf "%s")",
+                                                                                   cmake_exe_path.u8string(),
+                                                                                   package_dir.u8string(),
+                                                                                   cmake_exe_path.u8string(),
+                                                                                   archive_path.u8string()));
+                if (restore_code == 0)
+                {
+                    vcpkg::Stats::get().binary_cache_hits.increment();
+                    Paragraphs::invalidate_cached_control_package(spec);
+                    auto bcf = std::make_unique<BinaryControlFile>(
+                        Paragraphs::try_load_cached_control_package(paths, spec).value_or_exit(VCPKG_LINE_INFO));
+                    return {BuildResult::SUCCEEDED, std::move(bcf)};
+                }
+
+                System::println(
+                    System::Color::warning, "Restoring cached binary package failed; rebuilding from source");
+            }
+
+            if (GlobalState::g_cache_failed_builds)
+            {
+                const auto maybe_tombstone = fs.read_contents(archive_tombstone_path(paths, abi_tag));
+                if (const auto tombstone = maybe_tombstone.get())
+                {
+                    const BuildResult cached_result = *tombstone == to_string(BuildResult::POST_BUILD_CHECKS_FAILED)
+                                                          ? BuildResult::POST_BUILD_CHECKS_FAILED
+                                                          : BuildResult::BUILD_FAILED;
+                    System::println(System::Color::warning,
+                                    "Skipping %s: %s recorded for identical build inputs",
+                                    spec,
+                                    to_string(cached_result));
+                    return cached_result;
+                }
+            }
+
+            vcpkg::Stats::get().binary_cache_misses.increment();
+        }
+
+        // Feature-delta build: if this port's previous build opted into
+        // PolicyFeatureIncremental and its buildtree and BUILD_INFO are still on disk for
+        // the same version, tell the portfile so it can reuse the existing configure/build
+        // outputs and produce only the newly requested features' additions.
+        bool feature_incremental = false;
+        if (GlobalState::feature_packages)
+        {
+            const fs::path previous_build_info_path = paths.package_dir(spec) / "BUILD_INFO";
+            if (fs.exists(previous_build_info_path) && fs.exists(paths.buildtrees / spec.name()))
+            {
+                const BuildInfo previous_build_info = read_build_info(fs, previous_build_info_path);
+                const auto previous_version = previous_build_info.version.get();
+                feature_incremental = previous_build_info.policies.is_enabled(BuildPolicy::FEATURE_INCREMENTAL) &&
+                                      previous_version && *previous_version == config.scf.core_paragraph.version;
+            }
+        }
+
         const std::string cmd_launch_cmake = System::make_cmake_cmd(
             cmake_exe_path,
             ports_cmake_script_path,
             {
                 {"CMD", "BUILD"},
-                {"PORT", config.scf.core_paragraph->name},
+                {"PORT", config.scf.core_paragraph.name},
                 {"CURRENT_PORT_DIR", config.port_dir / "/."},
                 {"TARGET_TRIPLET", triplet.canonical_name()},
                 {"VCPKG_PLATFORM_TOOLSET", toolset.version.c_str()},
@@ -315,35 +904,88 @@ namespace vcpkg::Build
                 {"_VCPKG_NO_DOWNLOADS", !Util::Enum::to_bool(config.build_package_options.allow_downloads) ? "1" : "0"},
                 {"GIT", git_exe_path},
                 {"FEATURES", features},
+                {"_VCPKG_FEATURE_INCREMENTAL", feature_incremental ? "1" : "0"},
+                {"VCPKG_EXECUTABLE", System::get_exe_path_of_current_process()},
+                // The core share for build tools that cannot draw from the shared
+                // jobserver pool (msbuild /m, non-GNU make).
+                {"VCPKG_MAX_CONCURRENCY", std::to_string(CoreBudget::cores_per_build())},
             });
 
         const auto cmd_set_environment = make_build_env_cmd(pre_build_info, toolset);
-        const std::string command = Strings::format(R"(%s && %s)", cmd_set_environment, cmd_launch_cmake);
 
         const auto timer = Chrono::ElapsedTimer::create_started();
 
-        const int return_code = System::cmd_execute_clean(command);
+        // The build streams into a per-port log instead of the console or memory;
+        // chromium-derived ports produce logs in the gigabytes.
+        GC::record_buildtree_access(paths, spec.name());
+
+        fs::path build_log_path =
+            paths.buildtrees / spec.name() / Strings::format("build-%s.log", triplet.canonical_name());
+        if (GlobalState::g_compress_logs) build_log_path += LogCompression::FILE_EXTENSION;
+        {
+            std::error_code ec;
+            fs.create_directories(build_log_path.parent_path(), ec);
+        }
+
+#if defined(_WIN32)
+        const auto build_output =
+            cmd_execute_clean_with_build_env(paths, pre_build_info, toolset, cmd_launch_cmake, build_log_path);
+#else
+        const auto build_output = System::cmd_execute_and_capture_output_to_file(
+            Strings::format(R"(%s && %s)", cmd_set_environment, cmd_launch_cmake),
+            build_log_path,
+            BUILD_LOG_TAIL_CAPACITY);
+#endif
+        const int return_code = build_output.exit_code;
         const auto buildtimeus = timer.microseconds();
         const auto spec_string = spec.to_string();
 
+        // Recorded through the per-thread buffer: build_package runs on worker threads
+        // during parallel installs, which must not serialize on the metrics lock.
+        if (Metrics::metrics_enabled())
         {
-            auto locked_metrics = Metrics::g_metrics.lock();
-            locked_metrics->track_metric("buildtimeus-" + spec_string, buildtimeus);
+            Metrics::track_metric_buffered("buildtimeus-" + spec_string, buildtimeus);
             if (return_code != 0)
             {
-                locked_metrics->track_property("error", "build failed");
-                locked_metrics->track_property("build_error", spec_string);
-                return BuildResult::BUILD_FAILED;
+                Metrics::track_property_buffered("error", "build failed");
+                Metrics::track_property_buffered("build_error", spec_string);
             }
         }
 
+        if (return_code != 0)
+        {
+            if (!build_output.output.empty()) System::print("%s", build_output.output);
+            System::println(System::Color::error, "See the full log at:\n    %s", build_log_path.u8string());
+            record_build_failure(paths, abi_tag, BuildResult::BUILD_FAILED);
+            return BuildResult::BUILD_FAILED;
+        }
+
         const BuildInfo build_info = read_build_info(paths.get_filesystem(), paths.build_info_file_path(spec));
-        const size_t error_count = PostBuildLint::perform_all_checks(spec, paths, pre_build_info, build_info);
+        size_t error_count = 0;
+        const bool lint_previously_passed = !abi_tag.empty() && fs.exists(lint_pass_path_for_abi_tag(paths, abi_tag));
+        if (lint_previously_passed)
+        {
+            System::println("-- Skipping post-build validation: passed for identical build inputs");
+        }
+        else
+        {
+            Timing::PhaseScope lint_scope("lint");
+            error_count = PostBuildLint::perform_all_checks(spec, paths, pre_build_info, build_info);
+            if (error_count == 0 && !abi_tag.empty())
+            {
+                const fs::path lint_pass_path = lint_pass_path_for_abi_tag(paths, abi_tag);
+                std::error_code lint_ec;
+                fs.create_directories(lint_pass_path.parent_path(), lint_ec);
+                if (!lint_ec) fs.write_contents(lint_pass_path, to_string(BuildResult::SUCCEEDED));
+            }
+        }
 
-        auto bcf = create_binary_control_file(*config.scf.core_paragraph, triplet, build_info);
+        auto bcf = create_binary_control_file(config.scf.core_paragraph, triplet, build_info);
+        bcf->core_paragraph.abi = abi_tag;
 
         if (error_count != 0)
         {
+            record_build_failure(paths, abi_tag, BuildResult::POST_BUILD_CHECKS_FAILED);
             return BuildResult::POST_BUILD_CHECKS_FAILED;
         }
         if (GlobalState::feature_packages)
@@ -352,31 +994,98 @@ namespace vcpkg::Build
             {
                 for (auto&& f_pgh : config.scf.feature_paragraphs)
                 {
-                    if (f_pgh->name == feature)
+                    if (f_pgh.name == feature)
                         bcf->features.push_back(
-                            create_binary_feature_control_file(*config.scf.core_paragraph, *f_pgh, triplet));
+                            create_binary_feature_control_file(config.scf.core_paragraph, f_pgh, triplet));
                 }
             }
         }
 
         write_binary_control_file(paths, *bcf);
+        GC::record_package_access(paths, spec);
+
+        if (!abi_tag.empty())
+        {
+            const fs::path archive_path = archive_path_for_abi_tag(paths, abi_tag);
+            const fs::path archive_tmp_path = archive_path.generic_string() + ".tmp";
+            const fs::path package_dir = paths.package_dir(spec);
+
+            std::error_code ec;
+            fs.create_directories(archive_path.parent_path(), ec);
+            const int compress_code = System::cmd_execute_clean(Strings::format(R"("%s" -E chdir "%s" "%s" -E tar cf "%s" --format=zip .)",
+                                                                                cmake_exe_path.u8string(),
+                                                                                package_dir.u8string(),
+                                                                                cmake_exe_path.u8string(),
+                                                                                archive_tmp_path.u8string()));
+            if (compress_code == 0)
+            {
+                fs.rename(archive_tmp_path, archive_path);
+
+                const auto maybe_remote = remote_binary_cache_url();
+                if (const auto base_url = maybe_remote.get())
+                {
+                    // Uploaded on a detached thread so the install phase is not held
+                    // up; if an interrupted upload never lands, other agents simply
+                    // rebuild and retry the upload themselves.
+                    const std::string url = remote_archive_url(*base_url, abi_tag);
+                    std::thread([url, archive_path]() {
+                        if (!Downloads::upload_file(url, archive_path))
+                            System::println(
+                                System::Color::warning, "Failed to upload binary cache entry: %s", url);
+                    }).detach();
+                }
+            }
+            else
+            {
+                System::println(System::Color::warning, "Failed to store binary package cache entry");
+                fs.remove(archive_tmp_path, ec);
+            }
+        }
 
         if (config.build_package_options.clean_buildtrees == CleanBuildtrees::YES)
         {
-            auto& fs = paths.get_filesystem();
             auto buildtrees_dir = paths.buildtrees / spec.name();
             auto buildtree_files = fs.get_files_non_recursive(buildtrees_dir);
             for (auto&& file : buildtree_files)
             {
+                // Handed to the janitor: the deletion overlaps the next package's
+                // build instead of stalling this one's completion.
                 if (fs.is_directory(file) && file.filename() != "src")
                 {
-                    std::error_code ec;
-                    fs.remove_all(file, ec);
+                    BuildtreeJanitor::instance().enqueue(fs, file);
                 }
             }
         }
 
-        return {BuildResult::SUCCEEDED, std::move(bcf)};
+        if (GlobalState::g_compress_packages)
+        {
+            // Finalize the staged package as a single archive (the CONTROL metadata is
+            // inside). The expanded tree is kept for the install that follows in this run
+            // and is dropped by install_package() afterwards.
+            const fs::path package_dir = paths.package_dir(spec);
+            const fs::path package_archive = package_archive_path(paths, spec);
+            const fs::path package_archive_tmp = package_archive.generic_string() + ".tmp";
+            const int compress_code =
+                System::cmd_execute_clean(Strings::format(R"("%s" -E chdir "%s" "%s" -E tar cf "%s" --format=zip .)",
+                                                          cmake_exe_path.u8string(),
+                                                          package_dir.u8string(),
+                                                          cmake_exe_path.u8string(),
+                                                          package_archive_tmp.u8string()));
+            if (compress_code == 0)
+            {
+                fs.rename(package_archive_tmp, package_archive);
+            }
+            else
+            {
+                System::println(System::Color::warning, "Failed to compress package %s", spec);
+                std::error_code ec;
+                fs.remove(package_archive_tmp, ec);
+            }
+        }
+
+        ExtendedBuildResult result{BuildResult::SUCCEEDED, std::move(bcf)};
+        result.peak_memory_bytes = build_output.peak_memory_bytes;
+        return result;
     }
 
     const std::string& to_string(const BuildResult build_result)
@@ -419,56 +1128,82 @@ namespace vcpkg::Build
                                Commands::Version::version());
     }
 
-    static BuildInfo inner_create_buildinfo(std::unordered_map<std::string, std::string> pgh)
+    // BUILD_INFO is machine-generated with a fixed single-paragraph schema, so it is
+    // parsed in one pass straight into the struct, the same way parse_pre_build_info
+    // handles triplet variables, instead of through the generic paragraph machinery and
+    // an intermediate field map.
+    static BuildInfo parse_build_info(const std::vector<std::string>& lines)
     {
-        Parse::ParagraphParser parser(std::move(pgh));
-
         BuildInfo build_info;
+        bool seen_crt_linkage = false;
+        bool seen_library_linkage = false;
+        std::map<BuildPolicy, bool> policies;
 
+        for (const std::string& line : lines)
         {
-            std::string crt_linkage_as_string;
-            parser.required_field(BuildInfoRequiredField::CRT_LINKAGE, crt_linkage_as_string);
+            if (line.empty()) continue;
 
-            auto crtlinkage = to_linkage_type(crt_linkage_as_string);
-            if (const auto p = crtlinkage.get())
-                build_info.crt_linkage = *p;
-            else
-                Checks::exit_with_message(VCPKG_LINE_INFO, "Invalid crt linkage type: [%s]", crt_linkage_as_string);
-        }
+            const size_t colon = line.find(':');
+            Checks::check_exit(VCPKG_LINE_INFO,
+                               colon != std::string::npos,
+                               "Expected format is [FieldName: value], but was [%s]",
+                               line);
+            const std::string name = line.substr(0, colon);
+            size_t value_start = colon + 1;
+            while (value_start < line.size() && line[value_start] == ' ')
+                ++value_start;
+            const std::string value = line.substr(value_start);
 
-        {
-            std::string library_linkage_as_string;
-            parser.required_field(BuildInfoRequiredField::LIBRARY_LINKAGE, library_linkage_as_string);
-            auto liblinkage = to_linkage_type(library_linkage_as_string);
-            if (const auto p = liblinkage.get())
-                build_info.library_linkage = *p;
-            else
-                Checks::exit_with_message(
-                    VCPKG_LINE_INFO, "Invalid library linkage type: [%s]", library_linkage_as_string);
-        }
-        std::string version = parser.optional_field("Version");
-        if (!version.empty()) build_info.version = std::move(version);
+            if (name == BuildInfoRequiredField::CRT_LINKAGE)
+            {
+                const auto crtlinkage = to_linkage_type(value);
+                if (const auto p = crtlinkage.get())
+                    build_info.crt_linkage = *p;
+                else
+                    Checks::exit_with_message(VCPKG_LINE_INFO, "Invalid crt linkage type: [%s]", value);
+                seen_crt_linkage = true;
+                continue;
+            }
 
-        std::map<BuildPolicy, bool> policies;
-        for (auto policy : G_ALL_POLICIES)
-        {
-            const auto setting = parser.optional_field(to_string(policy));
-            if (setting.empty()) continue;
-            if (setting == "enabled")
-                policies.emplace(policy, true);
-            else if (setting == "disabled")
-                policies.emplace(policy, false);
-            else
-                Checks::exit_with_message(
-                    VCPKG_LINE_INFO, "Unknown setting for policy '%s': %s", to_string(policy), setting);
-        }
+            if (name == BuildInfoRequiredField::LIBRARY_LINKAGE)
+            {
+                const auto liblinkage = to_linkage_type(value);
+                if (const auto p = liblinkage.get())
+                    build_info.library_linkage = *p;
+                else
+                    Checks::exit_with_message(VCPKG_LINE_INFO, "Invalid library linkage type: [%s]", value);
+                seen_library_linkage = true;
+                continue;
+            }
 
-        if (const auto err = parser.error_info("PostBuildInformation"))
-        {
-            print_error_message(err);
-            Checks::exit_fail(VCPKG_LINE_INFO);
+            if (name == "Version")
+            {
+                if (!value.empty()) build_info.version = value;
+                continue;
+            }
+
+            const auto policy = Util::find_if(G_ALL_POLICIES, [&](BuildPolicy p) { return to_string(p) == name; });
+            if (policy != G_ALL_POLICIES.end())
+            {
+                if (value == "enabled")
+                    policies.emplace(*policy, true);
+                else if (value == "disabled")
+                    policies.emplace(*policy, false);
+                else
+                    Checks::exit_with_message(
+                        VCPKG_LINE_INFO, "Unknown setting for policy '%s': %s", name, value);
+                continue;
+            }
+
+            Checks::exit_with_message(VCPKG_LINE_INFO, "Unknown field in BUILD_INFO file: %s", name);
         }
 
+        Checks::check_exit(VCPKG_LINE_INFO,
+                           seen_crt_linkage && seen_library_linkage,
+                           "Missing required field in BUILD_INFO file (%s and %s are required)",
+                           BuildInfoRequiredField::CRT_LINKAGE,
+                           BuildInfoRequiredField::LIBRARY_LINKAGE);
+
         build_info.policies = BuildPolicies(std::move(policies));
 
         return build_info;
@@ -476,40 +1211,85 @@ namespace vcpkg::Build
 
     BuildInfo read_build_info(const Files::Filesystem& fs, const fs::path& filepath)
     {
-        const Expected<std::unordered_map<std::string, std::string>> pghs =
-            Paragraphs::get_single_paragraph(fs, filepath);
-        Checks::check_exit(VCPKG_LINE_INFO, pghs.get() != nullptr, "Invalid BUILD_INFO file for package");
-        return inner_create_buildinfo(*pghs.get());
+        const Expected<std::vector<std::string>> maybe_lines = fs.read_lines(filepath);
+        const auto lines = maybe_lines.get();
+        Checks::check_exit(VCPKG_LINE_INFO, lines != nullptr, "Invalid BUILD_INFO file for package");
+        return parse_build_info(*lines);
     }
 
-    PreBuildInfo PreBuildInfo::from_triplet_file(const VcpkgPaths& paths, const Triplet& triplet)
+    namespace
     {
-        static constexpr CStringView FLAG_GUID = "c35112b6-d1ba-415b-aa5d-81de856ef8eb";
+        // On-disk memo of triplet file evaluations, keyed by triplet name and the hash
+        // of the triplet file it was captured from. Each section is the raw
+        // VARIABLE=VALUE lines emitted by get_triplet_environment.cmake, terminated by
+        // a blank line.
+        struct TripletEnvCacheEntry
+        {
+            std::string file_hash;
+            std::vector<std::string> lines;
+        };
 
-        const fs::path& cmake_exe_path = paths.get_cmake_exe();
-        const fs::path ports_cmake_script_path = paths.scripts / "get_triplet_environment.cmake";
-        const fs::path triplet_file_path = paths.triplets / (triplet.canonical_name() + ".cmake");
+        const char* const TRIPLET_ENV_CACHE_VERSION = "1";
 
-        const auto cmd_launch_cmake = System::make_cmake_cmd(cmake_exe_path,
-                                                             ports_cmake_script_path,
-                                                             {
-                                                                 {"CMAKE_TRIPLET_FILE", triplet_file_path},
-                                                             });
-        const auto ec_data = System::cmd_execute_and_capture_output(cmd_launch_cmake);
-        Checks::check_exit(VCPKG_LINE_INFO, ec_data.exit_code == 0, ec_data.output);
+        fs::path triplet_env_cache_path(const VcpkgPaths& paths) { return paths.root / ".vcpkg-triplet-env.cache"; }
 
-        const std::vector<std::string> lines = Strings::split(ec_data.output, "\n");
+        std::unordered_map<std::string, TripletEnvCacheEntry> load_triplet_env_cache(const Files::Filesystem& fs,
+                                                                                     const fs::path& cache_path)
+        {
+            std::unordered_map<std::string, TripletEnvCacheEntry> cache;
+            auto maybe_lines = fs.read_lines(cache_path);
+            const auto lines = maybe_lines.get();
+            if (!lines || lines->empty() || (*lines)[0] != TRIPLET_ENV_CACHE_VERSION) return cache;
 
-        PreBuildInfo pre_build_info;
+            for (size_t i = 1; i < lines->size();)
+            {
+                if ((*lines)[i].empty())
+                {
+                    ++i;
+                    continue;
+                }
 
-        const auto e = lines.cend();
-        auto cur = std::find(lines.cbegin(), e, FLAG_GUID);
-        if (cur != e) ++cur;
+                const std::vector<std::string> header = Strings::split((*lines)[i], " ");
+                if (header.size() != 2) break;
 
-        for (; cur != e; ++cur)
+                TripletEnvCacheEntry entry;
+                entry.file_hash = header[1];
+                for (++i; i < lines->size() && !(*lines)[i].empty(); ++i)
+                {
+                    entry.lines.push_back((*lines)[i]);
+                }
+                cache.emplace(header[0], std::move(entry));
+            }
+
+            return cache;
+        }
+
+        void save_triplet_env_cache(Files::Filesystem& fs,
+                                    const fs::path& cache_path,
+                                    const std::unordered_map<std::string, TripletEnvCacheEntry>& cache)
         {
-            auto&& line = *cur;
+            std::string contents = TRIPLET_ENV_CACHE_VERSION;
+            contents.push_back('\n');
+            for (const auto& named_entry : cache)
+            {
+                contents.append(Strings::format("%s %s\n", named_entry.first, named_entry.second.file_hash));
+                for (const std::string& line : named_entry.second.lines)
+                {
+                    contents.append(line);
+                    contents.push_back('\n');
+                }
+                contents.push_back('\n');
+            }
+            fs.write_contents(cache_path, contents);
+        }
+    }
+
+    static PreBuildInfo parse_pre_build_info(const std::vector<std::string>& lines)
+    {
+        PreBuildInfo pre_build_info;
 
+        for (auto&& line : lines)
+        {
             const std::vector<std::string> s = Strings::split(line, "=");
             Checks::check_exit(VCPKG_LINE_INFO,
                                s.size() == 1 || s.size() == 2,
@@ -578,6 +1358,70 @@ namespace vcpkg::Build
 
         return pre_build_info;
     }
+
+    PreBuildInfo PreBuildInfo::from_triplet_file(const VcpkgPaths& paths, const Triplet& triplet)
+    {
+        static constexpr CStringView FLAG_GUID = "c35112b6-d1ba-415b-aa5d-81de856ef8eb";
+
+        // A plan over a single triplet would otherwise launch an identical CMake
+        // evaluation for every package it builds.
+        static std::mutex memo_mutex;
+        static std::unordered_map<std::string, PreBuildInfo> memo;
+        {
+            std::lock_guard<std::mutex> lock(memo_mutex);
+            auto it = memo.find(triplet.canonical_name());
+            if (it != memo.end()) return it->second;
+        }
+
+        auto& fs = paths.get_filesystem();
+        const fs::path triplet_file_path = paths.triplets / (triplet.canonical_name() + ".cmake");
+        auto maybe_file_hash = Hash::get_file_hash(fs, triplet_file_path, "SHA256");
+        std::string file_hash = maybe_file_hash.has_value() ? std::move(*maybe_file_hash.get()) : std::string();
+        const fs::path cache_path = triplet_env_cache_path(paths);
+
+        auto disk_cache = load_triplet_env_cache(fs, cache_path);
+        auto cached = disk_cache.find(triplet.canonical_name());
+        if (!file_hash.empty() && cached != disk_cache.end() && cached->second.file_hash == file_hash)
+        {
+            PreBuildInfo pre_build_info = parse_pre_build_info(cached->second.lines);
+            std::lock_guard<std::mutex> lock(memo_mutex);
+            return memo.emplace(triplet.canonical_name(), std::move(pre_build_info)).first->second;
+        }
+
+        const fs::path& cmake_exe_path = paths.get_cmake_exe();
+        const fs::path ports_cmake_script_path = paths.scripts / "get_triplet_environment.cmake";
+
+        const auto cmd_launch_cmake = System::make_cmake_cmd(cmake_exe_path,
+                                                             ports_cmake_script_path,
+                                                             {
+                                                                 {"CMAKE_TRIPLET_FILE", triplet_file_path},
+                                                             });
+        const auto ec_data = System::cmd_execute_and_capture_output(cmd_launch_cmake);
+        Checks::check_exit(VCPKG_LINE_INFO, ec_data.exit_code == 0, ec_data.output);
+
+        const std::vector<std::string> lines = Strings::split(ec_data.output, "\n");
+
+        std::vector<std::string> var_lines;
+        const auto e = lines.cend();
+        auto cur = std::find(lines.cbegin(), e, FLAG_GUID);
+        if (cur != e) ++cur;
+        for (; cur != e; ++cur)
+        {
+            if (!cur->empty()) var_lines.push_back(*cur);
+        }
+
+        PreBuildInfo pre_build_info = parse_pre_build_info(var_lines);
+
+        if (!file_hash.empty())
+        {
+            disk_cache[triplet.canonical_name()] = TripletEnvCacheEntry{file_hash, std::move(var_lines)};
+            save_triplet_env_cache(fs, cache_path, disk_cache);
+        }
+
+        std::lock_guard<std::mutex> lock(memo_mutex);
+        return memo.emplace(triplet.canonical_name(), std::move(pre_build_info)).first->second;
+    }
+
     ExtendedBuildResult::ExtendedBuildResult(BuildResult code) : code(code) {}
     ExtendedBuildResult::ExtendedBuildResult(BuildResult code, std::unique_ptr<BinaryControlFile>&& bcf)
         : code(code), binary_control_file(std::move(bcf))
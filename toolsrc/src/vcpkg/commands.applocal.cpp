@@ -0,0 +1,142 @@
+#include "pch.h"
+
+#include <vcpkg/base/cofffilereader.h>
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/strings.h>
+#include <vcpkg/base/system.h>
+#include <vcpkg/commands.h>
+#include <vcpkg/help.h>
+
+#include <set>
+
+namespace vcpkg::Commands::AppLocal
+{
+    // Native replacement for applocal.ps1: copies the DLLs a freshly linked binary imports
+    // from the installed tree next to the binary, recursing through the copied DLLs' own
+    // imports. Invoked by scripts/buildsystems/msbuild/vcpkg.targets after every link, so it
+    // avoids PowerShell startup entirely and skips the scan when the binary is unchanged.
+
+    const CommandStructure COMMAND_STRUCTURE = {
+        Help::create_example_string(R"(x-applocal path\to\app.exe installed\x64-windows\bin [tlogFile] [copiedFilesLog])"),
+        2,
+        4,
+        {},
+        nullptr,
+    };
+
+    struct AppLocalState
+    {
+        Files::Filesystem& fs;
+        fs::path installed_bin_dir;
+        std::set<std::string> searched;
+        std::vector<std::string> deployed;
+    };
+
+    static void resolve_imports(AppLocalState& state, const fs::path& binary)
+    {
+        if (!state.fs.exists(binary)) return;
+
+        const CoffFileReader::DllInfo info = CoffFileReader::read_dll(binary);
+        const fs::path binary_dir = binary.parent_path();
+
+        for (const std::string& dll_name : info.imported_dll_names)
+        {
+            const std::string key = Strings::ascii_to_lowercase(dll_name);
+            if (!state.searched.insert(key).second) continue;
+
+            const fs::path source = state.installed_bin_dir / dll_name;
+            const fs::path destination = binary_dir / dll_name;
+            if (state.fs.exists(source))
+            {
+                if (!state.fs.exists(destination))
+                {
+                    std::error_code ec;
+                    state.fs.copy_file(source, destination, fs::copy_options::none, ec);
+                }
+                state.deployed.push_back(destination.u8string());
+                resolve_imports(state, destination);
+            }
+            else if (state.fs.exists(destination))
+            {
+                // Not provided by vcpkg but already deployed locally; still scan its imports.
+                resolve_imports(state, destination);
+            }
+        }
+    }
+
+    // Stamp of the target binary recorded in the cache; when it matches, the previous
+    // deployment is still valid and the import scan can be skipped.
+    static std::string target_stamp(const Files::Filesystem& fs, const fs::path& target_binary)
+    {
+        std::error_code ec;
+        const auto write_time = fs.last_write_time(target_binary, ec);
+        if (ec) return "";
+        const auto size = fs.file_size(target_binary, ec);
+        if (ec) return "";
+        return Strings::format("%lld %llu", static_cast<long long>(write_time), static_cast<unsigned long long>(size));
+    }
+
+    static void write_logs(Files::Filesystem& fs,
+                           const std::string& tlog_file,
+                           const std::string& copied_files_log,
+                           const std::vector<std::string>& deployed)
+    {
+        std::string lines;
+        for (const std::string& file : deployed)
+        {
+            lines.append(file);
+            lines.append("\r\n");
+        }
+
+        if (!tlog_file.empty()) fs.append_contents(fs::u8path(tlog_file), lines);
+        if (!copied_files_log.empty()) fs.write_contents(fs::u8path(copied_files_log), lines);
+    }
+
+    void perform_and_exit(const VcpkgCmdArguments& args)
+    {
+        args.parse_arguments(COMMAND_STRUCTURE);
+
+        const fs::path target_binary = fs::u8path(args.command_arguments[0]);
+        const fs::path installed_bin_dir = fs::u8path(args.command_arguments[1]);
+        const std::string tlog_file = args.command_arguments.size() > 2 ? args.command_arguments[2] : "";
+        const std::string copied_files_log = args.command_arguments.size() > 3 ? args.command_arguments[3] : "";
+
+        auto& fs = Files::get_real_filesystem();
+        if (!fs.exists(target_binary)) Checks::exit_success(VCPKG_LINE_INFO);
+
+        const fs::path cache_path = fs::u8path(target_binary.u8string() + ".vcpkg-applocal.cache");
+        const std::string stamp = target_stamp(fs, target_binary);
+
+        // Cache hit: the binary has not been relinked and everything previously deployed is
+        // still in place, so only the logs need to be rewritten.
+        const auto cache_lines = fs.read_lines(cache_path);
+        if (const auto lines = cache_lines.get())
+        {
+            if (!lines->empty() && !stamp.empty() && (*lines)[0] == stamp)
+            {
+                const std::vector<std::string> deployed((*lines).begin() + 1, (*lines).end());
+                const bool all_present = std::all_of(deployed.begin(), deployed.end(), [&](const std::string& file) {
+                    return fs.exists(fs::u8path(file));
+                });
+                if (all_present)
+                {
+                    write_logs(fs, tlog_file, copied_files_log, deployed);
+                    Checks::exit_success(VCPKG_LINE_INFO);
+                }
+            }
+        }
+
+        AppLocalState state{fs, installed_bin_dir, {}, {}};
+        resolve_imports(state, target_binary);
+
+        write_logs(fs, tlog_file, copied_files_log, state.deployed);
+
+        std::vector<std::string> cache_contents;
+        cache_contents.push_back(target_stamp(fs, target_binary));
+        for (const std::string& file : state.deployed)
+            cache_contents.push_back(file);
+        fs.write_lines(cache_path, cache_contents);
+
+        Checks::exit_success(VCPKG_LINE_INFO);
+    }
+}
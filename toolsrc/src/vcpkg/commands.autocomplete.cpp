@@ -13,7 +13,7 @@ namespace vcpkg::Commands::Autocomplete
     [[noreturn]] static void output_sorted_results_and_exit(const LineInfo& line_info,
                                                             std::vector<std::string>&& results)
     {
-        const SortedVector<std::string> sorted_results(results);
+        const SortedVector<std::string> sorted_results(std::move(results));
         System::println(Strings::join("\n", sorted_results));
 
         Checks::exit_success(line_info);
@@ -39,8 +39,9 @@ namespace vcpkg::Commands::Autocomplete
         {
             const std::string requested_command = match[1].str();
 
-            // First try public commands
-            std::vector<std::string> public_commands = {
+            // The name tables are constexpr so a tab press allocates only for the
+            // matches it prints. First try public commands
+            static constexpr CStringView PUBLIC_COMMANDS[] = {
                 "install",
                 "search",
                 "remove",
@@ -58,17 +59,26 @@ namespace vcpkg::Commands::Autocomplete
                 "contact",
             };
 
-            Util::unstable_keep_if(public_commands, [&](const std::string& s) {
-                return Strings::case_insensitive_ascii_starts_with(s, requested_command);
-            });
+            const auto matches_of = [&](Span<const CStringView> commands) {
+                std::vector<std::string> results;
+                for (const CStringView& command : commands)
+                {
+                    if (Strings::case_insensitive_ascii_starts_with(command.c_str(), requested_command))
+                    {
+                        results.push_back(command.c_str());
+                    }
+                }
+                return results;
+            };
 
-            if (!public_commands.empty())
+            std::vector<std::string> public_matches = matches_of(PUBLIC_COMMANDS);
+            if (!public_matches.empty())
             {
-                output_sorted_results_and_exit(VCPKG_LINE_INFO, std::move(public_commands));
+                output_sorted_results_and_exit(VCPKG_LINE_INFO, std::move(public_matches));
             }
 
             // If no public commands match, try private commands
-            std::vector<std::string> private_commands = {
+            static constexpr CStringView PRIVATE_COMMANDS[] = {
                 "build",
                 "buildexternal",
                 "ci",
@@ -78,11 +88,7 @@ namespace vcpkg::Commands::Autocomplete
                 "portsdiff",
             };
 
-            Util::unstable_keep_if(private_commands, [&](const std::string& s) {
-                return Strings::case_insensitive_ascii_starts_with(s, requested_command);
-            });
-
-            output_sorted_results_and_exit(VCPKG_LINE_INFO, std::move(private_commands));
+            output_sorted_results_and_exit(VCPKG_LINE_INFO, matches_of(PRIVATE_COMMANDS));
         }
 
         // Handles vcpkg install package:<triplet>
@@ -1,6 +1,7 @@
 #include "pch.h"
 
 #include <vcpkg/base/files.h>
+#include <vcpkg/base/parallel.h>
 #include <vcpkg/base/system.h>
 #include <vcpkg/binaryparagraph.h>
 #include <vcpkg/commands.h>
@@ -9,20 +10,49 @@
 
 namespace vcpkg::Commands::Cache
 {
-    static std::vector<BinaryParagraph> read_all_binary_paragraphs(const VcpkgPaths& paths)
+    static Optional<BinaryParagraph> read_binary_paragraph(const Files::Filesystem& fs, const fs::path& path)
     {
-        std::vector<BinaryParagraph> output;
-        for (auto&& path : paths.get_filesystem().get_files_non_recursive(paths.packages))
+        // Prefer the binary sidecar written at package creation; parsing the text
+        // CONTROL of every package dominates this command on large caches.
+        const Expected<std::string> sidecar = fs.read_contents(path / "CONTROL.bin");
+        if (const auto contents = sidecar.get())
         {
-            const Expected<std::unordered_map<std::string, std::string>> pghs =
-                Paragraphs::get_single_paragraph(paths.get_filesystem(), path / "CONTROL");
-            if (const auto p = pghs.get())
+            auto maybe_bcf = deserialize_binary(*contents);
+            if (const auto bcf = maybe_bcf.get())
             {
-                const BinaryParagraph binary_paragraph = BinaryParagraph(*p);
-                output.push_back(binary_paragraph);
+                return std::move(bcf->core_paragraph);
             }
         }
 
+        const Expected<Paragraphs::RawParagraph> pghs =
+            Paragraphs::get_single_paragraph(fs, path / "CONTROL");
+        if (const auto p = pghs.get())
+        {
+            return BinaryParagraph(*p);
+        }
+
+        return nullopt;
+    }
+
+    static std::vector<BinaryParagraph> read_all_binary_paragraphs(const VcpkgPaths& paths)
+    {
+        auto& fs = paths.get_filesystem();
+        const std::vector<fs::path> package_dirs = fs.get_files_non_recursive(paths.packages);
+
+        // The per-package reads are independent and dominated by I/O latency, so they
+        // are sharded across worker threads. One result slot per directory keeps the
+        // output in enumeration order regardless of which worker finishes first.
+        std::vector<Optional<BinaryParagraph>> results(package_dirs.size());
+
+        Parallel::for_each_index(package_dirs.size(),
+                                 [&](const size_t i) { results[i] = read_binary_paragraph(fs, package_dirs[i]); });
+
+        std::vector<BinaryParagraph> output;
+        for (auto&& result : results)
+        {
+            if (const auto p = result.get()) output.push_back(std::move(*p));
+        }
+
         return output;
     }
 
@@ -0,0 +1,55 @@
+#include "pch.h"
+
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/logcompression.h>
+#include <vcpkg/base/system.h>
+#include <vcpkg/commands.h>
+#include <vcpkg/help.h>
+
+namespace vcpkg::Commands::CatLog
+{
+    // Not System::print: log bytes go out verbatim (no format interpretation, no
+    // truncation at an embedded NUL from a crashed tool's output).
+    static void write_stdout(const std::string& contents) { fwrite(contents.data(), 1, contents.size(), stdout); }
+
+    const CommandStructure COMMAND_STRUCTURE = {
+        Help::create_example_string("x-cat-log buildtrees/zlib/build-x64-windows.log.vlz"),
+        1,
+        SIZE_MAX,
+        {},
+        nullptr,
+    };
+
+    void perform_and_exit(const VcpkgCmdArguments& args)
+    {
+        args.parse_arguments(COMMAND_STRUCTURE);
+
+        auto& fs = Files::get_real_filesystem();
+        for (const std::string& arg : args.command_arguments)
+        {
+            const fs::path path = fs::u8path(arg);
+            auto maybe_contents = fs.read_contents(path);
+            Checks::check_exit(VCPKG_LINE_INFO,
+                               maybe_contents.has_value(),
+                               "Failed to read %s: %s",
+                               path.u8string(),
+                               maybe_contents.error().message());
+            const std::string& contents = *maybe_contents.get();
+
+            if (LogCompression::is_compressed_log_path(path))
+            {
+                auto decompressed = LogCompression::decompress(contents);
+                Checks::check_exit(
+                    VCPKG_LINE_INFO, decompressed.has_value(), "%s is not a valid compressed log", path.u8string());
+                write_stdout(*decompressed.get());
+            }
+            else
+            {
+                // Plain logs pass through, so scripts can x-cat-log whatever the
+                // build left behind without caring whether compression was on.
+                write_stdout(contents);
+            }
+        }
+        Checks::exit_success(VCPKG_LINE_INFO);
+    }
+}
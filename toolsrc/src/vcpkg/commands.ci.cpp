@@ -1,11 +1,13 @@
 #include "pch.h"
 
 #include <vcpkg/base/files.h>
+#include <vcpkg/base/hash.h>
 #include <vcpkg/base/system.h>
 #include <vcpkg/base/util.h>
 #include <vcpkg/build.h>
 #include <vcpkg/commands.h>
 #include <vcpkg/dependencies.h>
+#include <vcpkg/globalstate.h>
 #include <vcpkg/help.h>
 #include <vcpkg/input.h>
 #include <vcpkg/install.h>
@@ -17,19 +19,19 @@ namespace vcpkg::Commands::CI
     using Dependencies::InstallPlanAction;
     using Dependencies::InstallPlanType;
 
-    static Install::InstallSummary run_ci_on_triplet(const Triplet& triplet,
-                                                     const VcpkgPaths& paths,
-                                                     const std::vector<std::string>& ports,
-                                                     const std::set<std::string>& exclusions_set)
+    static std::vector<Dependencies::AnyAction> create_ci_plan(const Triplet& triplet,
+                                                               const VcpkgPaths& paths,
+                                                               const Dependencies::PathsPortFileProvider& provider,
+                                                               const std::vector<std::string>& ports,
+                                                               const std::set<std::string>& exclusions_set,
+                                                               const StatusParagraphs& status_db)
     {
         Input::check_triplet(triplet, paths);
 
         const std::vector<PackageSpec> specs = PackageSpec::to_package_specs(ports, triplet);
 
-        StatusParagraphs status_db = database_load_check(paths);
-        const auto& paths_port_file = Dependencies::PathsPortFileProvider(paths);
         std::vector<InstallPlanAction> install_plan =
-            Dependencies::create_install_plan(paths_port_file, specs, status_db);
+            Dependencies::create_install_plan(provider, specs, status_db);
 
         for (InstallPlanAction& plan : install_plan)
         {
@@ -47,11 +49,21 @@ namespace vcpkg::Commands::CI
             Build::CleanBuildtrees::YES,
         };
 
+        return Util::fmap(install_plan, [&install_plan_options](InstallPlanAction& install_action) {
+            install_action.build_options = install_plan_options;
+            return Dependencies::AnyAction(std::move(install_action));
+        });
+    }
+
+    static Install::InstallSummary run_ci_on_triplet(const Triplet& triplet,
+                                                     const VcpkgPaths& paths,
+                                                     const Dependencies::PathsPortFileProvider& provider,
+                                                     const std::vector<std::string>& ports,
+                                                     const std::set<std::string>& exclusions_set)
+    {
+        StatusParagraphs status_db = database_load_check(paths);
         const std::vector<Dependencies::AnyAction> action_plan =
-            Util::fmap(install_plan, [&install_plan_options](InstallPlanAction& install_action) {
-                install_action.build_options = install_plan_options;
-                return Dependencies::AnyAction(std::move(install_action));
-            });
+            create_ci_plan(triplet, paths, provider, ports, exclusions_set, status_db);
 
         return Install::perform(action_plan, Install::KeepGoing::YES, paths, status_db);
     }
@@ -62,12 +74,44 @@ namespace vcpkg::Commands::CI
         Install::InstallSummary summary;
     };
 
+    struct Shard
+    {
+        size_t index; // zero-based
+        size_t count;
+    };
+
+    // Keeps the ports this shard is responsible for. Partitioning keys on the stable
+    // hash of "port:triplet", so every machine computes the same assignment with no
+    // coordination. Only the top-level targets are partitioned; create_install_plan
+    // then pulls in each shard's full dependency closure, so shared dependencies are
+    // built by every shard that needs them rather than being missed.
+    static std::vector<std::string> ports_for_shard(const std::vector<std::string>& ports,
+                                                    const Triplet& triplet,
+                                                    const Shard& shard)
+    {
+        std::vector<std::string> result;
+        for (const std::string& port : ports)
+        {
+            const std::string hash =
+                vcpkg::Hash::get_string_hash(Strings::format("%s:%s", port, triplet.canonical_name()), "SHA256");
+            const uint64_t value = std::strtoull(hash.substr(0, 16).c_str(), nullptr, 16);
+            if (value % shard.count == shard.index) result.push_back(port);
+        }
+        return result;
+    }
+
     static const std::string OPTION_EXCLUDE = "--exclude";
     static const std::string OPTION_XUNIT = "--x-xunit";
+    static const std::string OPTION_X_CONCURRENCY = "--x-concurrency";
+    static const std::string OPTION_SHARD = "--shard";
+    static const std::string OPTION_X_RESULTS = "--x-results";
 
-    static const std::array<CommandSetting, 2> CI_SETTINGS = {{
+    static const std::array<CommandSetting, 5> CI_SETTINGS = {{
         {OPTION_EXCLUDE, "Comma separated list of ports to skip"},
         {OPTION_XUNIT, "File to output results in XUnit format (internal)"},
+        {OPTION_X_CONCURRENCY, "(Experimental) Build up to N packages concurrently across all triplets"},
+        {OPTION_SHARD, "Build only shard i of N (--shard=i/N); ports are partitioned by stable hash"},
+        {OPTION_X_RESULTS, "File to output a result manifest mergeable with the x-ci-merge command"},
     }};
 
     const CommandStructure COMMAND_STRUCTURE = {
@@ -82,6 +126,11 @@ namespace vcpkg::Commands::CI
     {
         const ParsedArguments options = args.parse_arguments(COMMAND_STRUCTURE);
 
+        // CI runs record failed outcomes next to the binary cache, keyed by the same abi
+        // tag, so a port that failed with unchanged inputs is reported from the cache
+        // instead of being rebuilt. Interactive builds keep retrying as before.
+        GlobalState::g_cache_failed_builds = true;
+
         std::set<std::string> exclusions_set;
         auto it_exclusions = options.settings.find(OPTION_EXCLUDE);
         if (it_exclusions != options.settings.end())
@@ -101,12 +150,83 @@ namespace vcpkg::Commands::CI
             triplets.push_back(default_triplet);
         }
 
+        Optional<Shard> shard;
+        const auto it_shard = options.settings.find(OPTION_SHARD);
+        if (it_shard != options.settings.end())
+        {
+            const std::vector<std::string> parts = Strings::split(it_shard->second, "/");
+            const int i = parts.size() == 2 ? atoi(parts[0].c_str()) : 0;
+            const int n = parts.size() == 2 ? atoi(parts[1].c_str()) : 0;
+            Checks::check_exit(VCPKG_LINE_INFO,
+                               n >= 1 && i >= 1 && i <= n,
+                               "Expected --shard=i/N with 1 <= i <= N, but got: %s",
+                               it_shard->second);
+            shard = Shard{static_cast<size_t>(i) - 1, static_cast<size_t>(n)};
+        }
+
+        size_t concurrency = 1;
+        const auto it_concurrency = options.settings.find(OPTION_X_CONCURRENCY);
+        if (it_concurrency != options.settings.end())
+        {
+            concurrency = static_cast<size_t>(std::max(1, atoi(it_concurrency->second.c_str())));
+        }
+
         const std::vector<std::string> ports = Install::get_all_port_names(paths);
+
+        // One provider serves every triplet's planning, pre-warmed in parallel so each
+        // port's CONTROL is parsed exactly once per process.
+        Dependencies::PathsPortFileProvider provider(paths, args.overlay_ports);
+        provider.load_ports(ports);
+
         std::vector<TripletAndSummary> results;
-        for (const Triplet& triplet : triplets)
+        if (concurrency > 1)
         {
-            Install::InstallSummary summary = run_ci_on_triplet(triplet, paths, ports, exclusions_set);
-            results.push_back({triplet, std::move(summary)});
+            // Merge every triplet's plan into a single action plan executed by the
+            // parallel scheduler in Install::perform. Specs carry their triplet, so the
+            // worker pool pulls whichever package becomes ready in any triplet instead
+            // of draining one triplet at a time.
+            StatusParagraphs status_db = database_load_check(paths);
+            std::vector<Dependencies::AnyAction> merged_plan;
+            for (const Triplet& triplet : triplets)
+            {
+                const std::vector<std::string> triplet_ports =
+                    shard.has_value() ? ports_for_shard(ports, triplet, *shard.get()) : ports;
+                auto triplet_plan =
+                    create_ci_plan(triplet, paths, provider, triplet_ports, exclusions_set, status_db);
+                for (auto&& action : triplet_plan)
+                    merged_plan.push_back(std::move(action));
+            }
+
+            Install::InstallSummary merged_summary =
+                Install::perform(merged_plan, Install::KeepGoing::YES, paths, status_db, concurrency);
+
+            for (const Triplet& triplet : triplets)
+            {
+                results.push_back({triplet, Install::InstallSummary{}});
+                results.back().summary.total_elapsed_time = merged_summary.total_elapsed_time;
+            }
+            for (auto&& result : merged_summary.results)
+            {
+                for (auto&& triplet_result : results)
+                {
+                    if (result.spec.triplet() == triplet_result.triplet)
+                    {
+                        triplet_result.summary.results.push_back(std::move(result));
+                        break;
+                    }
+                }
+            }
+        }
+        else
+        {
+            for (const Triplet& triplet : triplets)
+            {
+                const std::vector<std::string> triplet_ports =
+                    shard.has_value() ? ports_for_shard(ports, triplet, *shard.get()) : ports;
+                Install::InstallSummary summary =
+                    run_ci_on_triplet(triplet, paths, provider, triplet_ports, exclusions_set);
+                results.push_back({triplet, std::move(summary)});
+            }
         }
 
         for (auto&& result : results)
@@ -116,6 +236,25 @@ namespace vcpkg::Commands::CI
             result.summary.print();
         }
 
+        const auto it_results_file = options.settings.find(OPTION_X_RESULTS);
+        if (it_results_file != options.settings.end())
+        {
+            // One line per spec; x-ci-merge combines these manifests across machines.
+            std::string manifest = "$vcpkg-ci-results 1\n";
+            for (auto&& result : results)
+            {
+                for (const Install::SpecSummary& r : result.summary.results)
+                {
+                    manifest += Strings::format(
+                        "%s %s %lld\n",
+                        r.spec,
+                        Build::to_string(r.build_result.code),
+                        static_cast<long long>(r.timing.as<std::chrono::milliseconds>().count()));
+                }
+            }
+            paths.get_filesystem().write_contents(fs::u8path(it_results_file->second), manifest);
+        }
+
         auto it_xunit = options.settings.find(OPTION_XUNIT);
         if (it_xunit != options.settings.end())
         {
@@ -131,3 +270,96 @@ namespace vcpkg::Commands::CI
         Checks::exit_success(VCPKG_LINE_INFO);
     }
 }
+
+namespace vcpkg::Commands::CIMerge
+{
+    using Build::BuildResult;
+
+    static const std::string MANIFEST_HEADER = "$vcpkg-ci-results 1";
+
+    const CommandStructure COMMAND_STRUCTURE = {
+        Strings::format("The arguments should be result manifests written by ci --x-results\n%s",
+                        Help::create_example_string("x-ci-merge shard1.txt shard2.txt")),
+        1,
+        SIZE_MAX,
+        {},
+        nullptr,
+    };
+
+    static BuildResult parse_build_result(const std::string& text)
+    {
+        for (const BuildResult value : Build::BUILD_RESULT_VALUES)
+        {
+            if (text == Build::to_string(value)) return value;
+        }
+        Checks::exit_with_message(VCPKG_LINE_INFO, "Unknown build result in manifest: %s", text);
+    }
+
+    void perform_and_exit(const VcpkgCmdArguments& args)
+    {
+        args.parse_arguments(COMMAND_STRUCTURE);
+
+        auto& fs = Files::get_real_filesystem();
+
+        struct MergedResult
+        {
+            BuildResult code;
+            long long milliseconds;
+        };
+
+        // Dependencies shared between shards are built by every shard that needs
+        // them; when the same spec appears in several manifests, a failure anywhere
+        // wins over a success.
+        std::map<std::string, MergedResult> merged;
+
+        for (const std::string& manifest_path : args.command_arguments)
+        {
+            const auto maybe_lines = fs.read_lines(fs::u8path(manifest_path));
+            Checks::check_exit(
+                VCPKG_LINE_INFO, maybe_lines.has_value(), "Could not read manifest: %s", manifest_path);
+            const std::vector<std::string>& lines = *maybe_lines.get();
+            Checks::check_exit(VCPKG_LINE_INFO,
+                               !lines.empty() && lines.front() == MANIFEST_HEADER,
+                               "File is not a ci result manifest: %s",
+                               manifest_path);
+
+            for (size_t i = 1; i < lines.size(); ++i)
+            {
+                if (lines[i].empty()) continue;
+                const std::vector<std::string> fields = Strings::split(lines[i], " ");
+                Checks::check_exit(VCPKG_LINE_INFO,
+                                   fields.size() == 3,
+                                   "Malformed line in manifest %s: %s",
+                                   manifest_path,
+                                   lines[i]);
+
+                const MergedResult result{parse_build_result(fields[1]),
+                                          std::strtoll(fields[2].c_str(), nullptr, 10)};
+                const auto it = merged.find(fields[0]);
+                if (it == merged.end())
+                    merged.emplace(fields[0], result);
+                else if (it->second.code == BuildResult::SUCCEEDED && result.code != BuildResult::SUCCEEDED)
+                    it->second = result;
+            }
+        }
+
+        System::println("RESULTS");
+        for (const auto& entry : merged)
+        {
+            System::println(
+                "    %s: %s: %lld ms", entry.first, Build::to_string(entry.second.code), entry.second.milliseconds);
+        }
+
+        std::map<BuildResult, int> summary;
+        for (const BuildResult& v : Build::BUILD_RESULT_VALUES)
+            summary[v] = 0;
+        for (const auto& entry : merged)
+            summary[entry.second.code]++;
+
+        System::println("\nSUMMARY");
+        for (const auto& entry : summary)
+            System::println("    %s: %d", Build::to_string(entry.first), entry.second);
+
+        Checks::exit_success(VCPKG_LINE_INFO);
+    }
+}
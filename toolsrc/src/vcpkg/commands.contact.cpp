@@ -35,7 +35,7 @@ namespace vcpkg::Commands::Contact
             if (auto p_now = maybe_now.get())
             {
                 auto& fs = Files::get_real_filesystem();
-                auto config = UserConfig::try_read_data(fs);
+                auto& config = UserConfig::get_cached(fs);
                 config.last_completed_survey = p_now->to_string();
                 config.try_write_data(fs);
             }
@@ -3,6 +3,7 @@
 #include <vcpkg/build.h>
 #include <vcpkg/commands.h>
 #include <vcpkg/export.h>
+#include <vcpkg/gc.h>
 #include <vcpkg/help.h>
 #include <vcpkg/install.h>
 #include <vcpkg/remove.h>
@@ -10,49 +11,68 @@
 
 namespace vcpkg::Commands
 {
-    Span<const PackageNameAndFunction<CommandTypeA>> get_available_commands_type_a()
-    {
-        static std::vector<PackageNameAndFunction<CommandTypeA>> t = {
-            {"install", &Install::perform_and_exit},
-            {"ci", &CI::perform_and_exit},
-            {"remove", &Remove::perform_and_exit},
-            {"upgrade", &Upgrade::perform_and_exit},
-            {"build", &Build::Command::perform_and_exit},
-            {"env", &Env::perform_and_exit},
-            {"build-external", &BuildExternal::perform_and_exit},
-            {"export", &Export::perform_and_exit},
-        };
-        return t;
-    }
+    // Each table is sorted by name (all names are lowercase ASCII, so byte order and
+    // case-insensitive order agree) for the binary search in Commands::find, and is
+    // constexpr: the names live in the binary's read-only data and dispatch builds
+    // nothing at runtime.
+    static constexpr PackageNameAndFunction<CommandTypeA> COMMANDS_TYPE_A[] = {
+        {"build", &Build::Command::perform_and_exit},
+        {"build-external", &BuildExternal::perform_and_exit},
+        {"ci", &CI::perform_and_exit},
+        {"env", &Env::perform_and_exit},
+        {"export", &Export::perform_and_exit},
+        {"install", &Install::perform_and_exit},
+        {"remove", &Remove::perform_and_exit},
+        {"upgrade", &Upgrade::perform_and_exit},
+        {"x-generate-ports", &GeneratePorts::perform_and_exit},
+        {"x-set-installed", &SetInstalled::perform_and_exit},
+    };
 
-    Span<const PackageNameAndFunction<CommandTypeB>> get_available_commands_type_b()
-    {
-        static std::vector<PackageNameAndFunction<CommandTypeB>> t = {
-            {"/?", &Help::perform_and_exit},
-            {"help", &Help::perform_and_exit},
-            {"search", &Search::perform_and_exit},
-            {"list", &List::perform_and_exit},
-            {"integrate", &Integrate::perform_and_exit},
-            {"owns", &Owns::perform_and_exit},
-            {"update", &Update::perform_and_exit},
-            {"depend-info", &DependInfo::perform_and_exit},
-            {"edit", &Edit::perform_and_exit},
-            {"create", &Create::perform_and_exit},
-            {"import", &Import::perform_and_exit},
-            {"cache", &Cache::perform_and_exit},
-            {"portsdiff", &PortsDiff::perform_and_exit},
-            {"autocomplete", &Autocomplete::perform_and_exit},
-            {"hash", &Hash::perform_and_exit},
-            };
-        return t;
-    }
+    static constexpr PackageNameAndFunction<CommandTypeB> COMMANDS_TYPE_B[] = {
+        {"/?", &Help::perform_and_exit},
+        {"autocomplete", &Autocomplete::perform_and_exit},
+        {"cache", &Cache::perform_and_exit},
+        {"create", &Create::perform_and_exit},
+        {"depend-info", &DependInfo::perform_and_exit},
+        {"edit", &Edit::perform_and_exit},
+        {"help", &Help::perform_and_exit},
+        {"import", &Import::perform_and_exit},
+        {"integrate", &Integrate::perform_and_exit},
+        {"list", &List::perform_and_exit},
+        {"owns", &Owns::perform_and_exit},
+        {"portsdiff", &PortsDiff::perform_and_exit},
+        {"search", &Search::perform_and_exit},
+        {"update", &Update::perform_and_exit},
+        {"x-daemon", &Daemon::perform_and_exit},
+        {"x-download", &Download::perform_and_exit},
+        {"x-gc", &GC::perform_and_exit},
+        {"x-graph", &Graph::perform_and_exit},
+        {"x-snapshot", &Snapshot::perform_and_exit},
+        {"x-stats", &Stats::perform_and_exit},
+        {"x-verify", &Verify::perform_and_exit},
+    };
 
-    Span<const PackageNameAndFunction<CommandTypeC>> get_available_commands_type_c()
-    {
-        static std::vector<PackageNameAndFunction<CommandTypeC>> t = {
-            {"version", &Version::perform_and_exit},
-            {"contact", &Contact::perform_and_exit}
-        };
-        return t;
-    }
+    static constexpr PackageNameAndFunction<CommandTypeC> COMMANDS_TYPE_C[] = {
+        {"contact", &Contact::perform_and_exit},
+        // Hash only touches the file it is given; keeping it here means wrapper
+        // scripts that call it in a loop never pay for root discovery or
+        // VcpkgPaths construction.
+        {"hash", &Hash::perform_and_exit},
+        {"version", &Version::perform_and_exit},
+        // Runs after every MSBuild link, so like hash it must not pay for root
+        // discovery; everything it needs arrives on the command line.
+        {"x-applocal", &AppLocal::perform_and_exit},
+        // Decompresses .vlz build logs (--x-compress-logs) for viewing; like hash
+        // it only reads the files it is given.
+        {"x-cat-log", &CatLog::perform_and_exit},
+        // Merges ci --x-results manifests from sharded runs; it only reads the
+        // files it is given, so it does not need a vcpkg root either.
+        {"x-ci-merge", &CIMerge::perform_and_exit},
+    };
+
+    Span<const PackageNameAndFunction<CommandTypeA>> get_available_commands_type_a() { return COMMANDS_TYPE_A; }
+
+    Span<const PackageNameAndFunction<CommandTypeB>> get_available_commands_type_b() { return COMMANDS_TYPE_B; }
+
+    Span<const PackageNameAndFunction<CommandTypeC>> get_available_commands_type_c() { return COMMANDS_TYPE_C; }
 }
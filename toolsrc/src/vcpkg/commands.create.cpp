@@ -1,8 +1,10 @@
 #include "pch.h"
 
 #include <vcpkg/base/files.h>
+#include <vcpkg/base/hash.h>
 #include <vcpkg/base/system.h>
 #include <vcpkg/commands.h>
+#include <vcpkg/downloads.h>
 #include <vcpkg/help.h>
 
 namespace vcpkg::Commands::Create
@@ -22,21 +24,46 @@ namespace vcpkg::Commands::Create
         const std::string port_name = args.command_arguments.at(0);
         const std::string url = args.command_arguments.at(1);
 
-        const fs::path& cmake_exe = paths.get_cmake_exe();
-
-        std::vector<System::CMakeVariable> cmake_args{{"CMD", "CREATE"}, {"PORT", port_name}, {"URL", url}};
-
+        std::string zip_file_name;
         if (args.command_arguments.size() >= 3)
         {
-            const std::string& zip_file_name = args.command_arguments.at(2);
-            Checks::check_exit(VCPKG_LINE_INFO,
-                               !Files::has_invalid_chars_for_filesystem(zip_file_name),
-                               R"(Filename cannot contain invalid chars %s, but was %s)",
-                               Files::FILESYSTEM_INVALID_CHARACTERS,
-                               zip_file_name);
-            cmake_args.push_back({"FILENAME", zip_file_name});
+            zip_file_name = args.command_arguments.at(2);
+        }
+        else
+        {
+            // Mirror ports.cmake's default: the last path component of the URL.
+            const size_t last_slash = url.find_last_of('/');
+            zip_file_name = last_slash == std::string::npos ? url : url.substr(last_slash + 1);
+        }
+        Checks::check_exit(VCPKG_LINE_INFO,
+                           !Files::has_invalid_chars_for_filesystem(zip_file_name),
+                           R"(Filename cannot contain invalid chars %s, but was %s)",
+                           Files::FILESYSTEM_INVALID_CHARACTERS,
+                           zip_file_name);
+
+        // Download and hash in-process, in one pass: the archive's SHA512 is
+        // computed while it streams to disk, and the generation script receives it
+        // instead of rereading a multi-GB file.
+        auto& fs = paths.get_filesystem();
+        const fs::path archive = paths.downloads / fs::u8path(zip_file_name);
+        std::string sha512;
+        if (fs.exists(archive))
+        {
+            System::println("Using pre-downloaded: %s", archive.u8string());
+            sha512 = vcpkg::Hash::get_file_hash(fs, archive, "SHA512").value_or_exit(VCPKG_LINE_INFO);
+        }
+        else
+        {
+            const auto maybe_sha512 = Downloads::download_file_and_hash(fs, url, archive);
+            const auto downloaded_sha512 = maybe_sha512.get();
+            Checks::check_exit(VCPKG_LINE_INFO, downloaded_sha512 != nullptr, "Failed to download %s", url);
+            sha512 = *downloaded_sha512;
         }
 
+        const fs::path& cmake_exe = paths.get_cmake_exe();
+        const std::vector<System::CMakeVariable> cmake_args{
+            {"CMD", "CREATE"}, {"PORT", port_name}, {"URL", url}, {"FILENAME", zip_file_name}, {"SHA512", sha512}};
+
         const std::string cmd_launch_cmake = make_cmake_cmd(cmake_exe, paths.ports_cmake, cmake_args);
         Checks::exit_with_code(VCPKG_LINE_INFO, System::cmd_execute_clean(cmd_launch_cmake));
     }
@@ -0,0 +1,289 @@
+#include "pch.h"
+
+#include <vcpkg/base/hash.h>
+#include <vcpkg/base/strings.h>
+#include <vcpkg/base/system.h>
+#include <vcpkg/commands.h>
+#include <vcpkg/help.h>
+#include <vcpkg/input.h>
+#include <vcpkg/paragraphs.h>
+#include <vcpkg/portswatcher.h>
+#include <vcpkg/vcpkglib.h>
+
+#if !defined(_WIN32)
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace vcpkg::Commands::Daemon
+{
+    // The daemon keeps a warm process resident -- VcpkgPaths discovery, the ports tree, and
+    // the status database are loaded once -- and serves commands sent over a local socket.
+    // Each request is handled in a forked child, so command implementations are free to call
+    // Checks::exit_*() as usual; the parsed state is shared with the child copy-on-write.
+    //
+    // Protocol: the client sends one argument per line followed by a blank line, then reads
+    // the command's output verbatim until a 0x04 byte, which is followed by the decimal exit
+    // code and a newline.
+
+    const CommandStructure COMMAND_STRUCTURE = {
+        Help::create_example_string("x-daemon"),
+        0,
+        0,
+        {},
+        nullptr,
+    };
+
+#if defined(_WIN32)
+
+    void perform_and_exit(const VcpkgCmdArguments&, const VcpkgPaths&)
+    {
+        Checks::exit_with_message(VCPKG_LINE_INFO, "The vcpkg daemon is not supported on Windows.");
+    }
+
+    void try_dispatch_to_daemon(const int, const CommandLineCharType* const* const) {}
+
+#else
+
+    static const char RESPONSE_TERMINATOR = '\x04';
+
+    // The socket lives under the user's runtime directory, not the vcpkg root: the
+    // root may be group- or world-writable (shared build trees), and anyone who can
+    // write to the socket can run builds -- arbitrary portfile code -- as the
+    // daemon's user. One daemon can run per root, so the default name carries a
+    // hash of the root path.
+    static fs::path socket_path_for(const VcpkgPaths& paths)
+    {
+        const auto env = System::get_environment_variable("VCPKG_DAEMON_SOCKET");
+        if (const auto p = env.get()) return fs::path(*p);
+
+        const std::string root_tag = vcpkg::Hash::get_string_hash(paths.root.u8string(), "SHA256").substr(0, 12);
+        const std::string socket_name = "daemon-" + root_tag + ".sock";
+
+        const auto runtime_dir = System::get_environment_variable("XDG_RUNTIME_DIR");
+        if (const auto p = runtime_dir.get()) return fs::path(*p) / "vcpkg" / socket_name;
+
+        const auto home = System::get_environment_variable("HOME");
+        if (const auto p = home.get()) return fs::path(*p) / ".vcpkg" / socket_name;
+
+        return paths.root / socket_name;
+    }
+
+    static void dispatch_in_child(const std::vector<std::string>& request_args, const VcpkgPaths& paths)
+    {
+        const VcpkgCmdArguments args =
+            VcpkgCmdArguments::create_from_arg_sequence(request_args.data(), request_args.data() + request_args.size());
+
+        const auto find_command = [&](auto&& commands) { return find(args.command, commands); };
+
+        if (const auto command_function = find_command(get_available_commands_type_c()))
+        {
+            return command_function->function(args);
+        }
+
+        if (const auto command_function = find_command(get_available_commands_type_b()))
+        {
+            return command_function->function(args, paths);
+        }
+
+        Triplet default_triplet;
+        if (args.triplet != nullptr)
+        {
+            default_triplet = Triplet::from_canonical_name(*args.triplet);
+        }
+        else
+        {
+            const auto vcpkg_default_triplet_env = System::get_environment_variable("VCPKG_DEFAULT_TRIPLET");
+            if (const auto v = vcpkg_default_triplet_env.get())
+            {
+                default_triplet = Triplet::from_canonical_name(*v);
+            }
+            else
+            {
+                default_triplet = Triplet::X86_WINDOWS;
+            }
+        }
+
+        Input::check_triplet(default_triplet, paths);
+
+        if (const auto command_function = find_command(get_available_commands_type_a()))
+        {
+            return command_function->function(args, paths, default_triplet);
+        }
+
+        Checks::exit_with_message(VCPKG_LINE_INFO, "invalid command: %s", args.command);
+    }
+
+    static void serve_connection(const int connection, const VcpkgPaths& paths)
+    {
+        // Read one argument per line until a blank line.
+        std::string request;
+        char buffer[1024];
+        while (request.find("\n\n") == std::string::npos)
+        {
+            const ssize_t bytes = read(connection, buffer, sizeof(buffer));
+            if (bytes <= 0) return;
+            request.append(buffer, static_cast<size_t>(bytes));
+        }
+
+        std::vector<std::string> request_args;
+        for (auto&& line : Strings::split(request.substr(0, request.find("\n\n")), "\n"))
+        {
+            request_args.push_back(std::move(line));
+        }
+        if (request_args.empty()) return;
+
+        const pid_t child = fork();
+        if (child < 0) return;
+        if (child == 0)
+        {
+            dup2(connection, STDOUT_FILENO);
+            dup2(connection, STDERR_FILENO);
+            dispatch_in_child(request_args, paths);
+            Checks::exit_fail(VCPKG_LINE_INFO);
+        }
+
+        int status = 0;
+        waitpid(child, &status, 0);
+        const int exit_code = WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+        const std::string trailer = Strings::format("%c%d\n", RESPONSE_TERMINATOR, exit_code);
+        write(connection, trailer.data(), trailer.size());
+    }
+
+    void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths)
+    {
+        args.parse_arguments(COMMAND_STRUCTURE);
+
+        // Warm the caches the forked children will rely on: the status database and a full
+        // parse of the ports tree. The children re-reach this data through the page cache
+        // and the copy-on-write image of this process.
+        database_load_check(paths);
+        const auto all_ports = Paragraphs::load_all_ports_cached(paths);
+
+        // With the ports tree parsed and indexed, keep a watcher session alive so
+        // warm loads (ours and any plain vcpkg invocation on this root) skip the
+        // per-port stat sweep while the daemon runs.
+        PortsWatcher::start(paths);
+
+        const fs::path socket_path = socket_path_for(paths);
+        {
+            std::error_code ec;
+            paths.get_filesystem().create_directories(socket_path.parent_path(), ec);
+        }
+        unlink(socket_path.c_str());
+
+        const int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        Checks::check_exit(VCPKG_LINE_INFO, listener >= 0, "Failed to create daemon socket");
+
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        const std::string socket_path_string = socket_path.string();
+        Checks::check_exit(VCPKG_LINE_INFO,
+                           socket_path_string.size() < sizeof(address.sun_path),
+                           "Daemon socket path is too long: %s",
+                           socket_path_string);
+        std::copy(socket_path_string.begin(), socket_path_string.end(), address.sun_path);
+
+        // The socket must never be writable by another user: a writer can execute
+        // arbitrary vcpkg commands as this process's uid. umask guards the window
+        // inside bind(); the explicit chmod covers filesystems that ignore the
+        // creation mode for sockets.
+        const mode_t previous_umask = umask(077);
+        const int bind_result = bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+        umask(previous_umask);
+        Checks::check_exit(VCPKG_LINE_INFO, bind_result == 0, "Failed to bind daemon socket %s", socket_path_string);
+        Checks::check_exit(VCPKG_LINE_INFO,
+                           chmod(socket_path_string.c_str(), S_IRUSR | S_IWUSR) == 0,
+                           "Failed to restrict permissions on daemon socket %s",
+                           socket_path_string);
+        Checks::check_exit(VCPKG_LINE_INFO, listen(listener, 8) == 0, "Failed to listen on daemon socket");
+
+        System::println("Loaded %zd ports; listening on %s", all_ports.size(), socket_path_string);
+        System::println("Run commands through the daemon with: export VCPKG_DAEMON_SOCKET=%s", socket_path_string);
+
+        // Requests are served one at a time; a long-running build delays later requests
+        // rather than racing them against the same installed tree.
+        for (;;)
+        {
+            const int connection = accept(listener, nullptr, nullptr);
+            if (connection < 0) continue;
+            serve_connection(connection, paths);
+            close(connection);
+        }
+    }
+
+    void try_dispatch_to_daemon(const int argc, const CommandLineCharType* const* const argv)
+    {
+        const auto env = System::get_environment_variable("VCPKG_DAEMON_SOCKET");
+        const auto socket_path = env.get();
+        if (!socket_path) return;
+        if (argc > 1 && Strings::case_insensitive_ascii_equals(argv[1], "x-daemon")) return;
+
+        const int connection = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (connection < 0) return;
+
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        if (socket_path->size() >= sizeof(address.sun_path))
+        {
+            close(connection);
+            return;
+        }
+        std::copy(socket_path->begin(), socket_path->end(), address.sun_path);
+
+        if (connect(connection, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+        {
+            // No daemon running; fall back to handling the command in this process.
+            close(connection);
+            return;
+        }
+
+        std::string request;
+        for (int i = 1; i < argc; ++i)
+        {
+            request.append(argv[i]);
+            request.push_back('\n');
+        }
+        request.push_back('\n');
+        if (write(connection, request.data(), request.size()) < 0)
+        {
+            close(connection);
+            return;
+        }
+
+        int exit_code = 1;
+        std::string trailer;
+        bool in_trailer = false;
+        char buffer[4096];
+        for (;;)
+        {
+            const ssize_t bytes = read(connection, buffer, sizeof(buffer));
+            if (bytes <= 0) break;
+
+            const char* first = buffer;
+            const char* const last = buffer + bytes;
+            if (!in_trailer)
+            {
+                const char* const terminator = std::find(first, last, RESPONSE_TERMINATOR);
+                fwrite(first, 1, static_cast<size_t>(terminator - first), stdout);
+                if (terminator == last) continue;
+                in_trailer = true;
+                first = terminator + 1;
+            }
+            trailer.append(first, last);
+        }
+        close(connection);
+        fflush(stdout);
+
+        if (in_trailer)
+        {
+            exit_code = atoi(trailer.c_str());
+        }
+        Checks::exit_with_code(VCPKG_LINE_INFO, exit_code);
+    }
+
+#endif
+}
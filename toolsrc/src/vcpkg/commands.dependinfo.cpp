@@ -9,20 +9,147 @@
 
 namespace vcpkg::Commands::DependInfo
 {
+    static const std::string OPTION_TRANSITIVE = "--transitive";
+    static const std::string OPTION_REVERSE = "--reverse";
+
+    static const std::array<CommandSwitch, 2> DEPEND_SWITCHES = {{
+        {OPTION_TRANSITIVE, "Print the full transitive dependency closure of each port"},
+        {OPTION_REVERSE, "Print the ports that transitively depend on each port"},
+    }};
+
     const CommandStructure COMMAND_STRUCTURE = {
         Help::create_example_string(R"###(depend-info [pat])###"),
         0,
         1,
-        {},
+        {DEPEND_SWITCHES, {}},
         nullptr,
     };
 
+    // Transitive closure over the whole ports graph as one bitset row per port,
+    // computed bottom-up in a single pass. Rows double as the reverse index: the
+    // dependents of port i are exactly the rows with bit i set, so build-impact
+    // queries cost one scan over the matrix instead of a graph walk per query.
+    struct DependencyClosure
+    {
+        explicit DependencyClosure(const std::vector<std::unique_ptr<SourceControlFile>>& source_control_files)
+        {
+            const size_t port_count = source_control_files.size();
+            m_words_per_row = (port_count + 63) / 64;
+            m_names.reserve(port_count);
+            for (const auto& source_control_file : source_control_files)
+            {
+                m_name_to_id.emplace(source_control_file->core_paragraph.name, m_names.size());
+                m_names.push_back(source_control_file->core_paragraph.name);
+            }
+
+            m_depends.resize(port_count);
+            for (size_t i = 0; i < port_count; ++i)
+            {
+                for (const Dependency& dependency : source_control_files[i]->core_paragraph.depends)
+                {
+                    const auto it = m_name_to_id.find(dependency.depend.name);
+                    // Dependencies on ports outside the tree cannot contribute edges.
+                    if (it != m_name_to_id.end()) m_depends[i].push_back(it->second);
+                }
+            }
+
+            m_rows.resize(port_count * m_words_per_row, 0);
+            m_state.resize(port_count, NOT_VISITED);
+            for (size_t i = 0; i < port_count; ++i)
+                compute_row(i);
+        }
+
+        Optional<size_t> find(const std::string& name) const
+        {
+            const auto it = m_name_to_id.find(name);
+            if (it == m_name_to_id.end()) return nullopt;
+            return it->second;
+        }
+
+        size_t size() const { return m_names.size(); }
+        const std::string& name(const size_t id) const { return m_names[id]; }
+
+        std::vector<std::string> dependencies_of(const size_t id) const
+        {
+            std::vector<std::string> out;
+            const uint64_t* row = &m_rows[id * m_words_per_row];
+            for (size_t other = 0; other < m_names.size(); ++other)
+            {
+                if (row[other / 64] & (UINT64_C(1) << (other % 64))) out.push_back(m_names[other]);
+            }
+            return out;
+        }
+
+        std::vector<std::string> dependents_of(const size_t id) const
+        {
+            std::vector<std::string> out;
+            for (size_t other = 0; other < m_names.size(); ++other)
+            {
+                if (m_rows[other * m_words_per_row + id / 64] & (UINT64_C(1) << (id % 64)))
+                    out.push_back(m_names[other]);
+            }
+            return out;
+        }
+
+    private:
+        void compute_row(const size_t id)
+        {
+            if (m_state[id] == DONE) return;
+            if (m_state[id] == IN_PROGRESS) return; // Cycle; such edges are simply dropped.
+            m_state[id] = IN_PROGRESS;
+
+            uint64_t* row = &m_rows[id * m_words_per_row];
+            for (const size_t dep : m_depends[id])
+            {
+                compute_row(dep);
+                row[dep / 64] |= UINT64_C(1) << (dep % 64);
+                const uint64_t* dep_row = &m_rows[dep * m_words_per_row];
+                for (size_t w = 0; w < m_words_per_row; ++w)
+                    row[w] |= dep_row[w];
+            }
+
+            m_state[id] = DONE;
+        }
+
+        static constexpr char NOT_VISITED = 0;
+        static constexpr char IN_PROGRESS = 1;
+        static constexpr char DONE = 2;
+
+        size_t m_words_per_row;
+        std::vector<std::string> m_names;
+        std::unordered_map<std::string, size_t> m_name_to_id;
+        std::vector<std::vector<size_t>> m_depends;
+        std::vector<uint64_t> m_rows;
+        std::vector<char> m_state;
+    };
+
     void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths)
     {
-        args.parse_arguments(COMMAND_STRUCTURE);
+        const ParsedArguments options = args.parse_arguments(COMMAND_STRUCTURE);
+        const bool transitive = Util::Sets::contains(options.switches, OPTION_TRANSITIVE);
+        const bool reverse = Util::Sets::contains(options.switches, OPTION_REVERSE);
 
         std::vector<std::unique_ptr<SourceControlFile>> source_control_files =
-            Paragraphs::load_all_ports(paths.get_filesystem(), paths.ports);
+            Paragraphs::load_all_ports_cached(paths);
+
+        if (transitive || reverse)
+        {
+            const DependencyClosure closure(source_control_files);
+            const std::string filter =
+                args.command_arguments.size() == 1 ? args.command_arguments.at(0) : std::string();
+
+            for (size_t id = 0; id < closure.size(); ++id)
+            {
+                if (!filter.empty() && !Strings::case_insensitive_ascii_contains(closure.name(id), filter)) continue;
+
+                std::vector<std::string> related =
+                    reverse ? closure.dependents_of(id) : closure.dependencies_of(id);
+                std::sort(related.begin(), related.end());
+                System::println("%s: %s", closure.name(id), Strings::join(", ", related));
+            }
+
+            Checks::exit_success(VCPKG_LINE_INFO);
+        }
 
         if (args.command_arguments.size() == 1)
         {
@@ -31,7 +158,7 @@ namespace vcpkg::Commands::DependInfo
             Util::erase_remove_if(source_control_files,
                                   [&](const std::unique_ptr<SourceControlFile>& source_control_file) {
 
-                                      const SourceParagraph& source_paragraph = *source_control_file->core_paragraph;
+                                      const SourceParagraph& source_paragraph = source_control_file->core_paragraph;
 
                                       if (Strings::case_insensitive_ascii_contains(source_paragraph.name, filter))
                                       {
@@ -52,7 +179,7 @@ namespace vcpkg::Commands::DependInfo
 
         for (auto&& source_control_file : source_control_files)
         {
-            const SourceParagraph& source_paragraph = *source_control_file->core_paragraph;
+            const SourceParagraph& source_paragraph = source_control_file->core_paragraph;
             const auto s = Strings::join(", ", source_paragraph.depends, [](const Dependency& d) { return d.name(); });
             System::println("%s: %s", source_paragraph.name, s);
         }
@@ -0,0 +1,55 @@
+#include "pch.h"
+
+#include <vcpkg/base/system.h>
+#include <vcpkg/commands.h>
+#include <vcpkg/downloads.h>
+#include <vcpkg/help.h>
+
+namespace vcpkg::Commands::Download
+{
+    static const std::string OPTION_SHA512 = "--sha512";
+    static const std::string OPTION_MAX_CONNECTIONS = "--max-connections";
+
+    static const std::array<CommandSetting, 2> DOWNLOAD_SETTINGS = {{
+        {OPTION_SHA512, "Expected SHA-512 of the downloaded file"},
+        {OPTION_MAX_CONNECTIONS, "Maximum number of parallel byte-range connections (default 4)"},
+    }};
+
+    const CommandStructure COMMAND_STRUCTURE = {
+        Help::create_example_string("x-download https://example.com/file.tar.gz downloads/file.tar.gz --sha512=..."),
+        2,
+        2,
+        {{}, DOWNLOAD_SETTINGS},
+        nullptr,
+    };
+
+    void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths)
+    {
+        const ParsedArguments options = args.parse_arguments(COMMAND_STRUCTURE);
+
+        const std::string& url = args.command_arguments[0];
+        const fs::path destination = fs::u8path(args.command_arguments[1]);
+
+        std::string expected_sha512;
+        const auto it_sha512 = options.settings.find(OPTION_SHA512);
+        if (it_sha512 != options.settings.end())
+        {
+            expected_sha512 = it_sha512->second;
+        }
+
+        size_t max_connections = 4;
+        const auto it_max_connections = options.settings.find(OPTION_MAX_CONNECTIONS);
+        if (it_max_connections != options.settings.end())
+        {
+            max_connections =
+                static_cast<size_t>(std::max(1, std::min(16, atoi(it_max_connections->second.c_str()))));
+        }
+
+        if (!Downloads::download_file(paths.get_filesystem(), url, destination, expected_sha512, max_connections))
+        {
+            Checks::exit_fail(VCPKG_LINE_INFO);
+        }
+
+        Checks::exit_success(VCPKG_LINE_INFO);
+    }
+}
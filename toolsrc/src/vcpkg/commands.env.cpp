@@ -21,6 +21,17 @@ namespace vcpkg::Commands::Env
 
         const auto pre_build_info = Build::PreBuildInfo::from_triplet_file(paths, default_triplet);
         const Toolset& toolset = paths.get_toolset(pre_build_info);
+
+#if defined(_WIN32)
+        // Serve the shell from the cached vcvars environment block when one is
+        // available, so scripted `vcpkg env` loops skip the multi-second vcvarsall run.
+        const auto cached_block = Build::get_build_environment_block(paths, pre_build_info, toolset);
+        if (const auto block = cached_block.get())
+        {
+            Checks::exit_with_code(VCPKG_LINE_INFO, System::cmd_execute_with_environment("cmd", *block));
+        }
+#endif
+
         System::cmd_execute_clean(Build::make_build_env_cmd(pre_build_info, toolset) + " && cmd");
 
         Checks::exit_success(VCPKG_LINE_INFO);
@@ -1,5 +1,6 @@
 #include "pch.h"
 
+#include <vcpkg/base/parallel.h>
 #include <vcpkg/commands.h>
 #include <vcpkg/export.h>
 #include <vcpkg/export.ifw.h>
@@ -70,7 +71,7 @@ namespace vcpkg::Export::IFW
         std::error_code ec;
 
         const BinaryParagraph& binary_paragraph =
-            action.any_paragraph.binary_control_file.value_or_exit(VCPKG_LINE_INFO).core_paragraph;
+            action.any_paragraph.binary_control_file_or_exit(VCPKG_LINE_INFO).core_paragraph;
 
         // Prepare meta dir
         const fs::path package_xml_file_path =
@@ -143,7 +144,7 @@ namespace vcpkg::Export::IFW
         {
             const ExportPlanAction& action = *(package->second);
             const BinaryParagraph& binary_paragraph =
-                action.any_paragraph.binary_control_file.value_or_exit(VCPKG_LINE_INFO).core_paragraph;
+                action.any_paragraph.binary_control_file_or_exit(VCPKG_LINE_INFO).core_paragraph;
 
             package_xml_file_path =
                 raw_exported_dir_path / Strings::format("packages.%s", package->first) / "meta" / "package.xml";
@@ -335,25 +336,100 @@ namespace vcpkg::Export::IFW
         System::println("Exporting maintenance tool... done");
     }
 
-    void do_repository(const std::string& export_id, const Options& ifw_options, const VcpkgPaths& paths)
+    // Stamp manifest of the component payloads staged on the previous run, one
+    // "<component> <stamp>" line each; lets a re-export skip unchanged packages and
+    // tell repogen exactly which components to update.
+    static const char* const IFW_MANIFEST_VERSION = "1";
+
+    static fs::path ifw_manifest_path(const fs::path& ifw_packages_dir_path)
+    {
+        return ifw_packages_dir_path / "vcpkg-ifw.manifest";
+    }
+
+    static std::map<std::string, std::string> load_ifw_manifest(const Files::Filesystem& fs,
+                                                                const fs::path& manifest_path)
+    {
+        std::map<std::string, std::string> manifest;
+        auto maybe_lines = fs.read_lines(manifest_path);
+        const auto lines = maybe_lines.get();
+        if (!lines || lines->empty() || (*lines)[0] != IFW_MANIFEST_VERSION) return manifest;
+
+        for (size_t i = 1; i < lines->size(); ++i)
+        {
+            const auto space = (*lines)[i].find(' ');
+            if (space == std::string::npos) continue;
+            manifest.emplace((*lines)[i].substr(0, space), (*lines)[i].substr(space + 1));
+        }
+        return manifest;
+    }
+
+    static void save_ifw_manifest(Files::Filesystem& fs,
+                                  const fs::path& manifest_path,
+                                  const std::map<std::string, std::string>& manifest)
+    {
+        std::string contents = IFW_MANIFEST_VERSION;
+        contents.push_back('\n');
+        for (const auto& entry : manifest)
+        {
+            contents.append(Strings::format("%s %s\n", entry.first, entry.second));
+        }
+        fs.write_contents(manifest_path, contents);
+    }
+
+    static std::string component_name(const ExportPlanAction& action)
+    {
+        return Strings::format("packages.%s.%s", action.spec.name(), action.spec.triplet().canonical_name());
+    }
+
+    void do_repository(const std::string& export_id,
+                       const Options& ifw_options,
+                       const VcpkgPaths& paths,
+                       const std::vector<std::string>& changed_components,
+                       const bool incremental)
     {
         const fs::path& repogen_exe = paths.get_ifw_repogen_exe();
         const fs::path packages_dir = get_packages_dir_path(export_id, ifw_options, paths);
         const fs::path repository_dir = get_repository_dir_path(export_id, ifw_options, paths);
 
-        System::println("Generating repository %s...", repository_dir.generic_string());
-
         std::error_code ec;
         Files::Filesystem& fs = paths.get_filesystem();
 
-        fs.remove_all(repository_dir, ec);
-        Checks::check_exit(
-            VCPKG_LINE_INFO, !ec, "Could not remove outdated repository directory %s", repository_dir.generic_string());
+        std::string cmd_line;
+        if (incremental && fs.exists(repository_dir / "Updates.xml"))
+        {
+            if (changed_components.empty())
+            {
+                System::println(
+                    System::Color::success, "Repository %s is up to date.", repository_dir.generic_string());
+                return;
+            }
+
+            // Update only the components whose payload stamps changed; the rest of
+            // the repository (and its existing 7z archives) is left untouched.
+            System::println("Updating repository %s (%zd components)...",
+                            repository_dir.generic_string(),
+                            changed_components.size());
+            cmd_line = Strings::format(R"("%s" --update --include "%s" --packages "%s" "%s" > nul)",
+                                       repogen_exe.u8string(),
+                                       Strings::join(",", changed_components),
+                                       packages_dir.u8string(),
+                                       repository_dir.u8string());
+        }
+        else
+        {
+            System::println("Generating repository %s...", repository_dir.generic_string());
 
-        const auto cmd_line = Strings::format(R"("%s" --packages "%s" "%s" > nul)",
-                                              repogen_exe.u8string(),
-                                              packages_dir.u8string(),
-                                              repository_dir.u8string());
+            fs.remove_all(repository_dir, ec);
+            Checks::check_exit(VCPKG_LINE_INFO,
+                               !ec,
+                               "Could not remove outdated repository directory %s",
+                               repository_dir.generic_string());
+
+            cmd_line = Strings::format(R"("%s" --packages "%s" "%s" > nul)",
+                                       repogen_exe.u8string(),
+                                       packages_dir.u8string(),
+                                       repository_dir.u8string());
+        }
 
         const int exit_code = System::cmd_execute_clean(cmd_line);
         Checks::check_exit(VCPKG_LINE_INFO, exit_code == 0, "Error: IFW repository generating failed");
@@ -405,14 +481,22 @@ namespace vcpkg::Export::IFW
         std::error_code ec;
         Files::Filesystem& fs = paths.get_filesystem();
 
-        // Prepare packages directory
+        // Prepare packages directory. When the previous run left a stamp manifest,
+        // the staged tree is reused and only changed components are rewritten;
+        // otherwise (first run, or an unrecognized manifest) it is rebuilt whole.
         const fs::path ifw_packages_dir_path = get_packages_dir_path(export_id, ifw_options, paths);
+        std::map<std::string, std::string> previous_stamps =
+            load_ifw_manifest(fs, ifw_manifest_path(ifw_packages_dir_path));
+        const bool incremental = !previous_stamps.empty();
 
-        fs.remove_all(ifw_packages_dir_path, ec);
-        Checks::check_exit(VCPKG_LINE_INFO,
-                           !ec,
-                           "Could not remove outdated packages directory %s",
-                           ifw_packages_dir_path.generic_string());
+        if (!incremental)
+        {
+            fs.remove_all(ifw_packages_dir_path, ec);
+            Checks::check_exit(VCPKG_LINE_INFO,
+                               !ec,
+                               "Could not remove outdated packages directory %s",
+                               ifw_packages_dir_path.generic_string());
+        }
 
         fs.create_directory(ifw_packages_dir_path, ec);
         Checks::check_exit(
@@ -433,28 +517,78 @@ namespace vcpkg::Export::IFW
                 Checks::unreachable(VCPKG_LINE_INFO);
             }
 
-            const std::string display_name = action.spec.to_string();
-            System::println("Exporting package %s... ", display_name);
+            unique_packages[action.spec.name()] = &action;
+            unique_triplets.insert(action.spec.triplet().canonical_name());
+        }
 
+        // Decide which components actually changed since the last run: the stamp
+        // pairs the exact binary payload (fullstem) with its ABI. A component whose
+        // stamp matches is left exactly as staged; a changed one is wiped and
+        // restaged; anything staged before but absent from this plan is removed.
+        std::map<std::string, std::string> current_stamps;
+        std::vector<bool> needs_stage(export_plan.size());
+        std::vector<std::string> changed_components;
+        for (size_t i = 0; i < export_plan.size(); ++i)
+        {
+            const ExportPlanAction& action = export_plan[i];
             const BinaryParagraph& binary_paragraph =
-                action.any_paragraph.binary_control_file.value_or_exit(VCPKG_LINE_INFO).core_paragraph;
+                action.any_paragraph.binary_control_file_or_exit(VCPKG_LINE_INFO).core_paragraph;
+            const std::string component = component_name(action);
+            const std::string stamp = binary_paragraph.fullstem() + ';' + binary_paragraph.abi;
+            current_stamps[component] = stamp;
+
+            const auto it_previous = previous_stamps.find(component);
+            needs_stage[i] = it_previous == previous_stamps.end() || it_previous->second != stamp;
+            if (it_previous != previous_stamps.end()) previous_stamps.erase(it_previous);
+            if (!needs_stage[i]) continue;
+
+            changed_components.push_back(component);
+            fs.remove_all(ifw_packages_dir_path / component, ec);
+        }
+        for (const auto& stale : previous_stamps)
+        {
+            changed_components.push_back(stale.first);
+            fs.remove_all(ifw_packages_dir_path / stale.first, ec);
+        }
 
-            unique_packages[action.spec.name()] = &action;
-            unique_triplets.insert(action.spec.triplet().canonical_name());
+        // Stage every package's meta directory on a worker pool first. Each package
+        // writes only into its own packages.<name>.<triplet> subtree, so the workers
+        // never touch the same files; the writes are bound by per-file syscall latency,
+        // not CPU.
+        std::vector<fs::path> data_dir_paths(export_plan.size());
+        Parallel::for_each_index(export_plan.size(), [&](const size_t i) {
+            if (!needs_stage[i]) return;
+            data_dir_paths[i] = export_real_package(ifw_packages_dir_path, export_plan[i], fs);
+        });
+
+        // Copy package payloads into the staged data dirs. install_files_and_write_listfile
+        // already fans each package's file copies across workers, so the packages run
+        // back to back here rather than on a second pool of their own.
+        for (size_t i = 0; i < export_plan.size(); ++i)
+        {
+            const ExportPlanAction& action = export_plan[i];
+            const std::string display_name = action.spec.to_string();
+            if (!needs_stage[i])
+            {
+                System::println("Exporting package %s... unchanged", display_name);
+                continue;
+            }
+            System::println("Exporting package %s... ", display_name);
 
-            // Export real package and return data dir for installation
-            fs::path ifw_package_dir_path = export_real_package(ifw_packages_dir_path, action, fs);
+            const BinaryParagraph& binary_paragraph =
+                action.any_paragraph.binary_control_file_or_exit(VCPKG_LINE_INFO).core_paragraph;
 
-            // Copy package data
-            const InstallDir dirs = InstallDir::from_destination_root(ifw_package_dir_path,
+            const InstallDir dirs = InstallDir::from_destination_root(data_dir_paths[i],
                                                                       action.spec.triplet().to_string(),
-                                                                      ifw_package_dir_path / "vcpkg" / "info" /
+                                                                      data_dir_paths[i] / "vcpkg" / "info" /
                                                                           (binary_paragraph.fullstem() + ".list"));
 
             Install::install_files_and_write_listfile(paths.get_filesystem(), paths.package_dir(action.spec), dirs);
             System::println("Exporting package %s... done", display_name);
         }
 
+        save_ifw_manifest(fs, ifw_manifest_path(ifw_packages_dir_path), current_stamps);
+
         System::println("Exporting packages %s... done", ifw_packages_dir_path.generic_string());
 
         const fs::path config_file = get_config_file_path(export_id, ifw_options, paths);
@@ -481,7 +615,7 @@ namespace vcpkg::Export::IFW
         std::string ifw_repo_url = ifw_options.maybe_repository_url.value_or("");
         if (!ifw_repo_url.empty())
         {
-            do_repository(export_id, ifw_options, paths);
+            do_repository(export_id, ifw_options, paths, changed_components, incremental);
         }
 
         // Do installer
@@ -0,0 +1,112 @@
+#include "pch.h"
+
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/strings.h>
+#include <vcpkg/base/system.h>
+#include <vcpkg/commands.h>
+#include <vcpkg/help.h>
+#include <vcpkg/statusparagraph.h>
+
+namespace vcpkg::Commands::GeneratePorts
+{
+    static const std::string OPTION_COUNT = "--count";
+    static const std::string OPTION_FAN_OUT = "--fan-out";
+    static const std::string OPTION_OUTPUT_DIR = "--output-dir";
+
+    static const std::array<CommandSetting, 3> GENERATE_SETTINGS = {{
+        {OPTION_COUNT, "Number of synthetic ports to generate (default 1000)"},
+        {OPTION_FAN_OUT, "Dependencies per port (default 2)"},
+        {OPTION_OUTPUT_DIR, "Directory receiving the generated ports tree and status file"},
+    }};
+
+    const CommandStructure COMMAND_STRUCTURE = {
+        Help::create_example_string("x-generate-ports --count=10000 --fan-out=3 --output-dir=/path/to/fixture"),
+        0,
+        0,
+        {{}, GENERATE_SETTINGS},
+        nullptr,
+    };
+
+    static std::string port_name(const size_t i) { return "synth-" + std::to_string(i); }
+
+    void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths, const Triplet& default_triplet)
+    {
+        const ParsedArguments options = args.parse_arguments(COMMAND_STRUCTURE);
+
+        size_t count = 1000;
+        const auto it_count = options.settings.find(OPTION_COUNT);
+        if (it_count != options.settings.end())
+        {
+            count = static_cast<size_t>(std::max(1, atoi(it_count->second.c_str())));
+        }
+
+        size_t fan_out = 2;
+        const auto it_fan_out = options.settings.find(OPTION_FAN_OUT);
+        if (it_fan_out != options.settings.end())
+        {
+            fan_out = static_cast<size_t>(std::max(0, atoi(it_fan_out->second.c_str())));
+        }
+
+        const auto it_output_dir = options.settings.find(OPTION_OUTPUT_DIR);
+        Checks::check_exit(VCPKG_LINE_INFO, it_output_dir != options.settings.end(), "--output-dir is required");
+        const fs::path output_dir = fs::u8path(it_output_dir->second);
+
+        auto& fs = paths.get_filesystem();
+        std::error_code ec;
+        fs.create_directories(output_dir / "ports", ec);
+        Checks::check_exit(
+            VCPKG_LINE_INFO, !ec, "Could not create directory %s", (output_dir / "ports").u8string());
+
+        // Dependencies form a complete fan_out-ary tree: port i depends on ports
+        // i*fan_out+1 .. i*fan_out+fan_out, so a plan rooted at synth-0 reaches every
+        // generated port and the whole graph is reproducible from count and fan-out.
+        std::string status_file;
+        for (size_t i = 0; i < count; ++i)
+        {
+            SourceParagraph sp;
+            sp.name = port_name(i);
+            sp.version = "1.0." + std::to_string(i);
+            sp.description = "Synthetic port generated for scale testing";
+            for (size_t k = 1; k <= fan_out; ++k)
+            {
+                const size_t dep = i * fan_out + k;
+                if (dep >= count) break;
+                sp.depends.push_back(Dependency::parse_dependency(port_name(dep), ""));
+            }
+
+            std::string control;
+            control.append("Source: ").append(sp.name).push_back('\n');
+            control.append("Version: ").append(sp.version).push_back('\n');
+            control.append("Description: ").append(sp.description).push_back('\n');
+            if (!sp.depends.empty())
+            {
+                control.append("Build-Depends: ")
+                    .append(Strings::join(", ", sp.depends, [](const Dependency& dep) { return dep.name(); }))
+                    .push_back('\n');
+            }
+
+            const fs::path port_dir = output_dir / "ports" / sp.name;
+            fs.create_directory(port_dir, ec);
+            Checks::check_exit(VCPKG_LINE_INFO, !ec, [&] {
+                return Strings::format("Could not create directory %s", port_dir.u8string());
+            });
+            fs.write_contents(port_dir / "CONTROL", control);
+
+            StatusParagraph status_pgh;
+            status_pgh.package = BinaryParagraph(sp, default_triplet);
+            status_pgh.want = Want::INSTALL;
+            status_pgh.state = InstallState::INSTALLED;
+            serialize(status_pgh, status_file);
+            status_file.push_back('\n');
+        }
+
+        fs.write_contents(output_dir / "status", status_file);
+
+        System::println("Generated %s ports under %s with fan-out %s (status entries use triplet %s)",
+                        std::to_string(count),
+                        (output_dir / "ports").u8string(),
+                        std::to_string(fan_out),
+                        default_triplet);
+        Checks::exit_success(VCPKG_LINE_INFO);
+    }
+}
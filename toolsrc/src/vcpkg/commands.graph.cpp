@@ -0,0 +1,160 @@
+#include "pch.h"
+
+#include <vcpkg/base/system.h>
+#include <vcpkg/commands.h>
+#include <vcpkg/help.h>
+#include <vcpkg/paragraphs.h>
+
+namespace vcpkg::Commands::Graph
+{
+    static const std::string OPTION_JSON = "--x-json";
+    static const std::string OPTION_OUTPUT = "--output";
+
+    static const std::array<CommandSwitch, 1> GRAPH_SWITCHES = {{
+        {OPTION_JSON, "Emit the graph as JSON instead of DOT"},
+    }};
+
+    static const std::array<CommandSetting, 1> GRAPH_SETTINGS = {{
+        {OPTION_OUTPUT, "Write the graph to the given file instead of stdout"},
+    }};
+
+    const CommandStructure COMMAND_STRUCTURE = {
+        Help::create_example_string("x-graph --x-json --output=ports.json"),
+        0,
+        0,
+        {GRAPH_SWITCHES, GRAPH_SETTINGS},
+        nullptr,
+    };
+
+    static std::string json_escape(const std::string& s)
+    {
+        std::string out;
+        for (const char c : s)
+        {
+            if (c == '"' || c == '\\')
+            {
+                out.push_back('\\');
+                out.push_back(c);
+            }
+            else if (c == '\n')
+                out += "\\n";
+            else if (c == '\r')
+                out += "\\r";
+            else if (c == '\t')
+                out += "\\t";
+            else
+                out.push_back(c);
+        }
+        return out;
+    }
+
+    static void append_json_dependency_array(std::string& out, const std::vector<Dependency>& depends)
+    {
+        out.push_back('[');
+        for (size_t i = 0; i < depends.size(); ++i)
+        {
+            if (i != 0) out.push_back(',');
+            out.append("{\"name\":\"").append(json_escape(depends[i].depend.name)).push_back('"');
+            if (!depends[i].depend.features.empty())
+            {
+                out.append(",\"features\":[");
+                for (size_t j = 0; j < depends[i].depend.features.size(); ++j)
+                {
+                    if (j != 0) out.push_back(',');
+                    out.push_back('"');
+                    out.append(json_escape(depends[i].depend.features[j]));
+                    out.push_back('"');
+                }
+                out.push_back(']');
+            }
+            if (!depends[i].qualifier.empty())
+            {
+                out.append(",\"platform\":\"").append(json_escape(depends[i].qualifier)).push_back('"');
+            }
+            out.push_back('}');
+        }
+        out.push_back(']');
+    }
+
+    // One object per port, one array entry per feature, dependencies inline --
+    // external tooling gets the whole graph from a single parse of the ports tree
+    // instead of one `depend-info` process per port.
+    static std::string create_json_output(const std::vector<std::unique_ptr<SourceControlFile>>& ports)
+    {
+        std::string out = "[";
+        for (size_t i = 0; i < ports.size(); ++i)
+        {
+            const SourceControlFile& scf = *ports[i];
+            if (i != 0) out.push_back(',');
+            out.append("{\"name\":\"").append(json_escape(scf.core_paragraph.name));
+            out.append("\",\"version\":\"").append(json_escape(scf.core_paragraph.version));
+            out.append("\",\"depends\":");
+            append_json_dependency_array(out, scf.core_paragraph.depends);
+            out.append(",\"features\":[");
+            for (size_t j = 0; j < scf.feature_paragraphs.size(); ++j)
+            {
+                const FeatureParagraph& feature = scf.feature_paragraphs[j];
+                if (j != 0) out.push_back(',');
+                out.append("{\"name\":\"").append(json_escape(feature.name)).append("\",\"depends\":");
+                append_json_dependency_array(out, feature.depends);
+                out.push_back('}');
+            }
+            out.append("]}");
+        }
+        out.append("]\n");
+        return out;
+    }
+
+    // Core dependencies are plain edges; a dependency owned by a feature carries the
+    // feature name as the edge label, so impact tooling can distinguish mandatory
+    // from optional edges without re-reading any CONTROL file.
+    static std::string create_dot_output(const std::vector<std::unique_ptr<SourceControlFile>>& ports)
+    {
+        std::string out = "digraph ports {\n";
+        for (const auto& port : ports)
+        {
+            const SourceParagraph& core = port->core_paragraph;
+            out.append(Strings::format("    \"%s\" [label=\"%s\\n%s\"];\n", core.name, core.name, core.version));
+            for (const Dependency& dep : core.depends)
+            {
+                out.append(Strings::format("    \"%s\" -> \"%s\";\n", core.name, dep.depend.name));
+            }
+            for (const FeatureParagraph& feature : port->feature_paragraphs)
+            {
+                for (const Dependency& dep : feature.depends)
+                {
+                    out.append(Strings::format(
+                        "    \"%s\" -> \"%s\" [label=\"%s\"];\n", core.name, dep.depend.name, feature.name));
+                }
+            }
+        }
+        out.append("}\n");
+        return out;
+    }
+
+    void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths)
+    {
+        const ParsedArguments options = args.parse_arguments(COMMAND_STRUCTURE);
+
+        const std::vector<std::unique_ptr<SourceControlFile>> ports = Paragraphs::load_all_ports_cached(paths);
+
+        const std::string output = Util::Sets::contains(options.switches, OPTION_JSON) ? create_json_output(ports)
+                                                                                       : create_dot_output(ports);
+
+        const auto it_output = options.settings.find(OPTION_OUTPUT);
+        if (it_output != options.settings.end())
+        {
+            const fs::path output_path = fs::u8path(it_output->second);
+            paths.get_filesystem().write_contents(output_path, output);
+            System::println("Wrote the graph of %zd ports to:\n    %s", ports.size(), output_path.u8string());
+        }
+        else
+        {
+            // A single write keeps hundreds of thousands of lines from interleaving
+            // with any other output and from paying a flush per line.
+            System::print("%s", output);
+        }
+
+        Checks::exit_success(VCPKG_LINE_INFO);
+    }
+}
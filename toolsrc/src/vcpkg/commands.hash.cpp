@@ -1,5 +1,8 @@
 #include "pch.h"
 
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/hash.h>
+#include <vcpkg/base/parallel.h>
 #include <vcpkg/base/system.h>
 #include <vcpkg/base/util.h>
 #include <vcpkg/commands.h>
@@ -7,51 +10,123 @@
 
 namespace vcpkg::Commands::Hash
 {
-    static void do_file_hash(fs::path const &cmake_exe_path, fs::path const& path, std::string const& hash_type)
+    static bool is_algorithm_name(const std::string& arg)
     {
-        const std::string cmd_line = Strings::format(
-            R"("%s" -E %ssum %s)", cmake_exe_path.u8string(), Strings::ascii_to_lowercase(hash_type), path.u8string());
+        return Strings::case_insensitive_ascii_equals(arg, "SHA256") ||
+               Strings::case_insensitive_ascii_equals(arg, "SHA512");
+    }
 
-        const auto ec_data = System::cmd_execute_and_capture_output(cmd_line);
-        Checks::check_exit(VCPKG_LINE_INFO, ec_data.exit_code == 0, "Running command:\n   %s\n failed", cmd_line);
+    // Expands the positional arguments into the list of files to hash. An argument of
+    // the form @list.txt names a file containing one path per line, and @- reads such a
+    // list from stdin, so mirror-verification scripts can hash thousands of files in
+    // one invocation instead of one process spawn each.
+    static std::vector<fs::path> expand_file_arguments(const Files::Filesystem& fs,
+                                                       const std::vector<std::string>& arguments)
+    {
+        std::vector<fs::path> files;
+        for (const std::string& arg : arguments)
+        {
+            if (arg.empty()) continue;
+            if (arg[0] != '@')
+            {
+                files.push_back(fs::u8path(arg));
+                continue;
+            }
 
-        std::string const& output = ec_data.output;
+            std::vector<std::string> lines;
+            if (arg == "@-")
+            {
+                std::string line;
+                while (std::getline(std::cin, line))
+                {
+                    lines.push_back(std::move(line));
+                }
+            }
+            else
+            {
+                auto maybe_lines = fs.read_lines(fs::u8path(arg.substr(1)));
+                Checks::check_exit(
+                    VCPKG_LINE_INFO, maybe_lines.has_value(), "Failed to read file list: %s", arg.substr(1));
+                lines = std::move(*maybe_lines.get());
+            }
 
-        const auto start = output.find_first_of(" ");
-        Checks::check_exit(
-            VCPKG_LINE_INFO, start != std::string::npos, "Unexpected output format from command: %s", cmd_line);
+            for (std::string& line : lines)
+            {
+                const std::string trimmed = Strings::trim(std::move(line));
+                if (!trimmed.empty()) files.push_back(fs::u8path(trimmed));
+            }
+        }
+        return files;
+    }
 
-        const auto end = output.find_first_of("\r\n", start + 1);
-        Checks::check_exit(
-            VCPKG_LINE_INFO, end != std::string::npos, "Unexpected output format from command: %s", cmd_line);
+    static const std::string OPTION_ALGORITHM = "--algorithm";
 
-        auto hash = output.substr(0, start);
-        Util::erase_remove_if(hash, isspace);
-        System::println(hash);
-    }
+    static const std::array<CommandSetting, 1> HASH_SETTINGS = {{
+        {OPTION_ALGORITHM, "Hash algorithm to use: SHA256 or SHA512 (default SHA512)"},
+    }};
 
     const CommandStructure COMMAND_STRUCTURE = {
-        Strings::format("The argument should be a file path\n%s",
+        Strings::format("The arguments should be file paths; @list.txt names a file with one path per line and @- "
+                        "reads such a list from stdin\n%s",
                         Help::create_example_string("hash boost_1_62_0.tar.bz2")),
         1,
-        2,
-        {},
+        SIZE_MAX,
+        {{}, HASH_SETTINGS},
         nullptr,
     };
 
-    void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths)
+    void perform_and_exit(const VcpkgCmdArguments& args)
     {
-        args.parse_arguments(COMMAND_STRUCTURE);
+        const ParsedArguments options = args.parse_arguments(COMMAND_STRUCTURE);
+
+        std::string algorithm = "SHA512";
+        const auto it_algorithm = options.settings.find(OPTION_ALGORITHM);
+        if (it_algorithm != options.settings.end()) algorithm = it_algorithm->second;
 
-        if (args.command_arguments.size() == 1)
+        std::vector<std::string> positional = args.command_arguments;
+        // Original form: `hash <file> <algorithm>`
+        if (positional.size() == 2 && is_algorithm_name(positional[1]))
         {
-            do_file_hash(paths.get_cmake_exe(), args.command_arguments[0], "SHA512");
+            algorithm = positional[1];
+            positional.pop_back();
         }
-        if (args.command_arguments.size() == 2)
+
+        auto& fs = Files::get_real_filesystem();
+        const std::vector<fs::path> files = expand_file_arguments(fs, positional);
+        Checks::check_exit(VCPKG_LINE_INFO, !files.empty(), "No files to hash");
+
+        std::vector<std::string> hashes(files.size());
+        std::vector<std::string> errors(files.size());
+        Parallel::for_each_index(files.size(), [&](const size_t i) {
+            const auto hash = vcpkg::Hash::get_file_hash(fs, files[i], algorithm);
+            if (const auto h = hash.get())
+                hashes[i] = *h;
+            else
+                errors[i] = hash.error().message();
+        });
+
+        // One result per line, in argument order. A single file prints the bare hash
+        // as before; multiple files append the path so results stay attributable.
+        bool any_failed = false;
+        for (size_t i = 0; i < files.size(); ++i)
         {
-            do_file_hash(paths.get_cmake_exe(), args.command_arguments[0], args.command_arguments[1]);
+            if (!errors[i].empty())
+            {
+                any_failed = true;
+                System::println(
+                    System::Color::error, "Failed to read file: %s: %s", files[i].u8string(), errors[i]);
+            }
+            else if (files.size() == 1)
+            {
+                System::println(hashes[i]);
+            }
+            else
+            {
+                System::println("%s  %s", hashes[i], files[i].u8string());
+            }
         }
 
+        Checks::check_exit(VCPKG_LINE_INFO, !any_failed);
         Checks::exit_success(VCPKG_LINE_INFO);
     }
 }
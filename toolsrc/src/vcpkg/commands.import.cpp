@@ -1,6 +1,7 @@
 #include "pch.h"
 
 #include <vcpkg/base/files.h>
+#include <vcpkg/base/parallel.h>
 #include <vcpkg/commands.h>
 #include <vcpkg/help.h>
 #include <vcpkg/paragraphs.h>
@@ -38,6 +39,20 @@ namespace vcpkg::Commands::Import
         return binaries;
     }
 
+    // Places one file, preferring a hard link when source and destination share a
+    // volume -- vendor drops contain tens of thousands of headers, and linking them is
+    // metadata-only. Falls back to a copy when the filesystem refuses the link.
+    static void link_or_copy_file(Files::Filesystem& fs, const fs::path& src_path, const fs::path& dest_path)
+    {
+        std::error_code ec;
+        if (fs.exists(dest_path)) fs.remove(dest_path, ec);
+        fs.create_hard_link(src_path, dest_path, ec);
+        if (ec)
+        {
+            fs.copy_file(src_path, dest_path, fs::copy_options::overwrite_existing, ec);
+        }
+    }
+
     static void copy_files_into_directory(Files::Filesystem& fs,
                                           const std::vector<fs::path>& files,
                                           const fs::path& destination_folder)
@@ -45,11 +60,38 @@ namespace vcpkg::Commands::Import
         std::error_code ec;
         fs.create_directory(destination_folder, ec);
 
-        for (auto const& src_path : files)
+        Parallel::for_each_index(files.size(), [&](const size_t i) {
+            link_or_copy_file(fs, files[i], destination_folder / files[i].filename());
+        });
+    }
+
+    // Replicates an entire tree: directories are created up front on this thread to
+    // keep parents ordered before children, then the files are linked or copied across
+    // worker threads.
+    static void copy_directory_parallel(Files::Filesystem& fs, const fs::path& source, const fs::path& destination)
+    {
+        std::error_code ec;
+        fs.create_directory(destination, ec);
+
+        std::vector<fs::path> files;
+        for (const fs::path& entry : fs.get_files_recursive(source))
         {
-            const fs::path dest_path = destination_folder / src_path.filename();
-            fs.copy(src_path, dest_path, fs::copy_options::overwrite_existing);
+            const fs::path target = destination / entry.generic_string().substr(source.generic_string().size() + 1);
+            if (fs.is_directory(entry))
+            {
+                fs.create_directory(target, ec);
+            }
+            else
+            {
+                files.push_back(entry);
+            }
         }
+
+        Parallel::for_each_index(files.size(), [&](const size_t i) {
+            const fs::path target =
+                destination / files[i].generic_string().substr(source.generic_string().size() + 1);
+            link_or_copy_file(fs, files[i], target);
+        });
     }
 
     static void place_library_files_in(Files::Filesystem& fs,
@@ -64,9 +106,7 @@ namespace vcpkg::Commands::Import
         const Binaries release_binaries = find_binaries_in_dir(fs, project_directory / "Release");
 
         const fs::path destination_include_directory = destination_path / "include";
-        fs.copy(include_directory,
-                destination_include_directory,
-                fs::copy_options::recursive | fs::copy_options::overwrite_existing);
+        copy_directory_parallel(fs, include_directory, destination_include_directory);
 
         copy_files_into_directory(fs, release_binaries.dlls, destination_path / "bin");
         copy_files_into_directory(fs, release_binaries.libs, destination_path / "lib");
@@ -109,7 +149,7 @@ namespace vcpkg::Commands::Import
         const fs::path include_directory(args.command_arguments[1]);
         const fs::path project_directory(args.command_arguments[2]);
 
-        const Expected<std::unordered_map<std::string, std::string>> pghs =
+        Expected<Paragraphs::RawParagraph> pghs =
             Paragraphs::get_single_paragraph(paths.get_filesystem(), control_file_path);
         Checks::check_exit(VCPKG_LINE_INFO,
                            pghs.get() != nullptr,
@@ -117,7 +157,7 @@ namespace vcpkg::Commands::Import
                            control_file_path.generic_string());
 
         StatusParagraph spgh;
-        spgh.package = BinaryParagraph(*pghs.get());
+        spgh.package = BinaryParagraph(std::move(*pghs.get()));
         auto& control_file_data = spgh.package;
 
         do_import(paths, include_directory, project_directory, control_file_data);
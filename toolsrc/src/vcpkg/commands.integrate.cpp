@@ -2,6 +2,7 @@
 
 #include <vcpkg/base/checks.h>
 #include <vcpkg/base/files.h>
+#include <vcpkg/base/hash.h>
 #include <vcpkg/base/system.h>
 #include <vcpkg/base/util.h>
 #include <vcpkg/commands.h>
@@ -221,20 +222,29 @@ namespace vcpkg::Commands::Integrate
                                SYSTEM_WIDE_TARGETS_FILE.string());
         }
 
-        const fs::path appdata_src_path = tmp_dir / "vcpkg.user.targets";
-        fs.write_contents(appdata_src_path,
-                          create_appdata_targets_shortcut(paths.buildsystems_msbuild_targets.string()));
+        const std::string appdata_contents =
+            create_appdata_targets_shortcut(paths.buildsystems_msbuild_targets.string());
         auto appdata_dst_path = get_appdata_targets_path();
 
-        const auto rc = fs.copy_file(appdata_src_path, appdata_dst_path, fs::copy_options::overwrite_existing, ec);
-
-        if (!rc || ec)
+        // Provisioning scripts run `integrate install` on every boot; when the file
+        // already holds exactly the content we would write, skip the write entirely.
+        const Expected<std::string> existing_appdata_contents = fs.read_contents(appdata_dst_path);
+        const auto existing_appdata = existing_appdata_contents.get();
+        if (existing_appdata == nullptr || *existing_appdata != appdata_contents)
         {
-            System::println(System::Color::error,
-                            "Error: Failed to copy file: %s -> %s",
-                            appdata_src_path.string(),
-                            appdata_dst_path.string());
-            Checks::exit_fail(VCPKG_LINE_INFO);
+            const fs::path appdata_src_path = tmp_dir / "vcpkg.user.targets";
+            fs.write_contents(appdata_src_path, appdata_contents);
+
+            const auto rc = fs.copy_file(appdata_src_path, appdata_dst_path, fs::copy_options::overwrite_existing, ec);
+
+            if (!rc || ec)
+            {
+                System::println(System::Color::error,
+                                "Error: Failed to copy file: %s -> %s",
+                                appdata_src_path.string(),
+                                appdata_dst_path.string());
+                Checks::exit_fail(VCPKG_LINE_INFO);
+            }
         }
         System::println(System::Color::success, "Applied user-wide integration for this vcpkg root.");
         const fs::path cmake_toolchain = paths.buildsystems / "vcpkg.cmake";
@@ -290,22 +300,42 @@ CMake projects should use: "-DCMAKE_TOOLCHAIN_FILE=%s")",
         const std::string nuget_id = get_nuget_id(paths.root);
         const std::string nupkg_version = "1.0.0";
 
-        fs.write_contents(targets_file_path, create_nuget_targets_file_contents(paths.buildsystems_msbuild_targets));
-        fs.write_contents(props_file_path, create_nuget_props_file_contents());
-        fs.write_contents(nuspec_file_path, create_nuspec_file_contents(paths.root, nuget_id, nupkg_version));
-
-        // Using all forward slashes for the command line
-        const std::string cmd_line = Strings::format(R"("%s" pack -OutputDirectory "%s" "%s" > nul)",
-                                                     nuget_exe.u8string(),
-                                                     buildsystems_dir.u8string(),
-                                                     nuspec_file_path.u8string());
-
-        const int exit_code = System::cmd_execute_clean(cmd_line);
+        const std::string targets_contents = create_nuget_targets_file_contents(paths.buildsystems_msbuild_targets);
+        const std::string props_contents = create_nuget_props_file_contents();
+        const std::string nuspec_contents = create_nuspec_file_contents(paths.root, nuget_id, nupkg_version);
 
         const fs::path nuget_package = buildsystems_dir / Strings::format("%s.%s.nupkg", nuget_id, nupkg_version);
-        Checks::check_exit(
-            VCPKG_LINE_INFO, exit_code == 0 && fs.exists(nuget_package), "Error: NuGet package creation failed");
-        System::println(System::Color::success, "Created nupkg: %s", nuget_package.string());
+
+        // Hash of everything that feeds the package; when the previous run packed the
+        // same inputs and the nupkg is still there, the nuget spawn is skipped.
+        const fs::path inputs_stamp_path = tmp_dir / "vcpkg.nuget.inputs.sha";
+        const std::string inputs_hash =
+            vcpkg::Hash::get_string_hash(targets_contents + props_contents + nuspec_contents, "SHA256");
+        const Expected<std::string> previous_stamp = fs.read_contents(inputs_stamp_path);
+        const auto previous_hash = previous_stamp.get();
+        if (previous_hash != nullptr && *previous_hash == inputs_hash && fs.exists(nuget_package))
+        {
+            System::println(System::Color::success, "Reusing up-to-date nupkg: %s", nuget_package.string());
+        }
+        else
+        {
+            fs.write_contents(targets_file_path, targets_contents);
+            fs.write_contents(props_file_path, props_contents);
+            fs.write_contents(nuspec_file_path, nuspec_contents);
+
+            // Using all forward slashes for the command line
+            const std::string cmd_line = Strings::format(R"("%s" pack -OutputDirectory "%s" "%s" > nul)",
+                                                         nuget_exe.u8string(),
+                                                         buildsystems_dir.u8string(),
+                                                         nuspec_file_path.u8string());
+
+            const int exit_code = System::cmd_execute_clean(cmd_line);
+
+            Checks::check_exit(
+                VCPKG_LINE_INFO, exit_code == 0 && fs.exists(nuget_package), "Error: NuGet package creation failed");
+            fs.write_contents(inputs_stamp_path, inputs_hash);
+            System::println(System::Color::success, "Created nupkg: %s", nuget_package.string());
+        }
 
         auto source_path = buildsystems_dir.u8string();
         source_path = Strings::replace_all(std::move(source_path), "`", "``");
@@ -8,24 +8,64 @@
 namespace vcpkg::Commands::List
 {
     static const std::string OPTION_FULLDESC = "--x-full-desc"; // TODO: This should find a better home, eventually
+    static const std::string OPTION_JSON = "--x-json";
 
-    static void do_print(const StatusParagraph& pgh, bool full_desc)
+    static void do_print(const std::string& displayname, const StatusParagraph& pgh, const bool full_desc)
     {
         if (full_desc)
         {
-            System::println("%-50s %-16s %s", pgh.package.displayname(), pgh.package.version, pgh.package.description);
+            System::println("%-50s %-16s %s", displayname, pgh.package.version, pgh.package.description);
         }
         else
         {
             System::println("%-50s %-16s %s",
-                            vcpkg::shorten_text(pgh.package.displayname(), 50),
+                            vcpkg::shorten_text(displayname, 50),
                             vcpkg::shorten_text(pgh.package.version, 16),
                             vcpkg::shorten_text(pgh.package.description, 51));
         }
     }
 
-    static const std::array<CommandSwitch, 1> LIST_SWITCHES = {{
+    static std::string json_escape(const std::string& s)
+    {
+        std::string out;
+        for (const char c : s)
+        {
+            if (c == '"' || c == '\\')
+            {
+                out.push_back('\\');
+                out.push_back(c);
+            }
+            else if (c == '\n')
+                out += "\\n";
+            else if (c == '\r')
+                out += "\\r";
+            else if (c == '\t')
+                out += "\\t";
+            else
+                out.push_back(c);
+        }
+        return out;
+    }
+
+    static void append_json_entry(std::string& out, const StatusParagraph& pgh)
+    {
+        const BinaryParagraph& package = pgh.package;
+        out.append("{\"package\":\"")
+            .append(json_escape(package.spec.name()))
+            .append("\",\"triplet\":\"")
+            .append(json_escape(package.spec.triplet().canonical_name()))
+            .append("\",\"feature\":\"")
+            .append(json_escape(package.feature))
+            .append("\",\"version\":\"")
+            .append(json_escape(package.version))
+            .append("\",\"description\":\"")
+            .append(json_escape(package.description))
+            .append("\"}");
+    }
+
+    static const std::array<CommandSwitch, 2> LIST_SWITCHES = {{
         {OPTION_FULLDESC, "Do not truncate long text"},
+        {OPTION_JSON, "Emit the installed set as a JSON array in a single write"},
     }};
 
     const CommandStructure COMMAND_STRUCTURE = {
@@ -41,41 +81,61 @@ namespace vcpkg::Commands::List
     void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths)
     {
         const ParsedArguments options = args.parse_arguments(COMMAND_STRUCTURE);
+        const bool full_desc = Util::Sets::contains(options.switches, OPTION_FULLDESC);
+        const bool json = Util::Sets::contains(options.switches, OPTION_JSON);
 
         const StatusParagraphs status_paragraphs = database_load_check(paths);
-        std::vector<StatusParagraph*> installed_packages = get_installed_ports(status_paragraphs);
+        const std::vector<StatusParagraph*> installed_packages = get_installed_ports(status_paragraphs);
 
         if (installed_packages.empty())
         {
-            System::println("No packages are installed. Did you mean `search`?");
+            if (json)
+            {
+                System::println("[]");
+            }
+            else
+            {
+                System::println("No packages are installed. Did you mean `search`?");
+            }
             Checks::exit_success(VCPKG_LINE_INFO);
         }
 
-        std::sort(installed_packages.begin(),
-                  installed_packages.end(),
-                  [](const StatusParagraph* lhs, const StatusParagraph* rhs) -> bool {
-                      return lhs->package.displayname() < rhs->package.displayname();
-                  });
+        // Sort an index over displaynames computed once, instead of re-materializing the
+        // displayname for every comparison, and stream lines out in index order.
+        std::vector<std::pair<std::string, const StatusParagraph*>> index;
+        index.reserve(installed_packages.size());
+        for (const StatusParagraph* status_paragraph : installed_packages)
+        {
+            index.emplace_back(status_paragraph->package.displayname(), status_paragraph);
+        }
+        std::sort(index.begin(), index.end());
+
+        if (args.command_arguments.size() == 1)
+        {
+            const std::string& filter = args.command_arguments[0];
+            Util::erase_remove_if(index, [&](const std::pair<std::string, const StatusParagraph*>& entry) {
+                return Strings::case_insensitive_ascii_find(entry.first, filter) == entry.first.end();
+            });
+        }
 
-        if (args.command_arguments.size() == 0)
+        if (json)
         {
-            for (const StatusParagraph* status_paragraph : installed_packages)
+            // Tooling consumes this; emit the whole document in one write so consumers
+            // never observe a partially flushed array.
+            std::string out = "[";
+            for (const auto& entry : index)
             {
-                do_print(*status_paragraph, Util::Sets::contains(options.switches, OPTION_FULLDESC));
+                if (out.size() > 1) out.push_back(',');
+                append_json_entry(out, *entry.second);
             }
+            out += "]\n";
+            System::print(out);
         }
         else
         {
-            // At this point there is 1 argument
-            for (const StatusParagraph* status_paragraph : installed_packages)
+            for (const auto& entry : index)
             {
-                const std::string displayname = status_paragraph->package.displayname();
-                if (Strings::case_insensitive_ascii_find(displayname, args.command_arguments[0]) == displayname.end())
-                {
-                    continue;
-                }
-
-                do_print(*status_paragraph, Util::Sets::contains(options.switches, OPTION_FULLDESC));
+                do_print(entry.first, *entry.second, full_desc);
             }
         }
 
@@ -74,36 +74,109 @@ namespace vcpkg::Commands::PortsDiff
         }
     }
 
-    static std::map<std::string, VersionT> read_ports_from_commit(const VcpkgPaths& paths,
-                                                                  const std::string& git_commit_id)
+    // Ports not named by `git diff` are identical in both commits, so only the changed
+    // ones need their versions compared.
+    static std::vector<std::string> find_changed_port_names(const VcpkgPaths& paths,
+                                                            const std::string& git_commit_id_previous,
+                                                            const std::string& git_commit_id_current)
     {
+        const fs::path& git_exe = paths.get_git_exe();
+        const fs::path dot_git_dir = paths.root / ".git";
+        const std::string ports_dir_name_as_string = paths.ports.filename().u8string();
+
+        const std::string cmd = Strings::format(R"("%s" --git-dir="%s" diff --name-only %s %s -- "%s/")",
+                                                git_exe.u8string(),
+                                                dot_git_dir.u8string(),
+                                                git_commit_id_previous,
+                                                git_commit_id_current,
+                                                ports_dir_name_as_string);
+        const System::ExitCodeAndOutput output = System::cmd_execute_and_capture_output(cmd);
+        Checks::check_exit(VCPKG_LINE_INFO,
+                           output.exit_code == 0,
+                           "Failed to diff ports between %s and %s",
+                           git_commit_id_previous,
+                           git_commit_id_current);
+
+        std::set<std::string> port_names;
+        for (const std::string& line : Strings::split(output.output, "\n"))
+        {
+            const std::vector<std::string> components = Strings::split(line, "/");
+            if (components.size() >= 2 && components[0] == ports_dir_name_as_string)
+            {
+                port_names.insert(components[1]);
+            }
+        }
+
+        return std::vector<std::string>(port_names.begin(), port_names.end());
+    }
+
+    static std::map<std::string, VersionT> read_port_versions_at_commit(const VcpkgPaths& paths,
+                                                                        const std::string& git_commit_id,
+                                                                        const std::vector<std::string>& port_names)
+    {
+        std::map<std::string, VersionT> names_and_versions;
+        if (port_names.empty()) return names_and_versions;
+
         std::error_code ec;
         auto& fs = paths.get_filesystem();
         const fs::path& git_exe = paths.get_git_exe();
         const fs::path dot_git_dir = paths.root / ".git";
         const std::string ports_dir_name_as_string = paths.ports.filename().u8string();
-        const fs::path temp_checkout_path =
-            paths.root / Strings::format("%s-%s", ports_dir_name_as_string, git_commit_id);
-        fs.create_directory(temp_checkout_path, ec);
-        const auto checkout_this_dir =
-            Strings::format(R"(.\%s)", ports_dir_name_as_string); // Must be relative to the root of the repository
-
-        const std::string cmd =
-            Strings::format(R"("%s" --git-dir="%s" --work-tree="%s" checkout %s -f -q -- %s %s & "%s" reset >NUL)",
-                            git_exe.u8string(),
-                            dot_git_dir.u8string(),
-                            temp_checkout_path.u8string(),
-                            git_commit_id,
-                            checkout_this_dir,
-                            ".vcpkg-root",
-                            git_exe.u8string());
-        System::cmd_execute_clean(cmd);
-        const auto all_ports =
-            Paragraphs::load_all_ports(paths.get_filesystem(), temp_checkout_path / ports_dir_name_as_string);
-        std::map<std::string, VersionT> names_and_versions;
-        for (auto&& port : all_ports)
-            names_and_versions.emplace(port->core_paragraph->name, port->core_paragraph->version);
-        fs.remove_all(temp_checkout_path, ec);
+
+        // cat-file --batch streams every requested CONTROL blob back over a single git
+        // process, so no temporary checkout of either tree is ever materialized.
+        std::string requests;
+        for (const std::string& name : port_names)
+        {
+            requests.append(
+                Strings::format("%s:%s/%s/CONTROL\n", git_commit_id, ports_dir_name_as_string, name));
+        }
+
+        fs.create_directories(paths.buildtrees, ec);
+        const fs::path requests_path = paths.buildtrees / "portsdiff-requests.txt";
+        fs.write_contents(requests_path, requests);
+
+        const std::string cmd = Strings::format(R"("%s" --git-dir="%s" cat-file --batch < "%s")",
+                                                git_exe.u8string(),
+                                                dot_git_dir.u8string(),
+                                                requests_path.u8string());
+        const System::ExitCodeAndOutput output = System::cmd_execute_and_capture_output(cmd);
+        fs.remove(requests_path, ec);
+        Checks::check_exit(
+            VCPKG_LINE_INFO, output.exit_code == 0, "Failed to read port CONTROL files at %s", git_commit_id);
+
+        // Each response is a `<sha> <type> <size>` header line followed by `size` bytes
+        // of blob content and a trailing newline; absent objects report `missing`.
+        size_t pos = 0;
+        for (const std::string& name : port_names)
+        {
+            const size_t header_end = output.output.find('\n', pos);
+            if (header_end == std::string::npos) break;
+            const std::string header = output.output.substr(pos, header_end - pos);
+            pos = header_end + 1;
+
+            const std::vector<std::string> fields = Strings::split(header, " ");
+            if (fields.size() < 2) break;
+            // A port directory can exist in only one of the two commits.
+            if (fields[1] == "missing") continue;
+            if (fields.size() != 3) break;
+
+            const size_t blob_size = std::strtoull(fields[2].c_str(), nullptr, 10);
+            if (output.output.size() - pos < blob_size) break;
+            const std::string contents = output.output.substr(pos, blob_size);
+            pos += blob_size + 1;
+
+            auto maybe_paragraph = Paragraphs::parse_single_paragraph(contents);
+            if (const auto paragraph = maybe_paragraph.get())
+            {
+                const auto it = paragraph->find("Version");
+                if (it != paragraph->end())
+                {
+                    names_and_versions.emplace(name, VersionT(it->second));
+                }
+            }
+        }
+
         return names_and_versions;
     }
 
@@ -139,10 +212,12 @@ namespace vcpkg::Commands::PortsDiff
         check_commit_exists(git_exe, git_commit_id_for_current_snapshot);
         check_commit_exists(git_exe, git_commit_id_for_previous_snapshot);
 
+        const std::vector<std::string> changed_ports = find_changed_port_names(
+            paths, git_commit_id_for_previous_snapshot, git_commit_id_for_current_snapshot);
         const std::map<std::string, VersionT> current_names_and_versions =
-            read_ports_from_commit(paths, git_commit_id_for_current_snapshot);
+            read_port_versions_at_commit(paths, git_commit_id_for_current_snapshot, changed_ports);
         const std::map<std::string, VersionT> previous_names_and_versions =
-            read_ports_from_commit(paths, git_commit_id_for_previous_snapshot);
+            read_port_versions_at_commit(paths, git_commit_id_for_previous_snapshot, changed_ports);
 
         // Already sorted, so set_difference can work on std::vector too
         const std::vector<std::string> current_ports = Util::extract_keys(current_names_and_versions);
@@ -30,7 +30,7 @@ namespace vcpkg::Commands::Search
 
         for (const auto& source_control_file : source_control_files)
         {
-            const SourceParagraph& source_paragraph = *source_control_file->core_paragraph;
+            const SourceParagraph& source_paragraph = source_control_file->core_paragraph;
             if (source_paragraph.depends.empty())
             {
                 empty_node_count++;
@@ -79,6 +79,63 @@ namespace vcpkg::Commands::Search
         }
     }
 
+    // Edit distance between `query` and `name`, capped at `max_distance + 1` so the
+    // cost stays linear in the name length for non-matches. Both inputs must already be
+    // lowercased.
+    static size_t levenshtein_distance(const std::string& query, const std::string& name, const size_t max_distance)
+    {
+        if (query.size() > name.size() + max_distance || name.size() > query.size() + max_distance)
+            return max_distance + 1;
+
+        std::vector<size_t> row(query.size() + 1);
+        for (size_t i = 0; i <= query.size(); ++i)
+            row[i] = i;
+
+        for (size_t j = 1; j <= name.size(); ++j)
+        {
+            size_t diagonal = row[0];
+            row[0] = j;
+            size_t row_min = row[0];
+            for (size_t i = 1; i <= query.size(); ++i)
+            {
+                const size_t substitution = diagonal + (query[i - 1] != name[j - 1]);
+                diagonal = row[i];
+                row[i] = std::min({row[i - 1] + 1, row[i] + 1, substitution});
+                row_min = std::min(row_min, row[i]);
+            }
+            if (row_min > max_distance) return max_distance + 1;
+        }
+
+        return row[query.size()];
+    }
+
+    // Lower ranks sort first. Ports tie on rank in alphabetical order because the input
+    // is already sorted by port directory.
+    enum class MatchRank
+    {
+        NAME_EXACT = 0,
+        NAME_PREFIX,
+        NAME_SUBSTRING,
+        NAME_FUZZY,
+        DESCRIPTION_SUBSTRING,
+        NONE,
+    };
+
+    static MatchRank rank_against_name(const std::string& query_lowercase, const std::string& name)
+    {
+        const std::string name_lowercase = Strings::ascii_to_lowercase(name);
+        if (name_lowercase == query_lowercase) return MatchRank::NAME_EXACT;
+        if (Strings::case_insensitive_ascii_starts_with(name_lowercase, query_lowercase))
+            return MatchRank::NAME_PREFIX;
+        if (name_lowercase.find(query_lowercase) != std::string::npos) return MatchRank::NAME_SUBSTRING;
+        // Allow one typo in short queries and two in longer ones.
+        const size_t max_distance = query_lowercase.size() >= 8 ? 2 : query_lowercase.size() >= 4 ? 1 : 0;
+        if (max_distance != 0 &&
+            levenshtein_distance(query_lowercase, name_lowercase, max_distance) <= max_distance)
+            return MatchRank::NAME_FUZZY;
+        return MatchRank::NONE;
+    }
+
     static std::array<CommandSwitch, 2> SEARCH_SWITCHES = {{
         {OPTION_GRAPH, "Open editor into the port-specific buildtree subfolder"},
         {OPTION_FULLDESC, "Do not truncate long text"},
@@ -99,7 +156,7 @@ namespace vcpkg::Commands::Search
         const ParsedArguments options = args.parse_arguments(COMMAND_STRUCTURE);
         const bool full_description = Util::Sets::contains(options.switches, OPTION_FULLDESC);
 
-        auto source_paragraphs = Paragraphs::load_all_ports(paths.get_filesystem(), paths.ports);
+        auto source_paragraphs = Paragraphs::load_all_ports_cached(paths);
 
         if (Util::Sets::contains(options.switches, OPTION_GRAPH))
         {
@@ -112,10 +169,10 @@ namespace vcpkg::Commands::Search
         {
             for (const auto& source_control_file : source_paragraphs)
             {
-                do_print(*source_control_file->core_paragraph, full_description);
+                do_print(source_control_file->core_paragraph, full_description);
                 for (auto&& feature_paragraph : source_control_file->feature_paragraphs)
                 {
-                    do_print(source_control_file->core_paragraph->name, *feature_paragraph, full_description);
+                    do_print(source_control_file->core_paragraph.name, feature_paragraph, full_description);
                 }
             }
         }
@@ -125,22 +182,65 @@ namespace vcpkg::Commands::Search
 
             // At this point there is 1 argument
             auto&& args_zero = args.command_arguments[0];
+            const std::string query_lowercase = Strings::ascii_to_lowercase(args_zero);
+
+            // Rank every port once, then print best matches first: exact name, name
+            // prefix, name substring, close-typo names, and finally description-only
+            // hits.
+            struct RankedMatch
+            {
+                MatchRank rank;
+                const SourceControlFile* scf;
+                bool name_matched;
+            };
+            std::vector<RankedMatch> matches;
             for (const auto& source_control_file : source_paragraphs)
             {
-                auto&& sp = *source_control_file->core_paragraph;
+                auto&& sp = source_control_file->core_paragraph;
+
+                MatchRank rank = rank_against_name(query_lowercase, sp.name);
+                const bool name_matched = rank != MatchRank::NONE;
+                if (!name_matched && icontains(sp.description, args_zero))
+                {
+                    rank = MatchRank::DESCRIPTION_SUBSTRING;
+                }
+                if (rank == MatchRank::NONE)
+                {
+                    for (auto&& feature_paragraph : source_control_file->feature_paragraphs)
+                    {
+                        if (icontains(feature_paragraph.name, args_zero) ||
+                            icontains(feature_paragraph.description, args_zero))
+                        {
+                            rank = MatchRank::DESCRIPTION_SUBSTRING;
+                            break;
+                        }
+                    }
+                }
+                if (rank != MatchRank::NONE)
+                {
+                    matches.push_back({rank, source_control_file.get(), name_matched});
+                }
+            }
+
+            std::stable_sort(matches.begin(), matches.end(), [](const RankedMatch& l, const RankedMatch& r) {
+                return l.rank < r.rank;
+            });
+
+            for (const RankedMatch& match : matches)
+            {
+                auto&& sp = match.scf->core_paragraph;
 
-                const bool contains_name = icontains(sp.name, args_zero);
-                if (contains_name || icontains(sp.description, args_zero))
+                if (match.name_matched || icontains(sp.description, args_zero))
                 {
                     do_print(sp, full_description);
                 }
 
-                for (auto&& feature_paragraph : source_control_file->feature_paragraphs)
+                for (auto&& feature_paragraph : match.scf->feature_paragraphs)
                 {
-                    if (contains_name || icontains(feature_paragraph->name, args_zero) ||
-                        icontains(feature_paragraph->description, args_zero))
+                    if (match.name_matched || icontains(feature_paragraph.name, args_zero) ||
+                        icontains(feature_paragraph.description, args_zero))
                     {
-                        do_print(sp.name, *feature_paragraph, full_description);
+                        do_print(sp.name, feature_paragraph, full_description);
                     }
                 }
             }
@@ -0,0 +1,154 @@
+#include "pch.h"
+
+#include <vcpkg/base/util.h>
+#include <vcpkg/commands.h>
+#include <vcpkg/dependencies.h>
+#include <vcpkg/globalstate.h>
+#include <vcpkg/help.h>
+#include <vcpkg/input.h>
+#include <vcpkg/install.h>
+#include <vcpkg/paragraphs.h>
+#include <vcpkg/vcpkglib.h>
+
+#include <set>
+
+namespace vcpkg::Commands::SetInstalled
+{
+    using Install::KeepGoing;
+    using Install::to_keep_going;
+
+    // Declarative installation: the caller states the complete desired package set and one
+    // process computes a single combined plan -- install what is missing, remove what is no
+    // longer wanted -- instead of paying startup, parsing, and planning for a sequence of
+    // install/remove invocations.
+
+    static const std::string OPTION_DRY_RUN = "--dry-run";
+    static const std::string OPTION_KEEP_GOING = "--keep-going";
+    static const std::string OPTION_FILE = "--x-file";
+
+    static const std::array<CommandSwitch, 2> SET_INSTALLED_SWITCHES = {{
+        {OPTION_DRY_RUN, "Print the plan, but do not execute it"},
+        {OPTION_KEEP_GOING, "Continue installing packages on failure"},
+    }};
+
+    static const std::array<CommandSetting, 1> SET_INSTALLED_SETTINGS = {{
+        {OPTION_FILE, "File listing the desired packages, one spec per line ('#' starts a comment)"},
+    }};
+
+    const CommandStructure COMMAND_STRUCTURE = {
+        Help::create_example_string("x-set-installed zlib libpng --x-file=desired.txt"),
+        0,
+        SIZE_MAX,
+        {SET_INSTALLED_SWITCHES, SET_INSTALLED_SETTINGS},
+        nullptr,
+    };
+
+    void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths, const Triplet& default_triplet)
+    {
+        const ParsedArguments options = args.parse_arguments(COMMAND_STRUCTURE);
+
+        const bool dry_run = Util::Sets::contains(options.switches, OPTION_DRY_RUN);
+        const KeepGoing keep_going = to_keep_going(Util::Sets::contains(options.switches, OPTION_KEEP_GOING));
+
+        std::vector<std::string> spec_strings = args.command_arguments;
+        const auto it_file = options.settings.find(OPTION_FILE);
+        if (it_file != options.settings.end())
+        {
+            const auto maybe_lines = paths.get_filesystem().read_lines(fs::u8path(it_file->second));
+            Checks::check_exit(
+                VCPKG_LINE_INFO, maybe_lines.has_value(), "Could not read spec file: %s", it_file->second);
+            for (const std::string& line : *maybe_lines.get())
+            {
+                const std::string trimmed = Strings::trim(std::string(line));
+                if (trimmed.empty() || trimmed[0] == '#') continue;
+                spec_strings.push_back(trimmed);
+            }
+        }
+
+        const std::vector<FullPackageSpec> specs = Util::fmap(spec_strings, [&](auto&& arg) {
+            return Input::check_and_get_full_package_spec(arg, default_triplet, COMMAND_STRUCTURE.example_text);
+        });
+
+        for (auto&& spec : specs)
+        {
+            Input::check_triplet(spec.package_spec.triplet(), paths);
+        }
+
+        StatusParagraphs status_db = database_load_check(paths);
+
+        // Note: action_plan will hold raw pointers to SourceControlFiles from this map
+        auto all_ports = Paragraphs::load_all_ports_cached(paths);
+        std::unordered_map<std::string, SourceControlFile> scf_map;
+        for (auto&& port : all_ports)
+            scf_map[port->core_paragraph.name] = std::move(*port);
+        Dependencies::MapPortFileProvider provider(scf_map);
+
+        std::vector<Dependencies::AnyAction> install_plan =
+            Dependencies::create_feature_install_plan(provider, FullPackageSpec::to_feature_specs(specs), status_db);
+
+        // Everything reachable from the desired set stays; every other installed package is
+        // removed as part of the same transaction.
+        std::set<PackageSpec> desired_closure;
+        for (const auto& action : install_plan)
+        {
+            desired_closure.insert(action.spec());
+        }
+
+        std::vector<PackageSpec> to_remove;
+        for (const StatusParagraph* pgh : get_installed_ports(status_db))
+        {
+            if (!Util::Sets::contains(desired_closure, pgh->package.spec))
+            {
+                to_remove.push_back(pgh->package.spec);
+            }
+        }
+
+        std::vector<Dependencies::AnyAction> action_plan;
+        for (auto&& remove_action : Dependencies::create_remove_plan(to_remove, status_db))
+        {
+            action_plan.emplace_back(std::move(remove_action));
+        }
+        for (auto&& action : install_plan)
+        {
+            action_plan.push_back(std::move(action));
+        }
+
+        const Build::BuildPackageOptions install_plan_options = {
+            Build::UseHeadVersion::NO,
+            Build::AllowDownloads::YES,
+            Build::CleanBuildtrees::NO,
+        };
+
+        for (auto&& action : action_plan)
+        {
+            if (auto p_install = action.install_action.get())
+            {
+                p_install->build_options = install_plan_options;
+            }
+        }
+
+        if (action_plan.empty())
+        {
+            System::println(System::Color::success, "The installed packages already match the requested set.");
+            Checks::exit_success(VCPKG_LINE_INFO);
+        }
+
+        Dependencies::print_plan(action_plan, GlobalState::debugging);
+
+        if (dry_run)
+        {
+            Checks::exit_success(VCPKG_LINE_INFO);
+        }
+
+        const Install::InstallSummary summary = Install::perform(action_plan, keep_going, paths, status_db);
+
+        System::println("\nTotal elapsed time: %s\n", summary.total_elapsed_time);
+
+        if (keep_going == KeepGoing::YES)
+        {
+            summary.print();
+        }
+
+        Checks::exit_success(VCPKG_LINE_INFO);
+    }
+}
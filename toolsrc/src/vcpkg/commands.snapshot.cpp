@@ -0,0 +1,102 @@
+#include "pch.h"
+
+#include <vcpkg/base/system.h>
+#include <vcpkg/commands.h>
+#include <vcpkg/help.h>
+#include <vcpkg/vcpkglib.h>
+
+namespace vcpkg::Commands::Snapshot
+{
+    static const std::string OPTION_RESTORE = "--restore";
+
+    static const std::array<CommandSwitch, 1> SNAPSHOT_SWITCHES = {{
+        {OPTION_RESTORE, "Restore the installed tree from the given snapshot instead of creating one"},
+    }};
+
+    const CommandStructure COMMAND_STRUCTURE = {
+        Strings::format("The argument is the snapshot archive to write (or, with --restore, to read).\n%s",
+                        Help::create_example_string("x-snapshot agent-snapshot.zip")),
+        1,
+        1,
+        {SNAPSHOT_SWITCHES, {}},
+        nullptr,
+    };
+
+    // The whole installed/ tree is archived, which includes the status database and
+    // listfiles under installed/vcpkg/, so a restore reproduces exactly the state the
+    // status machinery expects without replaying any install.
+    static void snapshot_create(const VcpkgPaths& paths, const fs::path& archive_path)
+    {
+        auto& fs = paths.get_filesystem();
+        Checks::check_exit(
+            VCPKG_LINE_INFO, fs.is_directory(paths.installed), "There is no installed tree to snapshot.");
+
+        // Fold any journaled status updates into the status file first, so the
+        // archive carries a consistent database.
+        database_load_check(paths);
+
+        const fs::path archive_tmp_path = archive_path.generic_string() + ".tmp";
+        std::error_code ec;
+        fs.create_directories(archive_path.parent_path(), ec);
+
+        // One sequential compressed write through the same archiver the binary cache
+        // uses; zip keeps the snapshot portable across agent platforms.
+        const fs::path& cmake_exe = paths.get_cmake_exe();
+        const int exit_code =
+            System::cmd_execute_clean(Strings::format(R"("%s" -E chdir "%s" "%s" -E tar cf "%s" --format=zip -- .)",
+                                                      cmake_exe.u8string(),
+                                                      paths.installed.u8string(),
+                                                      cmake_exe.u8string(),
+                                                      archive_tmp_path.u8string()));
+        if (exit_code != 0)
+        {
+            fs.remove(archive_tmp_path, ec);
+            Checks::exit_with_message(VCPKG_LINE_INFO, "Creating the snapshot archive failed.");
+        }
+
+        fs.rename(archive_tmp_path, archive_path);
+        System::println(System::Color::success, "Snapshot written to:\n    %s", archive_path.u8string());
+    }
+
+    static void snapshot_restore(const VcpkgPaths& paths, const fs::path& archive_path)
+    {
+        auto& fs = paths.get_filesystem();
+        Checks::check_exit(
+            VCPKG_LINE_INFO, fs.exists(archive_path), "Snapshot archive does not exist: %s", archive_path.u8string());
+
+        std::error_code ec;
+        fs.create_directories(paths.installed, ec);
+
+        const fs::path& cmake_exe = paths.get_cmake_exe();
+        const int exit_code = System::cmd_execute_clean(Strings::format(R"("%s" -E chdir "%s" "%s" -E tar xf "%s")",
+                                                                        cmake_exe.u8string(),
+                                                                        paths.installed.u8string(),
+                                                                        cmake_exe.u8string(),
+                                                                        archive_path.u8string()));
+        Checks::check_exit(VCPKG_LINE_INFO, exit_code == 0, "Restoring the snapshot archive failed.");
+
+        // Any updates journal inside the snapshot predates it; folding it now leaves
+        // the database exactly as the snapshotted agent saw it.
+        const StatusParagraphs status_db = database_load_check(paths);
+        System::println(System::Color::success,
+                        "Restored %zd installed packages from:\n    %s",
+                        get_installed_ports(status_db).size(),
+                        archive_path.u8string());
+    }
+
+    void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths)
+    {
+        const ParsedArguments options = args.parse_arguments(COMMAND_STRUCTURE);
+        const fs::path archive_path = fs::stdfs::absolute(fs::u8path(args.command_arguments[0]));
+
+        if (Util::Sets::contains(options.switches, OPTION_RESTORE))
+        {
+            snapshot_restore(paths, archive_path);
+        }
+        else
+        {
+            snapshot_create(paths, archive_path);
+        }
+        Checks::exit_success(VCPKG_LINE_INFO);
+    }
+}
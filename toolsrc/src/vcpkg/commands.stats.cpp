@@ -0,0 +1,34 @@
+#include "pch.h"
+
+#include <vcpkg/base/stats.h>
+#include <vcpkg/commands.h>
+#include <vcpkg/help.h>
+#include <vcpkg/paragraphs.h>
+#include <vcpkg/vcpkglib.h>
+
+namespace vcpkg::Commands::Stats
+{
+    const CommandStructure COMMAND_STRUCTURE = {
+        Help::create_example_string("x-stats"),
+        0,
+        0,
+        {},
+        nullptr,
+    };
+
+    void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths)
+    {
+        args.parse_arguments(COMMAND_STRUCTURE);
+
+        // Exercise the instrumented hot paths -- the (cached) ports load and the status
+        // database -- so the reported counters reflect the state of the caches, then
+        // print them in the same JSON shape --stats uses at exit.
+        database_load_check(paths);
+        const auto all_ports = Paragraphs::load_all_ports_cached(paths);
+        (void)all_ports;
+
+        System::println("%s", vcpkg::Stats::to_json());
+
+        Checks::exit_success(VCPKG_LINE_INFO);
+    }
+}
@@ -40,7 +40,7 @@ namespace vcpkg::Commands::Upgrade
 
         StatusParagraphs status_db = database_load_check(paths);
 
-        Dependencies::PathsPortFileProvider provider(paths);
+        Dependencies::PathsPortFileProvider provider(paths, args.overlay_ports);
         Dependencies::PackageGraph graph(provider, status_db);
 
         // input sanitization
@@ -55,8 +55,10 @@ namespace vcpkg::Commands::Upgrade
 
         if (specs.empty())
         {
-            // If no packages specified, upgrade all outdated packages.
-            auto outdated_packages = Update::find_outdated_packages(provider, status_db);
+            // If no packages specified, upgrade all outdated packages. The version diff
+            // runs off the port version stamp index, so it loads no control files for
+            // up-to-date ports.
+            auto outdated_packages = Update::find_outdated_packages(paths, provider, status_db);
 
             if (outdated_packages.empty())
             {
@@ -64,6 +66,38 @@ namespace vcpkg::Commands::Upgrade
                 Checks::exit_success(VCPKG_LINE_INFO);
             }
 
+            // Only the changed ports and their reverse-dependency closure over the
+            // installed database can appear in the plan. Expand the closure from the
+            // status paragraphs -- no control files needed -- and batch-load exactly
+            // those, so planning never touches the other installed ports.
+            std::unordered_map<std::string, std::vector<std::string>> reverse_depends;
+            for (const StatusParagraph* pgh : get_installed_ports(status_db))
+            {
+                const auto deps =
+                    FeatureSpec::from_strings_and_triplet(pgh->package.depends, pgh->package.spec.triplet());
+                for (auto&& dep : deps)
+                {
+                    reverse_depends[dep.spec().name()].push_back(pgh->package.spec.name());
+                }
+            }
+
+            std::vector<std::string> to_visit = Util::fmap(
+                outdated_packages, [](const Update::OutdatedPackage& pkg) { return pkg.spec.name(); });
+            std::unordered_set<std::string> closure(to_visit.begin(), to_visit.end());
+            while (!to_visit.empty())
+            {
+                const std::string name = std::move(to_visit.back());
+                to_visit.pop_back();
+                const auto it_dependents = reverse_depends.find(name);
+                if (it_dependents == reverse_depends.end()) continue;
+                for (const std::string& dependent : it_dependents->second)
+                {
+                    if (closure.insert(dependent).second) to_visit.push_back(dependent);
+                }
+            }
+
+            provider.load_ports(std::vector<std::string>(closure.begin(), closure.end()));
+
             for (auto&& outdated_package : outdated_packages)
                 graph.upgrade(outdated_package.spec);
         }
@@ -74,10 +108,14 @@ namespace vcpkg::Commands::Upgrade
             std::vector<PackageSpec> to_upgrade;
             std::vector<PackageSpec> up_to_date;
 
-            for (auto&& spec : specs)
+            provider.load_ports(Util::fmap(specs, [](const PackageSpec& spec) { return spec.name(); }));
+
+            const std::vector<const StatusParagraph*> installed = status_db.find_all_installed(specs);
+            for (size_t i = 0; i < specs.size(); ++i)
             {
-                auto it = status_db.find_installed(spec);
-                if (it == status_db.end())
+                const PackageSpec& spec = specs[i];
+                const StatusParagraph* status_paragraph = installed[i];
+                if (status_paragraph == nullptr)
                 {
                     not_installed.push_back(spec);
                 }
@@ -85,9 +123,9 @@ namespace vcpkg::Commands::Upgrade
                 auto maybe_scf = provider.get_control_file(spec.name());
                 if (auto p_scf = maybe_scf.get())
                 {
-                    if (it != status_db.end())
+                    if (status_paragraph != nullptr)
                     {
-                        if (p_scf->core_paragraph->version != (*it)->package.version)
+                        if (p_scf->core_paragraph.version != status_paragraph->package.version)
                         {
                             to_upgrade.push_back(spec);
                         }
@@ -0,0 +1,163 @@
+#include "pch.h"
+
+#include <vcpkg/base/hash.h>
+#include <vcpkg/base/parallel.h>
+#include <vcpkg/base/system.h>
+#include <vcpkg/commands.h>
+#include <vcpkg/help.h>
+#include <vcpkg/vcpkglib.h>
+
+namespace vcpkg::Commands::Verify
+{
+    static const std::string OPTION_HASH = "--hash";
+
+    static const std::array<CommandSwitch, 1> VERIFY_SWITCHES = {{
+        {OPTION_HASH, "Also compare file contents (SHA256) against the staged package tree when it is present"},
+    }};
+
+    const CommandStructure COMMAND_STRUCTURE = {
+        Help::create_example_string("x-verify"),
+        0,
+        0,
+        {VERIFY_SWITCHES, {}},
+        nullptr,
+    };
+
+    struct PackageAudit
+    {
+        std::string displayname;
+        std::vector<std::string> divergences;
+    };
+
+    // Cross-checks one installed package's listfile against the filesystem. Existence
+    // is always checked; when the staged package tree (packages/<spec>) is still
+    // present it is the reference for sizes and, with --hash, contents.
+    static PackageAudit audit_package(const VcpkgPaths& paths, const StatusParagraph& pgh, const bool check_hashes)
+    {
+        auto& fs = paths.get_filesystem();
+        PackageAudit audit;
+        audit.displayname = pgh.package.displayname();
+
+        const auto maybe_lines = read_listfile(fs, paths.listfile_path(pgh.package));
+        const auto lines = maybe_lines.get();
+        if (!lines)
+        {
+            audit.divergences.push_back("listfile is missing or unreadable");
+            return audit;
+        }
+
+        const fs::path package_dir = paths.package_dir(pgh.package.spec);
+        const bool have_reference = fs.is_directory(package_dir);
+        const std::string triplet_prefix = pgh.package.spec.triplet().to_string() + "/";
+
+        for (const std::string& line : *lines)
+        {
+            std::string suffix = line;
+            if (!suffix.empty() && suffix.back() == '\r') suffix.pop_back();
+            if (suffix.empty()) continue;
+
+            const fs::path target = paths.installed / suffix;
+
+            std::error_code ec;
+            const auto status = fs.status(target, ec);
+            if (ec || !fs::stdfs::exists(status))
+            {
+                audit.divergences.push_back(Strings::format("missing: %s", suffix));
+                continue;
+            }
+            if (!fs::stdfs::is_regular_file(status)) continue;
+
+            if (!have_reference) continue;
+            // Listfile entries are "<triplet>/<path>"; the staged tree is rooted at
+            // the path below the triplet directory.
+            if (suffix.compare(0, triplet_prefix.size(), triplet_prefix) != 0) continue;
+            const fs::path reference = package_dir / suffix.substr(triplet_prefix.size());
+            if (!fs.is_regular_file(reference)) continue;
+
+            const auto installed_size = fs.file_size(target, ec);
+            if (ec) continue;
+            std::error_code reference_ec;
+            const auto reference_size = fs.file_size(reference, reference_ec);
+            if (reference_ec) continue;
+            if (installed_size != reference_size)
+            {
+                audit.divergences.push_back(
+                    Strings::format("size mismatch: %s (%llu, expected %llu)",
+                                    suffix,
+                                    static_cast<unsigned long long>(installed_size),
+                                    static_cast<unsigned long long>(reference_size)));
+                continue;
+            }
+
+            if (check_hashes)
+            {
+                const auto installed_hash = vcpkg::Hash::get_file_hash(fs, target, "SHA256");
+                const auto reference_hash = vcpkg::Hash::get_file_hash(fs, reference, "SHA256");
+                const auto h1 = installed_hash.get();
+                const auto h2 = reference_hash.get();
+                if (h1 && h2 && *h1 != *h2)
+                {
+                    audit.divergences.push_back(Strings::format("content mismatch: %s", suffix));
+                }
+            }
+        }
+
+        return audit;
+    }
+
+    void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths)
+    {
+        const ParsedArguments options = args.parse_arguments(COMMAND_STRUCTURE);
+        const bool check_hashes = Util::Sets::contains(options.switches, OPTION_HASH);
+
+        const StatusParagraphs status_db = database_load_check(paths);
+
+        // Only core paragraphs own a listfile; feature paragraphs install no files of
+        // their own.
+        std::vector<const StatusParagraph*> packages;
+        for (const std::unique_ptr<StatusParagraph>& pgh : status_db)
+        {
+            if (pgh->state != InstallState::INSTALLED || !pgh->package.feature.empty()) continue;
+            packages.push_back(pgh.get());
+        }
+
+        if (packages.empty())
+        {
+            System::println("No packages are installed.");
+            Checks::exit_success(VCPKG_LINE_INFO);
+        }
+
+        // Each package audits independently (its own listfile, its own files), so the
+        // work fans out across the pool with per-index result slots and no locking.
+        std::vector<PackageAudit> audits(packages.size());
+        Parallel::for_each_index(packages.size(),
+                                 [&](const size_t i) { audits[i] = audit_package(paths, *packages[i], check_hashes); });
+
+        size_t broken_packages = 0;
+        size_t total_divergences = 0;
+        for (const PackageAudit& audit : audits)
+        {
+            if (audit.divergences.empty()) continue;
+            ++broken_packages;
+            total_divergences += audit.divergences.size();
+            System::println(System::Color::error, "%s:", audit.displayname);
+            for (const std::string& divergence : audit.divergences)
+            {
+                System::println("    %s", divergence);
+            }
+        }
+
+        if (broken_packages == 0)
+        {
+            System::println(System::Color::success, "Verified %zd packages; no divergences found.", packages.size());
+            Checks::exit_success(VCPKG_LINE_INFO);
+        }
+
+        System::println(System::Color::error,
+                        "Verified %zd packages; %zd divergences across %zd packages.",
+                        packages.size(),
+                        total_divergences,
+                        broken_packages);
+        Checks::exit_fail(VCPKG_LINE_INFO);
+    }
+}
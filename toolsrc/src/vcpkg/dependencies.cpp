@@ -1,8 +1,13 @@
 #include "pch.h"
 
+#include <vcpkg/base/allocstats.h>
+#include <vcpkg/base/arena.h>
 #include <vcpkg/base/files.h>
+#include <vcpkg/base/parallel.h>
+#include <vcpkg/base/sortedvector.h>
 #include <vcpkg/base/graphs.h>
 #include <vcpkg/base/strings.h>
+#include <vcpkg/base/timing.h>
 #include <vcpkg/base/util.h>
 #include <vcpkg/dependencies.h>
 #include <vcpkg/packagespec.h>
@@ -11,6 +16,8 @@
 #include <vcpkg/vcpkglib.h>
 #include <vcpkg/vcpkgpaths.h>
 
+#include <deque>
+
 namespace vcpkg::Dependencies
 {
     struct FeatureNodeEdges
@@ -25,9 +32,9 @@ namespace vcpkg::Dependencies
         std::vector<StatusParagraph*> status_paragraphs;
         Optional<const SourceControlFile*> source_control_file;
         PackageSpec spec;
-        std::unordered_map<std::string, FeatureNodeEdges> edges;
-        std::unordered_set<std::string> to_install_features;
-        std::unordered_set<std::string> original_features;
+        FlatMap<std::string, FeatureNodeEdges> edges;
+        FlatSet<std::string> to_install_features;
+        FlatSet<std::string> original_features;
         bool will_remove = false;
         bool transient_uninstalled = true;
         RequestType request_type = RequestType::AUTO_SELECTED;
@@ -65,21 +72,41 @@ namespace vcpkg::Dependencies
 
     struct ClusterGraph : Util::MoveOnlyBase
     {
-        explicit ClusterGraph(const PortFileProvider& provider) : m_provider(provider) {}
+        ClusterGraph(const PortFileProvider& provider, const StatusParagraphs& status_db)
+            : m_cluster_indices(m_arena), m_installed(m_arena), m_installed_dependents(m_arena), m_provider(provider)
+        {
+            // Index the status database up front -- this is cheap -- but defer all cluster
+            // construction (and thereby all CONTROL loading) to get(), so a plan only pays
+            // for the clusters it actually reaches instead of every installed port.
+            for (auto&& status_paragraph : get_installed_ports(status_db))
+            {
+                m_installed[status_paragraph->package.spec].push_back(status_paragraph);
+
+                auto deps = FeatureSpec::from_strings_and_triplet(status_paragraph->package.depends,
+                                                                  status_paragraph->package.spec.triplet());
+                for (auto&& dependency : deps)
+                {
+                    m_installed_dependents[dependency.spec()].emplace_back(dependency.feature(), status_paragraph);
+                }
+            }
+        }
 
         Cluster& get(const PackageSpec& spec)
         {
-            auto it = m_graph.find(spec);
-            if (it == m_graph.end())
+            auto it = m_cluster_indices.find(spec);
+            if (it == m_cluster_indices.end())
             {
                 // Load on-demand from m_provider
                 auto maybe_scf = m_provider.get_control_file(spec.name());
-                auto& clust = m_graph[spec];
+                m_cluster_indices.emplace(spec, m_clusters.size());
+                m_clusters.emplace_back();
+                auto& clust = m_clusters.back();
                 clust.spec = spec;
                 if (auto p_scf = maybe_scf.get()) cluster_from_scf(*p_scf, clust);
+                apply_installed_state(clust);
                 return clust;
             }
-            return it->second;
+            return m_clusters[it->second];
         }
 
     private:
@@ -87,40 +114,106 @@ namespace vcpkg::Dependencies
         {
             FeatureNodeEdges core_dependencies;
             core_dependencies.build_edges =
-                filter_dependencies_to_specs(scf.core_paragraph->depends, out_cluster.spec.triplet());
+                filter_dependencies_to_specs(scf.core_paragraph.depends, out_cluster.spec.triplet());
             out_cluster.edges.emplace("core", std::move(core_dependencies));
 
             for (const auto& feature : scf.feature_paragraphs)
             {
                 FeatureNodeEdges added_edges;
-                added_edges.build_edges = filter_dependencies_to_specs(feature->depends, out_cluster.spec.triplet());
-                out_cluster.edges.emplace(feature->name, std::move(added_edges));
+                added_edges.build_edges = filter_dependencies_to_specs(feature.depends, out_cluster.spec.triplet());
+                out_cluster.edges.emplace(feature.name, std::move(added_edges));
             }
             out_cluster.source_control_file = &scf;
         }
 
-        std::unordered_map<PackageSpec, Cluster> m_graph;
+        void apply_installed_state(Cluster& cluster) const
+        {
+            const auto it_installed = m_installed.find(cluster.spec);
+            if (it_installed != m_installed.end())
+            {
+                cluster.transient_uninstalled = false;
+                for (StatusParagraph* status_paragraph : it_installed->second)
+                {
+                    cluster.status_paragraphs.emplace_back(status_paragraph);
+
+                    auto& status_paragraph_feature = status_paragraph->package.feature;
+                    // In this case, empty string indicates the "core" paragraph for a package.
+                    cluster.original_features.insert(status_paragraph_feature.empty() ? "core"
+                                                                                      : status_paragraph_feature);
+                }
+            }
+
+            // Populate the cluster with "remove edges", which are the reverse of the
+            // Build-Depends edges of the installed packages that depend on it.
+            const auto it_dependents = m_installed_dependents.find(cluster.spec);
+            if (it_dependents != m_installed_dependents.end())
+            {
+                for (auto&& dependent : it_dependents->second)
+                {
+                    auto depends_name = dependent.first;
+                    if (depends_name.empty()) depends_name = "core";
+
+                    auto& package = dependent.second->package;
+                    cluster.edges[depends_name].remove_edges.emplace_back(FeatureSpec{package.spec, package.feature});
+                }
+            }
+        }
+
+        template<class V>
+        using SpecMap = std::unordered_map<PackageSpec,
+                                           V,
+                                           std::hash<PackageSpec>,
+                                           std::equal_to<PackageSpec>,
+                                           ArenaAllocator<std::pair<const PackageSpec, V>>>;
+
+        // Clusters live in a chunk-allocated arena keyed by a spec index table instead of
+        // being scattered across map nodes. A deque rather than a vector because
+        // ClusterPtr (and the remove/install graphs) hold raw Cluster pointers that must
+        // survive later insertions.
+        std::deque<Cluster> m_clusters;
+        // The index maps draw their nodes from the arena: they are built once, queried
+        // for the rest of planning, and die with the graph, so nothing is ever returned
+        // to the heap. Their mapped vectors keep the default allocator -- threading the
+        // arena through every nested container is not worth the ergonomics.
+        Arena m_arena;
+        SpecMap<size_t> m_cluster_indices;
+        SpecMap<std::vector<StatusParagraph*>> m_installed;
+        SpecMap<std::vector<std::pair<std::string, StatusParagraph*>>> m_installed_dependents;
         const PortFileProvider& m_provider;
     };
 
+    const BinaryControlFile& AnyParagraph::binary_control_file_or_exit(const LineInfo& line_info) const
+    {
+        Checks::check_exit(line_info, this->binary_control_file != nullptr);
+        return *this->binary_control_file;
+    }
+
+    const SourceControlFile& AnyParagraph::source_control_file_or_exit(const LineInfo& line_info) const
+    {
+        Checks::check_exit(line_info, this->source_control_file != nullptr);
+        return *this->source_control_file;
+    }
+
     std::vector<PackageSpec> AnyParagraph::dependencies(const Triplet& triplet) const
     {
-        if (const auto p = this->status_paragraph.get())
+        if (const auto p = this->status_paragraph)
         {
             return PackageSpec::from_dependencies_of_port(p->package.spec.name(), p->package.depends, triplet);
         }
 
         if (const auto p = this->binary_control_file.get())
         {
-            auto deps = Util::fmap_flatten(p->features, [](const BinaryParagraph& pgh) { return pgh.depends; });
+            const auto feature_depends = Util::flatten(Util::transform(
+                p->features, [](const BinaryParagraph& pgh) -> const std::vector<std::string>& { return pgh.depends; }));
+            auto deps = Util::to_vector(feature_depends);
             deps.insert(deps.end(), p->core_paragraph.depends.cbegin(), p->core_paragraph.depends.cend());
             return PackageSpec::from_dependencies_of_port(p->core_paragraph.spec.name(), deps, triplet);
         }
 
-        if (const auto p = this->source_control_file.value_or(nullptr))
+        if (const auto p = this->source_control_file)
         {
             return PackageSpec::from_dependencies_of_port(
-                p->core_paragraph->name, filter_dependencies(p->core_paragraph->depends, triplet), triplet);
+                p->core_paragraph.name, filter_dependencies(p->core_paragraph.depends, triplet), triplet);
         }
 
         Checks::exit_with_message(VCPKG_LINE_INFO,
@@ -155,38 +248,47 @@ namespace vcpkg::Dependencies
 
     InstallPlanAction::InstallPlanAction(const PackageSpec& spec,
                                          const SourceControlFile& any_paragraph,
-                                         const std::unordered_set<std::string>& features,
+                                         const FlatSet<std::string>& features,
                                          const RequestType& request_type)
-        : spec(spec), plan_type(InstallPlanType::BUILD_AND_INSTALL), request_type(request_type), feature_list(features)
+        : spec(spec)
+        , plan_type(InstallPlanType::BUILD_AND_INSTALL)
+        , request_type(request_type)
+        , feature_list(features.begin(), features.end())
     {
         this->any_paragraph.source_control_file = &any_paragraph;
     }
 
     InstallPlanAction::InstallPlanAction(const PackageSpec& spec,
-                                         const std::unordered_set<std::string>& features,
+                                         const FlatSet<std::string>& features,
                                          const RequestType& request_type)
-        : spec(spec), plan_type(InstallPlanType::ALREADY_INSTALLED), request_type(request_type), feature_list(features)
+        : spec(spec)
+        , plan_type(InstallPlanType::ALREADY_INSTALLED)
+        , request_type(request_type)
+        , feature_list(features.begin(), features.end())
     {
     }
 
     InstallPlanAction::InstallPlanAction(const PackageSpec& spec,
-                                         const AnyParagraph& any_paragraph,
+                                         AnyParagraph&& any_paragraph,
                                          const RequestType& request_type)
-        : spec(spec), any_paragraph(any_paragraph), plan_type(InstallPlanType::UNKNOWN), request_type(request_type)
+        : spec(spec)
+        , any_paragraph(std::move(any_paragraph))
+        , plan_type(InstallPlanType::UNKNOWN)
+        , request_type(request_type)
     {
-        if (auto p = any_paragraph.status_paragraph.get())
+        if (this->any_paragraph.status_paragraph)
         {
             this->plan_type = InstallPlanType::ALREADY_INSTALLED;
             return;
         }
 
-        if (auto p = any_paragraph.binary_control_file.get())
+        if (this->any_paragraph.binary_control_file)
         {
             this->plan_type = InstallPlanType::INSTALL;
             return;
         }
 
-        if (auto p = any_paragraph.source_control_file.get())
+        if (this->any_paragraph.source_control_file)
         {
             this->plan_type = InstallPlanType::BUILD_AND_INSTALL;
             return;
@@ -243,17 +345,20 @@ namespace vcpkg::Dependencies
     ExportPlanAction::ExportPlanAction() : plan_type(ExportPlanType::UNKNOWN), request_type(RequestType::UNKNOWN) {}
 
     ExportPlanAction::ExportPlanAction(const PackageSpec& spec,
-                                       const AnyParagraph& any_paragraph,
+                                       AnyParagraph&& any_paragraph,
                                        const RequestType& request_type)
-        : spec(spec), any_paragraph(any_paragraph), plan_type(ExportPlanType::UNKNOWN), request_type(request_type)
+        : spec(spec)
+        , any_paragraph(std::move(any_paragraph))
+        , plan_type(ExportPlanType::UNKNOWN)
+        , request_type(request_type)
     {
-        if (auto p = any_paragraph.binary_control_file.get())
+        if (this->any_paragraph.binary_control_file)
         {
             this->plan_type = ExportPlanType::ALREADY_BUILT;
             return;
         }
 
-        if (auto p = any_paragraph.source_control_file.get())
+        if (this->any_paragraph.source_control_file)
         {
             this->plan_type = ExportPlanType::PORT_AVAILABLE_BUT_NOT_BUILT;
             return;
@@ -276,7 +381,41 @@ namespace vcpkg::Dependencies
         return scf->second;
     }
 
-    PathsPortFileProvider::PathsPortFileProvider(const VcpkgPaths& paths) : ports(paths) {}
+    PathsPortFileProvider::PathsPortFileProvider(const VcpkgPaths& paths,
+                                                 const std::vector<std::string>& overlay_ports)
+        : ports(paths)
+    {
+        for (const std::string& overlay : overlay_ports)
+        {
+            overlay_roots.push_back(fs::stdfs::absolute(fs::u8path(overlay)));
+        }
+
+        // Environment-provided overlays rank below the command line's, mirroring how
+        // VCPKG_DEFAULT_TRIPLET yields to --triplet.
+        const auto env_overlays = System::get_environment_variable("VCPKG_OVERLAY_PORTS");
+        if (const auto unpacked = env_overlays.get())
+        {
+#if defined(_WIN32)
+            static constexpr const char* SEPARATOR = ";";
+#else
+            static constexpr const char* SEPARATOR = ":";
+#endif
+            for (const std::string& overlay : Strings::split(*unpacked, SEPARATOR))
+            {
+                overlay_roots.push_back(fs::stdfs::absolute(fs::u8path(overlay)));
+            }
+        }
+    }
+
+    fs::path PathsPortFileProvider::port_directory(const std::string& src_name) const
+    {
+        for (const fs::path& root : overlay_roots)
+        {
+            const fs::path candidate = root / src_name;
+            if (ports.get_filesystem().exists(candidate / "CONTROL")) return candidate;
+        }
+        return ports.port_dir(src_name);
+    }
 
     Optional<const SourceControlFile&> PathsPortFileProvider::get_control_file(const std::string& spec) const
     {
@@ -286,7 +425,7 @@ namespace vcpkg::Dependencies
             return cache_it->second;
         }
         Parse::ParseExpected<SourceControlFile> source_control_file =
-            Paragraphs::try_load_port(ports.get_filesystem(), ports.port_dir(spec));
+            Paragraphs::try_load_port(ports.get_filesystem(), port_directory(spec));
 
         if (auto scf = source_control_file.get())
         {
@@ -296,6 +435,42 @@ namespace vcpkg::Dependencies
         return nullopt;
     }
 
+    void PathsPortFileProvider::load_ports(Span<const std::string> port_names) const
+    {
+        std::vector<std::string> to_load;
+        for (const std::string& name : port_names)
+        {
+            if (cache.find(name) == cache.end()) to_load.push_back(name);
+        }
+        Util::sort(to_load);
+        to_load.erase(std::unique(to_load.begin(), to_load.end()), to_load.end());
+        if (to_load.empty()) return;
+
+        // Workers only parse; ports that fail to parse are left out of the cache, so a
+        // later get_control_file() reports them the usual way. Results are merged into
+        // the cache on this thread after the join.
+        using LoadedPort = std::pair<std::string, SourceControlFile>;
+
+        const size_t worker_count = Parallel::worker_count_for(to_load.size());
+        std::vector<std::vector<LoadedPort>> loaded_per_worker(worker_count);
+
+        Parallel::for_each_index_with_worker(worker_count, to_load.size(), [&](const size_t i, const size_t worker) {
+            auto maybe_scf = Paragraphs::try_load_port(ports.get_filesystem(), port_directory(to_load[i]));
+            if (auto scf = maybe_scf.get())
+            {
+                loaded_per_worker[worker].emplace_back(to_load[i], std::move(**scf));
+            }
+        });
+
+        for (std::vector<LoadedPort>& loaded : loaded_per_worker)
+        {
+            for (LoadedPort& port : loaded)
+            {
+                cache.emplace(std::move(port.first), std::move(port.second));
+            }
+        }
+    }
+
     std::vector<InstallPlanAction> create_install_plan(const PortFileProvider& port_file_provider,
                                                        const std::vector<PackageSpec>& specs,
                                                        const StatusParagraphs& status_db)
@@ -326,16 +501,18 @@ namespace vcpkg::Dependencies
     std::vector<RemovePlanAction> create_remove_plan(const std::vector<PackageSpec>& specs,
                                                      const StatusParagraphs& status_db)
     {
+        Timing::PhaseScope timing_scope("create remove plan");
+
         struct RemoveAdjacencyProvider final : Graphs::AdjacencyProvider<PackageSpec, RemovePlanAction>
         {
-            const StatusParagraphs& status_db;
-            const std::vector<StatusParagraph*>& installed_ports;
+            const std::unordered_map<size_t, std::vector<PackageSpec>>& reverse_deps;
+            const std::unordered_set<PackageSpec>& installed_specs;
             const std::unordered_set<PackageSpec>& specs_as_set;
 
-            RemoveAdjacencyProvider(const StatusParagraphs& status_db,
-                                    const std::vector<StatusParagraph*>& installed_ports,
+            RemoveAdjacencyProvider(const std::unordered_map<size_t, std::vector<PackageSpec>>& reverse_deps,
+                                    const std::unordered_set<PackageSpec>& installed_specs,
                                     const std::unordered_set<PackageSpec>& specs_as_set)
-                : status_db(status_db), installed_ports(installed_ports), specs_as_set(specs_as_set)
+                : reverse_deps(reverse_deps), installed_specs(installed_specs), specs_as_set(specs_as_set)
             {
             }
 
@@ -347,18 +524,12 @@ namespace vcpkg::Dependencies
                 }
 
                 const PackageSpec& spec = plan.spec;
-                std::vector<PackageSpec> dependents;
-                for (const StatusParagraph* an_installed_package : installed_ports)
+                const auto it = reverse_deps.find(PackageSpec::intern_id(spec.name(), spec.triplet()));
+                if (it == reverse_deps.end())
                 {
-                    if (an_installed_package->package.spec.triplet() != spec.triplet()) continue;
-
-                    const std::vector<std::string>& deps = an_installed_package->package.depends;
-                    if (std::find(deps.begin(), deps.end(), spec.name()) == deps.end()) continue;
-
-                    dependents.push_back(an_installed_package->package.spec);
+                    return {};
                 }
-
-                return dependents;
+                return it->second;
             }
 
             RemovePlanAction load_vertex_data(const PackageSpec& spec) const override
@@ -366,8 +537,7 @@ namespace vcpkg::Dependencies
                 const RequestType request_type = specs_as_set.find(spec) != specs_as_set.end()
                                                      ? RequestType::USER_REQUESTED
                                                      : RequestType::AUTO_SELECTED;
-                const StatusParagraphs::const_iterator it = status_db.find_installed(spec);
-                if (it == status_db.end())
+                if (installed_specs.find(spec) == installed_specs.end())
                 {
                     return RemovePlanAction{spec, RemovePlanType::NOT_INSTALLED, request_type};
                 }
@@ -378,8 +548,31 @@ namespace vcpkg::Dependencies
         };
 
         const std::vector<StatusParagraph*>& installed_ports = get_installed_ports(status_db);
+
+        // One pass over the status database builds everything the graph walk needs:
+        // get_installed_ports applies the same state/want filter as find_installed, so
+        // the spec set answers every installed-or-not query (only core paragraphs count;
+        // feature paragraphs share the spec), and the reverse-dependency rows keyed by
+        // interned name:triplet id make finding the dependents of a package O(dependents)
+        // instead of a scan over every installed paragraph's dependency list.
+        std::unordered_set<PackageSpec> installed_specs;
+        std::unordered_map<size_t, std::vector<PackageSpec>> reverse_deps;
+        for (const StatusParagraph* an_installed_package : installed_ports)
+        {
+            if (an_installed_package->package.feature.empty())
+            {
+                installed_specs.insert(an_installed_package->package.spec);
+            }
+
+            const Triplet& triplet = an_installed_package->package.spec.triplet();
+            for (const std::string& dep : an_installed_package->package.depends)
+            {
+                reverse_deps[PackageSpec::intern_id(dep, triplet)].push_back(an_installed_package->package.spec);
+            }
+        }
+
         const std::unordered_set<PackageSpec> specs_as_set(specs.cbegin(), specs.cend());
-        return Graphs::topological_sort(specs, RemoveAdjacencyProvider{status_db, installed_ports, specs_as_set});
+        return Graphs::topological_sort(specs, RemoveAdjacencyProvider{reverse_deps, installed_specs, specs_as_set});
     }
 
     std::vector<ExportPlanAction> create_export_plan(const PortFileProvider& port_file_provider,
@@ -414,11 +607,19 @@ namespace vcpkg::Dependencies
                                                      : RequestType::AUTO_SELECTED;
 
                 Expected<BinaryControlFile> maybe_bpgh = Paragraphs::try_load_cached_control_package(paths, spec);
+                AnyParagraph any_paragraph;
                 if (auto bcf = maybe_bpgh.get())
-                    return ExportPlanAction{spec, AnyParagraph{nullopt, std::move(*bcf), nullopt}, request_type};
+                {
+                    any_paragraph.binary_control_file = std::make_unique<BinaryControlFile>(std::move(*bcf));
+                    return ExportPlanAction{spec, std::move(any_paragraph), request_type};
+                }
 
                 auto maybe_scf = provider.get_control_file(spec.name());
-                if (auto scf = maybe_scf.get()) return ExportPlanAction{spec, {nullopt, nullopt, scf}, request_type};
+                if (auto scf = maybe_scf.get())
+                {
+                    any_paragraph.source_control_file = scf;
+                    return ExportPlanAction{spec, std::move(any_paragraph), request_type};
+                }
 
                 Checks::exit_with_message(VCPKG_LINE_INFO, "Could not find package %s", spec);
             }
@@ -539,6 +740,9 @@ namespace vcpkg::Dependencies
                                                        const std::vector<FeatureSpec>& specs,
                                                        const StatusParagraphs& status_db)
     {
+        Timing::PhaseScope timing_scope("create install plan");
+        const AllocStats::TagScope alloc_scope("planner");
+
         PackageGraph pgraph(provider, status_db);
         for (auto&& spec : specs)
             pgraph.install(spec);
@@ -564,7 +768,7 @@ namespace vcpkg::Dependencies
             {
                 for (auto&& feature : p_scf->feature_paragraphs)
                 {
-                    auto res = mark_plus(feature->name, spec_cluster, *m_graph, *m_graph_plan);
+                    auto res = mark_plus(feature.name, spec_cluster, *m_graph, *m_graph_plan);
 
                     Checks::check_exit(
                         VCPKG_LINE_INFO, res == MarkPlusResult::SUCCESS, "Error: Unable to locate feature %s", spec);
@@ -602,18 +806,21 @@ namespace vcpkg::Dependencies
 
     std::vector<AnyAction> PackageGraph::serialize() const
     {
+        Graphs::SortScratch<ClusterPtr> sort_scratch;
         auto remove_vertex_list = m_graph_plan->remove_graph.vertex_list();
-        auto remove_toposort = Graphs::topological_sort(remove_vertex_list, m_graph_plan->remove_graph);
+        auto remove_toposort =
+            Graphs::topological_sort(remove_vertex_list, m_graph_plan->remove_graph, sort_scratch);
 
         auto insert_vertex_list = m_graph_plan->install_graph.vertex_list();
-        auto insert_toposort = Graphs::topological_sort(insert_vertex_list, m_graph_plan->install_graph);
+        auto insert_toposort =
+            Graphs::topological_sort(insert_vertex_list, m_graph_plan->install_graph, sort_scratch);
 
         std::vector<AnyAction> plan;
 
         for (auto&& p_cluster : remove_toposort)
         {
             auto scf = *p_cluster->source_control_file.get();
-            auto spec = PackageSpec::from_name_and_triplet(scf->core_paragraph->name, p_cluster->spec.triplet())
+            auto spec = PackageSpec::from_name_and_triplet(scf->core_paragraph.name, p_cluster->spec.triplet())
                             .value_or_exit(VCPKG_LINE_INFO);
             plan.emplace_back(RemovePlanAction{
                 std::move(spec),
@@ -651,57 +858,8 @@ namespace vcpkg::Dependencies
         return plan;
     }
 
-    static std::unique_ptr<ClusterGraph> create_feature_install_graph(const PortFileProvider& map,
-                                                                      const StatusParagraphs& status_db)
-    {
-        std::unique_ptr<ClusterGraph> graph = std::make_unique<ClusterGraph>(map);
-
-        auto installed_ports = get_installed_ports(status_db);
-
-        for (auto&& status_paragraph : installed_ports)
-        {
-            Cluster& cluster = graph->get(status_paragraph->package.spec);
-
-            cluster.transient_uninstalled = false;
-
-            cluster.status_paragraphs.emplace_back(status_paragraph);
-
-            auto& status_paragraph_feature = status_paragraph->package.feature;
-            // In this case, empty string indicates the "core" paragraph for a package.
-            if (status_paragraph_feature.empty())
-            {
-                cluster.original_features.insert("core");
-            }
-            else
-            {
-                cluster.original_features.insert(status_paragraph_feature);
-            }
-        }
-
-        // Populate the graph with "remove edges", which are the reverse of the Build-Depends edges.
-        for (auto&& status_paragraph : installed_ports)
-        {
-            auto& spec = status_paragraph->package.spec;
-            auto& status_paragraph_feature = status_paragraph->package.feature;
-            auto reverse_edges = FeatureSpec::from_strings_and_triplet(status_paragraph->package.depends,
-                                                                       status_paragraph->package.spec.triplet());
-
-            for (auto&& dependency : reverse_edges)
-            {
-                auto& dep_cluster = graph->get(dependency.spec());
-
-                auto depends_name = dependency.feature();
-                if (depends_name.empty()) depends_name = "core";
-
-                auto& target_node = dep_cluster.edges[depends_name];
-                target_node.remove_edges.emplace_back(FeatureSpec{spec, status_paragraph_feature});
-            }
-        }
-        return graph;
-    }
-
     PackageGraph::PackageGraph(const PortFileProvider& provider, const StatusParagraphs& status_db)
-        : m_graph(create_feature_install_graph(provider, status_db)), m_graph_plan(std::make_unique<GraphPlan>())
+        : m_graph(std::make_unique<ClusterGraph>(provider, status_db)), m_graph_plan(std::make_unique<GraphPlan>())
     {
     }
 
@@ -763,42 +921,32 @@ namespace vcpkg::Dependencies
         std::sort(already_installed_plans.begin(), already_installed_plans.end(), &InstallPlanAction::compare_by_name);
         std::sort(excluded.begin(), excluded.end(), &InstallPlanAction::compare_by_name);
 
-        static auto actions_to_output_string = [](const std::vector<const InstallPlanAction*>& v) {
-            return Strings::join("\n", v, [](const InstallPlanAction* p) {
-                return to_output_string(p->request_type, p->displayname(), p->build_options);
-            });
-        };
-
-        if (excluded.size() > 0)
-        {
-            System::println("The following packages are excluded:\n%s", actions_to_output_string(excluded));
-        }
-
-        if (already_installed_plans.size() > 0)
-        {
-            System::println("The following packages are already installed:\n%s",
-                            actions_to_output_string(already_installed_plans));
-        }
-
-        if (rebuilt_plans.size() > 0)
-        {
-            System::println("The following packages will be rebuilt:\n%s", actions_to_output_string(rebuilt_plans));
-        }
-
-        if (new_plans.size() > 0)
-        {
-            System::println("The following packages will be built and installed:\n%s",
-                            actions_to_output_string(new_plans));
-        }
+        // The whole plan is rendered into one buffer and emitted with a single write,
+        // so large plans display atomically instead of interleaving with other output
+        // line by line.
+        std::string out;
+        static auto append_actions =
+            [](std::string& out, const char* header, const std::vector<const InstallPlanAction*>& v) {
+                if (v.empty()) return;
+                out.append(header);
+                out.push_back('\n');
+                for (const InstallPlanAction* p : v)
+                {
+                    out.append(to_output_string(p->request_type, p->displayname(), p->build_options));
+                    out.push_back('\n');
+                }
+            };
 
-        if (only_install_plans.size() > 0)
-        {
-            System::println("The following packages will be directly installed:\n%s",
-                            actions_to_output_string(only_install_plans));
-        }
+        append_actions(out, "The following packages are excluded:", excluded);
+        append_actions(out, "The following packages are already installed:", already_installed_plans);
+        append_actions(out, "The following packages will be rebuilt:", rebuilt_plans);
+        append_actions(out, "The following packages will be built and installed:", new_plans);
+        append_actions(out, "The following packages will be directly installed:", only_install_plans);
 
         if (has_non_user_requested_packages)
-            System::println("Additional packages (*) will be modified to complete this operation.");
+            out.append("Additional packages (*) will be modified to complete this operation.\n");
+
+        if (!out.empty()) System::print(out);
 
         if (remove_plans.size() > 0 && !is_recursive)
         {
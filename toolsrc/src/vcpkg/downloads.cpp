@@ -0,0 +1,840 @@
+#include "pch.h"
+
+#include <vcpkg/base/chrono.h>
+#include <vcpkg/base/hash.h>
+#include <vcpkg/base/parallel.h>
+#include <vcpkg/base/strings.h>
+#include <vcpkg/base/util.h>
+#include <vcpkg/base/system.h>
+#include <vcpkg/downloads.h>
+
+#include <fstream>
+
+namespace vcpkg::Downloads
+{
+    // Ranges smaller than this are not worth a separate connection.
+    static const uint64_t MIN_CHUNK_SIZE = 8 * 1024 * 1024;
+
+    struct ProbeResult
+    {
+        Optional<uint64_t> content_length;
+        bool accept_ranges = false;
+    };
+
+#if defined(_WIN32)
+    struct CrackedUrl
+    {
+        std::wstring host;
+        std::wstring path;
+        INTERNET_PORT port;
+        bool https;
+    };
+
+    static Optional<CrackedUrl> crack_url(const std::string& url)
+    {
+        const std::wstring wide_url = Strings::to_utf16(url);
+
+        URL_COMPONENTSW components;
+        memset(&components, 0, sizeof(components));
+        components.dwStructSize = sizeof(components);
+        components.dwHostNameLength = static_cast<DWORD>(-1);
+        components.dwUrlPathLength = static_cast<DWORD>(-1);
+        components.dwExtraInfoLength = static_cast<DWORD>(-1);
+
+        if (!WinHttpCrackUrl(wide_url.c_str(), static_cast<DWORD>(wide_url.size()), 0, &components)) return nullopt;
+        if (components.nScheme != INTERNET_SCHEME_HTTP && components.nScheme != INTERNET_SCHEME_HTTPS) return nullopt;
+
+        CrackedUrl cracked;
+        cracked.host.assign(components.lpszHostName, components.dwHostNameLength);
+        cracked.path.assign(components.lpszUrlPath, components.dwUrlPathLength);
+        if (components.dwExtraInfoLength != 0)
+            cracked.path.append(components.lpszExtraInfo, components.dwExtraInfoLength);
+        cracked.port = components.nPort;
+        cracked.https = components.nScheme == INTERNET_SCHEME_HTTPS;
+        return cracked;
+    }
+
+    struct WinHttpHandle
+    {
+        HINTERNET h = nullptr;
+        ~WinHttpHandle()
+        {
+            if (h) WinHttpCloseHandle(h);
+        }
+    };
+
+    // Issues one request (optionally with a Range header) and appends the body to
+    // `part_path`, feeding `hasher` (when given) with the bytes as they stream to
+    // disk. Returns false on any transport or HTTP error.
+    static bool fetch_to_file(const CrackedUrl& url,
+                              const Optional<std::pair<uint64_t, uint64_t>>& range,
+                              const fs::path& part_path,
+                              Hash::StreamingHasher* const hasher)
+    {
+        WinHttpHandle session, connect, request;
+        session.h = WinHttpOpen(
+            L"vcpkg/1.0", WINHTTP_ACCESS_TYPE_DEFAULT_PROXY, WINHTTP_NO_PROXY_NAME, WINHTTP_NO_PROXY_BYPASS, 0);
+        if (!session.h) return false;
+        connect.h = WinHttpConnect(session.h, url.host.c_str(), url.port, 0);
+        if (!connect.h) return false;
+        request.h = WinHttpOpenRequest(connect.h,
+                                       L"GET",
+                                       url.path.c_str(),
+                                       nullptr,
+                                       WINHTTP_NO_REFERER,
+                                       WINHTTP_DEFAULT_ACCEPT_TYPES,
+                                       url.https ? WINHTTP_FLAG_SECURE : 0);
+        if (!request.h) return false;
+
+        std::wstring headers;
+        if (const auto r = range.get())
+        {
+            headers = Strings::to_utf16(
+                Strings::format("Range: bytes=%s-%s\r\n", std::to_string(r->first), std::to_string(r->second)));
+        }
+
+        if (!WinHttpSendRequest(request.h,
+                                headers.empty() ? WINHTTP_NO_ADDITIONAL_HEADERS : headers.c_str(),
+                                static_cast<DWORD>(headers.size()),
+                                WINHTTP_NO_REQUEST_DATA,
+                                0,
+                                0,
+                                0))
+            return false;
+        if (!WinHttpReceiveResponse(request.h, nullptr)) return false;
+
+        DWORD http_code = 0, junk = sizeof(DWORD);
+        if (!WinHttpQueryHeaders(request.h,
+                                 WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER,
+                                 nullptr,
+                                 &http_code,
+                                 &junk,
+                                 WINHTTP_NO_HEADER_INDEX))
+            return false;
+        if (http_code != 200 && http_code != 206) return false;
+
+        std::ofstream out(part_path.native(), std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+
+        std::vector<char> buffer(256 * 1024);
+        for (;;)
+        {
+            DWORD read = 0;
+            if (!WinHttpReadData(request.h, buffer.data(), static_cast<DWORD>(buffer.size()), &read)) return false;
+            if (read == 0) break;
+            if (hasher) hasher->update(buffer.data(), read);
+            out.write(buffer.data(), read);
+            if (!out) return false;
+        }
+        return true;
+    }
+
+    static Optional<ProbeResult> probe(const CrackedUrl& url)
+    {
+        WinHttpHandle session, connect, request;
+        session.h = WinHttpOpen(
+            L"vcpkg/1.0", WINHTTP_ACCESS_TYPE_DEFAULT_PROXY, WINHTTP_NO_PROXY_NAME, WINHTTP_NO_PROXY_BYPASS, 0);
+        if (!session.h) return nullopt;
+        connect.h = WinHttpConnect(session.h, url.host.c_str(), url.port, 0);
+        if (!connect.h) return nullopt;
+        request.h = WinHttpOpenRequest(connect.h,
+                                       L"HEAD",
+                                       url.path.c_str(),
+                                       nullptr,
+                                       WINHTTP_NO_REFERER,
+                                       WINHTTP_DEFAULT_ACCEPT_TYPES,
+                                       url.https ? WINHTTP_FLAG_SECURE : 0);
+        if (!request.h) return nullopt;
+        if (!WinHttpSendRequest(request.h, WINHTTP_NO_ADDITIONAL_HEADERS, 0, WINHTTP_NO_REQUEST_DATA, 0, 0, 0))
+            return nullopt;
+        if (!WinHttpReceiveResponse(request.h, nullptr)) return nullopt;
+
+        ProbeResult result;
+
+        wchar_t buffer[64];
+        DWORD buffer_size = sizeof(buffer);
+        if (WinHttpQueryHeaders(request.h,
+                                WINHTTP_QUERY_CONTENT_LENGTH,
+                                WINHTTP_HEADER_NAME_BY_INDEX,
+                                buffer,
+                                &buffer_size,
+                                WINHTTP_NO_HEADER_INDEX))
+        {
+            result.content_length = static_cast<uint64_t>(_wtoi64(buffer));
+        }
+
+        buffer_size = sizeof(buffer);
+        if (WinHttpQueryHeaders(request.h,
+                                WINHTTP_QUERY_ACCEPT_RANGES,
+                                WINHTTP_HEADER_NAME_BY_INDEX,
+                                buffer,
+                                &buffer_size,
+                                WINHTTP_NO_HEADER_INDEX))
+        {
+            result.accept_ranges = Strings::case_insensitive_ascii_equals(Strings::to_utf8(buffer), "bytes");
+        }
+
+        return result;
+    }
+
+    static bool upload_file_impl(const CrackedUrl& url, const fs::path& file)
+    {
+        std::ifstream in(file.native(), std::ios::binary);
+        if (!in) return false;
+        in.seekg(0, std::ios::end);
+        const uint64_t total_size = static_cast<uint64_t>(in.tellg());
+        in.seekg(0, std::ios::beg);
+        if (MAXDWORD <= total_size) return false;
+
+        WinHttpHandle session, connect, request;
+        session.h = WinHttpOpen(
+            L"vcpkg/1.0", WINHTTP_ACCESS_TYPE_DEFAULT_PROXY, WINHTTP_NO_PROXY_NAME, WINHTTP_NO_PROXY_BYPASS, 0);
+        if (!session.h) return false;
+        connect.h = WinHttpConnect(session.h, url.host.c_str(), url.port, 0);
+        if (!connect.h) return false;
+        request.h = WinHttpOpenRequest(connect.h,
+                                       L"PUT",
+                                       url.path.c_str(),
+                                       nullptr,
+                                       WINHTTP_NO_REFERER,
+                                       WINHTTP_DEFAULT_ACCEPT_TYPES,
+                                       url.https ? WINHTTP_FLAG_SECURE : 0);
+        if (!request.h) return false;
+        if (!WinHttpSendRequest(request.h,
+                                WINHTTP_NO_ADDITIONAL_HEADERS,
+                                0,
+                                WINHTTP_NO_REQUEST_DATA,
+                                0,
+                                static_cast<DWORD>(total_size),
+                                0))
+            return false;
+
+        std::vector<char> buffer(64 * 1024);
+        while (in)
+        {
+            in.read(buffer.data(), buffer.size());
+            const std::streamsize read = in.gcount();
+            if (read == 0) break;
+            DWORD written = 0;
+            if (!WinHttpWriteData(request.h, buffer.data(), static_cast<DWORD>(read), &written)) return false;
+        }
+
+        if (!WinHttpReceiveResponse(request.h, nullptr)) return false;
+
+        DWORD http_code = 0, junk = sizeof(DWORD);
+        if (!WinHttpQueryHeaders(request.h,
+                                 WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER,
+                                 nullptr,
+                                 &http_code,
+                                 &junk,
+                                 WINHTTP_NO_HEADER_INDEX))
+            return false;
+        return http_code >= 200 && http_code < 300;
+    }
+#else
+    // On non-Windows hosts the transfers go through the curl CLI, which is as
+    // ubiquitous there as WinHTTP is on Windows; the chunk orchestration, resume
+    // bookkeeping, and hash verification are shared.
+    struct CrackedUrl
+    {
+        std::string url;
+    };
+
+    static Optional<CrackedUrl> crack_url(const std::string& url)
+    {
+        if (!Strings::case_insensitive_ascii_starts_with(url, "http")) return nullopt;
+        return CrackedUrl{url};
+    }
+
+    static bool fetch_to_file(const CrackedUrl& url,
+                              const Optional<std::pair<uint64_t, uint64_t>>& range,
+                              const fs::path& part_path,
+                              Hash::StreamingHasher* const hasher)
+    {
+        if (hasher)
+        {
+            // Hashing needs the bytes in-process, so stream curl's stdout through
+            // this process to the part file; ranges never combine with hashing.
+            FILE* pipe = popen(Strings::format(R"(curl -fsSL --retry 3 "%s")", url.url).c_str(), "r");
+            if (!pipe) return false;
+
+            std::ofstream out(part_path.native(), std::ios::binary | std::ios::trunc);
+            std::vector<char> buffer(256 * 1024);
+            bool write_ok = static_cast<bool>(out);
+            size_t read;
+            while (write_ok && (read = fread(buffer.data(), 1, buffer.size(), pipe)) > 0)
+            {
+                hasher->update(buffer.data(), read);
+                out.write(buffer.data(), static_cast<std::streamsize>(read));
+                write_ok = static_cast<bool>(out);
+            }
+            const int rc = pclose(pipe);
+            return write_ok && rc == 0;
+        }
+
+        std::string range_arg;
+        if (const auto r = range.get())
+        {
+            range_arg = Strings::format("-r %s-%s ", std::to_string(r->first), std::to_string(r->second));
+        }
+        const int rc = System::cmd_execute_clean(Strings::format(
+            R"(curl -fsSL --retry 3 %s-o "%s" "%s")", range_arg, part_path.u8string(), url.url));
+        return rc == 0;
+    }
+
+    static Optional<ProbeResult> probe(const CrackedUrl& url)
+    {
+        const auto rc =
+            System::cmd_execute_and_capture_output(Strings::format(R"(curl -fsIL "%s")", url.url));
+        if (rc.exit_code != 0) return nullopt;
+
+        ProbeResult result;
+        for (const std::string& line : Strings::split(rc.output, "\n"))
+        {
+            if (Strings::case_insensitive_ascii_starts_with(line, "Content-Length:"))
+            {
+                result.content_length = static_cast<uint64_t>(atoll(line.c_str() + sizeof("Content-Length:") - 1));
+            }
+            else if (Strings::case_insensitive_ascii_starts_with(line, "Accept-Ranges:"))
+            {
+                result.accept_ranges = Strings::case_insensitive_ascii_contains(line, "bytes");
+            }
+        }
+        return result;
+    }
+
+    static bool upload_file_impl(const CrackedUrl& url, const fs::path& file)
+    {
+        const int rc =
+            System::cmd_execute_clean(Strings::format(R"(curl -fsS -T "%s" "%s")", file.u8string(), url.url));
+        return rc == 0;
+    }
+#endif
+
+    // `hasher`, when given, observes the assembled bytes as they are written, so the
+    // hash of the whole file exists the moment assembly finishes -- including chunks
+    // reused from an interrupted earlier run, which the fetch loop never saw.
+    static bool concatenate_parts(const std::vector<fs::path>& parts,
+                                  const fs::path& destination,
+                                  Hash::StreamingHasher* const hasher)
+    {
+        std::ofstream out(destination.native(), std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+
+        std::vector<char> buffer(1024 * 1024);
+        for (const fs::path& part : parts)
+        {
+            std::ifstream in(part.native(), std::ios::binary);
+            if (!in) return false;
+            while (in)
+            {
+                in.read(buffer.data(), buffer.size());
+                out.write(buffer.data(), in.gcount());
+                if (hasher) hasher->update(buffer.data(), static_cast<size_t>(in.gcount()));
+            }
+            if (!out) return false;
+        }
+        return true;
+    }
+
+    static std::string url_host(const std::string& url)
+    {
+        const size_t scheme = url.find("://");
+        if (scheme == std::string::npos) return "";
+        const size_t begin = scheme + 3;
+        const size_t end = url.find_first_of("/:?", begin); // ':' strips any port
+        return Strings::ascii_to_lowercase(url.substr(begin, end == std::string::npos ? end : end - begin));
+    }
+
+    // Observed per-host throughput persists next to the downloads and orders future
+    // mirror attempts, so the race usually starts on the host that won last time. An
+    // exponential moving average smooths noisy links without letting one slow fetch
+    // permanently demote a mirror.
+    static std::mutex g_throughput_mutex;
+    static std::unordered_map<std::string, double> g_throughput;
+    static bool g_throughput_loaded = false;
+
+    static fs::path throughput_stats_path(const fs::path& downloads_dir)
+    {
+        return downloads_dir / "host-throughput.txt";
+    }
+
+    // Runs under g_throughput_mutex.
+    static void load_throughput_stats(const Files::Filesystem& fs, const fs::path& downloads_dir)
+    {
+        if (g_throughput_loaded) return;
+        g_throughput_loaded = true;
+
+        const auto maybe_contents = fs.read_contents(throughput_stats_path(downloads_dir));
+        const auto contents = maybe_contents.get();
+        if (!contents) return;
+
+        for (const std::string& line : Strings::split(*contents, "\n"))
+        {
+            const size_t space = line.find(' ');
+            if (space == std::string::npos) continue;
+            g_throughput[line.substr(0, space)] = atof(line.c_str() + space + 1);
+        }
+    }
+
+    static double host_throughput(const Files::Filesystem& fs, const fs::path& downloads_dir, const std::string& host)
+    {
+        std::lock_guard<std::mutex> lock(g_throughput_mutex);
+        load_throughput_stats(fs, downloads_dir);
+        const auto it = g_throughput.find(host);
+        return it == g_throughput.end() ? 0.0 : it->second;
+    }
+
+    static void record_host_throughput(Files::Filesystem& fs,
+                                       const fs::path& downloads_dir,
+                                       const std::string& host,
+                                       const double bytes_per_second)
+    {
+        if (host.empty() || bytes_per_second <= 0) return;
+
+        std::lock_guard<std::mutex> lock(g_throughput_mutex);
+        load_throughput_stats(fs, downloads_dir);
+
+        double& recorded = g_throughput[host];
+        recorded = recorded == 0.0 ? bytes_per_second : recorded * 0.7 + bytes_per_second * 0.3;
+
+        std::string serialized;
+        for (const auto& entry : g_throughput)
+        {
+            serialized.append(Strings::format("%s %s\n", entry.first, std::to_string(entry.second)));
+        }
+        fs.write_contents(throughput_stats_path(downloads_dir), serialized);
+    }
+
+    static bool check_expected_hash(const std::string& actual_sha512, const std::string& expected_sha512)
+    {
+        if (Strings::case_insensitive_ascii_equals(actual_sha512, expected_sha512)) return true;
+        System::println(System::Color::error,
+                        "File does not have the expected hash:\n"
+                        "    Expected: %s\n"
+                        "      Actual: %s",
+                        expected_sha512,
+                        actual_sha512);
+        return false;
+    }
+
+    bool download_file(Files::Filesystem& fs,
+                       const std::string& url,
+                       const fs::path& destination,
+                       const std::string& expected_sha512,
+                       size_t max_connections,
+                       const bool print_transport_errors)
+    {
+        const auto maybe_cracked = crack_url(url);
+        const auto cracked = maybe_cracked.get();
+        if (!cracked)
+        {
+            System::println(System::Color::error, "Invalid or unsupported url: %s", url);
+            return false;
+        }
+
+        std::error_code ec;
+        fs.create_directories(destination.parent_path(), ec);
+
+        const auto timer = Chrono::ElapsedTimer::create_started();
+        const auto maybe_probe = probe(*cracked);
+        const ProbeResult probe_result = maybe_probe.value_or(ProbeResult{});
+        const auto content_length = probe_result.content_length.get();
+
+        size_t num_chunks = 1;
+        if (content_length && probe_result.accept_ranges && max_connections > 1)
+        {
+            num_chunks = std::min<size_t>(max_connections, static_cast<size_t>(*content_length / MIN_CHUNK_SIZE));
+            if (num_chunks == 0) num_chunks = 1;
+        }
+
+        const fs::path temp_file = destination.parent_path() / (destination.filename().u8string() + ".part");
+
+        // Verification streams with the bytes: the single-connection path hashes in
+        // the fetch loop and the chunked path hashes during part assembly, so a
+        // multi-GB distfile is never read back for a second pass.
+        Hash::StreamingHasher hasher("SHA512");
+        Hash::StreamingHasher* const streaming = expected_sha512.empty() ? nullptr : &hasher;
+
+        if (num_chunks == 1)
+        {
+            if (!fetch_to_file(*cracked, nullopt, temp_file, streaming))
+            {
+                if (print_transport_errors) System::println(System::Color::error, "Download failed: %s", url);
+                return false;
+            }
+        }
+        else
+        {
+            const uint64_t chunk_size = (*content_length + num_chunks - 1) / num_chunks;
+            std::vector<fs::path> parts;
+            std::vector<std::pair<uint64_t, uint64_t>> ranges;
+            for (size_t i = 0; i < num_chunks; ++i)
+            {
+                const uint64_t begin = i * chunk_size;
+                const uint64_t end = std::min<uint64_t>(begin + chunk_size, *content_length) - 1;
+                parts.push_back(destination.parent_path() /
+                                Strings::format("%s.part%s", destination.filename().u8string(), std::to_string(i)));
+                ranges.emplace_back(begin, end);
+            }
+
+            std::atomic<size_t> next_chunk{0};
+            std::atomic<bool> failed{false};
+            auto work = [&]() {
+                for (;;)
+                {
+                    const size_t i = next_chunk.fetch_add(1, std::memory_order_relaxed);
+                    if (i >= num_chunks || failed.load(std::memory_order_relaxed)) return;
+
+                    // Chunks completed by an interrupted earlier run are reused; the
+                    // final hash check still guards the assembled whole.
+                    const uint64_t expected_size = ranges[i].second - ranges[i].first + 1;
+                    if (fs.exists(parts[i]))
+                    {
+                        std::error_code size_ec;
+                        if (static_cast<uint64_t>(fs.file_size(parts[i], size_ec)) == expected_size && !size_ec)
+                            continue;
+                    }
+
+                    if (!fetch_to_file(*cracked, ranges[i], parts[i], nullptr))
+                        failed.store(true, std::memory_order_relaxed);
+                }
+            };
+
+            const size_t num_threads = std::min<size_t>(num_chunks, max_connections);
+            std::vector<std::thread> workers;
+            for (size_t i = 1; i < num_threads; ++i)
+                workers.emplace_back(work);
+            work();
+            for (auto&& worker : workers)
+                worker.join();
+
+            if (failed.load())
+            {
+                if (print_transport_errors) System::println(System::Color::error, "Download failed: %s", url);
+                return false;
+            }
+
+            if (!concatenate_parts(parts, temp_file, streaming))
+            {
+                System::println(System::Color::error, "Failed to assemble downloaded chunks for %s", url);
+                return false;
+            }
+
+            for (const fs::path& part : parts)
+                fs.remove(part, ec);
+        }
+
+        if (streaming && !check_expected_hash(hasher.finalize(), expected_sha512))
+        {
+            return false;
+        }
+
+        fs.remove(destination, ec);
+        fs.rename(temp_file, destination);
+
+        const double elapsed_us = timer.microseconds();
+        const auto downloaded_size = fs.file_size(destination, ec);
+        if (!ec && elapsed_us > 0)
+        {
+            record_host_throughput(
+                fs, destination.parent_path(), url_host(url), static_cast<double>(downloaded_size) * 1e6 / elapsed_us);
+        }
+        return true;
+    }
+
+    Optional<std::string> download_file_and_hash(Files::Filesystem& fs, const std::string& url, const fs::path& destination)
+    {
+        const auto maybe_cracked = crack_url(url);
+        const auto cracked = maybe_cracked.get();
+        if (!cracked)
+        {
+            System::println(System::Color::error, "Invalid or unsupported url: %s", url);
+            return nullopt;
+        }
+
+        std::error_code ec;
+        fs.create_directories(destination.parent_path(), ec);
+
+        // Hashing is sequential, so this path always uses a single connection; the
+        // chunked engine would have to reread the assembled file anyway.
+        const auto timer = Chrono::ElapsedTimer::create_started();
+        const fs::path temp_file = destination.parent_path() / (destination.filename().u8string() + ".part");
+        Hash::StreamingHasher hasher("SHA512");
+        if (!fetch_to_file(*cracked, nullopt, temp_file, &hasher))
+        {
+            System::println(System::Color::error, "Download failed: %s", url);
+            return nullopt;
+        }
+
+        fs.remove(destination, ec);
+        fs.rename(temp_file, destination);
+
+        const double elapsed_us = timer.microseconds();
+        const auto downloaded_size = fs.file_size(destination, ec);
+        if (!ec && elapsed_us > 0)
+        {
+            record_host_throughput(
+                fs, destination.parent_path(), url_host(url), static_cast<double>(downloaded_size) * 1e6 / elapsed_us);
+        }
+        return hasher.finalize();
+    }
+
+    // The next mirror joins the race this long after the previous one; long enough
+    // that a responsive first choice wins alone, short enough that a stalled
+    // upstream costs milliseconds instead of a timeout.
+    static const std::chrono::milliseconds MIRROR_STAGGER_DELAY{750};
+
+    bool download_file_from_mirrors(Files::Filesystem& fs,
+                                    const std::vector<std::string>& urls,
+                                    const fs::path& destination,
+                                    const std::string& expected_sha512,
+                                    const size_t max_connections)
+    {
+        if (urls.empty()) return false;
+        if (urls.size() == 1) return download_file(fs, urls[0], destination, expected_sha512, max_connections);
+
+        // Fastest measured host first; hosts with no history keep their given
+        // (preference) order behind the measured ones and get measured once a
+        // stagger reaches them.
+        std::vector<std::string> ordered = urls;
+        const fs::path downloads_dir = destination.parent_path();
+        std::stable_sort(ordered.begin(), ordered.end(), [&](const std::string& a, const std::string& b) {
+            return host_throughput(fs, downloads_dir, url_host(a)) > host_throughput(fs, downloads_dir, url_host(b));
+        });
+
+        struct RaceState
+        {
+            std::mutex m;
+            std::condition_variable cv;
+            size_t outstanding = 0;
+            bool succeeded = false;
+        };
+        const auto state = std::make_shared<RaceState>();
+
+        std::unique_lock<std::mutex> lock(state->m);
+        for (size_t i = 0; i < ordered.size(); ++i)
+        {
+            if (state->succeeded) break;
+            ++state->outstanding;
+
+            // Each racer downloads to its own temp name, so the racers' chunk and
+            // part files never collide; the winner is renamed into place.
+            const std::string url = ordered[i];
+            const fs::path race_destination =
+                destination.parent_path() /
+                Strings::format("%s.race%s", destination.filename().u8string(), std::to_string(i));
+            std::thread([&fs, state, url, race_destination, destination, expected_sha512, max_connections]() {
+                // Transport errors are expected from the losing mirrors.
+                const bool downloaded =
+                    download_file(fs, url, race_destination, expected_sha512, max_connections, false);
+
+                std::lock_guard<std::mutex> state_lock(state->m);
+                std::error_code ec;
+                if (downloaded && !state->succeeded)
+                {
+                    state->succeeded = true;
+                    fs.remove(destination, ec);
+                    fs.rename(race_destination, destination);
+                }
+                else
+                {
+                    fs.remove(race_destination, ec);
+                }
+                --state->outstanding;
+                state->cv.notify_all();
+            }).detach();
+
+            // Give the current racers a head start before widening the race; a fast
+            // failure widens it immediately.
+            state->cv.wait_for(
+                lock, MIRROR_STAGGER_DELAY, [&] { return state->succeeded || state->outstanding == 0; });
+        }
+
+        // There is no portable way to abort the losing transfers; they are left to
+        // finish in the background (holding the shared state alive) and delete
+        // their own work.
+        state->cv.wait(lock, [&] { return state->succeeded || state->outstanding == 0; });
+        return state->succeeded;
+    }
+
+    bool upload_file(const std::string& url, const fs::path& file)
+    {
+        const auto maybe_cracked = crack_url(url);
+        const auto cracked = maybe_cracked.get();
+        if (!cracked)
+        {
+            System::println(System::Color::error, "Invalid or unsupported url: %s", url);
+            return false;
+        }
+        return upload_file_impl(*cracked, file);
+    }
+
+    // Returns the raw argument text of the call whose name ends at `name_end`, or
+    // nullopt if no parenthesized argument list follows.
+    static Optional<std::string> call_arguments(const std::string& text, size_t name_end)
+    {
+        size_t i = name_end;
+        while (i < text.size() && isspace(static_cast<unsigned char>(text[i])))
+            ++i;
+        if (i >= text.size() || text[i] != '(') return nullopt;
+
+        const size_t start = ++i;
+        bool in_quotes = false;
+        for (; i < text.size(); ++i)
+        {
+            const char ch = text[i];
+            if (ch == '"')
+                in_quotes = !in_quotes;
+            else if (ch == ')' && !in_quotes)
+                return text.substr(start, i - start);
+        }
+        return nullopt;
+    }
+
+    static std::vector<std::string> tokenize_cmake_arguments(const std::string& text)
+    {
+        std::vector<std::string> tokens;
+        size_t i = 0;
+        while (i < text.size())
+        {
+            const char ch = text[i];
+            if (isspace(static_cast<unsigned char>(ch)))
+            {
+                ++i;
+            }
+            else if (ch == '"')
+            {
+                const size_t end = text.find('"', i + 1);
+                if (end == std::string::npos) break;
+                tokens.push_back(text.substr(i + 1, end - i - 1));
+                i = end + 1;
+            }
+            else
+            {
+                size_t end = i;
+                while (end < text.size() && !isspace(static_cast<unsigned char>(text[end])))
+                    ++end;
+                tokens.push_back(text.substr(i, end - i));
+                i = end;
+            }
+        }
+        return tokens;
+    }
+
+    static bool references_variables(const std::string& s) { return s.find("${") != std::string::npos; }
+
+    // Iterates every call to `function_name` in `contents` and hands its tokenized
+    // arguments to `f`.
+    template<class F>
+    static void for_each_call(const std::string& contents, const char* function_name, F f)
+    {
+        const size_t name_length = strlen(function_name);
+        size_t pos = 0;
+        while ((pos = contents.find(function_name, pos)) != std::string::npos)
+        {
+            const size_t name_end = pos + name_length;
+            pos = name_end;
+            const auto maybe_arguments = call_arguments(contents, name_end);
+            if (const auto arguments = maybe_arguments.get())
+            {
+                f(tokenize_cmake_arguments(*arguments));
+            }
+        }
+    }
+
+    static Optional<std::string> keyword_value(const std::vector<std::string>& tokens, const std::string& keyword)
+    {
+        for (size_t i = 0; i + 1 < tokens.size(); ++i)
+        {
+            if (tokens[i] == keyword) return tokens[i + 1];
+        }
+        return nullopt;
+    }
+
+    std::vector<Distfile> parse_portfile_distfiles(const std::string& portfile_contents)
+    {
+        std::vector<Distfile> distfiles;
+
+        const auto add_if_literal = [&](Distfile&& distfile) {
+            Util::erase_remove_if(distfile.urls, references_variables);
+            if (distfile.urls.empty() || distfile.filename.empty() || distfile.sha512.empty()) return;
+            if (distfile.sha512 == "0") return;
+            if (references_variables(distfile.filename) || references_variables(distfile.sha512)) return;
+            distfiles.push_back(std::move(distfile));
+        };
+
+        for_each_call(portfile_contents, "vcpkg_download_distfile", [&](const std::vector<std::string>& tokens) {
+            Distfile distfile;
+            // tokens[0] is the output variable; URLS may list several mirrors, all
+            // of which are collected so the downloader can race them.
+            for (size_t i = 1; i + 1 < tokens.size(); ++i)
+            {
+                if (tokens[i] == "URLS")
+                {
+                    for (size_t j = i + 1;
+                         j < tokens.size() && Strings::case_insensitive_ascii_starts_with(tokens[j], "http");
+                         ++j)
+                        distfile.urls.push_back(tokens[j]);
+                }
+                else if (tokens[i] == "FILENAME")
+                    distfile.filename = tokens[i + 1];
+                else if (tokens[i] == "SHA512")
+                    distfile.sha512 = tokens[i + 1];
+            }
+            add_if_literal(std::move(distfile));
+        });
+
+        for_each_call(portfile_contents, "vcpkg_from_github", [&](const std::vector<std::string>& tokens) {
+            const auto repo = keyword_value(tokens, "REPO");
+            const auto ref = keyword_value(tokens, "REF");
+            const auto sha512 = keyword_value(tokens, "SHA512");
+            if (!repo.has_value() || !ref.has_value() || !sha512.has_value()) return;
+
+            const size_t separator = repo.get()->find('/');
+            if (separator == std::string::npos) return;
+
+            // Mirror the URL and FILENAME vcpkg_from_github passes to
+            // vcpkg_download_distfile, including the sanitized REF.
+            std::string sanitized_ref = *ref.get();
+            std::replace(sanitized_ref.begin(), sanitized_ref.end(), '/', '-');
+
+            Distfile distfile;
+            distfile.urls.push_back(
+                Strings::format("https://github.com/%s/archive/%s.tar.gz", *repo.get(), *ref.get()));
+            distfile.filename = Strings::format("%s-%s-%s.tar.gz",
+                                                repo.get()->substr(0, separator),
+                                                repo.get()->substr(separator + 1),
+                                                sanitized_ref);
+            distfile.sha512 = *sha512.get();
+            add_if_literal(std::move(distfile));
+        });
+
+        return distfiles;
+    }
+
+    void prefetch_distfiles(Files::Filesystem& fs, const fs::path& downloads_dir, std::vector<Distfile>&& distfiles)
+    {
+        if (distfiles.empty()) return;
+
+        // Detached on purpose, like the metrics uploader: the builds this overlaps
+        // with never wait for the prefetcher, and a download cut short by process exit
+        // leaves part files behind that the next download of the same file resumes.
+        std::thread([&fs, downloads_dir, distfiles = std::move(distfiles)]() {
+            std::error_code ec;
+            fs.create_directories(downloads_dir, ec);
+            if (ec) return;
+
+            // A few downloads in flight saturate most links; each one still splits
+            // large files into byte-range chunks of its own.
+            static const size_t MAX_CONCURRENT_DOWNLOADS = 4;
+            const size_t worker_count = std::min(MAX_CONCURRENT_DOWNLOADS, distfiles.size());
+            Parallel::for_each_index_with_worker(worker_count, distfiles.size(), [&](const size_t i, size_t) {
+                const Distfile& distfile = distfiles[i];
+                const fs::path destination = downloads_dir / fs::u8path(distfile.filename);
+                if (fs.exists(destination)) return;
+                download_file_from_mirrors(fs, distfile.urls, destination, distfile.sha512, 2);
+            });
+        }).detach();
+    }
+}
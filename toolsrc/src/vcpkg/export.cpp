@@ -2,9 +2,11 @@
 
 #include <vcpkg/base/system.h>
 #include <vcpkg/base/util.h>
+#include <vcpkg/base/zipwriter.h>
 #include <vcpkg/commands.h>
 #include <vcpkg/dependencies.h>
 #include <vcpkg/export.h>
+#include <vcpkg/gc.h>
 #include <vcpkg/export.ifw.h>
 #include <vcpkg/help.h>
 #include <vcpkg/input.h>
@@ -21,10 +23,7 @@ namespace vcpkg::Export
     using Dependencies::RequestType;
     using Install::InstallDir;
 
-    static std::string create_nuspec_file_contents(const std::string& raw_exported_dir,
-                                                   const std::string& targets_redirect_path,
-                                                   const std::string& nuget_id,
-                                                   const std::string& nupkg_version)
+    static std::string create_nuspec_file_contents(const std::string& nuget_id, const std::string& nupkg_version)
     {
         static constexpr auto CONTENT_TEMPLATE = R"(
 <package>
@@ -36,21 +35,11 @@ namespace vcpkg::Export
             Vcpkg NuGet export
         </description>
     </metadata>
-    <files>
-        <file src="@RAW_EXPORTED_DIR@\installed\**" target="installed" />
-        <file src="@RAW_EXPORTED_DIR@\scripts\**" target="scripts" />
-        <file src="@RAW_EXPORTED_DIR@\.vcpkg-root" target="" />
-        <file src="@TARGETS_REDIRECT_PATH@" target="build\native\@NUGET_ID@.targets" />
-    </files>
 </package>
 )";
 
         std::string nuspec_file_content = Strings::replace_all(CONTENT_TEMPLATE, "@NUGET_ID@", nuget_id);
         nuspec_file_content = Strings::replace_all(std::move(nuspec_file_content), "@VERSION@", nupkg_version);
-        nuspec_file_content =
-            Strings::replace_all(std::move(nuspec_file_content), "@RAW_EXPORTED_DIR@", raw_exported_dir);
-        nuspec_file_content =
-            Strings::replace_all(std::move(nuspec_file_content), "@TARGETS_REDIRECT_PATH@", targets_redirect_path);
         return nuspec_file_content;
     }
 
@@ -115,40 +104,145 @@ namespace vcpkg::Export
         return ("vcpkg-export-" + date_time_as_string);
     }
 
+    static const std::vector<fs::path>& integration_files_relative_to_root()
+    {
+        static const std::vector<fs::path> integration_files = {
+            {".vcpkg-root"},
+            {fs::path{"scripts"} / "buildsystems" / "msbuild" / "applocal.ps1"},
+            {fs::path{"scripts"} / "buildsystems" / "msbuild" / "vcpkg.targets"},
+            {fs::path{"scripts"} / "buildsystems" / "vcpkg.cmake"},
+            {fs::path{"scripts"} / "cmake" / "vcpkg_get_windows_sdk.cmake"},
+            {fs::path{"scripts"} / "getWindowsSDK.ps1"},
+            {fs::path{"scripts"} / "getProgramFilesPlatformBitness.ps1"},
+            {fs::path{"scripts"} / "getProgramFiles32bit.ps1"},
+        };
+        return integration_files;
+    }
+
+    // Streams the package directly from the packages tree: every exported file is read
+    // once and written straight into the nupkg, so no staging copy and no nuget.exe
+    // invocation are needed.
     static fs::path do_nuget_export(const VcpkgPaths& paths,
                                     const std::string& nuget_id,
                                     const std::string& nuget_version,
-                                    const fs::path& raw_exported_dir,
+                                    Span<const ExportPlanAction> export_plan,
                                     const fs::path& output_dir)
     {
         Files::Filesystem& fs = paths.get_filesystem();
-        const fs::path& nuget_exe = paths.get_nuget_exe();
+        const fs::path output_path = output_dir / (nuget_id + ".nupkg");
+        Files::ZipWriter writer(output_path);
+
+        // A nupkg is an OPC zip: [Content_Types].xml must declare a content type for
+        // every part, by extension where one exists and by full name otherwise.
+        std::set<std::string> part_extensions;
+        std::vector<std::string> extensionless_parts;
+        const auto add_part = [&](const std::string& name, const std::string& contents) {
+            const std::string filename = name.substr(name.find_last_of('/') + 1);
+            const size_t last_dot = filename.find_last_of('.');
+            if (last_dot == std::string::npos || last_dot + 1 == filename.size())
+            {
+                extensionless_parts.push_back(name);
+            }
+            else
+            {
+                part_extensions.insert(Strings::ascii_to_lowercase(filename.substr(last_dot + 1)));
+            }
+            writer.add_file(name, contents);
+        };
+
+        add_part("_rels/.rels",
+                 Strings::format(R"(<?xml version="1.0" encoding="utf-8"?>
+<Relationships xmlns="http://schemas.openxmlformats.org/package/2006/relationships">
+    <Relationship Type="http://schemas.microsoft.com/packaging/2010/07/manifest" Target="/%s.nuspec" Id="R1" />
+</Relationships>
+)",
+                                 nuget_id));
+        add_part(nuget_id + ".nuspec", create_nuspec_file_contents(nuget_id, nuget_version));
 
         // This file will be placed in "build\native" in the nuget package. Therefore, go up two dirs.
-        const std::string targets_redirect_content =
-            create_targets_redirect("../../scripts/buildsystems/msbuild/vcpkg.targets");
-        const fs::path targets_redirect = paths.buildsystems / "tmp" / "vcpkg.export.nuget.targets";
+        add_part("build/native/" + nuget_id + ".targets",
+                 create_targets_redirect("../../scripts/buildsystems/msbuild/vcpkg.targets"));
 
-        std::error_code ec;
-        fs.create_directories(paths.buildsystems / "tmp", ec);
+        for (const ExportPlanAction& action : export_plan)
+        {
+            const BinaryParagraph& binary_paragraph =
+                action.any_paragraph.binary_control_file_or_exit(VCPKG_LINE_INFO).core_paragraph;
+            const std::string& triplet = action.spec.triplet().canonical_name();
+            const fs::path package_dir = paths.package_dir(action.spec);
+            const size_t prefix_length = package_dir.native().size();
+
+            std::vector<std::string> listfile_lines;
+            listfile_lines.push_back(Strings::format(R"(%s/)", triplet));
+            fs.for_each_file_recursive(package_dir, [&](const fs::path& file, const fs::file_status status) {
+                const std::string filename = file.filename().generic_string();
+                if (fs::is_regular_file(status) &&
+                    (Strings::case_insensitive_ascii_equals(filename.c_str(), "CONTROL") ||
+                     Strings::case_insensitive_ascii_equals(filename.c_str(), "BUILD_INFO")))
+                {
+                    // Do not export the control file
+                    return;
+                }
 
-        fs.write_contents(targets_redirect, targets_redirect_content);
+                const std::string suffix = file.generic_u8string().substr(prefix_length + 1);
 
-        const std::string nuspec_file_content =
-            create_nuspec_file_contents(raw_exported_dir.string(), targets_redirect.string(), nuget_id, nuget_version);
-        const fs::path nuspec_file_path = paths.buildsystems / "tmp" / "vcpkg.export.nuspec";
-        fs.write_contents(nuspec_file_path, nuspec_file_content);
+                if (fs::is_directory(status))
+                {
+                    // Trailing backslash for directories
+                    listfile_lines.push_back(Strings::format(R"(%s/%s/)", triplet, suffix));
+                    return;
+                }
 
-        // -NoDefaultExcludes is needed for ".vcpkg-root"
-        const auto cmd_line = Strings::format(R"("%s" pack -OutputDirectory "%s" "%s" -NoDefaultExcludes > nul)",
-                                              nuget_exe.u8string(),
-                                              output_dir.u8string(),
-                                              nuspec_file_path.u8string());
+                if (fs::is_regular_file(status))
+                {
+                    const Expected<std::string> contents = fs.read_contents(file);
+                    Checks::check_exit(VCPKG_LINE_INFO,
+                                       !contents.error(),
+                                       "Could not read file %s: %s",
+                                       file.u8string(),
+                                       contents.error().message());
+                    add_part(Strings::format("installed/%s/%s", triplet, suffix),
+                             *contents.get());
+                    listfile_lines.push_back(Strings::format(R"(%s/%s)", triplet, suffix));
+                    return;
+                }
+            });
 
-        const int exit_code = System::cmd_execute_clean(cmd_line);
-        Checks::check_exit(VCPKG_LINE_INFO, exit_code == 0, "Error: NuGet package creation failed");
+            add_part(Strings::format("installed/vcpkg/info/%s.list", binary_paragraph.fullstem()),
+                     Strings::join("\n", listfile_lines) + "\n");
+        }
 
-        const fs::path output_path = output_dir / (nuget_id + ".nupkg");
+        for (const fs::path& file : integration_files_relative_to_root())
+        {
+            const fs::path source = paths.root / file;
+            const Expected<std::string> contents = fs.read_contents(source);
+            Checks::check_exit(VCPKG_LINE_INFO,
+                               !contents.error(),
+                               "Could not read file %s: %s",
+                               source.u8string(),
+                               contents.error().message());
+            add_part(file.generic_u8string(), *contents.get());
+        }
+
+        std::string content_types = R"(<?xml version="1.0" encoding="utf-8"?>
+<Types xmlns="http://schemas.openxmlformats.org/package/2006/content-types">
+    <Default Extension="rels" ContentType="application/vnd.openxmlformats-package.relationships+xml" />
+)";
+        for (const std::string& extension : part_extensions)
+        {
+            if (extension == "rels") continue;
+            content_types +=
+                Strings::format("    <Default Extension=\"%s\" ContentType=\"application/octet-stream\" />\n",
+                                extension);
+        }
+        for (const std::string& part : extensionless_parts)
+        {
+            content_types += Strings::format(
+                "    <Override PartName=\"/%s\" ContentType=\"application/octet-stream\" />\n", part);
+        }
+        content_types += "</Types>\n";
+        writer.add_file("[Content_Types].xml", content_types);
+
+        writer.finish();
         return output_path;
     }
 
@@ -183,18 +277,16 @@ namespace vcpkg::Export
         constexpr const ArchiveFormat SEVEN_ZIP(ArchiveFormat::BackingEnum::SEVEN_ZIP, "7z", "7zip");
     }
 
-    static fs::path do_archive_export(const VcpkgPaths& paths,
-                                      const fs::path& raw_exported_dir,
-                                      const fs::path& output_dir,
-                                      const ArchiveFormat& format)
+    // The archiver runs in its own process, so multiple formats compress concurrently
+    // and the nuget pack proceeds while they run; the caller collects the futures once
+    // everything has been kicked off.
+    static std::future<System::ExitCodeAndOutput> begin_archive_export(const VcpkgPaths& paths,
+                                                                       const fs::path& raw_exported_dir,
+                                                                       const fs::path& exported_archive_path,
+                                                                       const ArchiveFormat& format)
     {
         const fs::path& cmake_exe = paths.get_cmake_exe();
 
-        const std::string exported_dir_filename = raw_exported_dir.filename().u8string();
-        const std::string exported_archive_filename =
-            Strings::format("%s.%s", exported_dir_filename, format.extension());
-        const fs::path exported_archive_path = (output_dir / exported_archive_filename);
-
         // -NoDefaultExcludes is needed for ".vcpkg-root"
         const auto cmd_line = Strings::format(R"("%s" -E tar "cf" "%s" --format=%s -- "%s")",
                                               cmake_exe.u8string(),
@@ -202,13 +294,10 @@ namespace vcpkg::Export
                                               format.cmake_option(),
                                               raw_exported_dir.u8string());
 
-        const int exit_code = System::cmd_execute_clean(cmd_line);
-        Checks::check_exit(
-            VCPKG_LINE_INFO, exit_code == 0, "Error: %s creation failed", exported_archive_path.generic_string());
-        return exported_archive_path;
+        return System::cmd_execute_and_capture_output_async(cmd_line);
     }
 
-    static Optional<std::string> maybe_lookup(std::unordered_map<std::string, std::string> const& m,
+    static Optional<std::string> maybe_lookup(FlatMap<std::string, std::string> const& m,
                                               std::string const& key)
     {
         const auto it = m.find(key);
@@ -218,18 +307,7 @@ namespace vcpkg::Export
 
     void export_integration_files(const fs::path& raw_exported_dir_path, const VcpkgPaths& paths)
     {
-        const std::vector<fs::path> integration_files_relative_to_root = {
-            {".vcpkg-root"},
-            {fs::path{"scripts"} / "buildsystems" / "msbuild" / "applocal.ps1"},
-            {fs::path{"scripts"} / "buildsystems" / "msbuild" / "vcpkg.targets"},
-            {fs::path{"scripts"} / "buildsystems" / "vcpkg.cmake"},
-            {fs::path{"scripts"} / "cmake" / "vcpkg_get_windows_sdk.cmake"},
-            {fs::path{"scripts"} / "getWindowsSDK.ps1"},
-            {fs::path{"scripts"} / "getProgramFilesPlatformBitness.ps1"},
-            {fs::path{"scripts"} / "getProgramFiles32bit.ps1"},
-        };
-
-        for (const fs::path& file : integration_files_relative_to_root)
+        for (const fs::path& file : integration_files_relative_to_root())
         {
             const fs::path source = paths.root / file;
             fs::path destination = raw_exported_dir_path / file;
@@ -251,6 +329,8 @@ namespace vcpkg::Export
         bool zip;
         bool seven_zip;
 
+        Optional<std::string> maybe_output;
+
         Optional<std::string> maybe_nuget_id;
         Optional<std::string> maybe_nuget_version;
 
@@ -258,6 +338,7 @@ namespace vcpkg::Export
         std::vector<PackageSpec> specs;
     };
 
+    static const std::string OPTION_OUTPUT = "--output";
     static const std::string OPTION_DRY_RUN = "--dry-run";
     static const std::string OPTION_RAW = "--raw";
     static const std::string OPTION_NUGET = "--nuget";
@@ -280,7 +361,8 @@ namespace vcpkg::Export
         {OPTION_ZIP, "Export to a zip file"},
         {OPTION_SEVEN_ZIP, "Export to a 7zip (.7z) file"},
     }};
-    static const std::array<CommandSetting, 7> EXPORT_SETTINGS = {{
+    static const std::array<CommandSetting, 8> EXPORT_SETTINGS = {{
+        {OPTION_OUTPUT, "Specify the output name (used to construct filename)"},
         {OPTION_NUGET_ID, "Specify the id for the exported NuGet package"},
         {OPTION_NUGET_VERSION, "Specify the version for the exported NuGet package"},
         {OPTION_IFW_REPOSITORY_URL, "Specify the remote repository URL for the online installer"},
@@ -309,6 +391,7 @@ namespace vcpkg::Export
         ret.specs = Util::fmap(args.command_arguments, [&](auto&& arg) {
             return Input::check_and_get_package_spec(arg, default_triplet, COMMAND_STRUCTURE.example_text);
         });
+        ret.maybe_output = maybe_lookup(options.settings, OPTION_OUTPUT);
         ret.dry_run = options.switches.find(OPTION_DRY_RUN) != options.switches.cend();
         ret.raw = options.switches.find(OPTION_RAW) != options.switches.cend();
         ret.nuget = options.switches.find(OPTION_NUGET) != options.switches.cend();
@@ -379,6 +462,80 @@ namespace vcpkg::Export
                         cmake_variable.s);
     };
 
+    // Manifest of what a staging directory already contains, so repeated exports of
+    // overlapping package sets to the same output only re-copy what changed. Each line
+    // is "<spec> <stamp>", where the stamp identifies the exact staged payload.
+    static const char* const STAGING_MANIFEST_VERSION = "1";
+
+    static fs::path staging_manifest_path(const fs::path& raw_exported_dir_path)
+    {
+        return raw_exported_dir_path / "vcpkg-export.manifest";
+    }
+
+    static std::map<std::string, std::string> load_staging_manifest(const Files::Filesystem& fs,
+                                                                    const fs::path& manifest_path)
+    {
+        std::map<std::string, std::string> manifest;
+        auto maybe_lines = fs.read_lines(manifest_path);
+        const auto lines = maybe_lines.get();
+        if (!lines || lines->empty() || (*lines)[0] != STAGING_MANIFEST_VERSION) return manifest;
+
+        for (size_t i = 1; i < lines->size(); ++i)
+        {
+            const auto space = (*lines)[i].find(' ');
+            if (space == std::string::npos) continue;
+            manifest.emplace((*lines)[i].substr(0, space), (*lines)[i].substr(space + 1));
+        }
+        return manifest;
+    }
+
+    static void save_staging_manifest(Files::Filesystem& fs,
+                                      const fs::path& manifest_path,
+                                      const std::map<std::string, std::string>& manifest)
+    {
+        std::string contents = STAGING_MANIFEST_VERSION;
+        contents.push_back('\n');
+        for (const auto& entry : manifest)
+        {
+            contents.append(Strings::format("%s %s\n", entry.first, entry.second));
+        }
+        fs.write_contents(manifest_path, contents);
+    }
+
+    // Removes a previously staged package using the listfile written when it was
+    // staged. Directories are removed only when emptied; ones still shared with other
+    // packages simply stay.
+    static void unstage_package(Files::Filesystem& fs, const fs::path& raw_exported_dir_path, const std::string& stamp)
+    {
+        const std::string fullstem = stamp.substr(0, stamp.find(';'));
+        const fs::path installed_root = raw_exported_dir_path / "installed";
+        const fs::path listfile = installed_root / "vcpkg" / "info" / (fullstem + ".list");
+
+        std::error_code ec;
+        auto maybe_lines = read_listfile(fs, listfile);
+        if (const auto lines = maybe_lines.get())
+        {
+            std::vector<std::string> directories;
+            for (const std::string& line : *lines)
+            {
+                if (line.empty()) continue;
+                if (line.back() == '/')
+                    directories.push_back(line.substr(0, line.size() - 1));
+                else
+                    fs.remove(installed_root / line, ec);
+            }
+            // Deepest first, so directories emptied above are removed as well.
+            std::sort(directories.begin(), directories.end(), [](const std::string& l, const std::string& r) {
+                return l.size() > r.size();
+            });
+            for (const std::string& directory : directories)
+            {
+                fs.remove(installed_root / directory, ec);
+            }
+        }
+        fs.remove(listfile, ec);
+    }
+
     static void handle_raw_based_export(Span<const ExportPlanAction> export_plan,
                                         const ExportArguments& opts,
                                         const std::string& export_id,
@@ -388,34 +545,124 @@ namespace vcpkg::Export
         const fs::path export_to_path = paths.root;
         const fs::path raw_exported_dir_path = export_to_path / export_id;
         std::error_code ec;
-        fs.remove_all(raw_exported_dir_path, ec);
-        fs.create_directory(raw_exported_dir_path, ec);
 
-        // execute the plan
-        for (const ExportPlanAction& action : export_plan)
+        // The nuget export streams directly from the packages tree, so the staged copy
+        // is only needed for the formats that archive a directory.
+        const bool needs_staged_copy = opts.raw || opts.zip || opts.seven_zip;
+
+        if (needs_staged_copy)
         {
-            if (action.plan_type != ExportPlanType::ALREADY_BUILT)
+            // Preflight: staging copies every exported package, so check the volume
+            // can take the sum of their sizes before spending the time. Hardlinked
+            // staging needs far less than this; the estimate errs on the safe side.
+            uint64_t required = 0;
+            for (const ExportPlanAction& action : export_plan)
+            {
+                std::error_code size_ec;
+                for (const fs::path& file : fs.get_files_recursive(paths.package_dir(action.spec)))
+                {
+                    const auto size = fs.file_size(file, size_ec);
+                    if (!size_ec) required += size;
+                }
+            }
+            std::error_code space_ec;
+            const auto space = fs::stdfs::space(paths.root, space_ec);
+            if (!space_ec && space.available < required)
             {
-                Checks::unreachable(VCPKG_LINE_INFO);
+                Checks::exit_with_message(VCPKG_LINE_INFO,
+                                          "This export is estimated to need %s, but only %s is free on %s.\n"
+                                          "Free up space or run `vcpkg x-gc --target-size=...` and try again.",
+                                          GC::format_size(required),
+                                          GC::format_size(space.available),
+                                          paths.root.u8string());
             }
 
-            const std::string display_name = action.spec.to_string();
-            System::println("Exporting package %s... ", display_name);
+            const fs::path manifest_path = staging_manifest_path(raw_exported_dir_path);
+            std::map<std::string, std::string> previous = load_staging_manifest(fs, manifest_path);
+            if (previous.empty())
+            {
+                // No usable manifest: wipe and stage from scratch, as before.
+                fs.remove_all(raw_exported_dir_path, ec);
+            }
+            fs.create_directory(raw_exported_dir_path, ec);
 
-            const BinaryParagraph& binary_paragraph =
-                action.any_paragraph.binary_control_file.value_or_exit(VCPKG_LINE_INFO).core_paragraph;
+            std::map<std::string, std::string> staged;
 
-            const InstallDir dirs = InstallDir::from_destination_root(
-                raw_exported_dir_path / "installed",
-                action.spec.triplet().to_string(),
-                raw_exported_dir_path / "installed" / "vcpkg" / "info" / (binary_paragraph.fullstem() + ".list"));
+            // execute the plan
+            for (const ExportPlanAction& action : export_plan)
+            {
+                if (action.plan_type != ExportPlanType::ALREADY_BUILT)
+                {
+                    Checks::unreachable(VCPKG_LINE_INFO);
+                }
 
-            Install::install_files_and_write_listfile(paths.get_filesystem(), paths.package_dir(action.spec), dirs);
-            System::println(System::Color::success, "Exporting package %s... done", display_name);
+                const std::string display_name = action.spec.to_string();
+
+                const BinaryParagraph& binary_paragraph =
+                    action.any_paragraph.binary_control_file_or_exit(VCPKG_LINE_INFO).core_paragraph;
+
+                const std::string stamp = binary_paragraph.fullstem() + ';' + binary_paragraph.abi;
+                staged[display_name] = stamp;
+
+                const auto it = previous.find(display_name);
+                if (it != previous.end())
+                {
+                    const std::string old_stamp = std::move(it->second);
+                    previous.erase(it);
+                    if (old_stamp == stamp)
+                    {
+                        System::println("Package %s is already staged", display_name);
+                        continue;
+                    }
+                    unstage_package(fs, raw_exported_dir_path, old_stamp);
+                }
+
+                System::println("Exporting package %s... ", display_name);
+
+                const InstallDir dirs = InstallDir::from_destination_root(
+                    raw_exported_dir_path / "installed",
+                    action.spec.triplet().to_string(),
+                    raw_exported_dir_path / "installed" / "vcpkg" / "info" / (binary_paragraph.fullstem() + ".list"));
+
+                // The staging root lives under paths.root, the same volume as the
+                // packages tree, so linking replaces the bulk copy; files.cpp falls
+                // back to copying per file when the link cannot be made.
+                Install::install_files_and_write_listfile(paths.get_filesystem(),
+                                                          paths.package_dir(action.spec),
+                                                          dirs,
+                                                          Install::PreferHardLinks::YES);
+                System::println(System::Color::success, "Exporting package %s... done", display_name);
+            }
+
+            // Anything staged last time but absent from this plan is removed.
+            for (const auto& stale : previous)
+            {
+                unstage_package(fs, raw_exported_dir_path, stale.second);
+            }
+
+            // Copy files needed for integration
+            export_integration_files(raw_exported_dir_path, paths);
+
+            save_staging_manifest(fs, manifest_path, staged);
         }
 
-        // Copy files needed for integration
-        export_integration_files(raw_exported_dir_path, paths);
+        // Kick off the requested archive formats first; they compress in their own
+        // processes while the raw/nuget steps below run.
+        struct PendingArchive
+        {
+            std::string description;
+            fs::path output_path;
+            std::future<System::ExitCodeAndOutput> result;
+        };
+        std::vector<PendingArchive> pending_archives;
+        const auto begin_archive = [&](const char* description, const ArchiveFormat& format) {
+            System::println("Creating %s archive... ", description);
+            fs::path output_path = export_to_path / Strings::format("%s.%s", export_id, format.extension());
+            auto result = begin_archive_export(paths, raw_exported_dir_path, output_path, format);
+            pending_archives.push_back({description, std::move(output_path), std::move(result)});
+        };
+        if (opts.zip) begin_archive("zip", ArchiveFormatC::ZIP);
+        if (opts.seven_zip) begin_archive("7zip", ArchiveFormatC::SEVEN_ZIP);
 
         if (opts.raw)
         {
@@ -428,10 +675,10 @@ namespace vcpkg::Export
         {
             System::println("Creating nuget package... ");
 
-            const std::string nuget_id = opts.maybe_nuget_id.value_or(raw_exported_dir_path.filename().string());
+            const std::string nuget_id = opts.maybe_nuget_id.value_or(export_id);
             const std::string nuget_version = opts.maybe_nuget_version.value_or("1.0.0");
             const fs::path output_path =
-                do_nuget_export(paths, nuget_id, nuget_version, raw_exported_dir_path, export_to_path);
+                do_nuget_export(paths, nuget_id, nuget_version, export_plan, export_to_path);
             System::println(System::Color::success, "Creating nuget package... done");
             System::println(System::Color::success, "NuGet package exported at: %s", output_path.generic_string());
 
@@ -444,27 +691,22 @@ With a project open, go to Tools->NuGet Package Manager->Package Manager Console
                             output_path.parent_path().u8string());
         }
 
-        if (opts.zip)
+        for (PendingArchive& pending : pending_archives)
         {
-            System::println("Creating zip archive... ");
-            const fs::path output_path =
-                do_archive_export(paths, raw_exported_dir_path, export_to_path, ArchiveFormatC::ZIP);
-            System::println(System::Color::success, "Creating zip archive... done");
-            System::println(System::Color::success, "Zip archive exported at: %s", output_path.generic_string());
-            print_next_step_info("[...]");
-        }
-
-        if (opts.seven_zip)
-        {
-            System::println("Creating 7zip archive... ");
-            const fs::path output_path =
-                do_archive_export(paths, raw_exported_dir_path, export_to_path, ArchiveFormatC::SEVEN_ZIP);
-            System::println(System::Color::success, "Creating 7zip archive... done");
-            System::println(System::Color::success, "7zip archive exported at: %s", output_path.generic_string());
+            const System::ExitCodeAndOutput result = pending.result.get();
+            Checks::check_exit(VCPKG_LINE_INFO,
+                               result.exit_code == 0,
+                               "Error: %s creation failed",
+                               pending.output_path.generic_string());
+            System::println(System::Color::success, "Creating %s archive... done", pending.description);
+            System::println(System::Color::success,
+                            "%s archive exported at: %s",
+                            pending.description,
+                            pending.output_path.generic_string());
             print_next_step_info("[...]");
         }
 
-        if (!opts.raw)
+        if (needs_staged_copy && !opts.raw)
         {
             fs.remove_all(raw_exported_dir_path, ec);
         }
@@ -478,7 +720,7 @@ With a project open, go to Tools->NuGet Package Manager->Package Manager Console
 
         // create the plan
         const StatusParagraphs status_db = database_load_check(paths);
-        Dependencies::PathsPortFileProvider provider(paths);
+        Dependencies::PathsPortFileProvider provider(paths, args.overlay_ports);
         std::vector<ExportPlanAction> export_plan =
             Dependencies::create_export_plan(provider, paths, opts.specs, status_db);
         Checks::check_exit(VCPKG_LINE_INFO, !export_plan.empty(), "Export plan cannot be empty");
@@ -520,7 +762,9 @@ With a project open, go to Tools->NuGet Package Manager->Package Manager Console
             Checks::exit_success(VCPKG_LINE_INFO);
         }
 
-        std::string export_id = create_export_id();
+        // A caller-provided output name gives a stable staging directory, which is what
+        // makes the incremental re-export in handle_raw_based_export effective.
+        const std::string export_id = opts.maybe_output ? *opts.maybe_output.get() : create_export_id();
 
         if (opts.raw || opts.nuget || opts.zip || opts.seven_zip)
         {
@@ -0,0 +1,367 @@
+#include "pch.h"
+
+#include <vcpkg/base/chrono.h>
+#include <vcpkg/base/parallel.h>
+#include <vcpkg/base/system.h>
+#include <vcpkg/base/util.h>
+#include <vcpkg/gc.h>
+#include <vcpkg/help.h>
+
+#include <time.h>
+
+namespace vcpkg::GC
+{
+    // The access journal is append-only: each build or install appends one
+    // "<unix-time> <tree>/<name>" line under the mutex, and readers fold duplicate
+    // keys keeping the newest stamp. x-gc rewrites it compacted, so it stays small
+    // even on long-lived agents.
+    static fs::path access_db_path(const VcpkgPaths& paths) { return paths.buildtrees / "vcpkg_gc_access.txt"; }
+
+    static void record_access(const VcpkgPaths& paths, const std::string& key)
+    {
+        static std::mutex journal_mutex;
+        std::lock_guard<std::mutex> lock(journal_mutex);
+
+        std::error_code ec;
+        paths.get_filesystem().create_directories(paths.buildtrees, ec);
+
+        const fs::path db = access_db_path(paths);
+#if defined(_WIN32)
+        FILE* f = _wfopen(db.native().c_str(), L"ab");
+#else
+        FILE* f = fopen(db.c_str(), "ab");
+#endif
+        if (!f) return;
+        const std::string line = Strings::format("%lld %s\n", static_cast<long long>(time(nullptr)), key);
+        fwrite(line.data(), 1, line.size(), f);
+        fclose(f);
+    }
+
+    void record_buildtree_access(const VcpkgPaths& paths, const std::string& port_name)
+    {
+        record_access(paths, "buildtrees/" + port_name);
+    }
+
+    void record_package_access(const VcpkgPaths& paths, const PackageSpec& spec)
+    {
+        record_access(paths, "packages/" + spec.dir());
+    }
+
+    // The size profile mirrors the throughput store in downloads: one "<bytes>
+    // <name>_<triplet>" line per package, folded into memory on first use and
+    // rewritten whole on update (it stays tiny).
+    static std::mutex g_size_profile_mutex;
+    static std::unordered_map<std::string, uint64_t> g_size_profile;
+    static bool g_size_profile_loaded = false;
+
+    static fs::path size_profile_path(const VcpkgPaths& paths) { return paths.buildtrees / "vcpkg_size_profile.txt"; }
+
+    // Runs under g_size_profile_mutex.
+    static void load_size_profile(const Files::Filesystem& fs, const VcpkgPaths& paths)
+    {
+        if (g_size_profile_loaded) return;
+        g_size_profile_loaded = true;
+
+        const auto maybe_lines = fs.read_lines(size_profile_path(paths));
+        if (const auto lines = maybe_lines.get())
+        {
+            for (const std::string& line : *lines)
+            {
+                const size_t split = line.find(' ');
+                if (split == std::string::npos) continue;
+                g_size_profile[line.substr(split + 1)] = strtoull(line.c_str(), nullptr, 10);
+            }
+        }
+    }
+
+    void record_package_size(const VcpkgPaths& paths, const PackageSpec& spec, const uint64_t bytes)
+    {
+        if (bytes == 0) return;
+        auto& fs = paths.get_filesystem();
+
+        std::lock_guard<std::mutex> lock(g_size_profile_mutex);
+        load_size_profile(fs, paths);
+        g_size_profile[spec.dir()] = bytes;
+
+        std::string serialized;
+        for (const auto& entry : g_size_profile)
+        {
+            serialized.append(
+                Strings::format("%llu %s\n", static_cast<unsigned long long>(entry.second), entry.first));
+        }
+        std::error_code ec;
+        fs.create_directories(paths.buildtrees, ec);
+        fs.write_contents(size_profile_path(paths), serialized);
+    }
+
+    Optional<uint64_t> profiled_package_size(const VcpkgPaths& paths, const PackageSpec& spec)
+    {
+        std::lock_guard<std::mutex> lock(g_size_profile_mutex);
+        load_size_profile(paths.get_filesystem(), paths);
+
+        const auto it = g_size_profile.find(spec.dir());
+        if (it != g_size_profile.end()) return it->second;
+
+        // The same port on another triplet is a far better guess than nothing.
+        const std::string prefix = spec.name() + '_';
+        uint64_t best = 0;
+        for (const auto& entry : g_size_profile)
+        {
+            if (entry.first.compare(0, prefix.size(), prefix) == 0 && entry.second > best) best = entry.second;
+        }
+        if (best != 0) return best;
+        return nullopt;
+    }
+
+    static std::unordered_map<std::string, long long> load_access_times(const Files::Filesystem& fs,
+                                                                        const fs::path& db)
+    {
+        std::unordered_map<std::string, long long> access_times;
+        const auto maybe_lines = fs.read_lines(db);
+        if (const auto lines = maybe_lines.get())
+        {
+            for (const std::string& line : *lines)
+            {
+                const size_t split = line.find(' ');
+                if (split == std::string::npos) continue;
+                const long long stamp = strtoll(line.c_str(), nullptr, 10);
+                auto& entry = access_times[line.substr(split + 1)];
+                if (stamp > entry) entry = stamp;
+            }
+        }
+        return access_times;
+    }
+
+    // Accepts "42949672960", "500m", "40g", "1t" (binary units, case-insensitive);
+    // nullopt on anything else.
+    static Optional<uint64_t> parse_size(const std::string& text)
+    {
+        if (text.empty() || !isdigit(static_cast<unsigned char>(text[0]))) return nullopt;
+        char* suffix = nullptr;
+        const unsigned long long value = strtoull(text.c_str(), &suffix, 10);
+        uint64_t multiplier = 1;
+        switch (tolower(static_cast<unsigned char>(*suffix)))
+        {
+            case '\0': return value;
+            case 'k': multiplier = 1024ull; break;
+            case 'm': multiplier = 1024ull * 1024; break;
+            case 'g': multiplier = 1024ull * 1024 * 1024; break;
+            case 't': multiplier = 1024ull * 1024 * 1024 * 1024; break;
+            default: return nullopt;
+        }
+        if (suffix[1] != '\0' && tolower(static_cast<unsigned char>(suffix[1])) != 'b') return nullopt;
+        return value * multiplier;
+    }
+
+    std::string format_size(const uint64_t bytes)
+    {
+        if (bytes >= 1024ull * 1024 * 1024) return Strings::format("%.1f GiB", bytes / (1024.0 * 1024 * 1024));
+        if (bytes >= 1024ull * 1024) return Strings::format("%.1f MiB", bytes / (1024.0 * 1024));
+        return Strings::format("%llu bytes", static_cast<unsigned long long>(bytes));
+    }
+
+    struct TreeEntry
+    {
+        fs::path path;
+        std::string key;
+        uint64_t size = 0;
+        long long last_access = 0;
+    };
+
+    // Every candidate in buildtrees/ and packages/, sized in parallel (sizing walks
+    // every file in both trees). Entries without an access stamp predate tracking
+    // and keep last_access 0, making them the stalest candidates rather than
+    // guessing from platform-dependent filesystem timestamps.
+    static std::vector<TreeEntry> collect_entries(const VcpkgPaths& paths,
+                                                  const std::unordered_map<std::string, long long>& access_times)
+    {
+        auto& fs = paths.get_filesystem();
+        std::vector<TreeEntry> entries;
+        const std::pair<const fs::path*, const char*> trees[] = {
+            {&paths.buildtrees, "buildtrees"},
+            {&paths.packages, "packages"},
+        };
+        for (const auto& tree : trees)
+        {
+            if (!fs.is_directory(*tree.first)) continue;
+            for (fs::path& entry_path : fs.get_files_non_recursive(*tree.first))
+            {
+                const std::string filename = entry_path.filename().u8string();
+                // The sidecars vcpkg keeps under buildtrees (the access journal, the
+                // size profile, the port hash cache) are not eviction candidates.
+                if (filename.compare(0, 6, "vcpkg_") == 0) continue;
+                TreeEntry entry;
+                entry.key = std::string(tree.second) + '/' + filename;
+                const auto it = access_times.find(entry.key);
+                if (it != access_times.end()) entry.last_access = it->second;
+                entry.path = std::move(entry_path);
+                entries.push_back(std::move(entry));
+            }
+        }
+
+        Parallel::for_each_index(entries.size(), [&](const size_t i) {
+            std::error_code ec;
+            if (fs.is_directory(entries[i].path))
+            {
+                uint64_t total = 0;
+                for (const fs::path& file : fs.get_files_recursive(entries[i].path))
+                {
+                    const auto size = fs.file_size(file, ec);
+                    if (!ec) total += size;
+                }
+                entries[i].size = total;
+            }
+            else
+            {
+                const auto size = fs.file_size(entries[i].path, ec);
+                if (!ec) entries[i].size = size;
+            }
+        });
+        return entries;
+    }
+
+    // Least recently used first; among equally stale entries the largest, so fewer
+    // deletions reach the target.
+    static bool eviction_order(const TreeEntry& lhs, const TreeEntry& rhs)
+    {
+        if (lhs.last_access != rhs.last_access) return lhs.last_access < rhs.last_access;
+        return lhs.size > rhs.size;
+    }
+
+    // Rewrites the access journal down to the entries past the first `victim_count`
+    // of the sorted list (everything before them was evicted).
+    static void compact_journal(Files::Filesystem& fs,
+                                const VcpkgPaths& paths,
+                                const std::vector<TreeEntry>& entries,
+                                const size_t victim_count,
+                                const std::unordered_map<std::string, long long>& access_times)
+    {
+        std::string compacted;
+        for (size_t i = victim_count; i < entries.size(); ++i)
+        {
+            const auto it = access_times.find(entries[i].key);
+            if (it == access_times.end()) continue;
+            compacted.append(Strings::format("%lld %s\n", it->second, entries[i].key));
+        }
+        fs.write_contents(access_db_path(paths), compacted);
+    }
+
+    uint64_t try_free_bytes(const VcpkgPaths& paths, const uint64_t bytes_needed)
+    {
+        auto& fs = paths.get_filesystem();
+        const auto access_times = load_access_times(fs, access_db_path(paths));
+        std::vector<TreeEntry> entries = collect_entries(paths, access_times);
+        std::sort(entries.begin(), entries.end(), eviction_order);
+
+        uint64_t freed = 0;
+        size_t victim_count = 0;
+        while (victim_count < entries.size() && freed < bytes_needed)
+            freed += entries[victim_count++].size;
+
+        Parallel::for_each_index(victim_count, [&](const size_t i) {
+            std::error_code ec;
+            fs.remove_all(entries[i].path, ec);
+        });
+        compact_journal(fs, paths, entries, victim_count, access_times);
+        return freed;
+    }
+
+    static const std::string OPTION_TARGET_SIZE = "--target-size";
+    static const std::string OPTION_DRY_RUN = "--dry-run";
+
+    static const std::array<CommandSwitch, 1> GC_SWITCHES = {{
+        {OPTION_DRY_RUN, "Print what would be removed without removing anything"},
+    }};
+
+    static const std::array<CommandSetting, 1> GC_SETTINGS = {{
+        {OPTION_TARGET_SIZE, "Evict until buildtrees/ and packages/ total at most this size, e.g. 40g"},
+    }};
+
+    const CommandStructure COMMAND_STRUCTURE = {
+        Help::create_example_string("x-gc --target-size=40g"),
+        0,
+        0,
+        {GC_SWITCHES, GC_SETTINGS},
+        nullptr,
+    };
+
+    void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths)
+    {
+        const ParsedArguments options = args.parse_arguments(COMMAND_STRUCTURE);
+        const bool dry_run = Util::Sets::contains(options.switches, OPTION_DRY_RUN);
+
+        const auto it_target = options.settings.find(OPTION_TARGET_SIZE);
+        Checks::check_exit(VCPKG_LINE_INFO, it_target != options.settings.end(), "x-gc requires --target-size");
+        const auto maybe_target = parse_size(it_target->second);
+        Checks::check_exit(
+            VCPKG_LINE_INFO, maybe_target.has_value(), "Could not parse size: %s", it_target->second);
+        const uint64_t target = *maybe_target.get();
+
+        const auto timer = Chrono::ElapsedTimer::create_started();
+        auto& fs = paths.get_filesystem();
+        const auto access_times = load_access_times(fs, access_db_path(paths));
+        std::vector<TreeEntry> entries = collect_entries(paths, access_times);
+
+        uint64_t total = 0;
+        for (const TreeEntry& entry : entries)
+            total += entry.size;
+
+        if (total <= target)
+        {
+            System::println("buildtrees/ and packages/ total %s, within the %s target; nothing to do.",
+                            format_size(total),
+                            format_size(target));
+            Checks::exit_success(VCPKG_LINE_INFO);
+        }
+
+        std::sort(entries.begin(), entries.end(), eviction_order);
+
+        std::vector<TreeEntry> victims;
+        uint64_t remaining = total;
+        for (TreeEntry& entry : entries)
+        {
+            if (remaining <= target) break;
+            remaining -= entry.size;
+            victims.push_back(std::move(entry));
+        }
+
+        if (dry_run)
+        {
+            for (const TreeEntry& victim : victims)
+            {
+                System::println("Would remove %s (%s)", victim.key, format_size(victim.size));
+            }
+            System::println("Would free %s, leaving %s (target %s)",
+                            format_size(total - remaining),
+                            format_size(remaining),
+                            format_size(target));
+            Checks::exit_success(VCPKG_LINE_INFO);
+        }
+
+        // The trees being evicted are independent, so deletion parallelizes cleanly;
+        // serial removal is what made the ad-hoc cleanup scripts take an hour.
+        std::atomic<size_t> failures(0);
+        Parallel::for_each_index(victims.size(), [&](const size_t i) {
+            std::error_code ec;
+            fs.remove_all(victims[i].path, ec);
+            if (ec)
+            {
+                System::println(
+                    System::Color::warning, "Failed to remove %s: %s", victims[i].path.u8string(), ec.message());
+                ++failures;
+            }
+        });
+
+        compact_journal(fs, paths, entries, victims.size(), access_times);
+
+        System::println("Removed %zu of %zu entries, freed %s in %d ms; %s remains (target %s)",
+                        victims.size() - failures.load(),
+                        entries.size(),
+                        format_size(total - remaining),
+                        static_cast<int>(timer.microseconds() / 1000),
+                        format_size(remaining),
+                        format_size(target));
+        Checks::check_exit(VCPKG_LINE_INFO, failures == 0, "%zu entries could not be removed", failures.load());
+        Checks::exit_success(VCPKG_LINE_INFO);
+    }
+}
@@ -7,8 +7,16 @@ namespace vcpkg
     Util::LockGuarded<Chrono::ElapsedTimer> GlobalState::timer;
     Util::LockGuarded<std::string> GlobalState::g_surveydate;
 
+    RelaxedCounter GlobalState::g_installed_file_count;
+    RelaxedCounter GlobalState::g_removed_file_count;
+
     std::atomic<bool> GlobalState::debugging(false);
     std::atomic<bool> GlobalState::feature_packages(false);
+    std::atomic<bool> GlobalState::g_use_hard_links(false);
+    std::atomic<bool> GlobalState::g_use_content_store(false);
+    std::atomic<bool> GlobalState::g_compress_packages(false);
+    std::atomic<bool> GlobalState::g_compress_logs(false);
+    std::atomic<bool> GlobalState::g_cache_failed_builds(false);
 
     std::atomic<int> GlobalState::g_init_console_cp(0);
     std::atomic<int> GlobalState::g_init_console_output_cp(0);
@@ -1,11 +1,19 @@
 #include "pch.h"
 
+#include <vcpkg/base/allocstats.h>
+#include <vcpkg/base/corebudget.h>
 #include <vcpkg/base/files.h>
+#include <vcpkg/base/hash.h>
+#include <vcpkg/base/parallel.h>
+#include <vcpkg/base/progress.h>
 #include <vcpkg/base/system.h>
+#include <vcpkg/base/timing.h>
 #include <vcpkg/base/util.h>
 #include <vcpkg/build.h>
 #include <vcpkg/commands.h>
 #include <vcpkg/dependencies.h>
+#include <vcpkg/gc.h>
+#include <vcpkg/downloads.h>
 #include <vcpkg/globalstate.h>
 #include <vcpkg/help.h>
 #include <vcpkg/input.h>
@@ -15,6 +23,9 @@
 #include <vcpkg/remove.h>
 #include <vcpkg/vcpkglib.h>
 
+#include <condition_variable>
+#include <deque>
+
 namespace vcpkg::Install
 {
     using namespace Dependencies;
@@ -36,11 +47,16 @@ namespace vcpkg::Install
 
     const fs::path& InstallDir::listfile() const { return this->m_listfile; }
 
+    void install_files_and_write_listfile(Files::Filesystem& fs, const fs::path& source_dir, const InstallDir& dirs)
+    {
+        install_files_and_write_listfile(fs, source_dir, dirs, PreferHardLinks::NO);
+    }
+
     void install_files_and_write_listfile(Files::Filesystem& fs,
                                           const fs::path& source_dir,
-                                          const InstallDir& destination_dir)
+                                          const InstallDir& destination_dir,
+                                          const PreferHardLinks prefer_hard_links)
     {
-        std::vector<std::string> output;
         std::error_code ec;
 
         const size_t prefix_length = source_dir.native().size();
@@ -48,37 +64,45 @@ namespace vcpkg::Install
         const std::string& destination_subdirectory = destination_dir.destination_subdirectory();
         const fs::path& listfile = destination_dir.listfile();
 
-        Checks::check_exit(
-            VCPKG_LINE_INFO, fs.exists(source_dir), "Source directory %s does not exist", source_dir.generic_string());
+        Checks::check_exit(VCPKG_LINE_INFO, fs.exists(source_dir), [&] {
+            return Strings::format("Source directory %s does not exist", source_dir.generic_string());
+        });
         fs.create_directories(destination, ec);
-        Checks::check_exit(
-            VCPKG_LINE_INFO, !ec, "Could not create destination directory %s", destination.generic_string());
+        Checks::check_exit(VCPKG_LINE_INFO, !ec, [&] {
+            return Strings::format("Could not create destination directory %s", destination.generic_string());
+        });
         const fs::path listfile_parent = listfile.parent_path();
         fs.create_directories(listfile_parent, ec);
-        Checks::check_exit(
-            VCPKG_LINE_INFO, !ec, "Could not create directory for listfile %s", listfile.generic_string());
+        Checks::check_exit(VCPKG_LINE_INFO, !ec, [&] {
+            return Strings::format("Could not create directory for listfile %s", listfile.generic_string());
+        });
 
-        output.push_back(Strings::format(R"(%s/)", destination_subdirectory));
-        auto files = fs.get_files_recursive(source_dir);
-        for (auto&& file : files)
-        {
-            const auto status = fs.status(file, ec);
-            if (ec)
-            {
-                System::println(System::Color::error, "failed: %s: %s", file.u8string(), ec.message());
-                continue;
-            }
+        ListfileWriter listfile_writer(fs, listfile);
+        listfile_writer.write_path(Strings::format(R"(%s/)", destination_subdirectory));
 
+        // First pass: create the directory skeleton in traversal order (parents precede
+        // children), write the listfile, and queue the regular files for copying.
+        struct FileToInstall
+        {
+            fs::path source;
+            fs::path target;
+            std::string warning;
+            std::string error;
+        };
+        std::vector<FileToInstall> files_to_install;
+        std::string listfile_line;
+        Files::PathBuilder make_target(destination);
+        fs.for_each_file_recursive(source_dir, [&](const fs::path& file, const fs::file_status status) {
             const std::string filename = file.filename().generic_string();
             if (fs::is_regular_file(status) && (Strings::case_insensitive_ascii_equals(filename.c_str(), "CONTROL") ||
                                                 Strings::case_insensitive_ascii_equals(filename.c_str(), "BUILD_INFO")))
             {
                 // Do not copy the control file
-                continue;
+                return;
             }
 
             const std::string suffix = file.generic_u8string().substr(prefix_length + 1);
-            const fs::path target = destination / suffix;
+            const fs::path target = make_target(suffix);
 
             if (fs::is_directory(status))
             {
@@ -89,40 +113,124 @@ namespace vcpkg::Install
                 }
 
                 // Trailing backslash for directories
-                output.push_back(Strings::format(R"(%s/%s/)", destination_subdirectory, suffix));
-                continue;
+                listfile_line.clear();
+                Strings::format_to(listfile_line, R"(%s/%s/)", destination_subdirectory, suffix);
+                listfile_writer.write_path(listfile_line);
+                return;
             }
 
             if (fs::is_regular_file(status))
             {
-                if (fs.exists(target))
-                {
-                    System::println(System::Color::warning,
-                                    "File %s was already present and will be overwritten",
-                                    target.u8string(),
-                                    ec.message());
-                }
-                fs.copy_file(file, target, fs::copy_options::overwrite_existing, ec);
-                if (ec)
-                {
-                    System::println(System::Color::error, "failed: %s: %s", target.u8string(), ec.message());
-                }
-                output.push_back(Strings::format(R"(%s/%s)", destination_subdirectory, suffix));
-                continue;
+                files_to_install.push_back({file, target, {}, {}});
+                listfile_line.clear();
+                Strings::format_to(listfile_line, R"(%s/%s)", destination_subdirectory, suffix);
+                listfile_writer.write_path(listfile_line);
+                return;
             }
 
             if (!fs::status_known(status))
             {
                 System::println(System::Color::error, "failed: %s: unknown status", file.u8string());
-                continue;
+                return;
             }
 
             System::println(System::Color::error, "failed: %s: cannot handle file type", file.u8string());
-        }
+        });
 
-        std::sort(output.begin(), output.end());
+        // Second pass: fan the file copies across workers. Copying many small files is
+        // bound by per-file syscall latency, so several in flight keep the disk queue
+        // full. Diagnostics are recorded per file and printed after the join so the
+        // output stays deterministic.
+        std::atomic<bool> use_hard_links(GlobalState::g_use_hard_links.load() ||
+                                         prefer_hard_links == PreferHardLinks::YES);
+        const bool use_content_store = GlobalState::g_use_content_store.load();
+        // <root>/store; destination is <root>/installed/<triplet>.
+        const fs::path content_store_root = destination.parent_path().parent_path() / "store";
+
+        // Content-addressed deduplication: each file is stored once under its SHA-256 and
+        // every installed tree hardlinks into the store, so identical headers and data
+        // files shared between triplets occupy disk once. Returns false when the file
+        // cannot be deduplicated (hashing failed, cross-volume store, ...), in which case
+        // the regular link/copy path below runs.
+        const auto link_from_content_store = [&](const FileToInstall& entry) -> bool {
+            const auto maybe_hash = vcpkg::Hash::get_file_hash(fs, entry.source, "SHA256");
+            const auto hash = maybe_hash.get();
+            if (!hash) return false;
+
+            const fs::path store_entry = content_store_root / hash->substr(0, 2) / *hash;
+            if (!fs.exists(store_entry))
+            {
+                std::error_code store_ec;
+                fs.create_directories(store_entry.parent_path(), store_ec);
+                fs.create_hard_link(entry.source, store_entry, store_ec);
+                // A racing worker may have created the entry; a cross-volume packages
+                // tree cannot be linked and is copied into the store instead.
+                if (store_ec && !fs.exists(store_entry))
+                {
+                    std::error_code copy_to_store_ec;
+                    fs.copy_file(entry.source, store_entry, fs::copy_options::none, copy_to_store_ec);
+                    if (copy_to_store_ec && !fs.exists(store_entry)) return false;
+                }
+            }
+
+            std::error_code link_ec;
+            if (fs.exists(entry.target)) fs.remove(entry.target, link_ec);
+            fs.create_hard_link(store_entry, entry.target, link_ec);
+            return !link_ec;
+        };
 
-        fs.write_lines(listfile, output);
+        Parallel::for_each_index(files_to_install.size(), [&](const size_t i) {
+            std::error_code copy_ec;
+            FileToInstall& entry = files_to_install[i];
+            if (fs.exists(entry.target))
+            {
+                entry.warning =
+                    Strings::format("File %s was already present and will be overwritten", entry.target.u8string());
+            }
+            bool linked = false;
+            if (use_content_store)
+            {
+                linked = link_from_content_store(entry);
+            }
+            if (!linked && use_hard_links)
+            {
+                fs.create_hard_link(entry.source, entry.target, copy_ec);
+                if (copy_ec)
+                {
+                    // Not all filesystems support hard links from the packages tree;
+                    // fall back to copying for the rest of this package.
+                    use_hard_links = false;
+                }
+                else
+                {
+                    linked = true;
+                }
+            }
+            if (!linked)
+            {
+                fs.copy_file(entry.source, entry.target, fs::copy_options::overwrite_existing, copy_ec);
+                if (copy_ec)
+                {
+                    entry.error = Strings::format("failed: %s: %s", entry.target.u8string(), copy_ec.message());
+                    return;
+                }
+            }
+            GlobalState::g_installed_file_count.increment();
+        });
+
+        for (const FileToInstall& entry : files_to_install)
+        {
+            if (!entry.warning.empty())
+            {
+                System::println(System::Color::warning, entry.warning);
+            }
+            if (!entry.error.empty())
+            {
+                System::println(System::Color::error, entry.error);
+            }
+        }
+
+        listfile_writer.flush();
     }
 
     static void remove_first_n_chars(std::vector<std::string>* strings, const size_t n)
@@ -175,9 +283,147 @@ namespace vcpkg::Install
         return SortedVector<std::string>(std::move(installed_files));
     }
 
+    // Intersects the file lists of already-built packages in the plan against the files
+    // owned by currently-installed packages, so a plan that would fail with
+    // FILE_CONFLICTS at install time is rejected before any builds start. Packages this
+    // plan removes are not counted as owners, since their files will be gone by the time
+    // the conflicting package installs. Packages that still need building are covered by
+    // the per-package check in install_package once their file lists exist.
+    static void check_plan_for_file_conflicts(const VcpkgPaths& paths,
+                                              const std::vector<AnyAction>& action_plan,
+                                              const StatusParagraphs& status_db)
+    {
+        std::unordered_set<PackageSpec> removed_specs;
+        for (const AnyAction& action : action_plan)
+        {
+            if (const auto remove_action = action.remove_action.get())
+            {
+                removed_specs.insert(remove_action->spec);
+            }
+        }
+
+        std::vector<StatusParagraphAndAssociatedFiles> pgh_and_files = get_installed_files(paths, status_db);
+        Util::erase_remove_if(pgh_and_files, [&](const StatusParagraphAndAssociatedFiles& t) {
+            return removed_specs.find(t.pgh.package.spec) != removed_specs.end();
+        });
+
+        std::map<std::string, SortedVector<std::string>> installed_files_per_triplet;
+
+        bool conflicts_found = false;
+        for (const AnyAction& action : action_plan)
+        {
+            const auto install_action = action.install_action.get();
+            if (!install_action || install_action->plan_type != InstallPlanType::INSTALL) continue;
+
+            const Triplet& triplet = install_action->spec.triplet();
+            auto it = installed_files_per_triplet.find(triplet.canonical_name());
+            if (it == installed_files_per_triplet.end())
+            {
+                it = installed_files_per_triplet
+                         .emplace(triplet.canonical_name(), build_list_of_installed_files(pgh_and_files, triplet))
+                         .first;
+            }
+
+            const SortedVector<std::string> package_files =
+                build_list_of_package_files(paths.get_filesystem(), paths.package_dir(install_action->spec));
+
+            std::vector<std::string> intersection;
+            std::set_intersection(package_files.begin(),
+                                  package_files.end(),
+                                  it->second.begin(),
+                                  it->second.end(),
+                                  std::back_inserter(intersection));
+
+            if (!intersection.empty())
+            {
+                const fs::path triplet_install_path = paths.installed / triplet.canonical_name();
+                System::println(System::Color::error,
+                                "The following files are already installed in %s and are in conflict with %s",
+                                triplet_install_path.generic_string(),
+                                install_action->spec);
+                System::print("\n    ");
+                System::println(Strings::join("\n    ", intersection));
+                System::println();
+                conflicts_found = true;
+            }
+        }
+
+        if (conflicts_found)
+        {
+            Checks::exit_with_message(
+                VCPKG_LINE_INFO, "Refusing to continue: the plan would fail with FILE_CONFLICTS at install time");
+        }
+    }
+
+    // Transaction journal for crash recovery: one "BEGIN <spec>" line is appended before a
+    // package's status entries go half-installed and one "COMMIT <spec>" line after they are
+    // fully installed. A BEGIN without a matching COMMIT identifies the single in-flight
+    // package after a crash, so recovery rolls back just that package instead of auditing
+    // the whole installed tree.
+    static fs::path install_journal_path(const VcpkgPaths& paths) { return paths.vcpkg_dir / "install-journal.txt"; }
+
+    static void recover_incomplete_installs(const VcpkgPaths& paths, StatusParagraphs& status_db)
+    {
+        auto& fs = paths.get_filesystem();
+        const fs::path journal_path = install_journal_path(paths);
+        const auto maybe_lines = fs.read_lines(journal_path);
+        const auto lines = maybe_lines.get();
+        if (!lines) return;
+
+        std::vector<std::string> in_flight;
+        for (const std::string& line : *lines)
+        {
+            const size_t space = line.find(' ');
+            if (space == std::string::npos) continue;
+            const std::string op = line.substr(0, space);
+            const std::string spec_string = line.substr(space + 1);
+            if (op == "BEGIN")
+                in_flight.push_back(spec_string);
+            else if (op == "COMMIT")
+                Util::erase_remove_if(in_flight, [&](const std::string& s) { return s == spec_string; });
+        }
+
+        for (const std::string& spec_string : in_flight)
+        {
+            const size_t colon = spec_string.rfind(':');
+            if (colon == std::string::npos) continue;
+            const auto maybe_spec = PackageSpec::from_name_and_triplet(
+                spec_string.substr(0, colon), Triplet::from_canonical_name(spec_string.substr(colon + 1)));
+            const auto spec = maybe_spec.get();
+            if (!spec) continue;
+
+            const auto it = status_db.find(spec->name(), spec->triplet());
+            // No status entry means the crash happened before anything was recorded; an
+            // INSTALLED entry means the install finished but the crash beat the COMMIT line.
+            // Only a half-installed package needs rolling back.
+            if (it == status_db.end()) continue;
+            if ((**it).state != InstallState::HALF_INSTALLED) continue;
+
+            System::println(
+                System::Color::warning, "Rolling back interrupted installation of %s...", spec_string);
+            Remove::remove_package(paths, *spec, &status_db);
+        }
+
+        fs.write_contents(journal_path, "");
+    }
+
     InstallResult install_package(const VcpkgPaths& paths, const BinaryControlFile& bcf, StatusParagraphs* status_db)
     {
+        Timing::PhaseScope timing_scope("install " + bcf.core_paragraph.spec.to_string());
+
         const fs::path package_dir = paths.package_dir(bcf.core_paragraph.spec);
+        GC::record_package_access(paths, bcf.core_paragraph.spec);
+        {
+            // Feed the preflight's per-port size profile with the measured package.
+            uint64_t package_bytes = 0;
+            std::error_code size_ec;
+            for (const fs::path& file : paths.get_filesystem().get_files_recursive(package_dir))
+            {
+                const auto size = paths.get_filesystem().file_size(file, size_ec);
+                if (!size_ec) package_bytes += size;
+            }
+            GC::record_package_size(paths, bcf.core_paragraph.spec, package_bytes);
+        }
         const Triplet& triplet = bcf.core_paragraph.spec.triplet();
         const std::vector<StatusParagraphAndAssociatedFiles> pgh_and_files = get_installed_files(paths, *status_db);
 
@@ -205,14 +451,14 @@ namespace vcpkg::Install
             return InstallResult::FILE_CONFLICTS;
         }
 
+        paths.get_filesystem().append_contents(install_journal_path(paths),
+                                               "BEGIN " + bcf.core_paragraph.spec.to_string() + "\n");
+
         StatusParagraph source_paragraph;
         source_paragraph.package = bcf.core_paragraph;
         source_paragraph.want = Want::INSTALL;
         source_paragraph.state = InstallState::HALF_INSTALLED;
 
-        write_update(paths, source_paragraph);
-        status_db->insert(std::make_unique<StatusParagraph>(source_paragraph));
-
         std::vector<StatusParagraph> features_spghs;
         for (auto&& feature : bcf.features)
         {
@@ -222,8 +468,22 @@ namespace vcpkg::Install
             feature_paragraph.package = feature;
             feature_paragraph.want = Want::INSTALL;
             feature_paragraph.state = InstallState::HALF_INSTALLED;
+        }
+
+        // The core and feature paragraphs always transition together, so each state is
+        // journaled as one batched flush instead of one write per paragraph. The
+        // half-installed flush stays: crash recovery depends on finding it on disk.
+        std::vector<const StatusParagraph*> update_batch;
+        update_batch.push_back(&source_paragraph);
+        for (auto&& feature_paragraph : features_spghs)
+        {
+            update_batch.push_back(&feature_paragraph);
+        }
 
-            write_update(paths, feature_paragraph);
+        write_updates(paths, update_batch);
+        status_db->insert(std::make_unique<StatusParagraph>(source_paragraph));
+        for (auto&& feature_paragraph : features_spghs)
+        {
             status_db->insert(std::make_unique<StatusParagraph>(feature_paragraph));
         }
 
@@ -233,22 +493,53 @@ namespace vcpkg::Install
         install_files_and_write_listfile(paths.get_filesystem(), package_dir, install_dir);
 
         source_paragraph.state = InstallState::INSTALLED;
-        write_update(paths, source_paragraph);
-        status_db->insert(std::make_unique<StatusParagraph>(source_paragraph));
-
         for (auto&& feature_paragraph : features_spghs)
         {
             feature_paragraph.state = InstallState::INSTALLED;
-            write_update(paths, feature_paragraph);
+        }
+
+        write_updates(paths, update_batch);
+        status_db->insert(std::make_unique<StatusParagraph>(source_paragraph));
+        for (auto&& feature_paragraph : features_spghs)
+        {
             status_db->insert(std::make_unique<StatusParagraph>(feature_paragraph));
         }
 
+        paths.get_filesystem().append_contents(install_journal_path(paths),
+                                               "COMMIT " + bcf.core_paragraph.spec.to_string() + "\n");
+
+        if (GlobalState::g_compress_packages &&
+            paths.get_filesystem().exists(Build::package_archive_path(paths, bcf.core_paragraph.spec)))
+        {
+            // The compressed archive is the package of record; drop the expanded
+            // staging tree now that its files are installed.
+            std::error_code compress_ec;
+            paths.get_filesystem().remove_all(package_dir, compress_ec);
+        }
+
         return InstallResult::SUCCESS;
     }
 
     using Build::BuildResult;
     using Build::ExtendedBuildResult;
 
+    static BuildResult aux_install(const VcpkgPaths& paths,
+                                   const std::string& name,
+                                   const BinaryControlFile& bcf,
+                                   StatusParagraphs& status_db)
+    {
+        System::println("Installing package %s... ", name);
+        const auto install_result = install_package(paths, bcf, &status_db);
+        switch (install_result)
+        {
+            case InstallResult::SUCCESS:
+                System::println(System::Color::success, "Installing package %s... done", name);
+                return BuildResult::SUCCEEDED;
+            case InstallResult::FILE_CONFLICTS: return BuildResult::FILE_CONFLICTS;
+            default: Checks::unreachable(VCPKG_LINE_INFO);
+        }
+    }
+
     ExtendedBuildResult perform_install_plan_action(const VcpkgPaths& paths,
                                                     const InstallPlanAction& action,
                                                     StatusParagraphs& status_db)
@@ -271,19 +562,6 @@ namespace vcpkg::Install
             return BuildResult::SUCCEEDED;
         }
 
-        auto aux_install = [&](const std::string& name, const BinaryControlFile& bcf) -> BuildResult {
-            System::println("Installing package %s... ", name);
-            const auto install_result = install_package(paths, bcf, &status_db);
-            switch (install_result)
-            {
-                case InstallResult::SUCCESS:
-                    System::println(System::Color::success, "Installing package %s... done", name);
-                    return BuildResult::SUCCEEDED;
-                case InstallResult::FILE_CONFLICTS: return BuildResult::FILE_CONFLICTS;
-                default: Checks::unreachable(VCPKG_LINE_INFO);
-            }
-        };
-
         if (plan_type == InstallPlanType::BUILD_AND_INSTALL)
         {
             if (use_head_version)
@@ -291,9 +569,12 @@ namespace vcpkg::Install
             else
                 System::println("Building package %s... ", display_name_with_features);
 
+            Progress::TaskScope progress(display_name_with_features);
+            progress.set_phase("build");
+
             auto result = [&]() -> Build::ExtendedBuildResult {
                 const Build::BuildPackageConfig build_config{
-                    *action.any_paragraph.source_control_file.value_or_exit(VCPKG_LINE_INFO),
+                    action.any_paragraph.source_control_file_or_exit(VCPKG_LINE_INFO),
                     action.spec.triplet(),
                     paths.port_dir(action.spec),
                     action.build_options,
@@ -308,10 +589,11 @@ namespace vcpkg::Install
             }
 
             System::println("Building package %s... done", display_name_with_features);
+            progress.set_phase("install");
 
             auto bcf = std::make_unique<BinaryControlFile>(
                 Paragraphs::try_load_cached_control_package(paths, action.spec).value_or_exit(VCPKG_LINE_INFO));
-            auto code = aux_install(display_name_with_features, *bcf);
+            auto code = aux_install(paths, display_name_with_features, *bcf, status_db);
             return {code, std::move(bcf)};
         }
 
@@ -322,8 +604,10 @@ namespace vcpkg::Install
                 System::println(
                     System::Color::warning, "Package %s is already built -- not building from HEAD", display_name);
             }
-            auto code = aux_install(display_name_with_features,
-                                    action.any_paragraph.binary_control_file.value_or_exit(VCPKG_LINE_INFO));
+            auto code = aux_install(paths,
+                                    display_name_with_features,
+                                    action.any_paragraph.binary_control_file_or_exit(VCPKG_LINE_INFO),
+                                    status_db);
             return code;
         }
 
@@ -363,17 +647,438 @@ namespace vcpkg::Install
         }
     }
 
+    // Durations of past builds, keyed by "port:triplet" and stored in milliseconds.
+    // The parallel installer dispatches the longest-building ready package first (a
+    // critical-path heuristic), so a slow build is not left for last while the other
+    // workers sit idle.
+    static fs::path build_duration_profile_path(const VcpkgPaths& paths)
+    {
+        return paths.root / "archives" / "build-durations.txt";
+    }
+
+    // Peak memory of past builds, keyed and stored like the duration profile but in
+    // bytes. Only recorded on platforms that can observe the build's process tree.
+    static fs::path build_memory_profile_path(const VcpkgPaths& paths)
+    {
+        return paths.root / "archives" / "build-memory.txt";
+    }
+
+    static std::map<std::string, long long> load_keyed_profile(const Files::Filesystem& fs, const fs::path& path)
+    {
+        std::map<std::string, long long> values;
+        auto maybe_lines = fs.read_lines(path);
+        if (const auto lines = maybe_lines.get())
+        {
+            for (const std::string& line : *lines)
+            {
+                const size_t separator = line.rfind(' ');
+                if (separator == std::string::npos || separator == 0) continue;
+                values[line.substr(0, separator)] = std::strtoll(line.c_str() + separator + 1, nullptr, 10);
+            }
+        }
+        return values;
+    }
+
+    static void save_keyed_profile(Files::Filesystem& fs,
+                                   const fs::path& path,
+                                   const std::map<std::string, long long>& values)
+    {
+        std::string contents;
+        for (const auto& entry : values)
+        {
+            contents.append(Strings::format("%s %lld\n", entry.first, entry.second));
+        }
+
+        std::error_code ec;
+        fs.create_directories(path.parent_path(), ec);
+        if (ec) return;
+        fs.write_contents(path, contents);
+    }
+
+    static void record_build_duration(std::map<std::string, long long>& durations,
+                                      const AnyAction& action,
+                                      const Chrono::ElapsedTime& timing)
+    {
+        if (const auto install_action = action.install_action.get())
+        {
+            if (install_action->plan_type == InstallPlanType::BUILD_AND_INSTALL)
+            {
+                durations[action.spec().to_string()] =
+                    timing.as<std::chrono::milliseconds>().count();
+            }
+        }
+    }
+
+    // Keeps the high-water mark across runs: working sets vary with build inputs, and
+    // underestimating a peak is what makes agents thrash.
+    static void record_build_memory(std::map<std::string, long long>& memory,
+                                    const AnyAction& action,
+                                    const long long peak_bytes)
+    {
+        auto& slot = memory[action.spec().to_string()];
+        if (peak_bytes > slot) slot = peak_bytes;
+    }
+
+    // Executes the build phase of a BUILD_AND_INSTALL action on a worker thread. The
+    // scheduler has already verified the dependencies, so this must not touch the status
+    // database or the installed tree.
+    static ExtendedBuildResult build_action_on_worker(const VcpkgPaths& paths, const InstallPlanAction& action)
+    {
+        const Build::BuildPackageConfig build_config{
+            action.any_paragraph.source_control_file_or_exit(VCPKG_LINE_INFO),
+            action.spec.triplet(),
+            paths.port_dir(action.spec),
+            action.build_options,
+            action.feature_list};
+        auto result = Build::build_package(paths, build_config);
+        if (result.code != BuildResult::SUCCEEDED) return result;
+
+        auto bcf = std::make_unique<BinaryControlFile>(
+            Paragraphs::try_load_cached_control_package(paths, action.spec).value_or_exit(VCPKG_LINE_INFO));
+        return {BuildResult::SUCCEEDED, std::move(bcf)};
+    }
+
+    static InstallSummary perform_parallel(const std::vector<AnyAction>& action_plan,
+                                           const KeepGoing keep_going,
+                                           const VcpkgPaths& paths,
+                                           StatusParagraphs& status_db,
+                                           const size_t concurrency)
+    {
+        const auto timer = Chrono::ElapsedTimer::create_started();
+        const size_t package_count = action_plan.size();
+
+        // Split the usable cores (after any container CPU caps) between the
+        // concurrent builds so each child build tool does not assume it owns the
+        // whole machine.
+        CoreBudget::initialize(System::get_cpu_topology().effective_cores, concurrency);
+
+        std::map<std::string, long long> build_durations =
+            load_keyed_profile(paths.get_filesystem(), build_duration_profile_path(paths));
+        std::map<std::string, long long> build_memory =
+            load_keyed_profile(paths.get_filesystem(), build_memory_profile_path(paths));
+
+        // Admit builds only while their predicted peaks fit in physical memory, so two
+        // memory-hungry ports are serialized instead of thrashing the machine.
+        // Unprofiled ports are assumed to take an even share of the budget.
+        const long long memory_budget = System::get_physical_memory_bytes();
+        const long long default_memory_estimate =
+            memory_budget > 0 ? memory_budget / static_cast<long long>(concurrency) : 0;
+        const auto expected_memory = [&](const size_t i) -> long long {
+            const auto it = build_memory.find(action_plan[i].spec().to_string());
+            return it != build_memory.end() && it->second > 0 ? it->second : default_memory_estimate;
+        };
+        long long memory_in_flight = 0;
+        size_t builds_in_flight = 0;
+        std::vector<long long> admitted_memory(package_count, 0);
+
+        // Unprofiled packages are treated as the longest so a first-time build of an
+        // unknown (potentially huge) port is started as early as possible.
+        const auto expected_duration = [&](const size_t i) -> long long {
+            const auto it = build_durations.find(action_plan[i].spec().to_string());
+            return it != build_durations.end() ? it->second : std::numeric_limits<long long>::max();
+        };
+
+        enum class ActionState
+        {
+            NOT_STARTED,
+            BUILDING,
+            DONE
+        };
+
+        std::vector<ActionState> states(package_count, ActionState::NOT_STARTED);
+        std::vector<bool> action_failed(package_count, false);
+        std::vector<Chrono::ElapsedTimer> action_timers(package_count);
+        std::vector<SpecSummary> results;
+        for (auto&& action : action_plan)
+            results.emplace_back(action.spec(), &action);
+
+        // Map each action to the plan positions it depends on. The plan is
+        // topologically ordered, so dependencies always appear earlier. Remove actions
+        // act as barriers: they wait for everything before them, and everything after
+        // them waits for them.
+        std::unordered_map<std::string, size_t> plan_position;
+        for (size_t i = 0; i < package_count; ++i)
+            plan_position.emplace(action_plan[i].spec().to_string(), i);
+
+        std::vector<std::vector<size_t>> dependencies(package_count);
+        size_t last_barrier = SIZE_MAX;
+        for (size_t i = 0; i < package_count; ++i)
+        {
+            if (const auto install_action = action_plan[i].install_action.get())
+            {
+                for (auto&& dep : install_action->any_paragraph.dependencies(install_action->spec.triplet()))
+                {
+                    const auto it = plan_position.find(dep.to_string());
+                    if (it != plan_position.end() && it->second < i) dependencies[i].push_back(it->second);
+                }
+                if (last_barrier != SIZE_MAX) dependencies[i].push_back(last_barrier);
+            }
+            else
+            {
+                for (size_t j = 0; j < i; ++j)
+                    dependencies[i].push_back(j);
+                last_barrier = i;
+            }
+        }
+
+        std::mutex queue_mutex;
+        std::condition_variable work_cv;
+        std::condition_variable finished_cv;
+        std::deque<size_t> work_queue;
+        struct FinishedBuild
+        {
+            size_t index;
+            ExtendedBuildResult result;
+        };
+        std::deque<FinishedBuild> finished_queue;
+        bool shutting_down = false;
+
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < concurrency; ++t)
+        {
+            workers.emplace_back([&]() {
+                for (;;)
+                {
+                    size_t index;
+                    {
+                        std::unique_lock<std::mutex> lock(queue_mutex);
+                        work_cv.wait(lock, [&]() { return shutting_down || !work_queue.empty(); });
+                        if (work_queue.empty()) return;
+                        index = work_queue.front();
+                        work_queue.pop_front();
+                    }
+
+                    auto result =
+                        build_action_on_worker(paths, action_plan[index].install_action.value_or_exit(VCPKG_LINE_INFO));
+
+                    {
+                        std::unique_lock<std::mutex> lock(queue_mutex);
+                        finished_queue.push_back({index, std::move(result)});
+                    }
+                    finished_cv.notify_one();
+                }
+            });
+        }
+
+        size_t done_count = 0;
+        size_t counter = 0;
+
+        auto record_result = [&](const size_t i, ExtendedBuildResult&& result) {
+            states[i] = ActionState::DONE;
+            ++done_count;
+            action_failed[i] = result.code != BuildResult::SUCCEEDED;
+
+            if (result.code != BuildResult::SUCCEEDED && keep_going == KeepGoing::NO)
+            {
+                System::println(Build::create_user_troubleshooting_message(action_plan[i].spec()));
+                Checks::exit_fail(VCPKG_LINE_INFO);
+            }
+
+            if (result.code == BuildResult::SUCCEEDED && result.peak_memory_bytes > 0)
+                record_build_memory(build_memory, action_plan[i], result.peak_memory_bytes);
+            results[i].build_result = std::move(result);
+            results[i].timing = action_timers[i].elapsed();
+            if (!action_failed[i]) record_build_duration(build_durations, action_plan[i], results[i].timing);
+            System::println(
+                "Elapsed time for package %s: %s", action_plan[i].spec().to_string(), results[i].timing.to_string());
+        };
+
+        while (done_count < package_count)
+        {
+            bool progress = false;
+            for (size_t i = 0; i < package_count; ++i)
+            {
+                if (states[i] != ActionState::NOT_STARTED) continue;
+
+                bool deps_done = true;
+                bool deps_failed = false;
+                for (const size_t dep : dependencies[i])
+                {
+                    if (states[dep] != ActionState::DONE) deps_done = false;
+                    if (action_failed[dep]) deps_failed = true;
+                }
+                if (!deps_done) continue;
+
+                if (const auto install_action = action_plan[i].install_action.get())
+                {
+                    // Memory-budget admission: defer this build while the predicted
+                    // peaks of the builds in flight leave no room for it. Always admit
+                    // when nothing is building so the plan cannot stall.
+                    if (!deps_failed && install_action->plan_type == InstallPlanType::BUILD_AND_INSTALL &&
+                        builds_in_flight != 0 && memory_budget > 0 &&
+                        memory_in_flight + expected_memory(i) > memory_budget)
+                        continue;
+                }
+
+                const auto& action = action_plan[i];
+                ++counter;
+                action_timers[i] = Chrono::ElapsedTimer::create_started();
+                System::println("Starting package %zd/%zd: %s", counter, package_count, action.spec().to_string());
+                progress = true;
+
+                if (const auto install_action = action.install_action.get())
+                {
+                    if (deps_failed)
+                    {
+                        System::println(System::Color::error,
+                                        Build::create_error_message(
+                                            BuildResult::CASCADED_DUE_TO_MISSING_DEPENDENCIES, action.spec()));
+                        record_result(i, ExtendedBuildResult{BuildResult::CASCADED_DUE_TO_MISSING_DEPENDENCIES});
+                        continue;
+                    }
+
+                    if (install_action->plan_type == InstallPlanType::BUILD_AND_INSTALL)
+                    {
+                        const std::string display_name = GlobalState::feature_packages
+                                                             ? install_action->displayname()
+                                                             : install_action->spec.to_string();
+                        if (Util::Enum::to_bool(install_action->build_options.use_head_version))
+                            System::println("Building package %s from HEAD... ", display_name);
+                        else
+                            System::println("Building package %s... ", display_name);
+
+                        states[i] = ActionState::BUILDING;
+                        admitted_memory[i] = expected_memory(i);
+                        memory_in_flight += admitted_memory[i];
+                        ++builds_in_flight;
+                        {
+                            // Keep the queue ordered by expected duration, longest
+                            // first, so workers pick up the critical path eagerly.
+                            std::unique_lock<std::mutex> lock(queue_mutex);
+                            const auto pos =
+                                std::find_if(work_queue.cbegin(), work_queue.cend(), [&](const size_t queued) {
+                                    return expected_duration(queued) < expected_duration(i);
+                                });
+                            work_queue.insert(pos, i);
+                        }
+                        work_cv.notify_one();
+                    }
+                    else
+                    {
+                        record_result(i, perform_install_plan_action(paths, *install_action, status_db));
+                    }
+                }
+                else if (const auto remove_action = action.remove_action.get())
+                {
+                    Remove::perform_remove_plan_action(paths, *remove_action, Remove::Purge::YES, status_db);
+                    record_result(i, ExtendedBuildResult{BuildResult::SUCCEEDED});
+                }
+                else
+                {
+                    Checks::unreachable(VCPKG_LINE_INFO);
+                }
+            }
+
+            if (progress) continue;
+
+            // Nothing else can be dispatched until a build in flight completes; fold its
+            // result in and run the install phase on this thread.
+            FinishedBuild finished = [&]() {
+                std::unique_lock<std::mutex> lock(queue_mutex);
+                finished_cv.wait(lock, [&]() { return !finished_queue.empty(); });
+                auto f = std::move(finished_queue.front());
+                finished_queue.pop_front();
+                return f;
+            }();
+
+            memory_in_flight -= admitted_memory[finished.index];
+            --builds_in_flight;
+
+            const InstallPlanAction& finished_action =
+                action_plan[finished.index].install_action.value_or_exit(VCPKG_LINE_INFO);
+            const std::string display_name = GlobalState::feature_packages ? finished_action.displayname()
+                                                                           : finished_action.spec.to_string();
+
+            ExtendedBuildResult result = std::move(finished.result);
+            if (result.code == BuildResult::SUCCEEDED)
+            {
+                System::println("Building package %s... done", display_name);
+                result.code = aux_install(paths, display_name, *result.binary_control_file, status_db);
+            }
+            else
+            {
+                System::println(System::Color::error, Build::create_error_message(result.code, finished_action.spec));
+            }
+
+            record_result(finished.index, std::move(result));
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            shutting_down = true;
+        }
+        work_cv.notify_all();
+        for (auto&& worker : workers)
+            worker.join();
+
+        save_keyed_profile(paths.get_filesystem(), build_duration_profile_path(paths), build_durations);
+        if (!build_memory.empty())
+            save_keyed_profile(paths.get_filesystem(), build_memory_profile_path(paths), build_memory);
+
+        return InstallSummary{std::move(results), timer.to_string()};
+    }
+
+    // Kicks off background downloads of every source the plan will need, so network
+    // transfer overlaps with the builds of earlier packages instead of each portfile
+    // fetching its distfile only once its own build starts. Only download steps that
+    // are statically resolvable from the portfile text are prefetched; everything
+    // else is fetched by the portfile as before.
+    static void start_source_prefetch(const std::vector<AnyAction>& action_plan, const VcpkgPaths& paths)
+    {
+        auto& fs = paths.get_filesystem();
+
+        std::vector<Downloads::Distfile> distfiles;
+        std::set<std::string> seen_filenames;
+        for (const AnyAction& action : action_plan)
+        {
+            const auto install_action = action.install_action.get();
+            if (!install_action || install_action->plan_type != InstallPlanType::BUILD_AND_INSTALL) continue;
+            if (!Util::Enum::to_bool(install_action->build_options.allow_downloads)) continue;
+            // HEAD builds resolve their download only at build time.
+            if (Util::Enum::to_bool(install_action->build_options.use_head_version)) continue;
+
+            const auto maybe_portfile = fs.read_contents(paths.port_dir(install_action->spec) / "portfile.cmake");
+            if (const auto portfile = maybe_portfile.get())
+            {
+                for (Downloads::Distfile& distfile : Downloads::parse_portfile_distfiles(*portfile))
+                {
+                    if (seen_filenames.insert(distfile.filename).second) distfiles.push_back(std::move(distfile));
+                }
+            }
+        }
+
+        Downloads::prefetch_distfiles(fs, paths.downloads, std::move(distfiles));
+    }
+
     InstallSummary perform(const std::vector<AnyAction>& action_plan,
                            const KeepGoing keep_going,
                            const VcpkgPaths& paths,
-                           StatusParagraphs& status_db)
+                           StatusParagraphs& status_db,
+                           const size_t concurrency)
     {
+        const AllocStats::TagScope alloc_scope("install");
+
+        recover_incomplete_installs(paths, status_db);
+
+        start_source_prefetch(action_plan, paths);
+        Build::prefetch_binary_archives(paths, action_plan);
+
+        if (concurrency > 1 && action_plan.size() > 1)
+        {
+            return perform_parallel(action_plan, keep_going, paths, status_db, concurrency);
+        }
+
         std::vector<SpecSummary> results;
 
         const auto timer = Chrono::ElapsedTimer::create_started();
         size_t counter = 0;
         const size_t package_count = action_plan.size();
 
+        std::map<std::string, long long> build_durations =
+            load_keyed_profile(paths.get_filesystem(), build_duration_profile_path(paths));
+        std::map<std::string, long long> build_memory =
+            load_keyed_profile(paths.get_filesystem(), build_memory_profile_path(paths));
+
         for (const auto& action : action_plan)
         {
             const auto build_timer = Chrono::ElapsedTimer::create_started();
@@ -407,36 +1112,117 @@ namespace vcpkg::Install
             }
 
             results.back().timing = build_timer.elapsed();
+            if (results.back().build_result.code == BuildResult::SUCCEEDED)
+            {
+                record_build_duration(build_durations, action, results.back().timing);
+                if (results.back().build_result.peak_memory_bytes > 0)
+                    record_build_memory(build_memory, action, results.back().build_result.peak_memory_bytes);
+            }
             System::println("Elapsed time for package %s: %s", display_name, results.back().timing.to_string());
         }
 
+        save_keyed_profile(paths.get_filesystem(), build_duration_profile_path(paths), build_durations);
+        if (!build_memory.empty())
+            save_keyed_profile(paths.get_filesystem(), build_memory_profile_path(paths), build_memory);
+
         return InstallSummary{std::move(results), timer.to_string()};
     }
 
+    // Disk-space preflight: a long install that dies at 90% with a full disk wastes
+    // the whole run, so the plan's disk need is estimated right after planning and
+    // compared against the volume's free space. Already-staged packages are measured
+    // directly; the rest come from the per-port size profile that successful
+    // installs maintain.
+    static const uint64_t UNPROFILED_PACKAGE_ESTIMATE = 64 * 1024 * 1024;
+    // A from-source build also materializes sources and object files under
+    // buildtrees, historically a low multiple of the installed size.
+    static const uint64_t BUILD_DISK_MULTIPLIER = 4;
+
+    static uint64_t estimate_plan_disk_bytes(const VcpkgPaths& paths, const std::vector<AnyAction>& action_plan)
+    {
+        auto& fs = paths.get_filesystem();
+        uint64_t total = 0;
+        for (const auto& action : action_plan)
+        {
+            const auto install_action = action.install_action.get();
+            if (!install_action) continue;
+            const InstallPlanType plan_type = install_action->plan_type;
+            if (plan_type != InstallPlanType::INSTALL && plan_type != InstallPlanType::BUILD_AND_INSTALL) continue;
+
+            uint64_t estimate = 0;
+            const fs::path package_dir = paths.package_dir(install_action->spec);
+            if (fs.is_directory(package_dir))
+            {
+                std::error_code ec;
+                for (const fs::path& file : fs.get_files_recursive(package_dir))
+                {
+                    const auto size = fs.file_size(file, ec);
+                    if (!ec) estimate += size;
+                }
+            }
+            if (estimate == 0)
+                estimate =
+                    GC::profiled_package_size(paths, install_action->spec).value_or(UNPROFILED_PACKAGE_ESTIMATE);
+            if (plan_type == InstallPlanType::BUILD_AND_INSTALL) estimate *= BUILD_DISK_MULTIPLIER;
+            total += estimate;
+        }
+        return total;
+    }
+
+    static void preflight_disk_space(const VcpkgPaths& paths,
+                                     const std::vector<AnyAction>& action_plan,
+                                     const bool gc_on_low_disk)
+    {
+        const uint64_t required = estimate_plan_disk_bytes(paths, action_plan);
+        std::error_code ec;
+        auto space = fs::stdfs::space(paths.root, ec);
+        if (ec) return; // cannot observe the volume; proceed as before
+        if (space.available >= required) return;
+
+        if (gc_on_low_disk)
+        {
+            System::println("Plan is estimated to need %s but only %s is free; evicting least recently used trees...",
+                            GC::format_size(required),
+                            GC::format_size(space.available));
+            GC::try_free_bytes(paths, required - space.available);
+            space = fs::stdfs::space(paths.root, ec);
+            if (!ec && space.available >= required) return;
+        }
+
+        Checks::exit_with_message(VCPKG_LINE_INFO,
+                                  "This plan is estimated to need %s, but only %s is free on %s.\n"
+                                  "Free up space, run `vcpkg x-gc --target-size=...`, or pass --x-gc-on-low-disk "
+                                  "to evict least recently used build and package trees automatically.",
+                                  GC::format_size(required),
+                                  GC::format_size(space.available),
+                                  paths.root.u8string());
+    }
+
     static const std::string OPTION_DRY_RUN = "--dry-run";
     static const std::string OPTION_USE_HEAD_VERSION = "--head";
     static const std::string OPTION_NO_DOWNLOADS = "--no-downloads";
     static const std::string OPTION_RECURSE = "--recurse";
     static const std::string OPTION_KEEP_GOING = "--keep-going";
     static const std::string OPTION_XUNIT = "--x-xunit";
+    static const std::string OPTION_X_CONCURRENCY = "--x-concurrency";
+    static const std::string OPTION_X_GC_ON_LOW_DISK = "--x-gc-on-low-disk";
 
-    static const std::array<CommandSwitch, 5> INSTALL_SWITCHES = {{
+    static const std::array<CommandSwitch, 6> INSTALL_SWITCHES = {{
         {OPTION_DRY_RUN, "Do not actually build or install"},
         {OPTION_USE_HEAD_VERSION, "Install the libraries on the command line using the latest upstream sources"},
         {OPTION_NO_DOWNLOADS, "Do not download new sources"},
         {OPTION_RECURSE, "Allow removal of packages as part of installation"},
         {OPTION_KEEP_GOING, "Continue installing packages on failure"},
+        {OPTION_X_GC_ON_LOW_DISK, "Evict least recently used build/package trees if the plan does not fit on disk"},
     }};
-    static const std::array<CommandSetting, 1> INSTALL_SETTINGS = {{
+    static const std::array<CommandSetting, 2> INSTALL_SETTINGS = {{
         {OPTION_XUNIT, "File to output results in XUnit format (Internal use)"},
+        {OPTION_X_CONCURRENCY, "(Experimental) Build up to N independent packages concurrently"},
     }};
 
     std::vector<std::string> get_all_port_names(const VcpkgPaths& paths)
     {
-        auto sources_and_errors = Paragraphs::try_load_all_ports(paths.get_filesystem(), paths.ports);
-
-        return Util::fmap(sources_and_errors.paragraphs,
-                          [](auto&& pgh) -> std::string { return pgh->core_paragraph->name; });
+        return Paragraphs::load_port_names_cached(paths);
     }
 
     const CommandStructure COMMAND_STRUCTURE = {
@@ -449,8 +1235,6 @@ namespace vcpkg::Install
 
     static void print_cmake_information(const BinaryParagraph& bpgh, const VcpkgPaths& paths)
     {
-        static const std::regex cmake_library_regex(R"(\badd_library\(([^\s\)]+)\s)", std::regex_constants::ECMAScript);
-
         auto& fs = paths.get_filesystem();
 
         auto usage_file = paths.installed / bpgh.spec.triplet().canonical_name() / "share" / bpgh.spec.name() / "usage";
@@ -480,14 +1264,12 @@ namespace vcpkg::Install
                     auto find_package_name = path.parent_path().filename().u8string();
                     if (auto p_contents = maybe_contents.get())
                     {
-                        std::sregex_iterator next(p_contents->begin(), p_contents->end(), cmake_library_regex);
-                        std::sregex_iterator last;
-
-                        while (next != last)
+                        std::vector<std::string> library_names;
+                        Strings::find_cmake_library_names(*p_contents, library_names);
+                        if (!library_names.empty())
                         {
-                            auto match = *next;
-                            library_targets[find_package_name].push_back(match[1]);
-                            ++next;
+                            auto& targets = library_targets[find_package_name];
+                            targets.insert(targets.end(), library_names.begin(), library_names.end());
                         }
                     }
                 }
@@ -551,8 +1333,25 @@ namespace vcpkg::Install
         const bool is_recursive = Util::Sets::contains(options.switches, (OPTION_RECURSE));
         const KeepGoing keep_going = to_keep_going(Util::Sets::contains(options.switches, OPTION_KEEP_GOING));
 
+        size_t concurrency = 1;
+        const auto it_concurrency = options.settings.find(OPTION_X_CONCURRENCY);
+        if (it_concurrency != options.settings.end())
+        {
+            concurrency = static_cast<size_t>(std::max(1, atoi(it_concurrency->second.c_str())));
+        }
+
+        // Planning-only mode: --dry-run exits right after the plan is printed, so it
+        // never needs cmake/git/vcvars and must not pay for tool acquisition or the
+        // status update sweep. Warm dry-runs then cost only the ports cache load.
+        if (!dry_run)
+        {
+            // Begin acquiring any missing tools now so that a first-run download
+            // overlaps with the status database load and ports parsing below.
+            paths.prefetch_tools();
+        }
+
         // create the plan
-        StatusParagraphs status_db = database_load_check(paths);
+        StatusParagraphs status_db = dry_run ? database_load_readonly(paths) : database_load_check(paths);
 
         const Build::BuildPackageOptions install_plan_options = {
             Util::Enum::to_enum<Build::UseHeadVersion>(use_head_version),
@@ -563,10 +1362,10 @@ namespace vcpkg::Install
         // Note: action_plan will hold raw pointers to SourceControlFiles from this map
         std::vector<AnyAction> action_plan;
 
-        auto all_ports = Paragraphs::load_all_ports(paths.get_filesystem(), paths.ports);
+        auto all_ports = Paragraphs::load_all_ports_cached(paths);
         std::unordered_map<std::string, SourceControlFile> scf_map;
         for (auto&& port : all_ports)
-            scf_map[port->core_paragraph->name] = std::move(*port);
+            scf_map[port->core_paragraph.name] = std::move(*port);
         MapPortFileProvider provider(scf_map);
 
         action_plan = create_feature_install_plan(provider, FullPackageSpec::to_feature_specs(specs), status_db);
@@ -598,17 +1397,17 @@ namespace vcpkg::Install
         // install plan will be empty if it is already installed - need to change this at status paragraph part
         Checks::check_exit(VCPKG_LINE_INFO, !action_plan.empty(), "Install plan cannot be empty");
 
-        // log the plan
-        const std::string specs_string = Strings::join(",", action_plan, [](const AnyAction& action) {
-            if (auto iaction = action.install_action.get())
-                return iaction->spec.to_string();
-            else if (auto raction = action.remove_action.get())
-                return "R$" + raction->spec.to_string();
-            Checks::unreachable(VCPKG_LINE_INFO);
+        // log the plan; the join only runs when metrics are on
+        Metrics::track_property_lazy("installplan", [&] {
+            return Strings::join(",", action_plan, [](const AnyAction& action) {
+                if (auto iaction = action.install_action.get())
+                    return iaction->spec.to_string();
+                else if (auto raction = action.remove_action.get())
+                    return "R$" + raction->spec.to_string();
+                Checks::unreachable(VCPKG_LINE_INFO);
+            });
         });
 
-        Metrics::g_metrics.lock()->track_property("installplan", specs_string);
-
         Dependencies::print_plan(action_plan, is_recursive);
 
         if (dry_run)
@@ -616,7 +1415,11 @@ namespace vcpkg::Install
             Checks::exit_success(VCPKG_LINE_INFO);
         }
 
-        const InstallSummary summary = perform(action_plan, keep_going, paths, status_db);
+        preflight_disk_space(paths, action_plan, Util::Sets::contains(options.switches, OPTION_X_GC_ON_LOW_DISK));
+
+        check_plan_for_file_conflicts(paths, action_plan, status_db);
+
+        const InstallSummary summary = perform(action_plan, keep_going, paths, status_db, concurrency);
 
         System::println("\nTotal elapsed time: %s\n", summary.total_elapsed_time);
 
@@ -664,7 +1467,7 @@ namespace vcpkg::Install
             {
                 if (auto p_bcf = p_install_plan->any_paragraph.binary_control_file.get())
                     return &p_bcf->core_paragraph;
-                else if (auto p_status = p_install_plan->any_paragraph.status_paragraph.get())
+                else if (auto p_status = p_install_plan->any_paragraph.status_paragraph)
                 {
                     return &p_status->package;
                 }
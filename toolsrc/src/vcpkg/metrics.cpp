@@ -5,9 +5,15 @@
 
 #include <vcpkg/base/chrono.h>
 #include <vcpkg/base/files.h>
+#include <vcpkg/base/hash.h>
 #include <vcpkg/base/strings.h>
 #include <vcpkg/base/system.h>
 
+#if defined(_WIN32)
+#include <iphlpapi.h>
+#endif
+
+#pragma comment(lib, "iphlpapi")
 #pragma comment(lib, "version")
 #pragma comment(lib, "winhttp")
 
@@ -204,7 +210,15 @@ namespace vcpkg::Metrics
         }
     };
 
-    static MetricMessage g_metricmessage;
+    // Constructed on first use rather than during static initialization: the
+    // constructor stamps the event time and generates an id, work a cold start
+    // should not pay before main() -- wrappers invoke vcpkg thousands of times a
+    // day and most invocations never send an event.
+    static MetricMessage& get_metric_message()
+    {
+        static MetricMessage message;
+        return message;
+    }
     static bool g_should_send_metrics =
 #if defined(NDEBUG) && (DISABLE_METRICS == 0)
         true
@@ -214,40 +228,57 @@ namespace vcpkg::Metrics
         ;
     static bool g_should_print_metrics = false;
 
-    bool get_compiled_metrics_enabled() { return DISABLE_METRICS == 0; }
+    std::atomic<bool> g_metrics_enabled{
+#if defined(NDEBUG) && (DISABLE_METRICS == 0)
+        true
+#else
+        false
+#endif
+    };
 
-    static fs::path get_vcpkg_root()
+    static void update_metrics_gate()
     {
-        return Files::get_real_filesystem().find_file_recursively_up(
-            fs::stdfs::absolute(System::get_exe_path_of_current_process()), ".vcpkg-root");
+        g_metrics_enabled.store(g_should_send_metrics || g_should_print_metrics, std::memory_order_relaxed);
     }
 
+    bool get_compiled_metrics_enabled() { return DISABLE_METRICS == 0; }
+
     std::string get_MAC_user()
     {
 #if defined(_WIN32)
-        auto getmac = System::cmd_execute_and_capture_output("getmac");
-
-        if (getmac.exit_code != 0) return "0";
+        // Enumerate the adapters in-process instead of spawning getmac and a
+        // powershell hashing script, which cost hundreds of milliseconds on the
+        // first metrics use of every command.
+        ULONG buffer_size = 16 * 1024;
+        std::vector<unsigned char> buffer;
+        ULONG error;
+        do
+        {
+            buffer.resize(buffer_size);
+            error = GetAdaptersAddresses(AF_UNSPEC,
+                                         GAA_FLAG_SKIP_UNICAST | GAA_FLAG_SKIP_ANYCAST | GAA_FLAG_SKIP_MULTICAST |
+                                             GAA_FLAG_SKIP_DNS_SERVER,
+                                         nullptr,
+                                         reinterpret_cast<IP_ADAPTER_ADDRESSES*>(buffer.data()),
+                                         &buffer_size);
+        } while (error == ERROR_BUFFER_OVERFLOW);
 
-        std::regex mac_regex("([a-fA-F0-9]{2}(-[a-fA-F0-9]{2}){5})");
-        std::sregex_iterator next(getmac.output.begin(), getmac.output.end(), mac_regex);
-        std::sregex_iterator last;
+        if (error != NO_ERROR) return "0";
 
-        while (next != last)
+        for (auto adapter = reinterpret_cast<const IP_ADAPTER_ADDRESSES*>(buffer.data()); adapter != nullptr;
+             adapter = adapter->Next)
         {
-            auto match = *next;
-            if (match[0] != "00-00-00-00-00-00")
-            {
-                const std::string matchstr = match[0];
-                const System::PowershellParameter value("Value", matchstr);
-                auto hash_result = System::powershell_execute_and_capture_output(
-                    "SHA256Hash", get_vcpkg_root() / "scripts" / "SHA256Hash.ps1", {value});
-                Util::erase_remove_if(hash_result,
-                                      [](char ch) { return !(ch >= 'A' && ch <= 'F') && !(ch >= '0' && ch <= '9'); });
-                hash_result = Strings::ascii_to_lowercase(hash_result);
-                return hash_result;
-            }
-            ++next;
+            static const ULONG MAC_LENGTH = 6;
+            if (adapter->PhysicalAddressLength != MAC_LENGTH) continue;
+
+            const BYTE* mac = adapter->PhysicalAddress;
+            if (std::all_of(mac, mac + MAC_LENGTH, [](const BYTE b) { return b == 0; })) continue;
+
+            // Format the address the way getmac printed it, so the hashed user id is
+            // stable across the previous implementation.
+            const std::string mac_string =
+                Strings::format("%02X-%02X-%02X-%02X-%02X-%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+            return Hash::get_string_hash(mac_string, "SHA256");
         }
 
         return "0";
@@ -258,8 +289,8 @@ namespace vcpkg::Metrics
 
     void Metrics::set_user_information(const std::string& user_id, const std::string& first_use_time)
     {
-        g_metricmessage.user_id = user_id;
-        g_metricmessage.user_timestamp = first_use_time;
+        get_metric_message().user_id = user_id;
+        get_metric_message().user_timestamp = first_use_time;
     }
 
     void Metrics::init_user_information(std::string& user_id, std::string& first_use_time)
@@ -268,18 +299,110 @@ namespace vcpkg::Metrics
         first_use_time = get_current_date_time();
     }
 
-    void Metrics::set_send_metrics(bool should_send_metrics) { g_should_send_metrics = should_send_metrics; }
+    void Metrics::set_send_metrics(bool should_send_metrics)
+    {
+        g_should_send_metrics = should_send_metrics;
+        update_metrics_gate();
+    }
 
-    void Metrics::set_print_metrics(bool should_print_metrics) { g_should_print_metrics = should_print_metrics; }
+    void Metrics::set_print_metrics(bool should_print_metrics)
+    {
+        g_should_print_metrics = should_print_metrics;
+        update_metrics_gate();
+    }
 
-    void Metrics::track_metric(const std::string& name, double value) { g_metricmessage.track_metric(name, value); }
+    void Metrics::track_metric(const std::string& name, double value)
+    {
+        if (!metrics_enabled()) return;
+        get_metric_message().track_metric(name, value);
+    }
 
     void Metrics::track_property(const std::string& name, const std::string& value)
     {
-        g_metricmessage.track_property(name, value);
+        if (!metrics_enabled()) return;
+        get_metric_message().track_property(name, value);
+    }
+
+    namespace
+    {
+        struct BufferedEvent
+        {
+            bool is_metric;
+            std::string name;
+            std::string property_value;
+            double metric_value;
+        };
+
+        // Buffers from finished threads land here; the one lock per thread lifetime is
+        // the only synchronization the buffered recording path ever takes.
+        std::mutex g_handoff_mutex;
+        std::vector<BufferedEvent> g_handed_off_events;
+
+        struct ThreadEventBuffer
+        {
+            std::vector<BufferedEvent> events;
+
+            ~ThreadEventBuffer()
+            {
+                if (events.empty()) return;
+                std::lock_guard<std::mutex> lock(g_handoff_mutex);
+                std::move(events.begin(), events.end(), std::back_inserter(g_handed_off_events));
+            }
+        };
+
+        thread_local ThreadEventBuffer g_thread_events;
+    }
+
+    void track_metric_buffered(const std::string& name, double value)
+    {
+        if (!metrics_enabled()) return;
+        g_thread_events.events.push_back({true, name, {}, value});
+    }
+
+    void track_property_buffered(const std::string& name, const std::string& value)
+    {
+        if (!metrics_enabled()) return;
+        g_thread_events.events.push_back({false, name, value, 0.0});
+    }
+
+    // Folds handed-off buffers and the calling thread's own buffer into the message.
+    // Runs under the g_metrics lock, from flush().
+    static void drain_buffered_events()
+    {
+        std::vector<BufferedEvent> events;
+        {
+            std::lock_guard<std::mutex> lock(g_handoff_mutex);
+            events.swap(g_handed_off_events);
+        }
+        std::move(
+            g_thread_events.events.begin(), g_thread_events.events.end(), std::back_inserter(events));
+        g_thread_events.events.clear();
+
+        for (const BufferedEvent& event : events)
+        {
+            if (event.is_metric)
+                get_metric_message().track_metric(event.name, event.metric_value);
+            else
+                get_metric_message().track_property(event.name, event.property_value);
+        }
+    }
+
+#if defined(_WIN32)
+    // Payloads waiting for upload live here, one file each; flush() appends to the
+    // spool and the background uploader drains it. The cap bounds the disk held by a
+    // machine that can never reach the endpoint — when full, new payloads are dropped.
+    static const size_t MAX_SPOOLED_PAYLOADS = 64;
+    static const size_t MAX_PAYLOADS_PER_POST = 8;
+
+    static fs::path get_metrics_spool_path()
+    {
+        wchar_t temp_folder[MAX_PATH];
+        GetTempPathW(MAX_PATH, temp_folder);
+        return fs::path(temp_folder) / "vcpkg" / "spool";
     }
+#endif
 
-    void Metrics::upload(const std::string& payload)
+    static void upload_payload(const std::string& payload)
     {
 #if defined(_WIN32)
         HINTERNET connect = nullptr, request = nullptr;
@@ -365,51 +488,146 @@ namespace vcpkg::Metrics
 #endif
     }
 
-    void Metrics::flush()
+    void Metrics::upload(const std::string& payload) { upload_payload(payload); }
+
+#if defined(_WIN32)
+    // One drainer per machine: the mutex is held for the whole drain, so a burst of
+    // vcpkg commands (or an explicit uploader run) starts at most one uploader
+    // instead of one each.
+    static HANDLE try_claim_uploader_mutex()
+    {
+        const HANDLE mutex = CreateMutexW(nullptr, TRUE, L"Local\\vcpkg-metrics-uploader");
+        if (mutex && GetLastError() == ERROR_ALREADY_EXISTS)
+        {
+            CloseHandle(mutex);
+            return nullptr;
+        }
+        return mutex;
+    }
+
+    // Drains the whole spool. Each spooled payload is a JSON array of Application
+    // Insights envelopes, so batches coalesce by splicing the arrays together: one
+    // POST carries up to MAX_PAYLOADS_PER_POST payloads.
+    static void drain_spool_inner()
+    {
+        auto& fs = Files::get_real_filesystem();
+        const fs::path spool_path = get_metrics_spool_path();
+        if (!fs.exists(spool_path)) return;
+
+        std::error_code ec;
+        std::vector<fs::path> batched_files;
+        std::string batch;
+
+        const auto send_batch = [&]() {
+            if (batched_files.empty()) return;
+            batch.push_back(']');
+            upload_payload(batch);
+            batch.clear();
+            for (const fs::path& file : batched_files)
+                fs.remove(file, ec);
+            batched_files.clear();
+        };
+
+        for (const fs::path& file : fs.get_files_non_recursive(spool_path))
+        {
+            // Leftover claims mean a previous uploader was killed mid-flight; the
+            // payload was attempted at least once, so discard it.
+            if (file.extension() == ".sending")
+            {
+                fs.remove(file, ec);
+                continue;
+            }
+            if (file.extension() != ".txt") continue;
+
+            // Renaming claims the file, so concurrent vcpkg processes never upload
+            // the same payload twice.
+            fs::path claimed = file;
+            claimed.replace_extension(".sending");
+            fs.rename(file, claimed, ec);
+            if (ec) continue;
+
+            auto maybe_contents = fs.read_contents(claimed);
+            const auto contents = maybe_contents.get();
+            if (!contents)
+            {
+                fs.remove(claimed, ec);
+                continue;
+            }
+
+            const auto open_bracket = contents->find('[');
+            const auto close_bracket = contents->rfind(']');
+            if (open_bracket == std::string::npos || close_bracket <= open_bracket)
+            {
+                fs.remove(claimed, ec);
+                continue;
+            }
+
+            batch.push_back(batch.empty() ? '[' : ',');
+            batch.append(*contents, open_bracket + 1, close_bracket - open_bracket - 1);
+            batched_files.push_back(std::move(claimed));
+
+            if (batched_files.size() >= MAX_PAYLOADS_PER_POST) send_batch();
+        }
+
+        send_batch();
+    }
+#endif
+
+    void Metrics::drain_spool()
     {
 #if defined(_WIN32)
-        const std::string payload = g_metricmessage.format_event_data_template();
-        if (g_should_print_metrics) std::cerr << payload << "\n";
-        if (!g_should_send_metrics) return;
+        const HANDLE uploader_mutex = try_claim_uploader_mutex();
+        if (!uploader_mutex) return;
 
-        // upload(payload);
+        drain_spool_inner();
 
-        wchar_t temp_folder[MAX_PATH];
-        GetTempPathW(MAX_PATH, temp_folder);
+        ReleaseMutex(uploader_mutex);
+        CloseHandle(uploader_mutex);
+#endif
+    }
+
+    void Metrics::start_background_uploader()
+    {
+#if defined(_WIN32)
+        if (!g_should_send_metrics) return;
 
-        const fs::path temp_folder_path = fs::path(temp_folder) / "vcpkg";
-        const fs::path temp_folder_path_exe =
-            temp_folder_path / Strings::format("vcpkgmetricsuploader-%s.exe", Commands::Version::base_version());
+        // If another process's uploader is already draining the spool, do not even
+        // start the thread; its rename-claims would find nothing to do anyway.
+        const HANDLE uploader_mutex = try_claim_uploader_mutex();
+        if (!uploader_mutex) return;
+
+        // Drain payloads spooled by previous runs while this command does its real
+        // work. The thread is detached on purpose: a spool file is only removed after
+        // its upload completed, so anything in flight when the process exits is simply
+        // retried by a later run.
+        std::thread([uploader_mutex]() {
+            drain_spool_inner();
+            ReleaseMutex(uploader_mutex);
+            CloseHandle(uploader_mutex);
+        }).detach();
+#endif
+    }
 
+    void Metrics::flush()
+    {
+        drain_buffered_events();
+#if defined(_WIN32)
+        const std::string payload = get_metric_message().format_event_data_template();
+        if (g_should_print_metrics) std::cerr << payload << "\n";
+        if (!g_should_send_metrics) return;
+
+        // Spool the payload for a later run's background uploader instead of paying
+        // network or process-spawn latency on the exit path.
         auto& fs = Files::get_real_filesystem();
+        const fs::path spool_path = get_metrics_spool_path();
 
-        if (true)
-        {
-            const fs::path exe_path = [&fs]() -> fs::path {
-                auto vcpkgdir = System::get_exe_path_of_current_process().parent_path();
-                auto path = vcpkgdir / "vcpkgmetricsuploader.exe";
-                if (fs.exists(path)) return path;
-
-                path = vcpkgdir / "scripts" / "vcpkgmetricsuploader.exe";
-                if (fs.exists(path)) return path;
-
-                return "";
-            }();
-
-            std::error_code ec;
-            fs.create_directories(temp_folder_path, ec);
-            if (ec) return;
-            fs.copy_file(exe_path, temp_folder_path_exe, fs::copy_options::skip_existing, ec);
-            if (ec) return;
-        }
+        std::error_code ec;
+        fs.create_directories(spool_path, ec);
+        if (ec) return;
 
-        const fs::path vcpkg_metrics_txt_path = temp_folder_path / ("vcpkg" + generate_random_UUID() + ".txt");
-        fs.write_contents(vcpkg_metrics_txt_path, payload);
+        if (fs.get_files_non_recursive(spool_path).size() >= MAX_SPOOLED_PAYLOADS) return;
 
-        const std::string cmd_line = Strings::format("start \"vcpkgmetricsuploader.exe\" \"%s\" \"%s\"",
-                                                     temp_folder_path_exe.u8string(),
-                                                     vcpkg_metrics_txt_path.u8string());
-        System::cmd_execute_clean(cmd_line);
+        fs.write_contents(spool_path / ("vcpkg" + generate_random_UUID() + ".txt"), payload);
 #endif
     }
 }
@@ -14,6 +14,18 @@ namespace vcpkg
         return (c == '-') || isdigit(c) || (isalpha(c) && islower(c)) || (c == '[') || (c == ']');
     }
 
+    size_t PackageSpec::intern_id(const std::string& name, const Triplet& triplet)
+    {
+        // Process-wide table assigning each distinct name:triplet pair a dense id.
+        // Guarded by a mutex because specs can be constructed from worker threads.
+        static std::mutex intern_mutex;
+        static std::unordered_map<std::string, size_t> intern_ids;
+
+        std::string key = name + ':' + triplet.canonical_name();
+        std::lock_guard<std::mutex> lock(intern_mutex);
+        return intern_ids.emplace(std::move(key), intern_ids.size()).first->second;
+    }
+
     std::string FeatureSpec::to_string() const
     {
         if (feature().empty()) return spec().to_string();
@@ -26,8 +38,8 @@ namespace vcpkg
         std::vector<FeatureSpec> f_specs;
         for (auto&& depend : depends)
         {
-            auto maybe_spec = ParsedSpecifier::from_string(depend);
-            if (auto spec = maybe_spec.get())
+            const auto& maybe_spec = ParsedSpecifier::from_string_cached(depend);
+            if (const auto spec = maybe_spec.get())
             {
                 Checks::check_exit(VCPKG_LINE_INFO,
                                    spec->triplet.empty(),
@@ -67,13 +79,13 @@ namespace vcpkg
     ExpectedT<FullPackageSpec, PackageSpecParseResult> FullPackageSpec::from_string(const std::string& spec_as_string,
                                                                                     const Triplet& default_triplet)
     {
-        auto res = ParsedSpecifier::from_string(spec_as_string);
-        if (auto p = res.get())
+        const auto& res = ParsedSpecifier::from_string_cached(spec_as_string);
+        if (const auto p = res.get())
         {
             FullPackageSpec fspec;
             Triplet t = p->triplet.empty() ? default_triplet : Triplet::from_canonical_name(p->triplet);
             fspec.package_spec = PackageSpec::from_name_and_triplet(p->name, t).value_or_exit(VCPKG_LINE_INFO);
-            fspec.features = std::move(p->features);
+            fspec.features = p->features;
             return fspec;
         }
         return res.error();
@@ -90,6 +102,7 @@ namespace vcpkg
         PackageSpec p;
         p.m_name = name;
         p.m_triplet = triplet;
+        p.m_id = intern_id(name, triplet);
         return p;
     }
 
@@ -141,10 +154,7 @@ namespace vcpkg
 
     std::string PackageSpec::to_string() const { return Strings::format("%s:%s", this->name(), this->triplet()); }
 
-    bool operator==(const PackageSpec& left, const PackageSpec& right)
-    {
-        return left.name() == right.name() && left.triplet() == right.triplet();
-    }
+    bool operator==(const PackageSpec& left, const PackageSpec& right) { return left.id() == right.id(); }
 
     bool operator!=(const PackageSpec& left, const PackageSpec& right) { return !(left == right); }
 
@@ -197,6 +207,24 @@ namespace vcpkg
         return f;
     }
 
+    const ExpectedT<ParsedSpecifier, PackageSpecParseResult>& ParsedSpecifier::from_string_cached(
+        const std::string& input)
+    {
+        // Entries are never erased or mutated after insertion and the map's nodes are
+        // address-stable, so the returned reference stays valid for the process
+        // lifetime. The mutex mirrors intern_id: specs are parsed from worker threads.
+        static std::mutex cache_mutex;
+        static std::unordered_map<std::string, ExpectedT<ParsedSpecifier, PackageSpecParseResult>> cache;
+
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        auto it = cache.find(input);
+        if (it == cache.end())
+        {
+            it = cache.emplace(input, from_string(input)).first;
+        }
+        return it->second;
+    }
+
     ExpectedT<Features, PackageSpecParseResult> Features::from_string(const std::string& name)
     {
         auto maybe_spec = ParsedSpecifier::from_string(name);
@@ -1,10 +1,17 @@
 #include "pch.h"
 
+#include <vcpkg/base/allocstats.h>
+#include <vcpkg/base/chrono.h>
 #include <vcpkg/base/files.h>
+#include <vcpkg/base/parallel.h>
+#include <vcpkg/base/stats.h>
+#include <vcpkg/base/timing.h>
 #include <vcpkg/base/util.h>
+#include <vcpkg/build.h>
 #include <vcpkg/globalstate.h>
 #include <vcpkg/paragraphparseresult.h>
 #include <vcpkg/paragraphs.h>
+#include <vcpkg/portswatcher.h>
 
 using namespace vcpkg::Parse;
 
@@ -12,11 +19,12 @@ namespace vcpkg::Paragraphs
 {
     struct Parser
     {
-        Parser(const char* c, const char* e) : cur(c), end(e) {}
+        Parser(const char* c, const char* e, Arena& arena) : cur(c), end(e), m_arena(arena) {}
 
     private:
         const char* cur;
         const char* const end;
+        Arena& m_arena;
 
         void peek(char& ch) const
         {
@@ -37,10 +45,22 @@ namespace vcpkg::Paragraphs
             }
         }
 
+        // Advances to the next '\r', '\n', or the end of the buffer. memchr compiles to
+        // the platform's vectorized byte scan, which is substantially faster than the
+        // byte-at-a-time next()/peek() loop on long field values.
+        void skip_to_lineend(char& ch)
+        {
+            const size_t remaining = static_cast<size_t>(end - cur);
+            const char* lineend = static_cast<const char*>(memchr(cur, '\n', remaining));
+            const size_t cr_search = lineend ? static_cast<size_t>(lineend - cur) : remaining;
+            if (const char* cr = static_cast<const char*>(memchr(cur, '\r', cr_search))) lineend = cr;
+            cur = lineend ? lineend : end;
+            peek(ch);
+        }
+
         void skip_comment(char& ch)
         {
-            while (ch != '\r' && ch != '\n' && ch != '\0')
-                next(ch);
+            skip_to_lineend(ch);
             if (ch == '\r') next(ch);
             if (ch == '\n') next(ch);
         }
@@ -60,18 +80,15 @@ namespace vcpkg::Paragraphs
 
         static bool is_lineend(char ch) { return ch == '\r' || ch == '\n' || ch == 0; }
 
-        void get_fieldvalue(char& ch, std::string& fieldvalue)
+        void get_fieldvalue(char& ch, FieldValueView& fieldvalue)
         {
-            fieldvalue.clear();
-
             auto beginning_of_line = cur;
             do
             {
                 // scan to end of current line (it is part of the field value)
-                while (!is_lineend(ch))
-                    next(ch);
+                skip_to_lineend(ch);
 
-                fieldvalue.append(beginning_of_line, cur);
+                fieldvalue.lines.emplace_back(beginning_of_line, cur);
 
                 if (ch == '\r') next(ch);
                 if (ch == '\n') next(ch);
@@ -97,29 +114,26 @@ namespace vcpkg::Paragraphs
                 }
 
                 // First nonspace is not a newline. This continues the current field value.
-                // We forcibly convert all newlines into single '\n' for ease of text handling later on.
-                fieldvalue.push_back('\n');
+                // Newlines are normalized into single '\n' when the value is materialized.
             } while (true);
         }
 
-        void get_fieldname(char& ch, std::string& fieldname)
+        void get_fieldname(char& ch, StringRange& fieldname)
         {
             auto begin_fieldname = cur;
             while (is_alphanum(ch) || ch == '-')
                 next(ch);
             Checks::check_exit(VCPKG_LINE_INFO, ch == ':', "Expected ':'");
-            fieldname = std::string(begin_fieldname, cur);
+            fieldname = StringRange(begin_fieldname, cur);
 
             // skip ': '
             next(ch);
             skip_spaces(ch);
         }
 
-        void get_paragraph(char& ch, std::unordered_map<std::string, std::string>& fields)
+        void get_paragraph(char& ch, RawParagraphView& fields)
         {
-            fields.clear();
-            std::string fieldname;
-            std::string fieldvalue;
+            StringRange fieldname;
             do
             {
                 if (is_comment(ch))
@@ -130,19 +144,21 @@ namespace vcpkg::Paragraphs
 
                 get_fieldname(ch, fieldname);
 
-                auto it = fields.find(fieldname);
-                Checks::check_exit(VCPKG_LINE_INFO, it == fields.end(), "Duplicate field");
+                const bool duplicate = std::any_of(
+                    fields.cbegin(), fields.cend(), [&](auto&& field) { return field.first == fieldname; });
+                Checks::check_exit(VCPKG_LINE_INFO, !duplicate, "Duplicate field");
 
+                FieldValueView fieldvalue(m_arena);
                 get_fieldvalue(ch, fieldvalue);
 
-                fields.emplace(fieldname, fieldvalue);
+                fields.emplace_back(fieldname, std::move(fieldvalue));
             } while (!is_lineend(ch));
         }
 
     public:
-        std::vector<std::unordered_map<std::string, std::string>> get_paragraphs()
+        std::vector<RawParagraphView> get_paragraphs()
         {
-            std::vector<std::unordered_map<std::string, std::string>> paragraphs;
+            std::vector<RawParagraphView> paragraphs;
 
             char ch;
             peek(ch);
@@ -155,7 +171,7 @@ namespace vcpkg::Paragraphs
                     continue;
                 }
 
-                paragraphs.emplace_back();
+                paragraphs.emplace_back(ArenaAllocator<std::pair<StringRange, FieldValueView>>(m_arena));
                 get_paragraph(ch, paragraphs.back());
             }
 
@@ -163,7 +179,36 @@ namespace vcpkg::Paragraphs
         }
     };
 
-    Expected<std::unordered_map<std::string, std::string>> get_single_paragraph(const Files::Filesystem& fs,
+    std::string FieldValueView::to_string() const
+    {
+        size_t total = 0;
+        for (auto&& line : lines)
+            total += line.size() + 1;
+
+        std::string ret;
+        if (total != 0) ret.reserve(total - 1);
+        for (auto&& line : lines)
+        {
+            if (&line != &lines.front()) ret.push_back('\n');
+            ret.append(line.begin, line.end);
+        }
+        return ret;
+    }
+
+    std::vector<RawParagraphView> parse_paragraph_views(StringRange buffer, Arena& arena)
+    {
+        return Parser(buffer.begin, buffer.end, arena).get_paragraphs();
+    }
+
+    static RawParagraph to_raw_paragraph(const RawParagraphView& view)
+    {
+        RawParagraph fields;
+        for (auto&& field : view)
+            fields.emplace(field.first.to_string(), field.second.to_string());
+        return fields;
+    }
+
+    Expected<RawParagraph> get_single_paragraph(const Files::Filesystem& fs,
                                                                                 const fs::path& control_path)
     {
         const Expected<std::string> contents = fs.read_contents(control_path);
@@ -175,7 +220,7 @@ namespace vcpkg::Paragraphs
         return contents.error();
     }
 
-    Expected<std::vector<std::unordered_map<std::string, std::string>>> get_paragraphs(const Files::Filesystem& fs,
+    Expected<std::vector<RawParagraph>> get_paragraphs(const Files::Filesystem& fs,
                                                                                        const fs::path& control_path)
     {
         const Expected<std::string> contents = fs.read_contents(control_path);
@@ -187,27 +232,40 @@ namespace vcpkg::Paragraphs
         return contents.error();
     }
 
-    Expected<std::unordered_map<std::string, std::string>> parse_single_paragraph(const std::string& str)
+    Expected<RawParagraph> parse_single_paragraph(const std::string& str)
     {
-        const std::vector<std::unordered_map<std::string, std::string>> p =
-            Parser(str.c_str(), str.c_str() + str.size()).get_paragraphs();
+        Arena arena;
+        const std::vector<RawParagraphView> p = parse_paragraph_views(str, arena);
 
         if (p.size() == 1)
         {
-            return p.at(0);
+            return to_raw_paragraph(p.front());
         }
 
         return std::error_code(ParagraphParseResult::EXPECTED_ONE_PARAGRAPH);
     }
 
-    Expected<std::vector<std::unordered_map<std::string, std::string>>> parse_paragraphs(const std::string& str)
+    Expected<std::vector<RawParagraph>> parse_paragraphs(const std::string& str)
     {
-        return Parser(str.c_str(), str.c_str() + str.size()).get_paragraphs();
+        Arena arena;
+        return Util::fmap(parse_paragraph_views(str, arena), &to_raw_paragraph);
     }
 
     ParseExpected<SourceControlFile> try_load_port(const Files::Filesystem& fs, const fs::path& path)
     {
-        Expected<std::vector<std::unordered_map<std::string, std::string>>> pghs = get_paragraphs(fs, path / "CONTROL");
+        Expected<std::vector<RawParagraph>> pghs = [&]() {
+            // Parse straight out of a memory mapping when possible: the parse itself does
+            // no per-field allocation, and each field is materialized exactly once below.
+            auto maybe_mapping = Files::MemoryMappedFile::map(path / "CONTROL");
+            if (auto mapping = maybe_mapping.get())
+            {
+                Arena arena;
+                return Expected<std::vector<RawParagraph>>(
+                    Util::fmap(parse_paragraph_views({mapping->data(), mapping->data() + mapping->size()}, arena),
+                               &to_raw_paragraph));
+            }
+            return get_paragraphs(fs, path / "CONTROL");
+        }();
         if (auto vector_pghs = pghs.get())
         {
             auto csf = SourceControlFile::parse_control_file(std::move(*vector_pghs));
@@ -216,7 +274,7 @@ namespace vcpkg::Paragraphs
                 if (auto ptr = csf.get())
                 {
                     Checks::check_exit(VCPKG_LINE_INFO, ptr->get() != nullptr);
-                    ptr->get()->core_paragraph->default_features.clear();
+                    ptr->get()->core_paragraph.default_features.clear();
                     ptr->get()->feature_paragraphs.clear();
                 }
             }
@@ -228,10 +286,26 @@ namespace vcpkg::Paragraphs
         return error_info;
     }
 
-    Expected<BinaryControlFile> try_load_cached_control_package(const VcpkgPaths& paths, const PackageSpec& spec)
+    static Expected<BinaryControlFile> load_control_package_from_dir(const Files::Filesystem& fs,
+                                                                     const fs::path& package_dir)
     {
-        Expected<std::vector<std::unordered_map<std::string, std::string>>> pghs =
-            get_paragraphs(paths.get_filesystem(), paths.package_dir(spec) / "CONTROL");
+        // Prefer the binary sidecar written at package creation; fall back to parsing
+        // the text CONTROL when it is absent or malformed.
+        const Expected<std::string> sidecar = fs.read_contents(package_dir / "CONTROL.bin");
+        if (const auto contents = sidecar.get())
+        {
+            auto maybe_bcf = deserialize_binary(*contents);
+            if (const auto bcf = maybe_bcf.get())
+            {
+                Stats::get().control_cache_hits.increment();
+                return std::move(*bcf);
+            }
+        }
+
+        Stats::get().control_cache_misses.increment();
+
+        Expected<std::vector<RawParagraph>> pghs =
+            get_paragraphs(fs, package_dir / "CONTROL");
 
         if (auto p = pghs.get())
         {
@@ -248,28 +322,106 @@ namespace vcpkg::Paragraphs
         return pghs.error();
     }
 
+    // Spec-keyed memo over the packages tree. Entries from the initial scan and from
+    // on-demand loads live together; build code republishes through
+    // store_cached_control_package when it rewrites a package.
+    static std::mutex s_package_cache_mutex;
+    static std::unordered_map<std::string, BinaryControlFile> s_package_cache;
+    static bool s_package_cache_scanned = false;
+
+    Expected<BinaryControlFile> try_load_cached_control_package(const VcpkgPaths& paths, const PackageSpec& spec)
+    {
+        // With compressed package staging the expanded tree may have been dropped after
+        // a previous install; bring it back before reading the metadata.
+        if (GlobalState::g_compress_packages) Build::expand_package_archive(paths, spec);
+
+        auto& fs = paths.get_filesystem();
+
+        {
+            std::lock_guard<std::mutex> lock(s_package_cache_mutex);
+            if (!s_package_cache_scanned)
+            {
+                s_package_cache_scanned = true;
+
+                const std::vector<fs::path> entries = fs.get_files_non_recursive(paths.packages);
+                std::vector<Optional<BinaryControlFile>> loaded(entries.size());
+                Parallel::for_each_index(entries.size(), [&](const size_t i) {
+                    if (!fs.is_directory(entries[i])) return;
+                    auto maybe_bcf = load_control_package_from_dir(fs, entries[i]);
+                    if (const auto bcf = maybe_bcf.get()) loaded[i] = std::move(*bcf);
+                });
+
+                for (size_t i = 0; i < entries.size(); ++i)
+                {
+                    if (const auto bcf = loaded[i].get())
+                        s_package_cache.emplace(entries[i].filename().u8string(), std::move(*bcf));
+                }
+            }
+
+            const auto it = s_package_cache.find(spec.dir());
+            if (it != s_package_cache.end()) return it->second;
+        }
+
+        // Not seen by the scan: built or restored after it, or simply absent. Load
+        // directly and publish on success.
+        auto maybe_bcf = load_control_package_from_dir(fs, paths.package_dir(spec));
+        if (const auto bcf = maybe_bcf.get())
+        {
+            std::lock_guard<std::mutex> lock(s_package_cache_mutex);
+            s_package_cache[spec.dir()] = *bcf;
+        }
+        return maybe_bcf;
+    }
+
+    void store_cached_control_package(const BinaryControlFile& bcf)
+    {
+        std::lock_guard<std::mutex> lock(s_package_cache_mutex);
+        s_package_cache[bcf.core_paragraph.dir()] = bcf;
+    }
+
+    void invalidate_cached_control_package(const PackageSpec& spec)
+    {
+        std::lock_guard<std::mutex> lock(s_package_cache_mutex);
+        s_package_cache.erase(spec.dir());
+    }
+
+    // Ports are parsed independently, so the directories are sharded across a set of
+    // worker threads. Results are collected per-index, which keeps the output (and in
+    // particular the error messages) in the same deterministic order as a serial scan.
+    static std::vector<ParseExpected<SourceControlFile>> parse_all_ports_parallel(
+        const Files::Filesystem& fs, const std::vector<fs::path>& port_dirs)
+    {
+        std::vector<ParseExpected<SourceControlFile>> results(port_dirs.size());
+
+        Parallel::for_each_index(port_dirs.size(),
+                                 [&](const size_t i) { results[i] = try_load_port(fs, port_dirs[i]); });
+
+        return results;
+    }
+
     LoadResults try_load_all_ports(const Files::Filesystem& fs, const fs::path& ports_dir)
     {
+        const AllocStats::TagScope alloc_scope("parser");
+        const std::vector<fs::path> port_dirs = fs.get_files_non_recursive(ports_dir);
+        auto results = parse_all_ports_parallel(fs, port_dirs);
+
         LoadResults ret;
-        for (auto&& path : fs.get_files_non_recursive(ports_dir))
+        for (auto&& result : results)
         {
-            auto maybe_spgh = try_load_port(fs, path);
-            if (const auto spgh = maybe_spgh.get())
+            if (const auto spgh = result.get())
             {
                 ret.paragraphs.emplace_back(std::move(*spgh));
             }
             else
             {
-                ret.errors.emplace_back(std::move(maybe_spgh).error());
+                ret.errors.emplace_back(std::move(result).error());
             }
         }
         return ret;
     }
 
-    std::vector<std::unique_ptr<SourceControlFile>> load_all_ports(const Files::Filesystem& fs,
-                                                                   const fs::path& ports_dir)
+    static std::vector<std::unique_ptr<SourceControlFile>> warn_and_extract(LoadResults&& results)
     {
-        auto results = try_load_all_ports(fs, ports_dir);
         if (!results.errors.empty())
         {
             if (GlobalState::debugging)
@@ -289,4 +441,375 @@ namespace vcpkg::Paragraphs
         }
         return std::move(results.paragraphs);
     }
+
+    std::vector<std::unique_ptr<SourceControlFile>> load_all_ports(const Files::Filesystem& fs,
+                                                                   const fs::path& ports_dir)
+    {
+        const auto timer = Chrono::ElapsedTimer::create_started();
+        auto ret = warn_and_extract(try_load_all_ports(fs, ports_dir));
+        Stats::get().ports_loaded.add(ret.size());
+        Stats::get().ports_load_us.add(static_cast<uint64_t>(timer.microseconds()));
+        return ret;
+    }
+
+    namespace
+    {
+        // On-disk format of the ports index: a versioned header followed by one
+        // length-prefixed record per port. Any malformed or short read discards the
+        // entire index; it is purely a cache and is rebuilt from the CONTROL files.
+        static const char PORTS_INDEX_MAGIC[8] = {'V', 'C', 'P', 'K', 'G', 'I', 'D', 'X'};
+        static const uint32_t PORTS_INDEX_VERSION = 1;
+
+        struct IndexWriter
+        {
+            std::string buffer;
+
+            void write_bytes(const void* data, size_t size)
+            {
+                buffer.append(static_cast<const char*>(data), size);
+            }
+            void write_u32(uint32_t v) { write_bytes(&v, sizeof(v)); }
+            void write_u64(uint64_t v) { write_bytes(&v, sizeof(v)); }
+            void write_i64(int64_t v) { write_bytes(&v, sizeof(v)); }
+            void write_string(const std::string& s)
+            {
+                write_u32(static_cast<uint32_t>(s.size()));
+                buffer.append(s);
+            }
+            void write_string_list(const std::vector<std::string>& list)
+            {
+                write_u32(static_cast<uint32_t>(list.size()));
+                for (auto&& s : list)
+                    write_string(s);
+            }
+            void write_dependencies(const std::vector<Dependency>& deps)
+            {
+                write_u32(static_cast<uint32_t>(deps.size()));
+                for (auto&& dep : deps)
+                {
+                    write_string(dep.depend.name);
+                    write_string_list(dep.depend.features);
+                    write_string(dep.qualifier);
+                }
+            }
+            void write_scf(const SourceControlFile& scf)
+            {
+                const auto& core = scf.core_paragraph;
+                write_string(core.name);
+                write_string(core.version);
+                write_string(core.description);
+                write_string(core.maintainer);
+                write_string_list(core.supports);
+                write_dependencies(core.depends);
+                write_string_list(core.default_features);
+
+                write_u32(static_cast<uint32_t>(scf.feature_paragraphs.size()));
+                for (auto&& feature : scf.feature_paragraphs)
+                {
+                    write_string(feature.name);
+                    write_string(feature.description);
+                    write_dependencies(feature.depends);
+                }
+            }
+        };
+
+        struct IndexReader
+        {
+            const char* cur;
+            const char* end;
+            bool ok = true;
+
+            bool read_bytes(void* out, size_t size)
+            {
+                if (!ok || static_cast<size_t>(end - cur) < size)
+                {
+                    ok = false;
+                    return false;
+                }
+                memcpy(out, cur, size);
+                cur += size;
+                return true;
+            }
+            uint32_t read_u32()
+            {
+                uint32_t v = 0;
+                read_bytes(&v, sizeof(v));
+                return v;
+            }
+            uint64_t read_u64()
+            {
+                uint64_t v = 0;
+                read_bytes(&v, sizeof(v));
+                return v;
+            }
+            int64_t read_i64()
+            {
+                int64_t v = 0;
+                read_bytes(&v, sizeof(v));
+                return v;
+            }
+            std::string read_string()
+            {
+                const uint32_t size = read_u32();
+                if (!ok || static_cast<size_t>(end - cur) < size)
+                {
+                    ok = false;
+                    return {};
+                }
+                std::string s(cur, cur + size);
+                cur += size;
+                return s;
+            }
+            std::vector<std::string> read_string_list()
+            {
+                std::vector<std::string> list;
+                const uint32_t size = read_u32();
+                for (uint32_t i = 0; ok && i < size; ++i)
+                    list.push_back(read_string());
+                return list;
+            }
+            std::vector<Dependency> read_dependencies()
+            {
+                std::vector<Dependency> deps;
+                const uint32_t size = read_u32();
+                for (uint32_t i = 0; ok && i < size; ++i)
+                {
+                    Dependency dep;
+                    dep.depend.name = read_string();
+                    dep.depend.features = read_string_list();
+                    dep.qualifier = read_string();
+                    deps.push_back(std::move(dep));
+                }
+                return deps;
+            }
+            std::unique_ptr<SourceControlFile> read_scf()
+            {
+                auto scf = std::make_unique<SourceControlFile>();
+                auto& core = scf->core_paragraph;
+                core.name = read_string();
+                core.version = read_string();
+                core.description = read_string();
+                core.maintainer = read_string();
+                core.supports = read_string_list();
+                core.depends = read_dependencies();
+                core.default_features = read_string_list();
+
+                const uint32_t num_features = read_u32();
+                for (uint32_t i = 0; ok && i < num_features; ++i)
+                {
+                    FeatureParagraph feature;
+                    feature.name = read_string();
+                    feature.description = read_string();
+                    feature.depends = read_dependencies();
+                    scf->feature_paragraphs.push_back(std::move(feature));
+                }
+                return scf;
+            }
+        };
+
+        struct PortStamp
+        {
+            int64_t mtime;
+            uint64_t size;
+
+            bool operator==(const PortStamp& other) const { return mtime == other.mtime && size == other.size; }
+        };
+
+        struct CachedPort
+        {
+            PortStamp stamp;
+            std::unique_ptr<SourceControlFile> scf;
+        };
+
+        std::unordered_map<std::string, CachedPort> load_ports_index(const Files::Filesystem& fs,
+                                                                     const fs::path& index_path)
+        {
+            std::unordered_map<std::string, CachedPort> cached;
+            auto maybe_mapping = fs.map_contents(index_path);
+            const auto mapping = maybe_mapping.get();
+            if (!mapping) return cached;
+
+            IndexReader reader{mapping->data(), mapping->data() + mapping->size()};
+            char magic[sizeof(PORTS_INDEX_MAGIC)];
+            if (!reader.read_bytes(magic, sizeof(magic)) || memcmp(magic, PORTS_INDEX_MAGIC, sizeof(magic)) != 0)
+                return cached;
+            if (reader.read_u32() != PORTS_INDEX_VERSION) return cached;
+            // Feature data is stripped at parse time when feature packages are disabled,
+            // so an index written under the opposite setting cannot be reused.
+            if (reader.read_u32() != static_cast<uint32_t>(GlobalState::feature_packages)) return cached;
+
+            const uint32_t num_ports = reader.read_u32();
+            for (uint32_t i = 0; reader.ok && i < num_ports; ++i)
+            {
+                std::string dir_name = reader.read_string();
+                CachedPort port;
+                port.stamp.mtime = reader.read_i64();
+                port.stamp.size = reader.read_u64();
+                port.scf = reader.read_scf();
+                if (reader.ok) cached.emplace(std::move(dir_name), std::move(port));
+            }
+
+            if (!reader.ok) cached.clear();
+            return cached;
+        }
+    }
+
+    LoadResults try_load_all_ports_cached(const VcpkgPaths& paths)
+    {
+        Timing::PhaseScope timing_scope("load ports");
+
+        auto& fs = paths.get_filesystem();
+        const fs::path index_path = paths.root / ".vcpkg-ports-index.bin";
+        const std::vector<fs::path> port_dirs = fs.get_files_non_recursive(paths.ports);
+
+        auto cached = load_ports_index(fs, index_path);
+
+        // With a live watcher session (see portswatcher.h) the index is trusted for
+        // every port the watcher has not flagged, skipping the per-port CONTROL stat
+        // that dominates warm runs on network filesystems.
+        const auto maybe_invalidated = PortsWatcher::fresh_invalidations(paths);
+        const auto invalidated = maybe_invalidated.get();
+
+        std::vector<ParseExpected<SourceControlFile>> results(port_dirs.size());
+        std::vector<PortStamp> stamps(port_dirs.size());
+        std::vector<fs::path> miss_dirs;
+        std::vector<size_t> miss_indices;
+
+        for (size_t i = 0; i < port_dirs.size(); ++i)
+        {
+            const auto it = cached.find(port_dirs[i].filename().generic_u8string());
+
+            if (invalidated && it != cached.end() &&
+                invalidated->count(port_dirs[i].filename().generic_u8string()) == 0)
+            {
+                stamps[i] = it->second.stamp;
+                results[i] = std::move(it->second.scf);
+                continue;
+            }
+
+            std::error_code ec;
+            const fs::path control_path = port_dirs[i] / "CONTROL";
+            stamps[i].mtime = fs.last_write_time(control_path, ec);
+            if (!ec) stamps[i].size = fs.file_size(control_path, ec);
+
+            if (!ec && it != cached.end() && it->second.stamp == stamps[i])
+            {
+                results[i] = std::move(it->second.scf);
+            }
+            else
+            {
+                miss_dirs.push_back(port_dirs[i]);
+                miss_indices.push_back(i);
+            }
+        }
+
+        if (!miss_dirs.empty())
+        {
+            auto parsed = parse_all_ports_parallel(fs, miss_dirs);
+            for (size_t i = 0; i < parsed.size(); ++i)
+                results[miss_indices[i]] = std::move(parsed[i]);
+        }
+
+        if (!miss_dirs.empty() || cached.size() != port_dirs.size())
+        {
+            IndexWriter writer;
+            writer.write_bytes(PORTS_INDEX_MAGIC, sizeof(PORTS_INDEX_MAGIC));
+            writer.write_u32(PORTS_INDEX_VERSION);
+            writer.write_u32(static_cast<uint32_t>(GlobalState::feature_packages));
+
+            uint32_t num_ports = 0;
+            for (size_t i = 0; i < results.size(); ++i)
+                if (results[i].get()) ++num_ports;
+            writer.write_u32(num_ports);
+
+            for (size_t i = 0; i < results.size(); ++i)
+            {
+                const auto scf = results[i].get();
+                if (!scf) continue;
+                writer.write_string(port_dirs[i].filename().generic_u8string());
+                writer.write_i64(stamps[i].mtime);
+                writer.write_u64(stamps[i].size);
+                writer.write_scf(**scf);
+            }
+
+            paths.get_filesystem().write_contents(index_path, writer.buffer);
+        }
+
+        // Refresh the compact name+version index alongside the full one, so completion
+        // and other latency-sensitive callers never need to deserialize paragraphs.
+        const fs::path names_path = paths.root / ".vcpkg-port-names.idx";
+        if (!miss_dirs.empty() || cached.size() != port_dirs.size() || !fs.exists(names_path))
+        {
+            std::vector<std::string> name_lines;
+            for (const auto& result : results)
+            {
+                if (const auto scf = result.get())
+                {
+                    name_lines.push_back((*scf)->core_paragraph.name + ' ' + (*scf)->core_paragraph.version);
+                }
+            }
+            std::sort(name_lines.begin(), name_lines.end());
+
+            Files::BufferedWriter names_writer = fs.open_for_write(names_path);
+            for (const std::string& line : name_lines)
+            {
+                names_writer.write_line(line);
+            }
+        }
+
+        LoadResults ret;
+        for (auto&& result : results)
+        {
+            if (const auto spgh = result.get())
+            {
+                ret.paragraphs.emplace_back(std::move(*spgh));
+            }
+            else
+            {
+                ret.errors.emplace_back(std::move(result).error());
+            }
+        }
+        return ret;
+    }
+
+    std::vector<std::unique_ptr<SourceControlFile>> load_all_ports_cached(const VcpkgPaths& paths)
+    {
+        const auto timer = Chrono::ElapsedTimer::create_started();
+        auto ret = warn_and_extract(try_load_all_ports_cached(paths));
+        Stats::get().ports_loaded.add(ret.size());
+        Stats::get().ports_load_us.add(static_cast<uint64_t>(timer.microseconds()));
+        return ret;
+    }
+
+    std::vector<std::string> load_port_names_cached(const VcpkgPaths& paths)
+    {
+        const fs::path names_path = paths.root / ".vcpkg-port-names.idx";
+        auto maybe_mapped = Files::MemoryMappedFile::map(names_path);
+        if (const auto mapped = maybe_mapped.get())
+        {
+            // Lines are "name version", already sorted by name.
+            std::vector<std::string> names;
+            const char* cur = mapped->data();
+            const char* const end = cur + mapped->size();
+            while (cur != end)
+            {
+                const char* const line_end = std::find(cur, end, '\n');
+                const char* const name_end = std::find(cur, line_end, ' ');
+                if (name_end != cur)
+                {
+                    names.emplace_back(cur, name_end);
+                }
+                cur = line_end == end ? end : line_end + 1;
+            }
+            return names;
+        }
+
+        // The index has not been generated yet; the full cached load writes it as a
+        // side effect, so this path is only paid once.
+        auto results = try_load_all_ports_cached(paths);
+        auto names = Util::fmap(results.paragraphs,
+                                [](auto&& pgh) -> std::string { return pgh->core_paragraph.name; });
+        std::sort(names.begin(), names.end());
+        return names;
+    }
 }
@@ -7,32 +7,149 @@
 
 namespace vcpkg::Parse
 {
-    static Optional<std::string> remove_field(std::unordered_map<std::string, std::string>* fields,
-                                              const std::string& fieldname)
+    ControlField identify_control_field(const std::string& name)
     {
-        auto it = fields->find(fieldname);
-        if (it == fields->end())
+        switch (name.size())
+        {
+            case 3:
+                if (name == "Abi") return ControlField::ABI;
+                break;
+            case 4:
+                if (name == "Type") return ControlField::TYPE;
+                break;
+            case 6:
+                if (name == "Source") return ControlField::SOURCE;
+                if (name == "Status") return ControlField::STATUS;
+                break;
+            case 7:
+                if (name == "Version") return ControlField::VERSION;
+                if (name == "Feature") return ControlField::FEATURE;
+                if (name == "Package") return ControlField::PACKAGE;
+                if (name == "Depends") return ControlField::DEPENDS;
+                break;
+            case 8:
+                if (name == "Supports") return ControlField::SUPPORTS;
+                break;
+            case 10:
+                if (name == "Maintainer") return ControlField::MAINTAINER;
+                if (name == "Multi-Arch") return ControlField::MULTI_ARCH;
+                break;
+            case 11:
+                if (name == "Description") return ControlField::DESCRIPTION;
+                break;
+            case 12:
+                if (name == "Architecture") return ControlField::ARCHITECTURE;
+                break;
+            case 13:
+                if (name == "Build-Depends") return ControlField::BUILD_DEPENDS;
+                break;
+            case 16:
+                if (name == "Default-Features") return ControlField::DEFAULT_FEATURES;
+                break;
+            default: break;
+        }
+        return ControlField::UNKNOWN;
+    }
+
+    const std::string& control_field_name(ControlField field)
+    {
+        // Must match the declaration order of ControlField.
+        static const std::string NAMES[] = {
+            "",
+            "Abi",
+            "Architecture",
+            "Build-Depends",
+            "Default-Features",
+            "Depends",
+            "Description",
+            "Feature",
+            "Maintainer",
+            "Multi-Arch",
+            "Package",
+            "Source",
+            "Status",
+            "Supports",
+            "Type",
+            "Version",
+        };
+        return NAMES[static_cast<size_t>(field)];
+    }
+
+    ParagraphParser::ParagraphParser(RawParagraph&& fields) : fields(std::move(fields))
+    {
+        known_fields.fill(NPOS);
+        size_t index = 0;
+        for (auto it = this->fields.begin(); it != this->fields.end(); ++it, ++index)
+        {
+            known_fields[static_cast<size_t>(identify_control_field(it->first))] = index;
+        }
+        known_fields[static_cast<size_t>(ControlField::UNKNOWN)] = NPOS;
+    }
+
+    void ParagraphParser::erase_entry(const size_t index)
+    {
+        fields.erase(fields.begin() + index);
+        for (size_t& slot : known_fields)
+        {
+            if (slot != NPOS && slot > index) --slot;
+        }
+    }
+
+    Optional<std::string> ParagraphParser::extract_field(ControlField field)
+    {
+        size_t& slot = known_fields[static_cast<size_t>(field)];
+        if (slot == NPOS)
         {
             return nullopt;
         }
 
-        const std::string value = std::move(it->second);
-        fields->erase(it);
+        const size_t index = slot;
+        std::string value = std::move((fields.begin() + index)->second);
+        slot = NPOS;
+        erase_entry(index);
+        return value;
+    }
+
+    Optional<std::string> ParagraphParser::extract_field(const std::string& fieldname)
+    {
+        const ControlField known = identify_control_field(fieldname);
+        if (known != ControlField::UNKNOWN)
+        {
+            return extract_field(known);
+        }
+
+        auto it = fields.find(fieldname);
+        if (it == fields.end())
+        {
+            return nullopt;
+        }
+
+        std::string value = std::move(it->second);
+        erase_entry(static_cast<size_t>(it - fields.begin()));
         return value;
     }
 
     void ParagraphParser::required_field(const std::string& fieldname, std::string& out)
     {
-        auto maybe_field = remove_field(&fields, fieldname);
+        auto maybe_field = extract_field(fieldname);
         if (const auto field = maybe_field.get())
             out = std::move(*field);
         else
             missing_fields.push_back(fieldname);
     }
-    std::string ParagraphParser::optional_field(const std::string& fieldname) const
+    std::string ParagraphParser::optional_field(const std::string& fieldname)
     {
-        return remove_field(&fields, fieldname).value_or("");
+        return extract_field(fieldname).value_or("");
     }
+    void ParagraphParser::required_field(ControlField field, std::string& out)
+    {
+        auto maybe_field = extract_field(field);
+        if (const auto f = maybe_field.get())
+            out = std::move(*f);
+        else
+            missing_fields.push_back(control_field_name(field));
+    }
+    std::string ParagraphParser::optional_field(ControlField field) { return extract_field(field).value_or(""); }
     std::unique_ptr<ParseControlErrorInfo> ParagraphParser::error_info(const std::string& name) const
     {
         if (!fields.empty() || !missing_fields.empty())
@@ -78,4 +195,38 @@ namespace vcpkg::Parse
 
         return out;
     }
+
+    std::vector<Span<const char>> parse_comma_list_views(const std::string& str)
+    {
+        if (str.empty())
+        {
+            return {};
+        }
+
+        std::vector<Span<const char>> out;
+
+        const char* const data = str.data();
+        size_t cur = 0;
+        do
+        {
+            auto pos = str.find(',', cur);
+            if (pos == std::string::npos)
+            {
+                out.push_back({data + cur, str.size() - cur});
+                break;
+            }
+            out.push_back({data + cur, pos - cur});
+
+            // skip comma and space
+            ++pos;
+            if (str[pos] == ' ')
+            {
+                ++pos;
+            }
+
+            cur = pos;
+        } while (cur != std::string::npos);
+
+        return out;
+    }
 }
@@ -0,0 +1,149 @@
+#include "pch.h"
+
+#include <vcpkg/portswatcher.h>
+
+#include <time.h>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace vcpkg::PortsWatcher
+{
+    // Session file layout: first line is the watcher's heartbeat (unix seconds,
+    // refreshed every pass of the watch loop), each following line one invalidated
+    // port name. A reader only trusts a heartbeat younger than the TTL, so a killed
+    // watcher degrades to the full stat sweep instead of serving stale trust. The
+    // invalidation list only ever grows within a watcher's lifetime; edited ports
+    // simply keep paying their one stat, which is the sound and cheap option.
+    static const long long SESSION_TTL_SECONDS = 30;
+    static const int HEARTBEAT_INTERVAL_MS = 5000;
+
+    static fs::path session_path(const fs::path& root) { return root / ".vcpkg-ports-session"; }
+
+    Optional<std::unordered_set<std::string>> fresh_invalidations(const VcpkgPaths& paths)
+    {
+        const auto maybe_lines = paths.get_filesystem().read_lines(session_path(paths.root));
+        const auto lines = maybe_lines.get();
+        if (!lines || lines->empty()) return nullopt;
+
+        const long long heartbeat = strtoll((*lines)[0].c_str(), nullptr, 10);
+        if (heartbeat <= 0 || time(nullptr) - heartbeat > SESSION_TTL_SECONDS) return nullopt;
+
+        std::unordered_set<std::string> invalidated;
+        for (size_t i = 1; i < lines->size(); ++i)
+        {
+            if (!(*lines)[i].empty()) invalidated.insert((*lines)[i]);
+        }
+        return invalidated;
+    }
+
+#if defined(__linux__)
+
+    static void write_session(const fs::path& root, const std::unordered_set<std::string>& invalidated)
+    {
+        std::string contents = Strings::format("%lld\n", static_cast<long long>(time(nullptr)));
+        for (const std::string& name : invalidated)
+        {
+            contents.append(name).push_back('\n');
+        }
+
+        // Written to a temp name and renamed so a reader never sees a torn session.
+        const fs::path target = session_path(root);
+        const fs::path temp = target.string() + ".tmp";
+        FILE* f = fopen(temp.c_str(), "wb");
+        if (!f) return;
+        fwrite(contents.data(), 1, contents.size(), f);
+        fclose(f);
+        ::rename(temp.c_str(), target.c_str());
+    }
+
+    static void watch_loop(const fs::path root, const fs::path ports)
+    {
+        const int fd = inotify_init1(IN_NONBLOCK);
+        if (fd < 0) return;
+
+        // inotify is not recursive, so the ports directory and every port directory
+        // get their own watch; roughly 900 watches is well within default limits.
+        const uint32_t mask = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_TO | IN_MOVED_FROM | IN_ATTRIB;
+        std::unordered_map<int, std::string> watched_ports;
+        const int root_wd = inotify_add_watch(fd, ports.c_str(), mask | IN_DELETE_SELF | IN_MOVE_SELF);
+        if (root_wd < 0)
+        {
+            close(fd);
+            return;
+        }
+
+        std::error_code ec;
+        for (fs::stdfs::directory_iterator it(ports, ec), end; !ec && it != end; it.increment(ec))
+        {
+            const int wd = inotify_add_watch(fd, it->path().c_str(), mask);
+            if (wd >= 0) watched_ports[wd] = it->path().filename().u8string();
+        }
+
+        std::unordered_set<std::string> invalidated;
+        write_session(root, invalidated);
+
+        for (;;)
+        {
+            pollfd pfd = {fd, POLLIN, 0};
+            poll(&pfd, 1, HEARTBEAT_INTERVAL_MS);
+
+            alignas(inotify_event) char buffer[16 * 1024];
+            for (;;)
+            {
+                const ssize_t length = read(fd, buffer, sizeof(buffer));
+                if (length <= 0) break;
+                for (ssize_t offset = 0; offset < length;)
+                {
+                    const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                    offset += sizeof(inotify_event) + event->len;
+
+                    if (event->mask & (IN_Q_OVERFLOW | IN_DELETE_SELF | IN_MOVE_SELF))
+                    {
+                        // Lost events (or the whole tree): trust can no longer be
+                        // given, so tear down the session and let every run fall
+                        // back to the stat sweep.
+                        std::error_code remove_ec;
+                        fs::stdfs::remove(session_path(root), remove_ec);
+                        close(fd);
+                        return;
+                    }
+
+                    if (event->wd == root_wd)
+                    {
+                        // A port directory appeared, vanished or was renamed.
+                        if (event->len == 0) continue;
+                        const std::string name = event->name;
+                        invalidated.insert(name);
+                        if (event->mask & (IN_CREATE | IN_MOVED_TO))
+                        {
+                            const int wd = inotify_add_watch(fd, (ports / name).c_str(), mask);
+                            if (wd >= 0) watched_ports[wd] = name;
+                        }
+                    }
+                    else
+                    {
+                        const auto it = watched_ports.find(event->wd);
+                        if (it != watched_ports.end()) invalidated.insert(it->second);
+                    }
+                }
+            }
+
+            write_session(root, invalidated);
+        }
+    }
+
+    void start(const VcpkgPaths& paths)
+    {
+        std::thread(watch_loop, paths.root, paths.ports).detach();
+    }
+
+#else
+
+    void start(const VcpkgPaths&) {}
+
+#endif
+}
@@ -1,7 +1,9 @@
 #include "pch.h"
 
+#include <vcpkg/base/allocstats.h>
 #include <vcpkg/base/cofffilereader.h>
 #include <vcpkg/base/files.h>
+#include <vcpkg/base/parallel.h>
 #include <vcpkg/base/system.h>
 #include <vcpkg/base/util.h>
 #include <vcpkg/build.h>
@@ -21,6 +23,27 @@ namespace vcpkg::PostBuildLint
         return [&fs, ext](const fs::path& path) { return !fs.is_directory(path) && path.extension() == ext; };
     }
 
+    // The binary inspections below read the PE/COFF structures straight out of file
+    // mappings (see base/cofffilereader.h) instead of spawning and scraping dumpbin.
+    // Each binary of a package is mapped and parsed exactly once, in parallel, and
+    // the checks consume the shared results so their output ordering stays
+    // deterministic.
+    static std::vector<CoffFileReader::DllInfo> read_dll_infos(const std::vector<fs::path>& dlls)
+    {
+        std::vector<CoffFileReader::DllInfo> infos(dlls.size());
+        Parallel::for_each_index(dlls.size(),
+                                 [&](const size_t i) { infos[i] = CoffFileReader::read_dll(dlls[i]); });
+        return infos;
+    }
+
+    static std::vector<CoffFileReader::LibInfo> read_lib_infos(const std::vector<fs::path>& libs)
+    {
+        std::vector<CoffFileReader::LibInfo> infos(libs.size());
+        Parallel::for_each_index(libs.size(),
+                                 [&](const size_t i) { infos[i] = CoffFileReader::read_lib(libs[i]); });
+        return infos;
+    }
+
     enum class LintStatus
     {
         SUCCESS = 0,
@@ -29,40 +52,35 @@ namespace vcpkg::PostBuildLint
 
     struct OutdatedDynamicCrt
     {
+        // Matched case-insensitively against the names in a DLL's import directory.
         std::string name;
-        std::regex regex;
-
-        OutdatedDynamicCrt(const std::string& name, const std::string& regex_as_string)
-            : name(name), regex(std::regex(regex_as_string, std::regex_constants::icase))
-        {
-        }
     };
 
     Span<const OutdatedDynamicCrt> get_outdated_dynamic_crts(const Optional<std::string>& toolset_version)
     {
         static const std::vector<OutdatedDynamicCrt> V_NO_120 = {
-            {"msvcp100.dll", R"(msvcp100\.dll)"},
-            {"msvcp100d.dll", R"(msvcp100d\.dll)"},
-            {"msvcp110.dll", R"(msvcp110\.dll)"},
-            {"msvcp110_win.dll", R"(msvcp110_win\.dll)"},
-            {"msvcp60.dll", R"(msvcp60\.dll)"},
-            {"msvcp60.dll", R"(msvcp60\.dll)"},
-
-            {"msvcrt.dll", R"(msvcrt\.dll)"},
-            {"msvcr100.dll", R"(msvcr100\.dll)"},
-            {"msvcr100d.dll", R"(msvcr100d\.dll)"},
-            {"msvcr100_clr0400.dll", R"(msvcr100_clr0400\.dll)"},
-            {"msvcr110.dll", R"(msvcr110\.dll)"},
-            {"msvcrt20.dll", R"(msvcrt20\.dll)"},
-            {"msvcrt40.dll", R"(msvcrt40\.dll)"},
+            {"msvcp100.dll"},
+            {"msvcp100d.dll"},
+            {"msvcp110.dll"},
+            {"msvcp110_win.dll"},
+            {"msvcp60.dll"},
+            {"msvcp60.dll"},
+
+            {"msvcrt.dll"},
+            {"msvcr100.dll"},
+            {"msvcr100d.dll"},
+            {"msvcr100_clr0400.dll"},
+            {"msvcr110.dll"},
+            {"msvcrt20.dll"},
+            {"msvcrt40.dll"},
         };
 
         static const std::vector<OutdatedDynamicCrt> V_NO_MSVCRT = [&]() {
             auto ret = V_NO_120;
-            ret.push_back({"msvcp120.dll", R"(msvcp120\.dll)"});
-            ret.push_back({"msvcp120_clr0400.dll", R"(msvcp120_clr0400\.dll)"});
-            ret.push_back({"msvcr120.dll", R"(msvcr120\.dll)"});
-            ret.push_back({"msvcr120_clr0400.dll", R"(msvcr120_clr0400\.dll)"});
+            ret.push_back({"msvcp120.dll"});
+            ret.push_back({"msvcp120_clr0400.dll"});
+            ret.push_back({"msvcr120.dll"});
+            ret.push_back({"msvcr120_clr0400.dll"});
             return ret;
         }();
 
@@ -294,19 +312,15 @@ namespace vcpkg::PostBuildLint
         return LintStatus::SUCCESS;
     }
 
-    static LintStatus check_exports_of_dlls(const std::vector<fs::path>& dlls, const fs::path& dumpbin_exe)
+    static LintStatus check_exports_of_dlls(const std::vector<fs::path>& dlls,
+                                            const std::vector<CoffFileReader::DllInfo>& dll_infos)
     {
         std::vector<fs::path> dlls_with_no_exports;
-        for (const fs::path& dll : dlls)
+        for (size_t i = 0; i < dlls.size(); ++i)
         {
-            const std::string cmd_line =
-                Strings::format(R"("%s" /exports "%s")", dumpbin_exe.u8string(), dll.u8string());
-            System::ExitCodeAndOutput ec_data = System::cmd_execute_and_capture_output(cmd_line);
-            Checks::check_exit(VCPKG_LINE_INFO, ec_data.exit_code == 0, "Running command:\n   %s\n failed", cmd_line);
-
-            if (ec_data.output.find("ordinal hint RVA      name") == std::string::npos)
+            if (!dll_infos[i].has_exports)
             {
-                dlls_with_no_exports.push_back(dll);
+                dlls_with_no_exports.push_back(dlls[i]);
             }
         }
 
@@ -323,7 +337,7 @@ namespace vcpkg::PostBuildLint
 
     static LintStatus check_uwp_bit_of_dlls(const std::string& expected_system_name,
                                             const std::vector<fs::path>& dlls,
-                                            const fs::path dumpbin_exe)
+                                            const std::vector<CoffFileReader::DllInfo>& dll_infos)
     {
         if (expected_system_name != "WindowsStore")
         {
@@ -331,16 +345,11 @@ namespace vcpkg::PostBuildLint
         }
 
         std::vector<fs::path> dlls_with_improper_uwp_bit;
-        for (const fs::path& dll : dlls)
+        for (size_t i = 0; i < dlls.size(); ++i)
         {
-            const std::string cmd_line =
-                Strings::format(R"("%s" /headers "%s")", dumpbin_exe.u8string(), dll.u8string());
-            System::ExitCodeAndOutput ec_data = System::cmd_execute_and_capture_output(cmd_line);
-            Checks::check_exit(VCPKG_LINE_INFO, ec_data.exit_code == 0, "Running command:\n   %s\n failed", cmd_line);
-
-            if (ec_data.output.find("App Container") == std::string::npos)
+            if (!dll_infos[i].is_appcontainer)
             {
-                dlls_with_improper_uwp_bit.push_back(dll);
+                dlls_with_improper_uwp_bit.push_back(dlls[i]);
             }
         }
 
@@ -389,22 +398,22 @@ namespace vcpkg::PostBuildLint
     }
 
     static LintStatus check_dll_architecture(const std::string& expected_architecture,
-                                             const std::vector<fs::path>& files)
+                                             const std::vector<fs::path>& files,
+                                             const std::vector<CoffFileReader::DllInfo>& dll_infos)
     {
         std::vector<FileAndArch> binaries_with_invalid_architecture;
 
-        for (const fs::path& file : files)
+        for (size_t i = 0; i < files.size(); ++i)
         {
             Checks::check_exit(VCPKG_LINE_INFO,
-                               file.extension() == ".dll",
+                               files[i].extension() == ".dll",
                                "The file extension was not .dll: %s",
-                               file.generic_string());
-            const CoffFileReader::DllInfo info = CoffFileReader::read_dll(file);
-            const std::string actual_architecture = get_actual_architecture(info.machine_type);
+                               files[i].generic_string());
+            const std::string actual_architecture = get_actual_architecture(dll_infos[i].machine_type);
 
             if (expected_architecture != actual_architecture)
             {
-                binaries_with_invalid_architecture.push_back({file, actual_architecture});
+                binaries_with_invalid_architecture.push_back({files[i], actual_architecture});
             }
         }
 
@@ -418,17 +427,18 @@ namespace vcpkg::PostBuildLint
     }
 
     static LintStatus check_lib_architecture(const std::string& expected_architecture,
-                                             const std::vector<fs::path>& files)
+                                             const std::vector<fs::path>& files,
+                                             const std::vector<CoffFileReader::LibInfo>& lib_infos)
     {
         std::vector<FileAndArch> binaries_with_invalid_architecture;
 
-        for (const fs::path& file : files)
+        for (size_t i = 0; i < files.size(); ++i)
         {
             Checks::check_exit(VCPKG_LINE_INFO,
-                               file.extension() == ".lib",
+                               files[i].extension() == ".lib",
                                "The file extension was not .lib: %s",
-                               file.generic_string());
-            CoffFileReader::LibInfo info = CoffFileReader::read_lib(file);
+                               files[i].generic_string());
+            const CoffFileReader::LibInfo& info = lib_infos[i];
 
             // This is zero for folly's debug library
             // TODO: Why?
@@ -437,12 +447,12 @@ namespace vcpkg::PostBuildLint
             Checks::check_exit(VCPKG_LINE_INFO,
                                info.machine_types.size() == 1,
                                "Found more than 1 architecture in file %s",
-                               file.generic_string());
+                               files[i].generic_string());
 
             const std::string actual_architecture = get_actual_architecture(info.machine_types.at(0));
             if (expected_architecture != actual_architecture)
             {
-                binaries_with_invalid_architecture.push_back({file, actual_architecture});
+                binaries_with_invalid_architecture.push_back({files[i], actual_architecture});
             }
         }
 
@@ -598,7 +608,7 @@ namespace vcpkg::PostBuildLint
 
     static LintStatus check_crt_linkage_of_libs(const BuildType& expected_build_type,
                                                 const std::vector<fs::path>& libs,
-                                                const fs::path dumpbin_exe)
+                                                const std::vector<CoffFileReader::LibInfo>& lib_infos)
     {
         std::vector<BuildType> bad_build_types(BuildTypeC::VALUES.cbegin(), BuildTypeC::VALUES.cend());
         bad_build_types.erase(std::remove(bad_build_types.begin(), bad_build_types.end(), expected_build_type),
@@ -606,18 +616,15 @@ namespace vcpkg::PostBuildLint
 
         std::vector<BuildTypeAndFile> libs_with_invalid_crt;
 
-        for (const fs::path& lib : libs)
+        for (size_t i = 0; i < libs.size(); ++i)
         {
-            const std::string cmd_line =
-                Strings::format(R"("%s" /directives "%s")", dumpbin_exe.u8string(), lib.u8string());
-            System::ExitCodeAndOutput ec_data = System::cmd_execute_and_capture_output(cmd_line);
-            Checks::check_exit(VCPKG_LINE_INFO, ec_data.exit_code == 0, "Running command:\n   %s\n failed", cmd_line);
+            const std::string& directives = lib_infos[i].linker_directives;
 
             for (const BuildType& bad_build_type : bad_build_types)
             {
-                if (std::regex_search(ec_data.output.cbegin(), ec_data.output.cend(), bad_build_type.crt_regex()))
+                if (std::regex_search(directives.cbegin(), directives.cend(), bad_build_type.crt_regex()))
                 {
-                    libs_with_invalid_crt.push_back({lib, bad_build_type});
+                    libs_with_invalid_crt.push_back({libs[i], bad_build_type});
                     break;
                 }
             }
@@ -652,25 +659,27 @@ namespace vcpkg::PostBuildLint
     };
 
     static LintStatus check_outdated_crt_linkage_of_dlls(const std::vector<fs::path>& dlls,
-                                                         const fs::path dumpbin_exe,
+                                                         const std::vector<CoffFileReader::DllInfo>& dll_infos,
                                                          const BuildInfo& build_info,
                                                          const PreBuildInfo& pre_build_info)
     {
         if (build_info.policies.is_enabled(BuildPolicy::ALLOW_OBSOLETE_MSVCRT)) return LintStatus::SUCCESS;
 
+        const auto outdated_crts = get_outdated_dynamic_crts(pre_build_info.platform_toolset);
+
         std::vector<OutdatedDynamicCrtAndFile> dlls_with_outdated_crt;
 
-        for (const fs::path& dll : dlls)
+        for (size_t i = 0; i < dlls.size(); ++i)
         {
-            const auto cmd_line = Strings::format(R"("%s" /dependents "%s")", dumpbin_exe.u8string(), dll.u8string());
-            System::ExitCodeAndOutput ec_data = System::cmd_execute_and_capture_output(cmd_line);
-            Checks::check_exit(VCPKG_LINE_INFO, ec_data.exit_code == 0, "Running command:\n   %s\n failed", cmd_line);
-
-            for (const OutdatedDynamicCrt& outdated_crt : get_outdated_dynamic_crts(pre_build_info.platform_toolset))
+            for (const std::string& import_name : dll_infos[i].imported_dll_names)
             {
-                if (std::regex_search(ec_data.output.cbegin(), ec_data.output.cend(), outdated_crt.regex))
+                const auto it =
+                    Util::find_if(outdated_crts, [&](const OutdatedDynamicCrt& crt) {
+                        return Strings::case_insensitive_ascii_equals(import_name.c_str(), crt.name.c_str());
+                    });
+                if (it != outdated_crts.end())
                 {
-                    dlls_with_outdated_crt.push_back({dll, outdated_crt});
+                    dlls_with_outdated_crt.push_back({dlls[i], *it});
                     break;
                 }
             }
@@ -725,8 +734,6 @@ namespace vcpkg::PostBuildLint
     {
         const auto& fs = paths.get_filesystem();
 
-        // for dumpbin
-        const Toolset& toolset = paths.get_toolset(pre_build_info);
         const fs::path package_dir = paths.package_dir(spec);
 
         size_t error_count = 0;
@@ -761,12 +768,21 @@ namespace vcpkg::PostBuildLint
         if (!pre_build_info.build_type)
             error_count += check_matching_debug_and_release_binaries(debug_libs, release_libs);
 
+        // Map and parse each lib exactly once; the architecture and CRT linkage
+        // checks below share the results.
+        const std::vector<CoffFileReader::LibInfo> debug_lib_infos = read_lib_infos(debug_libs);
+        const std::vector<CoffFileReader::LibInfo> release_lib_infos = read_lib_infos(release_libs);
+
         {
             std::vector<fs::path> libs;
             libs.insert(libs.cend(), debug_libs.cbegin(), debug_libs.cend());
             libs.insert(libs.cend(), release_libs.cbegin(), release_libs.cend());
 
-            error_count += check_lib_architecture(pre_build_info.target_architecture, libs);
+            std::vector<CoffFileReader::LibInfo> lib_infos;
+            lib_infos.insert(lib_infos.cend(), debug_lib_infos.cbegin(), debug_lib_infos.cend());
+            lib_infos.insert(lib_infos.cend(), release_lib_infos.cbegin(), release_lib_infos.cend());
+
+            error_count += check_lib_architecture(pre_build_info.target_architecture, libs, lib_infos);
         }
 
         std::vector<fs::path> debug_dlls = fs.get_files_recursive(debug_bin_dir);
@@ -790,11 +806,13 @@ namespace vcpkg::PostBuildLint
                 dlls.insert(dlls.cend(), debug_dlls.cbegin(), debug_dlls.cend());
                 dlls.insert(dlls.cend(), release_dlls.cbegin(), release_dlls.cend());
 
-                error_count += check_exports_of_dlls(dlls, toolset.dumpbin);
-                error_count += check_uwp_bit_of_dlls(pre_build_info.cmake_system_name, dlls, toolset.dumpbin);
-                error_count += check_dll_architecture(pre_build_info.target_architecture, dlls);
+                const std::vector<CoffFileReader::DllInfo> dll_infos = read_dll_infos(dlls);
 
-                error_count += check_outdated_crt_linkage_of_dlls(dlls, toolset.dumpbin, build_info, pre_build_info);
+                error_count += check_exports_of_dlls(dlls, dll_infos);
+                error_count += check_uwp_bit_of_dlls(pre_build_info.cmake_system_name, dlls, dll_infos);
+                error_count += check_dll_architecture(pre_build_info.target_architecture, dlls, dll_infos);
+
+                error_count += check_outdated_crt_linkage_of_dlls(dlls, dll_infos, build_info, pre_build_info);
                 break;
             }
             case Build::LinkageType::STATIC:
@@ -810,12 +828,12 @@ namespace vcpkg::PostBuildLint
                     error_count += check_crt_linkage_of_libs(
                         BuildType::value_of(Build::ConfigurationType::DEBUG, build_info.crt_linkage),
                         debug_libs,
-                        toolset.dumpbin);
+                        debug_lib_infos);
                 }
                 error_count += check_crt_linkage_of_libs(
                     BuildType::value_of(Build::ConfigurationType::RELEASE, build_info.crt_linkage),
                     release_libs,
-                    toolset.dumpbin);
+                    release_lib_infos);
                 break;
             }
             default: Checks::unreachable(VCPKG_LINE_INFO);
@@ -833,6 +851,8 @@ namespace vcpkg::PostBuildLint
                               const PreBuildInfo& pre_build_info,
                               const BuildInfo& build_info)
     {
+        const AllocStats::TagScope alloc_scope("lint");
+
         System::println("-- Performing post-build validation");
         const size_t error_count = perform_all_checks_and_return_error_count(spec, paths, pre_build_info, build_info);
 
@@ -1,9 +1,11 @@
 #include "pch.h"
 
+#include <vcpkg/base/parallel.h>
 #include <vcpkg/base/system.h>
 #include <vcpkg/base/util.h>
 #include <vcpkg/commands.h>
 #include <vcpkg/dependencies.h>
+#include <vcpkg/globalstate.h>
 #include <vcpkg/help.h>
 #include <vcpkg/input.h>
 #include <vcpkg/paragraphs.h>
@@ -33,13 +35,28 @@ namespace vcpkg::Remove
             write_update(paths, pkg);
         }
 
-        auto maybe_lines = fs.read_lines(paths.listfile_path(core_pkg.package));
+        auto maybe_lines = read_listfile(fs, paths.listfile_path(core_pkg.package));
 
         if (const auto lines = maybe_lines.get())
         {
-            std::vector<fs::path> dirs_touched;
-            for (auto&& suffix : *lines)
+            // Files listed for a package are independent of each other, so their
+            // deletion is fanned across workers. Directories are only recorded here
+            // (tagged with their listfile position) and pruned after the files are
+            // gone, children before parents, which needs the original ordering.
+            struct DirEntry
             {
+                size_t listfile_position;
+                fs::path path;
+            };
+
+            static const size_t PARALLEL_REMOVE_THRESHOLD = 256;
+            const size_t worker_count =
+                lines->size() < PARALLEL_REMOVE_THRESHOLD ? 1 : Parallel::worker_count_for(lines->size());
+
+            std::vector<std::vector<DirEntry>> dirs_per_worker(worker_count);
+
+            Parallel::for_each_index_with_worker(worker_count, lines->size(), [&](const size_t i, const size_t worker) {
+                std::string suffix = (*lines)[i];
                 if (!suffix.empty() && suffix.back() == '\r') suffix.pop_back();
 
                 std::error_code ec;
@@ -50,12 +67,12 @@ namespace vcpkg::Remove
                 if (ec)
                 {
                     System::println(System::Color::error, "failed: %s", ec.message());
-                    continue;
+                    return;
                 }
 
                 if (fs::is_directory(status))
                 {
-                    dirs_touched.push_back(target);
+                    dirs_per_worker[worker].push_back({i, std::move(target)});
                 }
                 else if (fs::is_regular_file(status))
                 {
@@ -64,6 +81,10 @@ namespace vcpkg::Remove
                     {
                         System::println(System::Color::error, "failed: %s: %s", target.u8string(), ec.message());
                     }
+                    else
+                    {
+                        GlobalState::g_removed_file_count.increment();
+                    }
                 }
                 else if (!fs::status_known(status))
                 {
@@ -73,16 +94,23 @@ namespace vcpkg::Remove
                 {
                     System::println(System::Color::warning, "Warning: %s: cannot handle file type", target.u8string());
                 }
-            }
+            });
+
+            std::vector<DirEntry> dirs_touched;
+            for (std::vector<DirEntry>& dirs : dirs_per_worker)
+                std::move(dirs.begin(), dirs.end(), std::back_inserter(dirs_touched));
+            std::sort(dirs_touched.begin(), dirs_touched.end(), [](const DirEntry& l, const DirEntry& r) {
+                return l.listfile_position < r.listfile_position;
+            });
 
             auto b = dirs_touched.rbegin();
             const auto e = dirs_touched.rend();
             for (; b != e; ++b)
             {
-                if (fs.is_empty(*b))
+                if (fs.is_empty(b->path))
                 {
                     std::error_code ec;
-                    fs.remove(*b, ec);
+                    fs.remove(b->path, ec);
                     if (ec)
                     {
                         System::println(System::Color::error, "failed: %s", ec.message());
@@ -90,7 +118,12 @@ namespace vcpkg::Remove
                 }
             }
 
-            fs.remove(paths.listfile_path(core_pkg.package));
+            std::error_code ec;
+            fs.remove(paths.listfile_path(core_pkg.package), ec);
+            if (ec)
+            {
+                System::println(System::Color::error, "failed: %s", ec.message());
+            }
         }
 
         for (auto&& spgh : spghs)
@@ -208,9 +241,9 @@ namespace vcpkg::Remove
                 Checks::exit_fail(VCPKG_LINE_INFO);
             }
 
-            Dependencies::PathsPortFileProvider provider(paths);
+            Dependencies::PathsPortFileProvider provider(paths, args.overlay_ports);
 
-            specs = Util::fmap(Update::find_outdated_packages(provider, status_db),
+            specs = Util::fmap(Update::find_outdated_packages(paths, provider, status_db),
                                [](auto&& outdated) { return outdated.spec; });
 
             if (specs.empty())
@@ -92,15 +92,15 @@ namespace vcpkg
 
         auto spgh = std::make_unique<SourceParagraph>();
 
-        parser.required_field(SourceParagraphFields::SOURCE, spgh->name);
-        parser.required_field(SourceParagraphFields::VERSION, spgh->version);
+        parser.required_field(ControlField::SOURCE, spgh->name);
+        parser.required_field(ControlField::VERSION, spgh->version);
 
-        spgh->description = parser.optional_field(SourceParagraphFields::DESCRIPTION);
-        spgh->maintainer = parser.optional_field(SourceParagraphFields::MAINTAINER);
-        spgh->depends = expand_qualified_dependencies(
-            parse_comma_list(parser.optional_field(SourceParagraphFields::BUILD_DEPENDS)));
-        spgh->supports = parse_comma_list(parser.optional_field(SourceParagraphFields::SUPPORTS));
-        spgh->default_features = parse_comma_list(parser.optional_field(SourceParagraphFields::DEFAULTFEATURES));
+        spgh->description = parser.optional_field(ControlField::DESCRIPTION);
+        spgh->maintainer = parser.optional_field(ControlField::MAINTAINER);
+        const std::string build_depends = parser.optional_field(ControlField::BUILD_DEPENDS);
+        spgh->depends = expand_qualified_dependencies(parse_comma_list_views(build_depends));
+        spgh->supports = parse_comma_list(parser.optional_field(ControlField::SUPPORTS));
+        spgh->default_features = parse_comma_list(parser.optional_field(ControlField::DEFAULT_FEATURES));
 
         auto err = parser.error_info(spgh->name);
         if (err)
@@ -115,11 +115,11 @@ namespace vcpkg
 
         auto fpgh = std::make_unique<FeatureParagraph>();
 
-        parser.required_field(SourceParagraphFields::FEATURE, fpgh->name);
-        parser.required_field(SourceParagraphFields::DESCRIPTION, fpgh->description);
+        parser.required_field(ControlField::FEATURE, fpgh->name);
+        parser.required_field(ControlField::DESCRIPTION, fpgh->description);
 
-        fpgh->depends = expand_qualified_dependencies(
-            parse_comma_list(parser.optional_field(SourceParagraphFields::BUILD_DEPENDS)));
+        const std::string build_depends = parser.optional_field(ControlField::BUILD_DEPENDS);
+        fpgh->depends = expand_qualified_dependencies(parse_comma_list_views(build_depends));
 
         auto err = parser.error_info(fpgh->name);
         if (err)
@@ -129,7 +129,7 @@ namespace vcpkg
     }
 
     ParseExpected<SourceControlFile> SourceControlFile::parse_control_file(
-        std::vector<std::unordered_map<std::string, std::string>>&& control_paragraphs)
+        std::vector<Parse::RawParagraph>&& control_paragraphs)
     {
         if (control_paragraphs.size() == 0)
         {
@@ -140,7 +140,7 @@ namespace vcpkg
 
         auto maybe_source = parse_source_paragraph(std::move(control_paragraphs.front()));
         if (const auto source = maybe_source.get())
-            control_file->core_paragraph = std::move(*source);
+            control_file->core_paragraph = std::move(**source);
         else
             return std::move(maybe_source).error();
 
@@ -150,7 +150,7 @@ namespace vcpkg
         {
             auto maybe_feature = parse_feature_paragraph(std::move(feature_pgh));
             if (const auto feature = maybe_feature.get())
-                control_file->feature_paragraphs.emplace_back(std::move(*feature));
+                control_file->feature_paragraphs.emplace_back(std::move(**feature));
             else
                 return std::move(maybe_feature).error();
         }
@@ -161,9 +161,9 @@ namespace vcpkg
     Dependency Dependency::parse_dependency(std::string name, std::string qualifier)
     {
         Dependency dep;
-        dep.qualifier = qualifier;
+        dep.qualifier = std::move(qualifier);
         if (auto maybe_features = Features::from_string(name))
-            dep.depend = *maybe_features.get();
+            dep.depend = std::move(*maybe_features.get());
         else
             Checks::exit_with_message(
                 VCPKG_LINE_INFO, "error while parsing dependency: %s: %s", to_string(maybe_features.error()), name);
@@ -180,19 +180,27 @@ namespace vcpkg
 
     std::vector<Dependency> expand_qualified_dependencies(const std::vector<std::string>& depends)
     {
-        return Util::fmap(depends, [&](const std::string& depend_string) -> Dependency {
-            auto pos = depend_string.find(' ');
-            if (pos == std::string::npos) return Dependency::parse_dependency(depend_string, "");
+        return expand_qualified_dependencies(
+            Util::fmap(depends, [](const std::string& s) { return Span<const char>(s.data(), s.size()); }));
+    }
+
+    std::vector<Dependency> expand_qualified_dependencies(Span<const Span<const char>> depends)
+    {
+        return Util::fmap(depends, [](const Span<const char>& depend_view) -> Dependency {
+            const char* const first = depend_view.begin();
+            const char* const last = depend_view.end();
+            const char* const pos = std::find(first, last, ' ');
+            if (pos == last) return Dependency::parse_dependency(std::string(first, last), "");
             // expect of the form "\w+ \[\w+\]"
             Dependency dep;
 
-            dep.depend.name = depend_string.substr(0, pos);
-            if (depend_string.c_str()[pos + 1] != '(' || depend_string[depend_string.size() - 1] != ')')
+            if (pos + 1 == last || *(pos + 1) != '(' || *(last - 1) != ')')
             {
                 // Error, but for now just slurp the entire string.
-                return Dependency::parse_dependency(depend_string, "");
+                return Dependency::parse_dependency(std::string(first, last), "");
             }
-            dep.qualifier = depend_string.substr(pos + 2, depend_string.size() - pos - 3);
+            dep.depend.name.assign(first, pos);
+            dep.qualifier.assign(pos + 2, last - 1);
             return dep;
         });
     }
@@ -212,7 +220,31 @@ namespace vcpkg
 
     std::vector<FeatureSpec> filter_dependencies_to_specs(const std::vector<Dependency>& deps, const Triplet& t)
     {
-        return FeatureSpec::from_strings_and_triplet(filter_dependencies(deps, t), t);
+        // The planner calls this for every cluster it expands, so the specs are built
+        // straight from the pre-split dependency data rather than formatting
+        // "name[features]" strings and re-parsing them.
+        std::vector<FeatureSpec> f_specs;
+        for (auto&& dep : deps)
+        {
+            if (!dep.qualifier.empty() && t.canonical_name().find(dep.qualifier) == std::string::npos)
+            {
+                continue;
+            }
+
+            const PackageSpec pspec =
+                PackageSpec::from_name_and_triplet(dep.depend.name, t).value_or_exit(VCPKG_LINE_INFO);
+
+            for (auto&& feature : dep.depend.features)
+            {
+                f_specs.emplace_back(pspec, feature);
+            }
+
+            if (dep.depend.features.empty())
+            {
+                f_specs.emplace_back(pspec, "");
+            }
+        }
+        return f_specs;
     }
 
     std::string to_string(const Dependency& dep) { return dep.name(); }
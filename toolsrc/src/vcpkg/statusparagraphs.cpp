@@ -1,26 +1,112 @@
 #include "pch.h"
 
 #include <vcpkg/base/checks.h>
+#include <vcpkg/paragraphs.h>
 #include <vcpkg/statusparagraphs.h>
 
 namespace vcpkg
 {
     StatusParagraphs::StatusParagraphs() = default;
 
-    StatusParagraphs::StatusParagraphs(std::vector<std::unique_ptr<StatusParagraph>>&& ps)
-        : paragraphs(std::move(ps)){};
+    StatusParagraphs::StatusParagraphs(std::vector<std::unique_ptr<StatusParagraph>>&& ps) : paragraphs(std::move(ps))
+    {
+        rebuild_index();
+    };
 
-    std::vector<std::unique_ptr<StatusParagraph>*> StatusParagraphs::find_all(const std::string& name,
-                                                                              const Triplet& triplet)
+    // Pulls just the Package and Architecture fields out of an unparsed record --
+    // enough for the index key without deserializing anything else.
+    static Optional<size_t> raw_record_key(const std::string& record)
     {
-        std::vector<std::unique_ptr<StatusParagraph>*> spghs;
-        for (auto&& p : *this)
+        std::string name, architecture;
+        size_t pos = 0;
+        while (pos < record.size() && (name.empty() || architecture.empty()))
+        {
+            size_t line_end = record.find('\n', pos);
+            if (line_end == std::string::npos) line_end = record.size();
+            size_t content_end = line_end;
+            if (content_end > pos && record[content_end - 1] == '\r') --content_end;
+
+            static const char PACKAGE_PREFIX[] = "Package: ";
+            static const char ARCHITECTURE_PREFIX[] = "Architecture: ";
+            if (record.compare(pos, sizeof(PACKAGE_PREFIX) - 1, PACKAGE_PREFIX) == 0)
+                name = record.substr(pos + sizeof(PACKAGE_PREFIX) - 1, content_end - pos - sizeof(PACKAGE_PREFIX) + 1);
+            else if (record.compare(pos, sizeof(ARCHITECTURE_PREFIX) - 1, ARCHITECTURE_PREFIX) == 0)
+                architecture = record.substr(pos + sizeof(ARCHITECTURE_PREFIX) - 1,
+                                             content_end - pos - sizeof(ARCHITECTURE_PREFIX) + 1);
+
+            pos = line_end + 1;
+        }
+
+        if (name.empty() || architecture.empty()) return nullopt;
+        return PackageSpec::intern_id(name, Triplet::from_canonical_name(architecture));
+    }
+
+    StatusParagraphs::StatusParagraphs(std::vector<std::string>&& rs)
+        : paragraphs(rs.size()), raw_records(std::move(rs))
+    {
+        for (size_t i = 0; i < raw_records.size(); ++i)
         {
-            if (p->package.spec.name() == name && p->package.spec.triplet() == triplet)
+            const auto maybe_key = raw_record_key(raw_records[i]);
+            if (const auto key = maybe_key.get())
             {
-                spghs.emplace_back(&p);
+                index.emplace(*key, i);
+            }
+            else
+            {
+                // A record the scanner cannot key is deserialized now; the full
+                // parser then reports whatever is wrong with it.
+                materialize(i);
+                index.emplace(paragraphs[i]->package.spec.id(), i);
             }
         }
+    }
+
+    void StatusParagraphs::materialize(const size_t i) const
+    {
+        if (paragraphs[i]) return;
+
+        auto fields = Paragraphs::parse_single_paragraph(raw_records[i]);
+        Checks::check_exit(VCPKG_LINE_INFO, fields.get() != nullptr, "Failed to parse status database record");
+        paragraphs[i] = std::make_unique<StatusParagraph>(std::move(*fields.get()));
+        raw_records[i].clear();
+    }
+
+    void StatusParagraphs::materialize_all() const
+    {
+        for (size_t i = 0; i < paragraphs.size(); ++i)
+            materialize(i);
+    }
+
+    size_t StatusParagraphs::index_key(const std::string& name, const Triplet& triplet)
+    {
+        return PackageSpec::intern_id(name, triplet);
+    }
+
+    void StatusParagraphs::rebuild_index()
+    {
+        index.clear();
+        for (size_t i = 0; i < paragraphs.size(); ++i)
+        {
+            index.emplace(paragraphs[i]->package.spec.id(), i);
+        }
+    }
+
+    std::vector<std::unique_ptr<StatusParagraph>*> StatusParagraphs::find_all(const std::string& name,
+                                                                              const Triplet& triplet)
+    {
+        const auto range = index.equal_range(index_key(name, triplet));
+        std::vector<size_t> positions;
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            materialize(it->second);
+            positions.push_back(it->second);
+        }
+        // Iteration over this container runs back-to-front; preserve that ordering.
+        std::sort(positions.rbegin(), positions.rend());
+
+        std::vector<std::unique_ptr<StatusParagraph>*> spghs;
+        for (const size_t i : positions)
+            spghs.emplace_back(&paragraphs[i]);
         return spghs;
     }
 
@@ -28,20 +114,40 @@ namespace vcpkg
                                                       const Triplet& triplet,
                                                       const std::string& feature)
     {
-        return std::find_if(begin(), end(), [&](const std::unique_ptr<StatusParagraph>& pgh) {
-            const PackageSpec& spec = pgh->package.spec;
-            return spec.name() == name && spec.triplet() == triplet && pgh->package.feature == feature;
-        });
+        const auto range = index.equal_range(index_key(name, triplet));
+        size_t best = 0;
+        bool found = false;
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            materialize(it->second);
+            if (paragraphs[it->second]->package.feature == feature && (!found || it->second > best))
+            {
+                best = it->second;
+                found = true;
+            }
+        }
+        if (!found) return end();
+        return paragraphs.rbegin() + (paragraphs.size() - 1 - best);
     }
 
     StatusParagraphs::const_iterator StatusParagraphs::find(const std::string& name,
                                                             const Triplet& triplet,
                                                             const std::string& feature) const
     {
-        return std::find_if(begin(), end(), [&](const std::unique_ptr<StatusParagraph>& pgh) {
-            const PackageSpec& spec = pgh->package.spec;
-            return spec.name() == name && spec.triplet() == triplet && pgh->package.feature == feature;
-        });
+        const auto range = index.equal_range(index_key(name, triplet));
+        size_t best = 0;
+        bool found = false;
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            materialize(it->second);
+            if (paragraphs[it->second]->package.feature == feature && (!found || it->second > best))
+            {
+                best = it->second;
+                found = true;
+            }
+        }
+        if (!found) return end();
+        return paragraphs.crbegin() + (paragraphs.size() - 1 - best);
     }
 
     StatusParagraphs::const_iterator StatusParagraphs::find_installed(const std::string& name,
@@ -56,6 +162,18 @@ namespace vcpkg
         return end();
     }
 
+    std::vector<const StatusParagraph*> StatusParagraphs::find_all_installed(Span<const PackageSpec> specs) const
+    {
+        std::vector<const StatusParagraph*> results;
+        results.reserve(specs.size());
+        for (const PackageSpec& spec : specs)
+        {
+            const const_iterator it = find_installed(spec);
+            results.push_back(it == end() ? nullptr : it->get());
+        }
+        return results;
+    }
+
     StatusParagraphs::iterator StatusParagraphs::insert(std::unique_ptr<StatusParagraph> pgh)
     {
         Checks::check_exit(VCPKG_LINE_INFO, pgh != nullptr, "Inserted null paragraph");
@@ -64,6 +182,7 @@ namespace vcpkg
         if (ptr == end())
         {
             paragraphs.push_back(std::move(pgh));
+            index.emplace(paragraphs.back()->package.spec.id(), paragraphs.size() - 1);
             return paragraphs.rbegin();
         }
 
@@ -72,11 +191,44 @@ namespace vcpkg
         return ptr;
     }
 
+    // Upper-bound size of one serialized paragraph: the sum of its field lengths plus
+    // a fixed allowance for field labels and the status line.
+    static size_t serialized_size_estimate(const StatusParagraph& pgh)
+    {
+        const BinaryParagraph& p = pgh.package;
+        size_t size = 160;
+        size += p.spec.name().size() + p.spec.triplet().canonical_name().size();
+        size += p.version.size() + p.feature.size() + p.maintainer.size() + p.abi.size() + p.description.size();
+        for (const std::string& dep : p.depends)
+        {
+            size += dep.size() + 2;
+        }
+        return size;
+    }
+
     void serialize(const StatusParagraphs& pghs, std::string& out_str)
     {
-        for (auto& pgh : pghs.paragraphs)
+        // A full database rewrite appends thousands of fields; reserving the estimated
+        // total up front keeps it one contiguous buffer instead of a reallocation per
+        // growth step, and the caller hands that buffer to a single write_contents().
+        size_t estimate = out_str.size();
+        for (size_t i = 0; i < pghs.paragraphs.size(); ++i)
         {
-            serialize(*pgh, out_str);
+            estimate += pghs.paragraphs[i] ? serialized_size_estimate(*pghs.paragraphs[i])
+                                           : pghs.raw_records[i].size() + 1;
+        }
+        out_str.reserve(estimate);
+
+        for (size_t i = 0; i < pghs.paragraphs.size(); ++i)
+        {
+            // Records nobody materialized round-trip verbatim.
+            if (!pghs.paragraphs[i])
+            {
+                out_str.append(pghs.raw_records[i]);
+                out_str.push_back('\n');
+                continue;
+            }
+            serialize(*pghs.paragraphs[i], out_str);
             out_str.push_back('\n');
         }
     }
@@ -14,11 +14,54 @@ namespace vcpkg::Update
         return left.spec.name() < right.spec.name();
     }
 
-    std::vector<OutdatedPackage> find_outdated_packages(const Dependencies::PortFileProvider& provider,
+    namespace
+    {
+        // The version each port's CONTROL declared the last time update planning looked
+        // at it, stamped with the CONTROL mtime and size it was read under. A port whose
+        // stamp still matches needs no parse at all, so repeated update/upgrade planning
+        // costs O(changed ports) parses instead of O(installed ports).
+        struct PortVersionStamp
+        {
+            int64_t mtime;
+            uint64_t size;
+            std::string version;
+        };
+
+        const char* const PORT_VERSIONS_INDEX_VERSION = "1";
+
+        std::unordered_map<std::string, PortVersionStamp> load_port_version_stamps(const Files::Filesystem& fs,
+                                                                                   const fs::path& stamps_path)
+        {
+            std::unordered_map<std::string, PortVersionStamp> stamps;
+            auto maybe_lines = fs.read_lines(stamps_path);
+            const auto lines = maybe_lines.get();
+            if (!lines || lines->empty() || (*lines)[0] != PORT_VERSIONS_INDEX_VERSION) return stamps;
+
+            for (size_t i = 1; i < lines->size(); ++i)
+            {
+                const std::vector<std::string> fields = Strings::split((*lines)[i], "\t");
+                if (fields.size() != 4) continue;
+                stamps.emplace(fields[0],
+                               PortVersionStamp{std::strtoll(fields[1].c_str(), nullptr, 10),
+                                                std::strtoull(fields[2].c_str(), nullptr, 10),
+                                                fields[3]});
+            }
+
+            return stamps;
+        }
+    }
+
+    std::vector<OutdatedPackage> find_outdated_packages(const VcpkgPaths& paths,
+                                                        const Dependencies::PortFileProvider& provider,
                                                         const StatusParagraphs& status_db)
     {
         const std::vector<StatusParagraph*> installed_packages = get_installed_ports(status_db);
 
+        auto& fs = paths.get_filesystem();
+        const fs::path stamps_path = paths.root / ".vcpkg-port-versions.idx";
+        auto stamps = load_port_version_stamps(fs, stamps_path);
+        bool stamps_dirty = false;
+
         std::vector<OutdatedPackage> output;
         for (const StatusParagraph* pgh : installed_packages)
         {
@@ -28,19 +71,56 @@ namespace vcpkg::Update
                 continue;
             }
 
-            auto maybe_scf = provider.get_control_file(pgh->package.spec.name());
-            if (auto p_scf = maybe_scf.get())
+            const std::string& name = pgh->package.spec.name();
+
+            std::error_code ec;
+            const fs::path control_path = paths.port_dir(name) / "CONTROL";
+            const int64_t mtime = fs.last_write_time(control_path, ec);
+            const uint64_t size = ec ? 0 : fs.file_size(control_path, ec);
+
+            std::string port_version;
+            const auto stamp_it = ec ? stamps.end() : stamps.find(name);
+            if (stamp_it != stamps.end() && stamp_it->second.mtime == mtime && stamp_it->second.size == size)
+            {
+                port_version = stamp_it->second.version;
+            }
+            else
             {
-                auto&& port_version = p_scf->core_paragraph->version;
-                auto&& installed_version = pgh->package.version;
-                if (installed_version != port_version)
+                auto maybe_scf = provider.get_control_file(name);
+                if (auto p_scf = maybe_scf.get())
                 {
-                    output.push_back({pgh->package.spec, VersionDiff(installed_version, port_version)});
+                    port_version = p_scf->core_paragraph.version;
+                    if (!ec)
+                    {
+                        stamps[name] = {mtime, size, port_version};
+                        stamps_dirty = true;
+                    }
+                }
+                else
+                {
+                    // No portfile available
+                    continue;
                 }
             }
-            else
+
+            auto&& installed_version = pgh->package.version;
+            if (installed_version != port_version)
+            {
+                output.push_back({pgh->package.spec, VersionDiff(installed_version, port_version)});
+            }
+        }
+
+        if (stamps_dirty)
+        {
+            Files::BufferedWriter writer = fs.open_for_write(stamps_path);
+            writer.write_line(PORT_VERSIONS_INDEX_VERSION);
+            for (const auto& stamp : stamps)
             {
-                // No portfile available
+                writer.write_line(Strings::format("%s\t%lld\t%llu\t%s",
+                                                  stamp.first,
+                                                  static_cast<long long>(stamp.second.mtime),
+                                                  static_cast<unsigned long long>(stamp.second.size),
+                                                  stamp.second.version));
             }
         }
 
@@ -62,9 +142,9 @@ namespace vcpkg::Update
 
         const StatusParagraphs status_db = database_load_check(paths);
 
-        Dependencies::PathsPortFileProvider provider(paths);
+        Dependencies::PathsPortFileProvider provider(paths, args.overlay_ports);
 
-        const auto outdated_packages = SortedVector<OutdatedPackage>(find_outdated_packages(provider, status_db),
+        const auto outdated_packages = SortedVector<OutdatedPackage>(find_outdated_packages(paths, provider, status_db),
                                                                      &OutdatedPackage::compare_by_name);
 
         if (outdated_packages.empty())
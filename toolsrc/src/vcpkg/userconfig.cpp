@@ -29,6 +29,29 @@ namespace
 
 namespace vcpkg
 {
+    // The parse shared by get_cached() and, for the write-back comparison, the values
+    // the config file held when it was last read or written.
+    static UserConfig s_cached_config;
+    static UserConfig s_on_disk_config;
+    static bool s_config_loaded = false;
+
+    static bool config_equal(const UserConfig& left, const UserConfig& right)
+    {
+        return left.user_id == right.user_id && left.user_time == right.user_time &&
+               left.user_mac == right.user_mac && left.last_completed_survey == right.last_completed_survey;
+    }
+
+    UserConfig& UserConfig::get_cached(const Files::Filesystem& fs)
+    {
+        if (!s_config_loaded)
+        {
+            s_cached_config = try_read_data(fs);
+            s_on_disk_config = s_cached_config;
+            s_config_loaded = true;
+        }
+        return s_cached_config;
+    }
+
     UserConfig UserConfig::try_read_data(const Files::Filesystem& fs)
     {
         UserConfig ret;
@@ -41,11 +64,9 @@ namespace vcpkg
                 const auto& pghs = *p_pghs;
 
                 std::unordered_map<std::string, std::string> keys;
-                if (pghs.size() > 0) keys = pghs[0];
-
-                for (size_t x = 1; x < pghs.size(); ++x)
+                for (auto&& pgh : pghs)
                 {
-                    for (auto&& p : pghs[x])
+                    for (auto&& p : pgh)
                         keys.insert(p);
                 }
 
@@ -65,6 +86,8 @@ namespace vcpkg
 
     void UserConfig::try_write_data(Files::Filesystem& fs) const
     {
+        if (s_config_loaded && config_equal(*this, s_on_disk_config)) return;
+
 #if defined(_WIN32)
         try
         {
@@ -84,5 +107,8 @@ namespace vcpkg
         {
         }
 #endif
+
+        s_on_disk_config = *this;
+        s_config_loaded = true;
     }
 }
@@ -1,6 +1,9 @@
 #include "pch.h"
 
+#include <vcpkg/base/allocstats.h>
 #include <vcpkg/base/system.h>
+#include <vcpkg/base/stats.h>
+#include <vcpkg/base/timing.h>
 #include <vcpkg/commands.h>
 #include <vcpkg/globalstate.h>
 #include <vcpkg/help.h>
@@ -99,6 +102,19 @@ namespace vcpkg
                     parse_value(arg_begin, arg_end, "--triplet", args.triplet);
                     continue;
                 }
+                if (arg == "--overlay-ports")
+                {
+                    ++arg_begin;
+                    if (arg_begin == arg_end)
+                    {
+                        System::println(System::Color::error, "Error: expected value after --overlay-ports");
+                        Metrics::g_metrics.lock()->track_property("error", "error option name");
+                        Help::print_usage();
+                        Checks::exit_fail(VCPKG_LINE_INFO);
+                    }
+                    args.overlay_ports.push_back(*arg_begin);
+                    continue;
+                }
                 if (arg == "--debug")
                 {
                     parse_switch(true, "debug", args.debug);
@@ -129,6 +145,41 @@ namespace vcpkg
                     GlobalState::feature_packages = true;
                     continue;
                 }
+                if (arg == "--x-use-hard-links")
+                {
+                    GlobalState::g_use_hard_links = true;
+                    continue;
+                }
+                if (arg == "--x-content-store")
+                {
+                    GlobalState::g_use_content_store = true;
+                    continue;
+                }
+                if (arg == "--x-compress-packages")
+                {
+                    GlobalState::g_compress_packages = true;
+                    continue;
+                }
+                if (arg == "--x-compress-logs")
+                {
+                    GlobalState::g_compress_logs = true;
+                    continue;
+                }
+                if (arg == "--x-alloc-stats")
+                {
+                    AllocStats::enable();
+                    continue;
+                }
+                if (arg == "--debug-timing")
+                {
+                    Timing::enable();
+                    continue;
+                }
+                if (arg == "--stats")
+                {
+                    Stats::enable();
+                    continue;
+                }
 
                 const auto eq_pos = arg.find('=');
                 if (eq_pos != std::string::npos)
@@ -1,6 +1,8 @@
 #include "pch.h"
 
+#include <vcpkg/base/filelock.h>
 #include <vcpkg/base/files.h>
+#include <vcpkg/base/parallel.h>
 #include <vcpkg/base/strings.h>
 #include <vcpkg/base/util.h>
 #include <vcpkg/metrics.h>
@@ -9,66 +11,135 @@
 
 namespace vcpkg
 {
-    static StatusParagraphs load_current_database(Files::Filesystem& fs,
-                                                  const fs::path& vcpkg_dir_status_file,
-                                                  const fs::path& vcpkg_dir_status_file_old)
+    static fs::path database_lock_file(const VcpkgPaths& paths) { return paths.vcpkg_dir / "lock"; }
+
+    static StatusParagraphs load_status_paragraphs(const Files::Filesystem& fs, const fs::path& status_file)
     {
-        if (!fs.exists(vcpkg_dir_status_file))
+        // Only split the file into records here; StatusParagraphs deserializes a
+        // record the first time a lookup reaches it, so single-package commands
+        // parse one or two records no matter how many are installed.
+        const auto contents = fs.read_contents(status_file).value_or_exit(VCPKG_LINE_INFO);
+
+        std::vector<std::string> records;
+        std::string current;
+        size_t pos = 0;
+        while (pos < contents.size())
         {
-            if (!fs.exists(vcpkg_dir_status_file_old))
+            size_t line_end = contents.find('\n', pos);
+            const size_t next_pos = line_end == std::string::npos ? contents.size() : line_end + 1;
+            if (line_end == std::string::npos) line_end = contents.size();
+            size_t content_end = line_end;
+            if (content_end > pos && contents[content_end - 1] == '\r') --content_end;
+
+            if (content_end == pos)
             {
-                // no status file, use empty db
-                return StatusParagraphs();
+                // Blank line: end of record.
+                if (!current.empty())
+                {
+                    records.push_back(std::move(current));
+                    current.clear();
+                }
             }
-
-            fs.rename(vcpkg_dir_status_file_old, vcpkg_dir_status_file);
-        }
-
-        auto pghs = Paragraphs::get_paragraphs(fs, vcpkg_dir_status_file).value_or_exit(VCPKG_LINE_INFO);
-
-        std::vector<std::unique_ptr<StatusParagraph>> status_pghs;
-        for (auto&& p : pghs)
-        {
-            status_pghs.push_back(std::make_unique<StatusParagraph>(std::move(p)));
+            else
+            {
+                current.append(contents, pos, line_end - pos);
+                current.push_back('\n');
+            }
+            pos = next_pos;
         }
+        if (!current.empty()) records.push_back(std::move(current));
 
-        return StatusParagraphs(std::move(status_pghs));
+        return StatusParagraphs(std::move(records));
     }
 
-    StatusParagraphs database_load_check(const VcpkgPaths& paths)
+    // Loads the status file and folds in any pending update records. When `commit` is
+    // false the database directory is left untouched and `*out_needs_commit` reports
+    // whether a rewrite is pending, so the caller can retry under the exclusive lock.
+    static StatusParagraphs load_database(Files::Filesystem& fs,
+                                          const VcpkgPaths& paths,
+                                          const bool commit,
+                                          bool* out_needs_commit)
     {
-        auto& fs = paths.get_filesystem();
-
-        const auto updates_dir = paths.vcpkg_dir_updates;
-
-        std::error_code ec;
-        fs.create_directory(paths.installed, ec);
-        fs.create_directory(paths.vcpkg_dir, ec);
-        fs.create_directory(paths.vcpkg_dir_info, ec);
-        fs.create_directory(updates_dir, ec);
-
         const fs::path& status_file = paths.vcpkg_dir_status_file;
         const fs::path status_file_old = status_file.parent_path() / "status-old";
         const fs::path status_file_new = status_file.parent_path() / "status-new";
+        const auto updates_dir = paths.vcpkg_dir_updates;
+        const fs::path journal_file = updates_dir / "journal";
 
-        StatusParagraphs current_status_db = load_current_database(fs, status_file, status_file_old);
+        *out_needs_commit = false;
 
-        auto update_files = fs.get_files_non_recursive(updates_dir);
-        if (update_files.empty())
+        StatusParagraphs current_status_db;
+        if (fs.exists(status_file))
         {
-            // updates directory is empty, control file is up-to-date.
-            return current_status_db;
+            current_status_db = load_status_paragraphs(fs, status_file);
+        }
+        else if (fs.exists(status_file_old))
+        {
+            // Recovering from an interrupted rewrite mutates the database directory,
+            // so it is deferred to the exclusive pass.
+            *out_needs_commit = true;
+            if (!commit) return current_status_db;
+
+            fs.rename(status_file_old, status_file);
+            current_status_db = load_status_paragraphs(fs, status_file);
         }
+        // else: no status file, use empty db
+
+        auto update_files = fs.get_files_non_recursive(updates_dir);
+
+        // Replay legacy one-file-per-update records first; they predate any journal
+        // entries from the current scheme. The files are numbered in creation order,
+        // so applying them sorted by filename preserves last-writer-wins. An
+        // interrupted install can leave thousands of them, so the reads and parses
+        // fan out across worker threads; the results are folded in on this thread,
+        // in order, and any parse failure is reported from here as well.
+        std::vector<const fs::path*> replay_files;
         for (auto&& file : update_files)
         {
             if (!fs.is_regular_file(file)) continue;
             if (file.filename() == "incomplete") continue;
+            if (file.filename() == "journal") continue;
+            replay_files.push_back(&file);
+        }
+        std::sort(replay_files.begin(),
+                  replay_files.end(),
+                  [](const fs::path* lhs, const fs::path* rhs) { return lhs->filename() < rhs->filename(); });
+
+        std::vector<Expected<std::vector<Paragraphs::RawParagraph>>> parsed_updates(replay_files.size());
+        Parallel::for_each_index(replay_files.size(), [&](const size_t i) {
+            parsed_updates[i] = Paragraphs::get_paragraphs(fs, *replay_files[i]);
+        });
 
-            auto pghs = Paragraphs::get_paragraphs(fs, file).value_or_exit(VCPKG_LINE_INFO);
-            for (auto&& p : pghs)
+        for (auto&& parsed : parsed_updates)
+        {
+            for (auto&& p : parsed.value_or_exit(VCPKG_LINE_INFO))
             {
                 current_status_db.insert(std::make_unique<StatusParagraph>(std::move(p)));
             }
+            *out_needs_commit = true;
+        }
+
+        auto maybe_journal = fs.read_contents(journal_file);
+        if (const auto journal = maybe_journal.get())
+        {
+            // Only records terminated by a blank line were fully committed; a torn final
+            // append from an interrupted run is discarded.
+            const auto last_complete = journal->rfind("\n\n");
+            if (last_complete != std::string::npos)
+            {
+                auto pghs = Paragraphs::parse_paragraphs(journal->substr(0, last_complete + 2))
+                                .value_or_exit(VCPKG_LINE_INFO);
+                for (auto&& p : pghs)
+                {
+                    current_status_db.insert(std::make_unique<StatusParagraph>(std::move(p)));
+                }
+            }
+            *out_needs_commit = true;
+        }
+
+        if (!*out_needs_commit || !commit)
+        {
+            return current_status_db;
         }
 
         fs.write_contents(status_file_new, Strings::serialize(current_status_db));
@@ -79,23 +150,89 @@ namespace vcpkg
         {
             if (!fs.is_regular_file(file)) continue;
 
-            fs.remove(file);
+            std::error_code ec;
+            fs.remove(file, ec);
+            if (ec)
+            {
+                System::println(
+                    System::Color::warning, "Failed to remove %s: %s", file.u8string(), ec.message());
+            }
         }
 
         return current_status_db;
     }
 
+    StatusParagraphs database_load_check(const VcpkgPaths& paths)
+    {
+        auto& fs = paths.get_filesystem();
+
+        std::error_code ec;
+        fs.create_directory(paths.installed, ec);
+        fs.create_directory(paths.vcpkg_dir, ec);
+        fs.create_directory(paths.vcpkg_dir_info, ec);
+        fs.create_directory(paths.vcpkg_dir_updates, ec);
+
+        {
+            // Concurrent vcpkg processes (e.g. per-triplet installs on one machine) may
+            // read the status database simultaneously; only folding pending updates back
+            // into the status file requires excluding other processes.
+            const auto lock = Files::FileLock::take_shared(database_lock_file(paths));
+            bool needs_commit = false;
+            auto status_db = load_database(fs, paths, false, &needs_commit);
+            if (!needs_commit) return status_db;
+        }
+
+        // Reload under the exclusive lock: another process may have committed the
+        // pending updates in the window between releasing the shared lock and here.
+        const auto lock = Files::FileLock::take_exclusive(database_lock_file(paths));
+        bool needs_commit = false;
+        return load_database(fs, paths, true, &needs_commit);
+    }
+
+    StatusParagraphs database_load_readonly(const VcpkgPaths& paths)
+    {
+        auto& fs = paths.get_filesystem();
+
+        // Planning-only callers (install --dry-run) fold any pending updates into the
+        // in-memory database but never rewrite the status file, create directories, or
+        // take the exclusive lock, so a warm dry-run touches nothing on disk.
+        if (!fs.is_directory(paths.vcpkg_dir)) return StatusParagraphs();
+
+        const auto lock = Files::FileLock::take_shared(database_lock_file(paths));
+        bool needs_commit = false;
+        return load_database(fs, paths, false, &needs_commit);
+    }
+
     void write_update(const VcpkgPaths& paths, const StatusParagraph& p)
     {
-        static int update_id = 0;
         auto& fs = paths.get_filesystem();
 
-        const auto my_update_id = update_id++;
-        const auto tmp_update_filename = paths.vcpkg_dir_updates / "incomplete";
-        const auto update_filename = paths.vcpkg_dir_updates / std::to_string(my_update_id);
+        // Updates are journaled by appending to a single file instead of creating and
+        // renaming one file per update. database_load_check() folds complete records
+        // back into the status file and removes the journal; a record only counts as
+        // committed once its trailing blank line reaches the disk. The exclusive lock
+        // keeps concurrent processes from interleaving partial records and from
+        // appending while another process is truncating the journal.
+        const auto lock = Files::FileLock::take_exclusive(database_lock_file(paths));
+        std::string record = Strings::serialize(p);
+        record.push_back('\n');
+        fs.append_contents(paths.vcpkg_dir_updates / "journal", record);
+    }
+
+    void write_updates(const VcpkgPaths& paths, const std::vector<const StatusParagraph*>& pghs)
+    {
+        if (pghs.empty()) return;
 
-        fs.write_contents(tmp_update_filename, Strings::serialize(p));
-        fs.rename(tmp_update_filename, update_filename);
+        auto& fs = paths.get_filesystem();
+
+        const auto lock = Files::FileLock::take_exclusive(database_lock_file(paths));
+        std::string records;
+        for (const StatusParagraph* pgh : pghs)
+        {
+            serialize(*pgh, records);
+            records.push_back('\n');
+        }
+        fs.append_contents(paths.vcpkg_dir_updates / "journal", records);
     }
 
     static void upgrade_to_slash_terminated_sorted_format(Files::Filesystem& fs,
@@ -168,6 +305,60 @@ namespace vcpkg
         fs.rename(updated_listfile_path, listfile_path);
     }
 
+    static const char* const LISTFILE_V2_MARKER = "$vcpkg-list-version 2";
+
+    ListfileWriter::ListfileWriter(Files::Filesystem& fs, const fs::path& listfile)
+        : m_writer(fs.open_for_write(listfile))
+    {
+        m_writer.write_line(LISTFILE_V2_MARKER);
+    }
+
+    void ListfileWriter::write_path(const std::string& path)
+    {
+        const size_t max_common = std::min(m_previous.size(), path.size());
+        size_t common = 0;
+        while (common < max_common && m_previous[common] == path[common])
+            ++common;
+
+        m_line.clear();
+        m_line.append(std::to_string(common));
+        m_line.push_back(' ');
+        m_line.append(path, common, std::string::npos);
+        m_writer.write_line(m_line);
+        m_previous = path;
+    }
+
+    void ListfileWriter::flush() { m_writer.flush(); }
+
+    Expected<std::vector<std::string>> read_listfile(const Files::Filesystem& fs, const fs::path& listfile)
+    {
+        Expected<std::vector<std::string>> maybe_lines = fs.read_lines(listfile);
+        const auto lines = maybe_lines.get();
+        if (!lines || lines->empty() || (*lines)[0] != LISTFILE_V2_MARKER) return maybe_lines;
+
+        std::vector<std::string> decoded;
+        decoded.reserve(lines->size() - 1);
+        std::string previous;
+        for (size_t i = 1; i < lines->size(); ++i)
+        {
+            const std::string& line = (*lines)[i];
+            if (line.empty()) continue;
+
+            char* suffix = nullptr;
+            const unsigned long long common = std::strtoull(line.c_str(), &suffix, 10);
+            if (suffix == line.c_str() || *suffix != ' ' || common > previous.size())
+            {
+                return std::make_error_code(std::errc::bad_message);
+            }
+
+            previous.resize(static_cast<size_t>(common));
+            previous.append(suffix + 1);
+            decoded.push_back(previous);
+        }
+
+        return decoded;
+    }
+
     std::vector<StatusParagraph*> get_installed_ports(const StatusParagraphs& status_db)
     {
         std::vector<StatusParagraph*> installed_packages;
@@ -180,12 +371,59 @@ namespace vcpkg
         return installed_packages;
     }
 
+    namespace
+    {
+        // Consolidated index of every installed package's file list, persisted next to
+        // the status database. Each section is stamped with the mtime and size of the
+        // listfile it was built from, so entries go stale (and are rebuilt) exactly when
+        // install or remove rewrites the corresponding listfile. Loading one sequential
+        // file replaces opening hundreds of listfiles for queries like `vcpkg owns`.
+        struct FilesIndexEntry
+        {
+            int64_t mtime;
+            uint64_t size;
+            std::vector<std::string> files;
+        };
+
+        const char* const FILES_INDEX_VERSION = "1";
+
+        std::unordered_map<std::string, FilesIndexEntry> load_files_index(const Files::Filesystem& fs,
+                                                                          const fs::path& index_path)
+        {
+            std::unordered_map<std::string, FilesIndexEntry> index;
+            auto maybe_lines = fs.read_lines(index_path);
+            const auto lines = maybe_lines.get();
+            if (!lines || lines->empty() || (*lines)[0] != FILES_INDEX_VERSION) return index;
+
+            for (size_t i = 1; i < lines->size();)
+            {
+                const std::vector<std::string> header = Strings::split((*lines)[i], "\t");
+                if (header.size() != 4) break;
+                FilesIndexEntry entry;
+                entry.mtime = std::strtoll(header[1].c_str(), nullptr, 10);
+                entry.size = std::strtoull(header[2].c_str(), nullptr, 10);
+                const size_t file_count = std::strtoull(header[3].c_str(), nullptr, 10);
+                if (lines->size() - i - 1 < file_count) break;
+                entry.files.assign(lines->begin() + i + 1, lines->begin() + i + 1 + file_count);
+                i += 1 + file_count;
+                index.emplace(header[0], std::move(entry));
+            }
+
+            return index;
+        }
+    }
+
     std::vector<StatusParagraphAndAssociatedFiles> get_installed_files(const VcpkgPaths& paths,
                                                                        const StatusParagraphs& status_db)
     {
         auto& fs = paths.get_filesystem();
+        const fs::path index_path = paths.vcpkg_dir / "files.idx";
+
+        auto index = load_files_index(fs, index_path);
+        bool index_dirty = index.empty();
 
         std::vector<StatusParagraphAndAssociatedFiles> installed_files;
+        std::vector<std::pair<std::string, const FilesIndexEntry*>> index_order;
 
         for (const std::unique_ptr<StatusParagraph>& pgh : status_db)
         {
@@ -195,27 +433,66 @@ namespace vcpkg
             }
 
             const fs::path listfile_path = paths.listfile_path(pgh->package);
-            std::vector<std::string> installed_files_of_current_pgh =
-                fs.read_lines(listfile_path).value_or_exit(VCPKG_LINE_INFO);
-            Strings::trim_all_and_remove_whitespace_strings(&installed_files_of_current_pgh);
-            upgrade_to_slash_terminated_sorted_format(fs, &installed_files_of_current_pgh, listfile_path);
+            const std::string listfile_name = listfile_path.filename().generic_u8string();
 
-            // Remove the directories
-            Util::erase_remove_if(installed_files_of_current_pgh,
-                                  [](const std::string& file) { return file.back() == '/'; });
+            std::error_code ec;
+            const int64_t mtime = fs.last_write_time(listfile_path, ec);
+            const uint64_t size = ec ? 0 : fs.file_size(listfile_path, ec);
+
+            auto it = index.find(listfile_name);
+            if (ec || it == index.end() || it->second.mtime != mtime || it->second.size != size)
+            {
+                std::vector<std::string> installed_files_of_current_pgh =
+                    read_listfile(fs, listfile_path).value_or_exit(VCPKG_LINE_INFO);
+                Strings::trim_all_and_remove_whitespace_strings(&installed_files_of_current_pgh);
+                upgrade_to_slash_terminated_sorted_format(fs, &installed_files_of_current_pgh, listfile_path);
+
+                // Remove the directories
+                Util::erase_remove_if(installed_files_of_current_pgh,
+                                      [](const std::string& file) { return file.back() == '/'; });
+
+                FilesIndexEntry entry;
+                // Re-stat after the potential format upgrade rewrote the listfile.
+                entry.mtime = fs.last_write_time(listfile_path, ec);
+                entry.size = ec ? 0 : fs.file_size(listfile_path, ec);
+                entry.files = std::move(installed_files_of_current_pgh);
+                it = index.emplace(listfile_name, std::move(entry)).first;
+                index_dirty = true;
+            }
+
+            index_order.emplace_back(listfile_name, &it->second);
 
             StatusParagraphAndAssociatedFiles pgh_and_files = {
-                *pgh, SortedVector<std::string>(std::move(installed_files_of_current_pgh))};
+                *pgh, SortedVector<std::string>(std::vector<std::string>(it->second.files))};
             installed_files.push_back(std::move(pgh_and_files));
         }
 
+        if (index_dirty || index_order.size() != index.size())
+        {
+            Files::BufferedWriter writer = fs.open_for_write(index_path);
+            writer.write_line(FILES_INDEX_VERSION);
+            for (const auto& named_entry : index_order)
+            {
+                const FilesIndexEntry& entry = *named_entry.second;
+                writer.write_line(Strings::format("%s\t%lld\t%llu\t%zu",
+                                                  named_entry.first,
+                                                  static_cast<long long>(entry.mtime),
+                                                  static_cast<unsigned long long>(entry.size),
+                                                  entry.files.size()));
+                for (const std::string& file : entry.files)
+                {
+                    writer.write_line(file);
+                }
+            }
+        }
+
         return installed_files;
     }
 
     std::string shorten_text(const std::string& desc, const size_t length)
     {
         Checks::check_exit(VCPKG_LINE_INFO, length >= 3);
-        auto simple_desc = std::regex_replace(desc, std::regex("\\s+"), " ");
+        auto simple_desc = Strings::collapse_whitespace(desc);
         return simple_desc.size() <= length ? simple_desc : simple_desc.substr(0, length - 3) + "...";
     }
 }
@@ -65,16 +65,21 @@ namespace vcpkg
 
     static std::vector<std::string> keep_data_lines(const std::string& data_blob)
     {
-        static const std::regex DATA_LINE_REGEX(R"(<sol>::(.+?)(?=::<eol>))");
+        // Payloads are delimited as <sol>::<data>::<eol>; a direct scan replaces the
+        // lookahead regex previously compiled here on every call.
+        static const std::string SOL_MARKER = "<sol>::";
+        static const std::string EOL_MARKER = "::<eol>";
 
         std::vector<std::string> data_lines;
 
-        const std::sregex_iterator it(data_blob.cbegin(), data_blob.cend(), DATA_LINE_REGEX);
-        const std::sregex_iterator end;
-        for (std::sregex_iterator i = it; i != end; ++i)
+        size_t pos = data_blob.find(SOL_MARKER);
+        while (pos != std::string::npos)
         {
-            const std::smatch match = *i;
-            data_lines.push_back(match[1].str());
+            const size_t data_begin = pos + SOL_MARKER.size();
+            const size_t data_end = data_blob.find(EOL_MARKER, data_begin);
+            if (data_end == std::string::npos) break;
+            if (data_end > data_begin) data_lines.push_back(data_blob.substr(data_begin, data_end - data_begin));
+            pos = data_blob.find(SOL_MARKER, data_end + EOL_MARKER.size());
         }
 
         return data_lines;
@@ -278,15 +283,55 @@ namespace vcpkg
         return this->vcpkg_dir_info / (pgh.fullstem() + ".list");
     }
 
+    static fs::path triplet_cache_path(const VcpkgPaths& paths) { return paths.root / ".vcpkg-triplets.cache"; }
+
     const std::vector<std::string>& VcpkgPaths::get_available_triplets() const
     {
         return this->available_triplets.get_lazy([this]() -> std::vector<std::string> {
+            auto& fs = this->get_filesystem();
+
+            // Every command validates its triplet before doing anything useful, so the
+            // name list is persisted across invocations. The triplets directory's mtime
+            // changes whenever a file is added, removed, or renamed -- editing a file
+            // in place does not change the name list -- so it serves as the
+            // fingerprint.
+            std::error_code ec;
+            const int64_t dir_mtime = fs.last_write_time(this->triplets, ec);
+            const std::string fingerprint =
+                Strings::format("fingerprint %lld", static_cast<long long>(dir_mtime));
+
+            if (!ec)
+            {
+                auto maybe_lines = fs.read_lines(triplet_cache_path(*this));
+                if (const auto lines = maybe_lines.get())
+                {
+                    if (!lines->empty() && lines->front() == fingerprint)
+                    {
+                        std::vector<std::string> output(lines->begin() + 1, lines->end());
+                        Util::erase_remove_if(output, [](const std::string& s) { return s.empty(); });
+                        return output;
+                    }
+                }
+            }
+
             std::vector<std::string> output;
-            for (auto&& path : this->get_filesystem().get_files_non_recursive(this->triplets))
+            for (auto&& path : fs.get_files_non_recursive(this->triplets))
             {
                 output.push_back(path.stem().filename().string());
             }
 
+            if (!ec)
+            {
+                std::string contents = fingerprint;
+                contents.push_back('\n');
+                for (const std::string& name : output)
+                {
+                    contents.append(name);
+                    contents.push_back('\n');
+                }
+                fs.write_contents(triplet_cache_path(*this), contents);
+            }
+
             return output;
         });
     }
@@ -298,6 +343,13 @@ namespace vcpkg
         return it != this->get_available_triplets().cend();
     }
 
+    void VcpkgPaths::prefetch_tools() const
+    {
+        this->cmake_exe.prefetch([this]() { return get_cmake_path(this->downloads, this->scripts); });
+        this->git_exe.prefetch([this]() { return get_git_path(this->downloads, this->scripts); });
+        this->nuget_exe.prefetch([this]() { return get_nuget_path(this->downloads, this->scripts); });
+    }
+
     const fs::path& VcpkgPaths::get_cmake_exe() const
     {
         return this->cmake_exe.get_lazy([this]() { return get_cmake_path(this->downloads, this->scripts); });
@@ -546,6 +598,167 @@ namespace vcpkg
         return found_toolsets;
     }
 
+    // The probe above shells out to powershell and stats every candidate vcvarsall and
+    // dumpbin location, which costs several hundred milliseconds on machines with
+    // multiple VS versions -- on every process start, before any build begins. The
+    // result only changes when an installation is added, removed, or updated, so it is
+    // persisted to disk keyed by the timestamps of the VS installer's state.
+
+    static std::string compute_toolset_fingerprint(const VcpkgPaths& paths)
+    {
+        std::vector<fs::path> state_paths;
+#if defined(_WIN32)
+        // The VS 2017 installer keeps per-instance state files here; they are rewritten
+        // whenever an instance is installed, modified, or removed.
+        if (const auto program_data = System::get_environment_variable("PROGRAMDATA").get())
+        {
+            state_paths.push_back(fs::path(*program_data) / "Microsoft" / "VisualStudio" / "Packages" /
+                                  "_Instances");
+        }
+        // Older VS versions have no instance store; fall back to the install roots.
+        state_paths.push_back(System::get_program_files_32_bit() / "Microsoft Visual Studio");
+        state_paths.push_back(System::get_program_files_32_bit() / "Microsoft Visual Studio 14.0" / "VC");
+        state_paths.push_back(System::get_program_files_32_bit() / "Microsoft Visual Studio 12.0" / "VC");
+#endif
+
+        const auto& fs = paths.get_filesystem();
+        std::string fingerprint = "1";
+        for (const fs::path& state_path : state_paths)
+        {
+            std::error_code ec;
+            const std::int64_t mtime = fs.last_write_time(state_path, ec);
+            fingerprint += ';';
+            fingerprint += std::to_string(ec ? 0 : mtime);
+        }
+        return fingerprint;
+    }
+
+    static fs::path toolset_cache_path(const VcpkgPaths& paths) { return paths.root / ".vcpkg-toolsets.cache"; }
+
+    // Toolset and ToolsetArchOption hold non-owning CStringViews, so deserialized
+    // entries must resolve back to the same static strings the probe would have used.
+    // Unknown names invalidate the cache and force a re-probe.
+    static Optional<ToolsetArchOption> toolset_arch_from_name(const std::string& name)
+    {
+        using CPU = System::CPUArchitecture;
+        static const std::vector<ToolsetArchOption> KNOWN_ARCH_OPTIONS = {
+            {"x86", CPU::X86, CPU::X86},
+            {"x64", CPU::X64, CPU::X64},
+            {"amd64", CPU::X64, CPU::X64},
+            {"x86_amd64", CPU::X86, CPU::X64},
+            {"x86_arm", CPU::X86, CPU::ARM},
+            {"x86_arm64", CPU::X86, CPU::ARM64},
+            {"amd64_x86", CPU::X64, CPU::X86},
+            {"amd64_arm", CPU::X64, CPU::ARM},
+            {"amd64_arm64", CPU::X64, CPU::ARM64},
+        };
+
+        for (const ToolsetArchOption& option : KNOWN_ARCH_OPTIONS)
+        {
+            if (name == option.name) return option;
+        }
+        return nullopt;
+    }
+
+    static Optional<CStringView> toolset_version_from_name(const std::string& name)
+    {
+        for (const CStringView& version : {V_120, V_140, V_141})
+        {
+            if (name == version) return version;
+        }
+        return nullopt;
+    }
+
+    static Optional<std::vector<Toolset>> try_load_toolset_cache(const VcpkgPaths& paths,
+                                                                 const std::string& fingerprint)
+    {
+        const auto& fs = paths.get_filesystem();
+        const Expected<std::string> maybe_contents = fs.read_contents(toolset_cache_path(paths));
+        const auto contents = maybe_contents.get();
+        if (!contents) return nullopt;
+
+        const std::vector<std::string> lines = Strings::split(*contents, "\n");
+        if (lines.empty() || lines.front() != "fingerprint " + fingerprint) return nullopt;
+
+        std::vector<Toolset> toolsets;
+        for (size_t i = 1; i < lines.size(); ++i)
+        {
+            const std::string& line = lines[i];
+            if (line.empty()) continue;
+            const size_t space = line.find(' ');
+            if (space == std::string::npos) return nullopt;
+            const std::string key = line.substr(0, space);
+            const std::string value = line.substr(space + 1);
+
+            if (key == "toolset")
+            {
+                const auto version = toolset_version_from_name(value);
+                if (!version) return nullopt;
+                toolsets.emplace_back();
+                toolsets.back().version = *version.get();
+            }
+            else if (toolsets.empty())
+                return nullopt;
+            else if (key == "vsroot")
+                toolsets.back().visual_studio_root_path = fs::u8path(value);
+            else if (key == "dumpbin")
+                toolsets.back().dumpbin = fs::u8path(value);
+            else if (key == "vcvarsall")
+                toolsets.back().vcvarsall = fs::u8path(value);
+            else if (key == "option")
+                toolsets.back().vcvarsall_options.push_back(value);
+            else if (key == "arch")
+            {
+                const auto arch = toolset_arch_from_name(value);
+                if (!arch) return nullopt;
+                toolsets.back().supported_architectures.push_back(*arch.get());
+            }
+            else
+                return nullopt;
+        }
+
+        if (toolsets.empty()) return nullopt;
+
+        // Belt and braces: the fingerprint covers the installer state, but the scripts
+        // must still be where the cache says they are.
+        for (const Toolset& toolset : toolsets)
+        {
+            if (!fs.exists(toolset.vcvarsall)) return nullopt;
+        }
+
+        return toolsets;
+    }
+
+    static void save_toolset_cache(const VcpkgPaths& paths,
+                                   const std::string& fingerprint,
+                                   const std::vector<Toolset>& toolsets)
+    {
+        std::string contents = "fingerprint " + fingerprint + "\n";
+        for (const Toolset& toolset : toolsets)
+        {
+            contents.append("toolset ").append(toolset.version.c_str()).push_back('\n');
+            contents.append("vsroot ").append(toolset.visual_studio_root_path.u8string()).push_back('\n');
+            contents.append("dumpbin ").append(toolset.dumpbin.u8string()).push_back('\n');
+            contents.append("vcvarsall ").append(toolset.vcvarsall.u8string()).push_back('\n');
+            for (const std::string& option : toolset.vcvarsall_options)
+                contents.append("option ").append(option).push_back('\n');
+            for (const ToolsetArchOption& arch : toolset.supported_architectures)
+                contents.append("arch ").append(arch.name.c_str()).push_back('\n');
+        }
+        paths.get_filesystem().write_contents(toolset_cache_path(paths), contents);
+    }
+
+    static std::vector<Toolset> load_toolset_instances(const VcpkgPaths& paths)
+    {
+        const std::string fingerprint = compute_toolset_fingerprint(paths);
+        auto cached = try_load_toolset_cache(paths, fingerprint);
+        if (const auto p = cached.get()) return std::move(*p);
+
+        std::vector<Toolset> found = find_toolset_instances(paths);
+        save_toolset_cache(paths, fingerprint, found);
+        return found;
+    }
+
     const Toolset& VcpkgPaths::get_toolset(const Build::PreBuildInfo& prebuildinfo) const
     {
         if (prebuildinfo.external_toolchain_file)
@@ -571,7 +784,7 @@ namespace vcpkg
 
         // Invariant: toolsets are non-empty and sorted with newest at back()
         const std::vector<Toolset>& vs_toolsets =
-            this->toolsets.get_lazy([this]() { return find_toolset_instances(*this); });
+            this->toolsets.get_lazy([this]() { return load_toolset_instances(*this); });
 
         std::vector<const Toolset*> candidates = Util::element_pointers(vs_toolsets);
         const auto tsv = prebuildinfo.platform_toolset.get();
@@ -5,11 +5,38 @@
 
 namespace vcpkg
 {
-    VersionT::VersionT() : value("0.0.0") {}
-    VersionT::VersionT(const std::string& value) : value(value) {}
+    VersionT::VersionT() : VersionT("0.0.0") {}
+    VersionT::VersionT(const std::string& value) : value(value)
+    {
+        const char* it = value.c_str();
+        const char* const last = it + value.size();
+        while (it != last)
+        {
+            if (*it >= '0' && *it <= '9')
+            {
+                unsigned long long segment = 0;
+                for (; it != last && *it >= '0' && *it <= '9'; ++it)
+                    segment = segment * 10 + static_cast<unsigned long long>(*it - '0');
+                segments.push_back(segment);
+            }
+            else
+            {
+                suffix.push_back(*it);
+                ++it;
+            }
+        }
+    }
     const std::string& VersionT::to_string() const { return value; }
-    bool operator==(const VersionT& left, const VersionT& right) { return left.to_string() == right.to_string(); }
-    bool operator!=(const VersionT& left, const VersionT& right) { return left.to_string() != right.to_string(); }
+    const std::vector<unsigned long long>& VersionT::numeric_segments() const { return segments; }
+    bool operator==(const VersionT& left, const VersionT& right) { return left.value == right.value; }
+    bool operator!=(const VersionT& left, const VersionT& right) { return !(left == right); }
+    bool operator<(const VersionT& left, const VersionT& right)
+    {
+        if (left.segments != right.segments) return left.segments < right.segments;
+        if (left.suffix != right.suffix) return left.suffix < right.suffix;
+        return left.value < right.value;
+    }
+    bool operator>(const VersionT& left, const VersionT& right) { return right < left; }
     std::string to_printf_arg(const VersionT& version) { return version.to_string(); }
 
     VersionDiff::VersionDiff() : left(), right() {}
@@ -12,9 +12,18 @@ int WINAPI WinMain(_In_ HINSTANCE, _In_opt_ HINSTANCE, _In_ LPSTR, _In_ int)
     int argCount;
     LPWSTR* szArgList = CommandLineToArgvW(GetCommandLineW(), &argCount);
 
-    Checks::check_exit(VCPKG_LINE_INFO, argCount == 2, "Requires exactly one argument, the path to the payload file");
-    auto v = Files::get_real_filesystem().read_contents(szArgList[1]).value_or_exit(VCPKG_LINE_INFO);
-    Metrics::g_metrics.lock()->upload(v);
+    Checks::check_exit(VCPKG_LINE_INFO, argCount <= 2, "Usage: vcpkgmetricsuploader [path-to-payload-file]");
+    if (argCount == 2)
+    {
+        // Legacy single-payload invocation.
+        auto v = Files::get_real_filesystem().read_contents(szArgList[1]).value_or_exit(VCPKG_LINE_INFO);
+        Metrics::g_metrics.lock()->upload(v);
+    }
+    else
+    {
+        // With no argument, drain the whole spool in one run with batched POSTs.
+        Metrics::g_metrics.lock()->drain_spool();
+    }
     LocalFree(szArgList);
     return 0;
 }